@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "geom/culling.hpp"
+#include "geom/view-frustum.hpp"
+#include "math/math.hpp"
+#include "utility/fundamental-types.hpp"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/**
+ * Times bulk culling of AABB and sphere arrays against a view frustum, compared with testing each bounding volume through the virtual bounding_volume::intersects(), and checks that both agree.
+ */
+int main()
+{
+	const int iteration_count = 200;
+	const int object_count = 100000;
+	
+	std::mt19937 random(0);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	
+	// Bounding volumes scattered around the camera
+	std::vector<geom::aabb<float>> aabbs;
+	std::vector<geom::sphere<float>> spheres;
+	geom::aabb_array<float> aabb_array;
+	geom::sphere_array<float> sphere_array;
+	for (int i = 0; i < object_count; ++i)
+	{
+		const float3 center = {(unit(random) - 0.5f) * 400.0f, (unit(random) - 0.5f) * 100.0f, (unit(random) - 0.5f) * 400.0f};
+		const float radius = 0.25f + unit(random) * 2.0f;
+		const float3 extents = {radius, radius, radius};
+		
+		aabbs.push_back({center - extents, center + extents});
+		spheres.push_back({center, radius});
+		aabb_array.push_back(aabbs.back());
+		sphere_array.push_back(spheres.back());
+	}
+	
+	const float4x4 projection = math::perspective_half_z(math::radians(60.0f), 16.0f / 9.0f, 0.1f, 150.0f);
+	const float4x4 view = math::look_at(float3{0.0f, 2.0f, 0.0f}, float3{1.0f, 1.0f, -3.0f}, float3{0.0f, 1.0f, 0.0f});
+	const geom::view_frustum<float> frustum(projection * view);
+	const geom::convex_hull<float>& hull = frustum.get_bounds();
+	const geom::bounding_volume<float>& volume = hull;
+	
+	std::vector<unsigned char> aabb_visibility(object_count);
+	std::vector<unsigned char> sphere_visibility(object_count);
+	std::vector<std::uint64_t> aabb_mask;
+	std::vector<std::uint64_t> sphere_mask;
+	
+	using clock = std::chrono::high_resolution_clock;
+	const auto t0 = clock::now();
+	for (int i = 0; i < iteration_count; ++i)
+		for (int j = 0; j < object_count; ++j)
+			aabb_visibility[j] = volume.intersects(aabbs[j]);
+	const auto t1 = clock::now();
+	for (int i = 0; i < iteration_count; ++i)
+		geom::cull(hull, aabb_array, aabb_mask);
+	const auto t2 = clock::now();
+	for (int i = 0; i < iteration_count; ++i)
+		for (int j = 0; j < object_count; ++j)
+			sphere_visibility[j] = volume.intersects(spheres[j]);
+	const auto t3 = clock::now();
+	for (int i = 0; i < iteration_count; ++i)
+		geom::cull(hull, sphere_array, sphere_mask);
+	const auto t4 = clock::now();
+	
+	// Count objects on which the bulk and per-object tests disagree
+	std::size_t visible_count = 0;
+	std::size_t mismatch_count = 0;
+	for (int i = 0; i < object_count; ++i)
+	{
+		const bool aabb_visible = (aabb_mask[i / 64] >> (i % 64)) & 1;
+		const bool sphere_visible = (sphere_mask[i / 64] >> (i % 64)) & 1;
+		visible_count += aabb_visible;
+		mismatch_count += (aabb_visible != static_cast<bool>(aabb_visibility[i]));
+		mismatch_count += (sphere_visible != static_cast<bool>(sphere_visibility[i]));
+	}
+	
+	const auto ns_per_object = [&](clock::duration duration)
+	{
+		return std::chrono::duration<double, std::nano>(duration).count() / (static_cast<double>(iteration_count) * object_count);
+	};
+	
+	#if defined(ANTKEEPER_MATH_AVX)
+		std::cout << "culling: AVX, ";
+	#else
+		std::cout << "culling: auto-vectorized, ";
+	#endif
+	std::cout << object_count << " objects, " << visible_count << " visible" << std::endl;
+	std::cout << "aabb, per object:    " << ns_per_object(t1 - t0) << " ns/object" << std::endl;
+	std::cout << "aabb, bulk:          " << ns_per_object(t2 - t1) << " ns/object" << std::endl;
+	std::cout << "sphere, per object:  " << ns_per_object(t3 - t2) << " ns/object" << std::endl;
+	std::cout << "sphere, bulk:        " << ns_per_object(t4 - t3) << " ns/object" << std::endl;
+	std::cout << "mismatches:          " << mismatch_count << std::endl;
+	
+	return (mismatch_count == 0) ? 0 : 1;
+}
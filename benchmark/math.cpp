@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "math/math.hpp"
+#include "utility/fundamental-types.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+/**
+ * Times the single-precision math kernels which have SIMD specializations. Built twice: once with the specializations, and once with ANTKEEPER_MATH_NO_SIMD defined, which times the generic implementations.
+ */
+int main()
+{
+	const int run_count = 5;
+	const int iteration_count = 100;
+	const std::size_t count = 10000;
+	
+	std::mt19937 random(0);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	
+	std::vector<math::transform<float>> transforms(count);
+	std::vector<float4x4> models(count);
+	std::vector<float3x3> normal_matrices(count);
+	std::vector<math::quaternion<float>> rotations(count);
+	std::vector<float3> vectors(count);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		math::transform<float>& t = transforms[i];
+		t.translation = {unit(random) * 100.0f, unit(random) * 100.0f, unit(random) * 100.0f};
+		t.rotation = math::normalize(math::quaternion<float>{unit(random), unit(random), unit(random), unit(random)});
+		t.scale = {1.5f + unit(random), 1.5f + unit(random), 1.5f + unit(random)};
+		
+		models[i] = math::matrix_cast(t);
+		normal_matrices[i] = math::resize<3, 3>(models[i]);
+		rotations[i] = t.rotation;
+		vectors[i] = t.translation;
+	}
+	
+	const float4x4 view_projection = math::perspective_half_z(1.0f, 1.5f, 0.1f, 100.0f) * math::look_at(float3{0.0f, 2.0f, 5.0f}, float3{0.0f, 0.0f, 0.0f}, float3{0.0f, 1.0f, 0.0f});
+	
+	std::vector<float4x4> matrix_output(count);
+	std::vector<float3x3> normal_output(count);
+	std::vector<math::quaternion<float>> quaternion_output(count);
+	std::vector<float3> vector_output(count);
+	
+	// Summed into the output, so the timed loops can't be discarded
+	float checksum = 0.0f;
+	
+	// Reports the fastest of several runs of a kernel, to reduce noise from other processes
+	using clock = std::chrono::high_resolution_clock;
+	const auto measure = [&](const char* name, auto&& kernel)
+	{
+		double best = std::numeric_limits<double>::infinity();
+		for (int run = 0; run < run_count; ++run)
+		{
+			const auto start = clock::now();
+			for (int i = 0; i < iteration_count; ++i)
+				kernel(i);
+			best = std::min<double>(best, std::chrono::duration<double, std::nano>(clock::now() - start).count());
+		}
+		std::cout << name << best / (static_cast<double>(iteration_count) * count) << " ns/op" << std::endl;
+	};
+	
+	#if defined(ANTKEEPER_MATH_AVX)
+		std::cout << "math: AVX" << std::endl;
+	#elif defined(ANTKEEPER_MATH_SSE)
+		std::cout << "math: SSE" << std::endl;
+	#else
+		std::cout << "math: generic" << std::endl;
+	#endif
+	
+	measure("float4x4 * float4x4:          ", [&](int i)
+	{
+		for (std::size_t j = 0; j < count; ++j)
+			matrix_output[j] = view_projection * models[j];
+		checksum += matrix_output[i][3][3];
+	});
+	
+	measure("inverse_transpose(float3x3):  ", [&](int i)
+	{
+		for (std::size_t j = 0; j < count; ++j)
+			normal_output[j] = math::inverse_transpose(normal_matrices[j]);
+		checksum += normal_output[i][2][2];
+	});
+	
+	measure("quaternion * quaternion:      ", [&](int i)
+	{
+		for (std::size_t j = 0; j < count; ++j)
+			quaternion_output[j] = rotations[j] * rotations[count - 1 - j];
+		checksum += quaternion_output[i].w;
+	});
+	
+	measure("quaternion * float3:          ", [&](int i)
+	{
+		for (std::size_t j = 0; j < count; ++j)
+			vector_output[j] = rotations[j] * vectors[j];
+		checksum += vector_output[i].x;
+	});
+	
+	measure("matrix_cast(transform) batch: ", [&](int i)
+	{
+		math::matrix_cast(transforms.data(), matrix_output.data(), count);
+		checksum += matrix_output[i][3][0];
+	});
+	
+	std::cout << "checksum: " << checksum << std::endl;
+	
+	return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "renderer/occlusion-culler.hpp"
+#include "geom/aabb.hpp"
+#include "math/math.hpp"
+#include "utility/fundamental-types.hpp"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/**
+ * Times the occlusion culler over a synthetic underground scene: staggered rows of chamber walls occluding a field of small objects, viewed from a camera which sweeps across the scene.
+ */
+int main()
+{
+	const int frame_count = 500;
+	const int wall_count = 96;
+	const int object_count = 10000;
+	
+	// Unit box mesh
+	const float3 box_positions[8] =
+	{
+		{-0.5f, -0.5f, -0.5f}, { 0.5f, -0.5f, -0.5f}, {-0.5f,  0.5f, -0.5f}, { 0.5f,  0.5f, -0.5f},
+		{-0.5f, -0.5f,  0.5f}, { 0.5f, -0.5f,  0.5f}, {-0.5f,  0.5f,  0.5f}, { 0.5f,  0.5f,  0.5f}
+	};
+	const std::uint32_t box_indices[36] =
+	{
+		0, 2, 1, 1, 2, 3,
+		4, 5, 6, 5, 7, 6,
+		0, 1, 4, 1, 5, 4,
+		2, 6, 3, 3, 6, 7,
+		0, 4, 2, 2, 4, 6,
+		1, 3, 5, 3, 7, 5
+	};
+	
+	std::mt19937 random(0);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	
+	// Staggered rows of walls
+	std::vector<float4x4> walls;
+	for (int i = 0; i < wall_count; ++i)
+	{
+		const int row = i / 12;
+		const int column = i % 12;
+		const float3 translation = {(static_cast<float>(column) - 5.5f) * 7.0f + ((row & 1) ? 3.5f : 0.0f), 0.0f, -10.0f - static_cast<float>(row) * 12.0f};
+		const float3 scale = {6.0f, 8.0f + unit(random) * 4.0f, 0.5f};
+		walls.push_back(math::translate(math::identity4x4<float>, translation) * math::scale(math::identity4x4<float>, scale));
+	}
+	
+	// Small objects scattered between and behind the walls
+	std::vector<geom::aabb<float>> objects;
+	for (int i = 0; i < object_count; ++i)
+	{
+		const float3 center = {(unit(random) - 0.5f) * 90.0f, (unit(random) - 0.5f) * 8.0f, -5.0f - unit(random) * 110.0f};
+		const float3 extents = float3{1.0f, 1.0f, 1.0f} * (0.25f + unit(random));
+		objects.push_back({center - extents, center + extents});
+	}
+	
+	occlusion_culler culler(256, 128);
+	const float4x4 projection = math::perspective_half_z(math::radians(60.0f), 2.0f, 0.1f, 500.0f);
+	
+	double rasterize_time = 0.0;
+	double hierarchy_time = 0.0;
+	double test_time = 0.0;
+	std::size_t occluded_count = 0;
+	
+	using clock = std::chrono::high_resolution_clock;
+	for (int frame = 0; frame < frame_count; ++frame)
+	{
+		const float sweep = static_cast<float>(frame) / static_cast<float>(frame_count) - 0.5f;
+		const float3 eye = {sweep * 20.0f, 1.0f, 5.0f};
+		const float4x4 view = math::look_at(eye, eye + float3{sweep * 0.5f, 0.0f, -1.0f}, float3{0.0f, 1.0f, 0.0f});
+		
+		const auto t0 = clock::now();
+		culler.clear(projection * view);
+		for (const float4x4& wall: walls)
+			culler.rasterize(box_positions, box_indices, 36, wall);
+		const auto t1 = clock::now();
+		culler.update_hierarchy();
+		const auto t2 = clock::now();
+		for (const geom::aabb<float>& object: objects)
+			occluded_count += !culler.is_visible(object);
+		const auto t3 = clock::now();
+		
+		rasterize_time += std::chrono::duration<double, std::milli>(t1 - t0).count();
+		hierarchy_time += std::chrono::duration<double, std::milli>(t2 - t1).count();
+		test_time += std::chrono::duration<double, std::milli>(t3 - t2).count();
+	}
+	
+	std::cout << "occlusion culler: " << culler.get_width() << "x" << culler.get_height() << ", " << wall_count << " occluders, " << object_count << " objects, " << frame_count << " frames" << std::endl;
+	std::cout << "rasterize:  " << rasterize_time / frame_count << " ms/frame" << std::endl;
+	std::cout << "hierarchy:  " << hierarchy_time / frame_count << " ms/frame" << std::endl;
+	std::cout << "test:       " << test_time / frame_count << " ms/frame" << std::endl;
+	std::cout << "occluded:   " << 100.0 * static_cast<double>(occluded_count) / (static_cast<double>(object_count) * frame_count) << "%" << std::endl;
+	
+	return 0;
+}
@@ -23,13 +23,40 @@
 frame_scheduler::frame_scheduler():
 	update_callback(nullptr),
 	render_callback(nullptr),
+	snapshot_callback(nullptr),
 	update_rate(60.0),
 	update_timestep(1.0 / update_rate),
-	max_frame_duration(update_timestep)
+	max_frame_duration(update_timestep),
+	pipelined(false),
+	update_thread_running(false),
+	scheduled_update_count(0),
+	scheduled_update_time(0.0),
+	scheduled_update_timestep(0.0),
+	update_exception(nullptr),
+	pending_update_count(0),
+	pending_update_time(0.0),
+	pending_alpha(0.0),
+	snapshot_update_count(0),
+	fast_forward(false),
+	render_interval(0.0)
 {
 	reset();
 }
 
+frame_scheduler::~frame_scheduler()
+{
+	if (update_thread.joinable())
+	{
+		// Stop update thread after it finishes any scheduled updates
+		{
+			std::lock_guard<std::mutex> lock(update_mutex);
+			update_thread_running = false;
+		}
+		update_condition.notify_all();
+		update_thread.join();
+	}
+}
+
 void frame_scheduler::set_update_callback(std::function<void(double, double)> callback)
 {
 	update_callback = callback;
@@ -40,6 +67,57 @@ void frame_scheduler::set_render_callback(std::function<void(double)> callback)
 	render_callback = callback;
 }
 
+void frame_scheduler::set_snapshot_callback(std::function<void(double, double)> callback)
+{
+	snapshot_callback = callback;
+}
+
+void frame_scheduler::set_pipelined(bool pipelined)
+{
+	if (this->pipelined == pipelined)
+		return;
+	
+	if (pipelined)
+	{
+		// Start update thread
+		update_thread_running = true;
+		update_thread = std::thread(&frame_scheduler::run_updates, this);
+		snapshot_update_count = 0;
+	}
+	else
+	{
+		// Wait for scheduled updates, then stop update thread
+		wait_for_updates();
+		{
+			std::lock_guard<std::mutex> lock(update_mutex);
+			update_thread_running = false;
+		}
+		update_condition.notify_all();
+		update_thread.join();
+		
+		// Publish updates which were performed but not yet published
+		if (pending_update_count && snapshot_callback)
+			snapshot_callback(pending_update_time, update_timestep * pending_update_count);
+		pending_update_count = 0;
+	}
+	
+	this->pipelined = pipelined;
+}
+
+void frame_scheduler::set_fast_forward(bool fast_forward)
+{
+	this->fast_forward = fast_forward;
+	
+	// Discard wall time accumulated before the mode change
+	accumulator = 0.0;
+	render_time = std::chrono::high_resolution_clock::now();
+}
+
+void frame_scheduler::set_render_interval(double interval)
+{
+	render_interval = interval;
+}
+
 void frame_scheduler::set_update_rate(double frequency)
 {
 	update_rate = frequency;
@@ -56,13 +134,36 @@ double frame_scheduler::get_frame_duration() const
 	return frame_duration;
 }
 
+double frame_scheduler::get_elapsed_time() const
+{
+	return elapsed_time;
+}
+
+bool frame_scheduler::is_pipelined() const
+{
+	return pipelined;
+}
+
+bool frame_scheduler::is_fast_forward() const
+{
+	return fast_forward;
+}
+
 void frame_scheduler::reset()
 {
+	// Discard updates scheduled before the reset
+	if (pipelined)
+		wait_for_updates();
+	pending_update_count = 0;
+	pending_alpha = 0.0;
+	snapshot_update_count = 0;
+	
 	elapsed_time = 0.0;
 	accumulator = 0.0;
 	frame_start = std::chrono::high_resolution_clock::now();
 	frame_end = frame_start;
 	frame_duration = 0.0;
+	render_time = frame_start;
 }
 
 void frame_scheduler::tick()
@@ -71,14 +172,152 @@ void frame_scheduler::tick()
 	frame_duration = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(frame_end - frame_start).count()) / 1000000.0;
 	frame_start = frame_end;
 	
+	if (fast_forward)
+		tick_fast_forward();
+	else if (pipelined)
+		tick_pipelined();
+	else
+		tick_serial();
+}
+
+void frame_scheduler::tick_serial()
+{
 	accumulator += std::min<double>(max_frame_duration, frame_duration);
 
 	while (accumulator >= update_timestep)
 	{
 		update_callback(elapsed_time, update_timestep);
+		if (snapshot_callback)
+			snapshot_callback(elapsed_time, update_timestep);
 		elapsed_time += update_timestep;
 		accumulator -= update_timestep;
 	}
 	
 	render_callback(accumulator * update_rate);
 }
+
+void frame_scheduler::tick_pipelined()
+{
+	// Wait for the updates scheduled last frame, then publish them
+	wait_for_updates();
+	if (pending_update_count)
+	{
+		if (snapshot_callback)
+			snapshot_callback(pending_update_time, update_timestep * pending_update_count);
+		snapshot_update_count = pending_update_count;
+	}
+	
+	// A snapshot may span several updates, so remap alpha from the last update onto the whole snapshot
+	double alpha = pending_alpha;
+	if (snapshot_update_count > 1)
+		alpha = 1.0 - (1.0 - alpha) / static_cast<double>(snapshot_update_count);
+	
+	// Determine the updates of this frame
+	accumulator += std::min<double>(max_frame_duration, frame_duration);
+	std::size_t update_count = 0;
+	while (accumulator >= update_timestep)
+	{
+		++update_count;
+		accumulator -= update_timestep;
+	}
+	pending_update_count = update_count;
+	pending_update_time = elapsed_time;
+	pending_alpha = accumulator * update_rate;
+	elapsed_time += update_timestep * static_cast<double>(update_count);
+	
+	// Schedule updates on the update thread
+	if (update_count)
+	{
+		{
+			std::lock_guard<std::mutex> lock(update_mutex);
+			scheduled_update_count = update_count;
+			scheduled_update_time = pending_update_time;
+			scheduled_update_timestep = update_timestep;
+		}
+		update_condition.notify_all();
+	}
+	
+	// Render the published snapshot while the updates are performed
+	render_callback(alpha);
+}
+
+void frame_scheduler::tick_fast_forward()
+{
+	// Publish updates performed on the update thread, which is left idle while fast-forwarding
+	if (pipelined)
+	{
+		wait_for_updates();
+		if (pending_update_count && snapshot_callback)
+			snapshot_callback(pending_update_time, update_timestep * pending_update_count);
+		pending_update_count = 0;
+		snapshot_update_count = 0;
+	}
+	
+	// Perform updates back to back until the maximum frame duration has elapsed
+	std::chrono::high_resolution_clock::time_point now;
+	do
+	{
+		update_callback(elapsed_time, update_timestep);
+		if (snapshot_callback)
+			snapshot_callback(elapsed_time, update_timestep);
+		elapsed_time += update_timestep;
+		
+		now = std::chrono::high_resolution_clock::now();
+	}
+	while (std::chrono::duration<double>(now - frame_start).count() < max_frame_duration);
+	
+	// Render the latest update state, if the render interval has elapsed
+	if (render_interval > 0.0 && std::chrono::duration<double>(now - render_time).count() >= render_interval)
+	{
+		render_callback(1.0);
+		render_time = now;
+	}
+}
+
+void frame_scheduler::wait_for_updates()
+{
+	std::unique_lock<std::mutex> lock(update_mutex);
+	update_condition.wait(lock, [this]{return !scheduled_update_count;});
+	
+	// Rethrow exceptions thrown on the update thread
+	if (update_exception)
+	{
+		std::exception_ptr exception = update_exception;
+		update_exception = nullptr;
+		std::rethrow_exception(exception);
+	}
+}
+
+void frame_scheduler::run_updates()
+{
+	std::unique_lock<std::mutex> lock(update_mutex);
+	for (;;)
+	{
+		update_condition.wait(lock, [this]{return scheduled_update_count || !update_thread_running;});
+		if (!scheduled_update_count)
+			break;
+		
+		const std::size_t update_count = scheduled_update_count;
+		const double t = scheduled_update_time;
+		const double dt = scheduled_update_timestep;
+		lock.unlock();
+		
+		// Perform scheduled updates
+		std::exception_ptr exception = nullptr;
+		try
+		{
+			for (std::size_t i = 0; i < update_count; ++i)
+				update_callback(t + dt * static_cast<double>(i), dt);
+		}
+		catch (...)
+		{
+			exception = std::current_exception();
+		}
+		
+		// Signal completion
+		lock.lock();
+		update_exception = exception;
+		scheduled_update_count = 0;
+		update_condition.notify_all();
+	}
+}
@@ -21,17 +21,30 @@
 #define ANTKEEPER_FRAME_SCHEDULER_HPP
 
 #include <chrono>
+#include <condition_variable>
+#include <exception>
 #include <functional>
+#include <mutex>
+#include <thread>
 
 /**
  * Schedules fixed-timestep update calls and variable timestep render calls.
  *
+ * By default, updates and renders are performed serially on the thread which calls tick(). In pipelined mode, the update callbacks for the next frame are performed on an update thread while the current frame is rendered, so frames take as long as the longer of the two rather than their sum. Simulation state is handed from the update side to the render side by the snapshot callback, which is the only point at which both sides are idle. Rendered frames lag the simulation by one frame.
+ *
+ * In fast-forward mode, wall time is ignored and updates are performed back to back, as fast as the CPU allows, with renders performed only at a fixed wall-time interval, if at all.
+ *
  * @see https://gafferongames.com/post/fix_your_timestep/
  */
 class frame_scheduler
 {
 public:
 	frame_scheduler();
+	
+	/**
+	 * Stops the update thread, if any.
+	 */
+	~frame_scheduler();
 
 	/**
 	 * Sets the update callback.
@@ -46,6 +59,36 @@ public:
 	 * @param callback Function which takes one parameter: `alpha`, which is a factor that can be used to interpolate between the previous and current update states.
 	 */
 	void set_render_callback(std::function<void(double)> callback);
+	
+	/**
+	 * Sets the snapshot callback.
+	 *
+	 * @param callback Function which publishes simulation state for rendering, taking two parameters: `t`, the total elapsed time at the start of the published updates, and `dt`, the time spanned by the published updates. In serial mode, it is called after each update callback. In pipelined mode, it is called on the thread which calls tick(), once per frame in which updates were performed, while the update thread is idle.
+	 */
+	void set_snapshot_callback(std::function<void(double, double)> callback);
+	
+	/**
+	 * Enables or disables pipelined mode. In pipelined mode, the update callback is called on a separate update thread, concurrently with the render callback, which may then only access state published by the snapshot callback.
+	 *
+	 * @param pipelined `true` to enable pipelined mode, `false` to perform updates and renders serially.
+	 */
+	void set_pipelined(bool pipelined);
+	
+	/**
+	 * Enables or disables fast-forward mode. In fast-forward mode, each tick performs serial update and snapshot callbacks back to back for the maximum frame duration, regardless of the update rate, and the render callback is only called once the render interval has elapsed.
+	 *
+	 * @param fast_forward `true` to enable fast-forward mode, `false` to keep updates in step with wall time.
+	 *
+	 * @see frame_scheduler::set_render_interval()
+	 */
+	void set_fast_forward(bool fast_forward);
+	
+	/**
+	 * Sets the minimum wall time between renders in fast-forward mode.
+	 *
+	 * @param interval Render interval, in seconds. If not positive, nothing will be rendered in fast-forward mode.
+	 */
+	void set_render_interval(double interval);
 
 	/**
 	 * Sets the update rate.
@@ -65,6 +108,17 @@ public:
 	 * Returns the duration of the last frame, in seconds.
 	 */
 	double get_frame_duration() const;
+	
+	/**
+	 * Returns the total simulated time, in seconds.
+	 */
+	double get_elapsed_time() const;
+	
+	/// Returns `true` if pipelined mode is enabled, `false` otherwise.
+	bool is_pipelined() const;
+	
+	/// Returns `true` if fast-forward mode is enabled, `false` otherwise.
+	bool is_fast_forward() const;
 
 	/**
 	 * Resets the total elapsed time, frame duration, and internal timers.
@@ -77,8 +131,24 @@ public:
 	void tick();
 
 private:
+	/// Performs serial update, snapshot, and render callbacks.
+	void tick_serial();
+	
+	/// Publishes the previous frame's updates, schedules the next frame's updates on the update thread, then renders.
+	void tick_pipelined();
+	
+	/// Performs as many serial updates as fit in the maximum frame duration, then renders if the render interval has elapsed.
+	void tick_fast_forward();
+	
+	/// Blocks until the update thread has performed all scheduled updates, rethrowing any exception they threw.
+	void wait_for_updates();
+	
+	/// Update thread function.
+	void run_updates();
+	
 	std::function<void(double, double)> update_callback;
 	std::function<void(double)> render_callback;
+	std::function<void(double, double)> snapshot_callback;
 	double update_rate;
 	double update_timestep;
 	double max_frame_duration;
@@ -87,6 +157,24 @@ private:
 	std::chrono::high_resolution_clock::time_point frame_start;
 	std::chrono::high_resolution_clock::time_point frame_end;
 	double frame_duration;
+	
+	bool pipelined;
+	std::thread update_thread;
+	std::mutex update_mutex;
+	std::condition_variable update_condition;
+	bool update_thread_running;
+	std::size_t scheduled_update_count;
+	double scheduled_update_time;
+	double scheduled_update_timestep;
+	std::exception_ptr update_exception;
+	std::size_t pending_update_count;
+	double pending_update_time;
+	double pending_alpha;
+	std::size_t snapshot_update_count;
+	
+	bool fast_forward;
+	double render_interval;
+	std::chrono::high_resolution_clock::time_point render_time;
 };
 
 #endif // ANTKEEPER_FRAME_SCHEDULER_HPP
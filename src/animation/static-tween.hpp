@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTKEEPER_STATIC_TWEEN_HPP
+#define ANTKEEPER_STATIC_TWEEN_HPP
+
+#include "math/math.hpp"
+#include <algorithm>
+#include <type_traits>
+
+/**
+ * Tween with an interpolator which is fixed at compile time. Unlike tween<T, S>, interpolation is a direct, inlinable call rather than a call through a `std::function`, and the tween is no larger than its two states.
+ *
+ * @tparam T Value type.
+ * @tparam S Scalar type.
+ * @tparam Interpolator Function used to interpolate between states 0 and 1.
+ *
+ * @see lerp_tween
+ * @see nlerp_tween
+ * @see slerp_tween
+ * @see transform_tween
+ */
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+class static_tween
+{
+public:
+	static_assert(std::is_scalar<S>::value);
+	
+	typedef T value_type;
+	typedef S scalar_type;
+	
+	/**
+	 * Creates a static tween.
+	 *
+	 * @param state0 Initial value of state 0.
+	 * @param state1 Initial value of state 1.
+	 */
+	static_tween(const value_type& state0, const value_type& state1);
+	
+	/**
+	 * Creates a static tween.
+	 *
+	 * @param value Initial value of states 0 and 1.
+	 */
+	explicit static_tween(const value_type& value);
+	
+	/**
+	 * Creates a static tween.
+	 */
+	static_tween() = default;
+	
+	/**
+	 * Returns a reference to the specified tween state.
+	 *
+	 * @param i Index of a tween state. Should be either `0` or `1`.
+	 * @return Reference to the specified tween state.
+	 */
+	const value_type& operator[](int i) const;
+	
+	/// @copydoc static_tween::operator[](int) const
+	value_type& operator[](int i);
+	
+	/// @copydoc static_tween::interpolate(scalar_type) const
+	value_type operator[](scalar_type a) const;
+	
+	/**
+	 * Returns an interpolated state between state 0 and state 1.
+	 *
+	 * @param a Interpolation factor on `[0.0, 1.0]`.
+	 * @return Interpolated state.
+	 */
+	value_type interpolate(scalar_type a) const;
+	
+	/**
+	 * Sets state 0 = state 1.
+	 */
+	void update();
+	
+	/**
+	 * Swaps state 0 and state 1.
+	 */
+	void swap();
+	
+private:
+	value_type states[2];
+};
+
+/// Static tween which linearly interpolates between its states.
+template <class T, class S = float>
+using lerp_tween = static_tween<T, S, math::lerp<T, S>>;
+
+/// Static tween which normalized linearly interpolates between two rotations.
+template <class T>
+using nlerp_tween = static_tween<math::quaternion<T>, T, math::nlerp<T>>;
+
+/// Static tween which spherical linearly interpolates between two rotations.
+template <class T>
+using slerp_tween = static_tween<math::quaternion<T>, T, math::slerp<T>>;
+
+/// Static tween which interpolates between two transforms.
+template <class T>
+using transform_tween = static_tween<math::transform<T>, T, math::lerp<T>>;
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+static_tween<T, S, Interpolator>::static_tween(const value_type& state0, const value_type& state1):
+	states{state0, state1}
+{}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+static_tween<T, S, Interpolator>::static_tween(const value_type& value):
+	states{value, value}
+{}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+inline const typename static_tween<T, S, Interpolator>::value_type& static_tween<T, S, Interpolator>::operator[](int i) const
+{
+	return states[i];
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+inline typename static_tween<T, S, Interpolator>::value_type& static_tween<T, S, Interpolator>::operator[](int i)
+{
+	return states[i];
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+inline typename static_tween<T, S, Interpolator>::value_type static_tween<T, S, Interpolator>::operator[](scalar_type a) const
+{
+	return interpolate(a);
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+inline typename static_tween<T, S, Interpolator>::value_type static_tween<T, S, Interpolator>::interpolate(scalar_type a) const
+{
+	return Interpolator(states[0], states[1], a);
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+inline void static_tween<T, S, Interpolator>::update()
+{
+	states[0] = states[1];
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+inline void static_tween<T, S, Interpolator>::swap()
+{
+	std::swap(states[0], states[1]);
+}
+
+#endif // ANTKEEPER_STATIC_TWEEN_HPP
@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTKEEPER_TWEEN_STORE_HPP
+#define ANTKEEPER_TWEEN_STORE_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Stores many tweens of the same type as two contiguous arrays of states, one per tween state.
+ *
+ * All tweens in the store are updated with a single `memcpy` of state 1 over state 0, and can be interpolated in bulk into a contiguous output array. Tweens are addressed by index, and the indices of removed tweens are reused. States are read and written by value, as inserting a tween may reallocate the state arrays.
+ *
+ * @tparam T Value type. Must be trivially copyable.
+ * @tparam S Scalar type.
+ * @tparam Interpolator Function used to interpolate between states 0 and 1.
+ */
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+class tween_store
+{
+public:
+	static_assert(std::is_scalar<S>::value);
+	static_assert(std::is_trivially_copyable<T>::value);
+	
+	typedef T value_type;
+	typedef S scalar_type;
+	
+	/**
+	 * Handle to a tween in a tween store, which stays valid as long as the tween is in the store.
+	 *
+	 * @tparam Store Tween store type, which is const-qualified for read-only handles.
+	 */
+	template <class Store>
+	class basic_reference
+	{
+	public:
+		basic_reference(Store* store, std::size_t index);
+		
+		/// Returns the specified tween state.
+		value_type get(int i) const;
+		
+		/// Sets the specified tween state.
+		void set(int i, const value_type& value) const;
+		
+		/// Returns an interpolated state between state 0 and state 1.
+		value_type interpolate(scalar_type a) const;
+		
+		/// Sets state 0 = state 1.
+		void update() const;
+		
+	private:
+		Store* store;
+		std::size_t index;
+	};
+	
+	typedef basic_reference<tween_store> reference;
+	typedef basic_reference<const tween_store> const_reference;
+	
+	/**
+	 * Creates an empty tween store.
+	 */
+	tween_store();
+	
+	/**
+	 * Adds a tween to the store.
+	 *
+	 * @param value Initial value of states 0 and 1.
+	 * @return Index of the new tween.
+	 */
+	std::size_t insert(const value_type& value);
+	
+	/**
+	 * Removes a tween from the store. Its index may be reused by tweens inserted later.
+	 *
+	 * @param index Index of the tween to remove.
+	 */
+	void erase(std::size_t index);
+	
+	/**
+	 * Returns a state of a tween.
+	 *
+	 * @param index Index of a tween.
+	 * @param i Index of a tween state. Should be either `0` or `1`.
+	 * @return Specified tween state.
+	 */
+	value_type get(std::size_t index, int i) const;
+	
+	/**
+	 * Sets a state of a tween.
+	 *
+	 * @param index Index of a tween.
+	 * @param i Index of a tween state. Should be either `0` or `1`.
+	 * @param value Value of the tween state.
+	 */
+	void set(std::size_t index, int i, const value_type& value);
+	
+	/// Returns a handle to a tween.
+	reference operator[](std::size_t index);
+	
+	/// @copydoc tween_store::operator[](std::size_t)
+	const_reference operator[](std::size_t index) const;
+	
+	/**
+	 * Returns an interpolated state of a tween.
+	 *
+	 * @param index Index of a tween.
+	 * @param a Interpolation factor on `[0.0, 1.0]`.
+	 * @return Interpolated state.
+	 */
+	value_type interpolate(std::size_t index, scalar_type a) const;
+	
+	/**
+	 * Interpolates all tweens and transforms the interpolated states into a contiguous array, in index order.
+	 *
+	 * @param a Interpolation factor on `[0.0, 1.0]`.
+	 * @param output Array of at least size() elements to which the transformed states will be written.
+	 * @param op Function which transforms an interpolated state into an output element.
+	 */
+	template <class U, class UnaryOperation>
+	void interpolate(scalar_type a, U* output, UnaryOperation op) const;
+	
+	/**
+	 * Sets state 0 = state 1 for all tweens in the store.
+	 */
+	void update();
+	
+	/**
+	 * Sets state 0 = state 1 for a single tween.
+	 *
+	 * @param index Index of a tween.
+	 */
+	void update(std::size_t index);
+	
+	/// Returns the number of tween slots in the store, including the slots of removed tweens.
+	std::size_t size() const;
+	
+	/// Returns a counter which is incremented every time the store may have been modified.
+	std::size_t get_revision() const;
+	
+private:
+	std::vector<value_type> states[2];
+	std::vector<std::size_t> free_indices;
+	std::size_t revision;
+};
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+template <class Store>
+inline tween_store<T, S, Interpolator>::basic_reference<Store>::basic_reference(Store* store, std::size_t index):
+	store(store),
+	index(index)
+{}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+template <class Store>
+inline typename tween_store<T, S, Interpolator>::value_type tween_store<T, S, Interpolator>::basic_reference<Store>::get(int i) const
+{
+	return store->get(index, i);
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+template <class Store>
+inline void tween_store<T, S, Interpolator>::basic_reference<Store>::set(int i, const value_type& value) const
+{
+	store->set(index, i, value);
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+template <class Store>
+inline typename tween_store<T, S, Interpolator>::value_type tween_store<T, S, Interpolator>::basic_reference<Store>::interpolate(scalar_type a) const
+{
+	return store->interpolate(index, a);
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+template <class Store>
+inline void tween_store<T, S, Interpolator>::basic_reference<Store>::update() const
+{
+	store->update(index);
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+tween_store<T, S, Interpolator>::tween_store():
+	revision(0)
+{}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+std::size_t tween_store<T, S, Interpolator>::insert(const value_type& value)
+{
+	++revision;
+	
+	// Reuse the index of a removed tween, if any
+	if (!free_indices.empty())
+	{
+		const std::size_t index = free_indices.back();
+		free_indices.pop_back();
+		states[0][index] = value;
+		states[1][index] = value;
+		return index;
+	}
+	
+	states[0].push_back(value);
+	states[1].push_back(value);
+	return states[0].size() - 1;
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+void tween_store<T, S, Interpolator>::erase(std::size_t index)
+{
+	++revision;
+	free_indices.push_back(index);
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+inline typename tween_store<T, S, Interpolator>::value_type tween_store<T, S, Interpolator>::get(std::size_t index, int i) const
+{
+	return states[i][index];
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+inline void tween_store<T, S, Interpolator>::set(std::size_t index, int i, const value_type& value)
+{
+	++revision;
+	states[i][index] = value;
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+inline typename tween_store<T, S, Interpolator>::reference tween_store<T, S, Interpolator>::operator[](std::size_t index)
+{
+	return reference(this, index);
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+inline typename tween_store<T, S, Interpolator>::const_reference tween_store<T, S, Interpolator>::operator[](std::size_t index) const
+{
+	return const_reference(this, index);
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+inline typename tween_store<T, S, Interpolator>::value_type tween_store<T, S, Interpolator>::interpolate(std::size_t index, scalar_type a) const
+{
+	return Interpolator(states[0][index], states[1][index], a);
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+template <class U, class UnaryOperation>
+void tween_store<T, S, Interpolator>::interpolate(scalar_type a, U* output, UnaryOperation op) const
+{
+	const value_type* states0 = states[0].data();
+	const value_type* states1 = states[1].data();
+	const std::size_t count = states[0].size();
+	for (std::size_t i = 0; i < count; ++i)
+		output[i] = op(Interpolator(states0[i], states1[i], a));
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+void tween_store<T, S, Interpolator>::update()
+{
+	++revision;
+	if (!states[0].empty())
+		std::memcpy(states[0].data(), states[1].data(), states[0].size() * sizeof(value_type));
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+inline void tween_store<T, S, Interpolator>::update(std::size_t index)
+{
+	++revision;
+	states[0][index] = states[1][index];
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+inline std::size_t tween_store<T, S, Interpolator>::size() const
+{
+	return states[0].size();
+}
+
+template <class T, class S, T (*Interpolator)(const T&, const T&, S)>
+inline std::size_t tween_store<T, S, Interpolator>::get_revision() const
+{
+	return revision;
+}
+
+#endif // ANTKEEPER_TWEEN_STORE_HPP
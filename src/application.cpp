@@ -43,6 +43,9 @@ application::application():
 	queued_state{std::string(), nullptr, nullptr},
 	update_callback(nullptr),
 	render_callback(nullptr),
+	snapshot_callback(nullptr),
+	pipelined(false),
+	headless(false),
 	fullscreen(true),
 	vsync(true),
 	cursor_visible(true),
@@ -215,6 +218,7 @@ application::application():
 	frame_scheduler = new ::frame_scheduler();
 	frame_scheduler->set_update_callback(std::bind(&application::update, this, std::placeholders::_1, std::placeholders::_2));
 	frame_scheduler->set_render_callback(std::bind(&application::render, this, std::placeholders::_1));
+	frame_scheduler->set_snapshot_callback(std::bind(&application::snapshot, this, std::placeholders::_1, std::placeholders::_2));
 	frame_scheduler->set_update_rate(update_rate);
 	frame_scheduler->set_max_frame_duration(0.25);
 
@@ -254,18 +258,27 @@ int application::execute(bootloader_type bootloader)
 		}
 	}
 	
-	// Show window
-	SDL_ShowWindow(sdl_window);
-	
-	// Clear window
-	rasterizer->clear_framebuffer(true, false, false);
-	SDL_GL_SwapWindow(sdl_window);
+	if (!headless)
+	{
+		// Show window
+		SDL_ShowWindow(sdl_window);
+		
+		// Clear window
+		rasterizer->clear_framebuffer(true, false, false);
+		SDL_GL_SwapWindow(sdl_window);
+	}
 	
 	// Perform initial update
 	update(0.0, 0.0);
+	snapshot(0.0, 0.0);
 	
 	// Reset frame scheduler
 	frame_scheduler->reset();
+	
+	// Simulation rate reporting interval while fast-forwarding, in seconds
+	const double report_interval = 5.0;
+	double report_duration = 0.0;
+	double report_elapsed_time = 0.0;
 
 	// Schedule frames until closed
 	while (!closed)
@@ -275,8 +288,32 @@ int application::execute(bootloader_type bootloader)
 
 		// Sample frame duration
 		performance_sampler->sample(frame_scheduler->get_frame_duration());
+		
+		// Report simulated seconds per wall second while fast-forwarding
+		if (frame_scheduler->is_fast_forward())
+		{
+			report_duration += frame_scheduler->get_frame_duration();
+			if (report_duration >= report_interval)
+			{
+				const double elapsed_time = frame_scheduler->get_elapsed_time();
+				const double simulation_rate = (elapsed_time - report_elapsed_time) / report_duration;
+				logger->log("Fast-forwarding at " + std::to_string(simulation_rate) + " simulated seconds per second (" + std::to_string(elapsed_time) + " s simulated)");
+				
+				report_duration = 0.0;
+				report_elapsed_time = elapsed_time;
+			}
+		}
+		else
+		{
+			report_duration = 0.0;
+			report_elapsed_time = frame_scheduler->get_elapsed_time();
+		}
 	}
 	
+	// Finish pipelined updates before exiting
+	if (pipelined)
+		set_pipelined(false);
+	
 	// Exit current state
 	change_state({std::string(), nullptr, nullptr});
 	
@@ -385,6 +422,41 @@ void application::set_render_callback(const render_callback_type& callback)
 	render_callback = callback;
 }
 
+void application::set_snapshot_callback(const snapshot_callback_type& callback)
+{
+	snapshot_callback = callback;
+}
+
+void application::set_pipelined(bool pipelined)
+{
+	// Only change the flag while the update thread is stopped, as updates read it
+	if (pipelined)
+	{
+		this->pipelined = true;
+		frame_scheduler->set_pipelined(true);
+	}
+	else
+	{
+		frame_scheduler->set_pipelined(false);
+		this->pipelined = false;
+	}
+}
+
+void application::set_fast_forward(bool fast_forward)
+{
+	frame_scheduler->set_fast_forward(fast_forward);
+}
+
+void application::set_render_interval(double interval)
+{
+	frame_scheduler->set_render_interval(interval);
+}
+
+void application::set_headless(bool headless)
+{
+	this->headless = headless;
+}
+
 void application::set_update_rate(double frequency)
 {
 	update_rate = frequency;
@@ -473,8 +545,12 @@ void application::swap_buffers()
 
 void application::update(double t, double dt)
 {
-	translate_sdl_events();
-	event_dispatcher->update(t);
+	// SDL events must be handled on the main thread, so in pipelined mode they are handled with snapshots instead
+	if (!pipelined)
+	{
+		translate_sdl_events();
+		event_dispatcher->update(t);
+	}
 	
 	if (update_callback)
 	{
@@ -493,6 +569,20 @@ void application::update(double t, double dt)
 	*/
 }
 
+void application::snapshot(double t, double dt)
+{
+	if (pipelined)
+	{
+		translate_sdl_events();
+		event_dispatcher->update(t);
+	}
+	
+	if (snapshot_callback)
+	{
+		snapshot_callback(t, dt);
+	}
+}
+
 void application::render(double alpha)
 {
 	/*
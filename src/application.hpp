@@ -65,6 +65,7 @@ public:
 	typedef std::function<int(application*)> bootloader_type;
 	typedef std::function<void(double, double)> update_callback_type;
 	typedef std::function<void(double)> render_callback_type;
+	typedef std::function<void(double, double)> snapshot_callback_type;
 	
 	/**
 	 * Creates and initializes an application.
@@ -132,6 +133,43 @@ public:
 	 */
 	void set_render_callback(const render_callback_type& callback);
 	
+	/**
+	 * Sets the snapshot callback, which publishes the state produced by update callbacks for rendering. It expects the same parameters as the update callback, with dt spanning all updates being published. Input events are dispatched before it is called in pipelined mode, so it is also where input should be handled.
+	 *
+	 * @see application::set_pipelined()
+	 */
+	void set_snapshot_callback(const snapshot_callback_type& callback);
+	
+	/**
+	 * Enables or disables pipelined updates. In pipelined mode, the update callback runs on an update thread while the previous state is rendered, and may only touch simulation state. Rendering resources, scene objects, and input are then handled by the snapshot callback.
+	 *
+	 * @param pipelined `true` to pipeline updates and rendering, `false` to perform them serially.
+	 */
+	void set_pipelined(bool pipelined);
+	
+	/**
+	 * Enables or disables fast-forward mode. In fast-forward mode, the update callback is called as fast as possible rather than at the update rate, the render callback is only called at the render interval, and the simulation rate is periodically logged.
+	 *
+	 * @param fast_forward `true` to run updates as fast as possible, `false` to run them in real time.
+	 *
+	 * @see application::set_render_interval()
+	 */
+	void set_fast_forward(bool fast_forward);
+	
+	/**
+	 * Sets the minimum time between renders in fast-forward mode.
+	 *
+	 * @param interval Render interval, in seconds. If not positive, nothing will be rendered in fast-forward mode.
+	 */
+	void set_render_interval(double interval);
+	
+	/**
+	 * Enables or disables headless mode, in which the window is never shown. The OpenGL context is still created, as resources are loaded into it.
+	 *
+	 * @param headless `true` if the window should remain hidden, `false` otherwise.
+	 */
+	void set_headless(bool headless);
+	
 	/**
 	 * Sets the frequency with which the update callback should be called.
 	 *
@@ -218,6 +256,7 @@ public:
 
 private:
 	void update(double t, double dt);
+	void snapshot(double t, double dt);
 	void render(double alpha);
 	
 	void translate_sdl_events();
@@ -229,6 +268,9 @@ private:
 	application::state queued_state;
 	update_callback_type update_callback;
 	render_callback_type render_callback;
+	snapshot_callback_type snapshot_callback;
+	bool pipelined;
+	bool headless;
 	bool fullscreen;
 	bool vsync;
 	bool cursor_visible;
@@ -21,6 +21,8 @@
 #define ANTKEEPER_ENTITY_COMPONENT_ATMOSPHERE_HPP
 
 #include "utility/fundamental-types.hpp"
+#include "physics/atmosphere.hpp"
+#include <memory>
 
 namespace entity {
 namespace component {
@@ -54,6 +56,9 @@ struct atmosphere
 	
 	/// (Dependent) Mie scattering coefficients at sea level.
 	double3 mie_scattering;
+	
+	/// (Dependent) Transmittance lookup table. Generated only if the entity also has a celestial body component.
+	std::shared_ptr<const physics::atmosphere::transmittance_lut<float>> transmittance_lut;
 };
 
 } // namespace component
@@ -21,6 +21,7 @@
 #define ANTKEEPER_ENTITY_COMPONENT_BEHAVIOR_HPP
 
 #include "entity/ebt.hpp"
+#include <cstdint>
 
 namespace entity {
 namespace component {
@@ -28,6 +29,15 @@ namespace component {
 struct behavior
 {
 	const ebt::node* behavior_tree;
+	
+	/// Number of ticks since the behavior tree was last executed.
+	std::uint32_t idle_ticks;
+	
+	/// Tick offset which staggers the executions of entities with equal periods.
+	std::uint32_t phase;
+	
+	/// Time elapsed since the behavior tree was last executed.
+	double idle_time;
 };
 
 } // namespace component
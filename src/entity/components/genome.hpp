@@ -20,7 +20,7 @@
 #ifndef ANTKEEPER_ENTITY_COMPONENT_GENOME_HPP
 #define ANTKEEPER_ENTITY_COMPONENT_GENOME_HPP
 
-#include <string>
+#include "genetics/packed-sequence.hpp"
 #include <vector>
 
 namespace entity {
@@ -39,9 +39,9 @@ struct genome
 	/**
 	 * Set of DNA base sequences for every chromosomes in the genome.
 	 *
-	 * A DNA base sequence is a string of IUPAC DNA base symbols. Homologous chromosomes should be stored consecutively, such that in a diploid organism, a chromosome with an even index is homologous to the following chromosome.
+	 * DNA base sequences are packed two bits per base, and can be converted to and from strings of IUPAC DNA base symbols. Homologous chromosomes should be stored consecutively, such that in a diploid organism, a chromosome with an even index is homologous to the following chromosome.
 	 */
-	std::vector<std::string> chromosomes;
+	std::vector<genetics::packed_sequence> chromosomes;
 };
 
 } // namespace component
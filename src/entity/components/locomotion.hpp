@@ -20,6 +20,7 @@
 #ifndef ANTKEEPER_ENTITY_COMPONENT_PLACEMENT_HPP
 #define ANTKEEPER_ENTITY_COMPONENT_PLACEMENT_HPP
 
+#include "entity/id.hpp"
 #include "geom/mesh.hpp"
 #include "utility/fundamental-types.hpp"
 
@@ -28,8 +29,17 @@ namespace component {
 
 struct locomotion
 {
+	/// Entity with the collision mesh on which this entity walks.
+	entity::id surface;
+	
+	/// Triangle of the collision mesh on which this entity stands.
 	const geom::mesh::face* triangle;
+	
+	/// Position of this entity within its triangle, in barycentric coordinates.
 	float3 barycentric_position;
+	
+	/// Velocity, in the local space of the surface. Velocity is projected onto the triangle on which this entity stands, and is carried over the edges it crosses, preserving speed.
+	float3 velocity;
 };
 
 } // namespace component
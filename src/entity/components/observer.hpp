@@ -35,6 +35,9 @@ struct observer
 	double latitude;
 	double longitude;
 	scene::camera* camera;
+	
+	/// Bit mask of the render layers seen by the camera.
+	unsigned int layers;
 };
 
 } // namespace component
@@ -20,6 +20,7 @@
 #ifndef ANTKEEPER_ENTITY_COMPONENT_PROTEOME_HPP
 #define ANTKEEPER_ENTITY_COMPONENT_PROTEOME_HPP
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -29,8 +30,12 @@ namespace component {
 /// Set of all proteins that can be expressed by an organism.
 struct proteome
 {
-	/// Set of amino acid sequences of every protein in the proteome.
-	std::vector<std::string> proteins;
+	/**
+	 * Amino acid sequences of the proteins encoded by each chromosome in the genome, in chromosome order.
+	 *
+	 * Protein sets are immutable and shared between all organisms with identical chromosomes.
+	 */
+	std::vector<std::shared_ptr<const std::vector<std::string>>> chromosomes;
 };
 
 } // namespace component
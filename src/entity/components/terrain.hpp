@@ -21,6 +21,7 @@
 #define ANTKEEPER_ENTITY_COMPONENT_TERRAIN_HPP
 
 #include "renderer/material.hpp"
+#include <cstddef>
 #include <functional>
 
 namespace entity {
@@ -31,6 +32,11 @@ struct terrain
 	/// Function object which returns elevation (in meters) given latitude (radians) and longitude (radians).
 	std::function<double(double, double)> elevation;
 	
+	/**
+	 * Function object which calculates elevations (in meters) for a batch of positions, given arrays of latitudes (radians) and longitudes (radians), an output array of elevations, and the number of positions. If set, it is used instead of `elevation` when generating terrain patches.
+	 */
+	std::function<void(const double*, const double*, double*, std::size_t)> batch_elevation;
+	
 	/// Maximum level of detail (maximum quadtree depth level)
 	std::size_t max_lod;
 	
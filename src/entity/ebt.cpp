@@ -49,5 +49,44 @@ bool is_carrying_food(const context& context)
 	return false;
 }
 
+std::size_t find_neighbors(const context& context, float radius, std::vector<entity::id>& neighbors)
+{
+	if (!context.neighbors)
+		return 0;
+	
+	const float3& center = context.registry->get<component::transform>(context.entity_id).world.translation;
+	const std::size_t initial_size = neighbors.size();
+	context.neighbors->visit_radius(center, radius,
+		[&](geom::spatial_hash::value_type value, const float3&, float)
+		{
+			const entity::id neighbor = static_cast<entity::id>(value);
+			if (neighbor != context.entity_id)
+				neighbors.push_back(neighbor);
+		});
+	
+	return neighbors.size() - initial_size;
+}
+
+std::size_t find_nearest_neighbors(const context& context, std::size_t k, float radius, std::vector<entity::id>& neighbors)
+{
+	if (!context.neighbors || !k)
+		return 0;
+	
+	// Query one extra point, as the context entity is its own nearest neighbor
+	const float3& center = context.registry->get<component::transform>(context.entity_id).world.translation;
+	std::vector<geom::spatial_hash::value_type> values;
+	context.neighbors->query_nearest(center, k + 1, radius, values);
+	
+	const std::size_t initial_size = neighbors.size();
+	for (geom::spatial_hash::value_type value: values)
+	{
+		const entity::id neighbor = static_cast<entity::id>(value);
+		if (neighbor != context.entity_id && neighbors.size() - initial_size < k)
+			neighbors.push_back(neighbor);
+	}
+	
+	return neighbors.size() - initial_size;
+}
+
 } // namespace ebt
 } // namespace entity
@@ -23,6 +23,8 @@
 #include "ai/behavior-tree.hpp"
 #include "entity/id.hpp"
 #include "entity/registry.hpp"
+#include "geom/spatial-hash.hpp"
+#include <vector>
 
 namespace entity {
 
@@ -36,6 +38,12 @@ struct context
 {
 	entity::registry* registry;
 	entity::id entity_id;
+	
+	/// Time elapsed since the entity's behavior was last executed. Entities far from observers are executed less often, and so see larger time steps.
+	double dt;
+	
+	/// Spatial hash of entity translations, or `nullptr` if neighbor queries are unavailable.
+	const geom::spatial_hash* neighbors;
 };
 
 typedef ai::bt::status status;
@@ -59,6 +67,29 @@ status warp_to(context& context, float x, float y, float z);
 // Conditions
 bool is_carrying_food(const context& context);
 
+// Queries
+
+/**
+ * Finds the entities within a radius of the context entity, excluding the context entity.
+ *
+ * @param context Context whose entity is the center of the query.
+ * @param radius Radius of the query sphere.
+ * @param[out] neighbors Vector to which the found entities will be appended.
+ * @return Number of entities found.
+ */
+std::size_t find_neighbors(const context& context, float radius, std::vector<entity::id>& neighbors);
+
+/**
+ * Finds the entities nearest to the context entity, excluding the context entity.
+ *
+ * @param context Context whose entity is the center of the query.
+ * @param k Maximum number of entities to find.
+ * @param radius Distance beyond which entities are ignored.
+ * @param[out] neighbors Vector to which the found entities will be appended, nearest first.
+ * @return Number of entities found.
+ */
+std::size_t find_nearest_neighbors(const context& context, std::size_t k, float radius, std::vector<entity::id>& neighbors);
+
 } // namespace ebt
 } // namespace entity
 
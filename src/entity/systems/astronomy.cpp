@@ -35,21 +35,6 @@
 namespace entity {
 namespace system {
 
-template <class T>
-math::vector3<T> transmittance(T depth_r, T depth_m, T depth_o, const math::vector3<T>& beta_r, const math::vector3<T>& beta_m)
-{
-	math::vector3<T> transmittance_r = beta_r * depth_r;
-	math::vector3<T> transmittance_m = beta_m * 1.1 * depth_m;
-	math::vector3<T> transmittance_o = {0, 0, 0};
-	
-	math::vector3<T> t = transmittance_r + transmittance_m + transmittance_o;
-	t.x = std::exp(-t.x);
-	t.y = std::exp(-t.y);
-	t.z = std::exp(-t.z);
-	
-	return t;
-}
-
 astronomy::astronomy(entity::registry& registry):
 	updatable(registry),
 	universal_time(0.0),
@@ -137,31 +122,18 @@ void astronomy::update(double t, double dt)
 		// Init atmospheric transmittance
 		double3 atmospheric_transmittance = {1.0, 1.0, 1.0};
 		
-		// Get atmosphere component of reference body (if any)
-		if (reference_atmosphere)
+		// Look up atmospheric transmittance along the direction to the blackbody
+		if (reference_atmosphere && reference_atmosphere->transmittance_lut)
 		{
-			// Altitude of observer in meters	
-			geom::ray<double> sample_ray;
-			sample_ray.origin = {0, reference_body->radius + observer_location[0], 0};
-			sample_ray.direction = math::normalize(blackbody_position_topocentric);
-			
-			geom::sphere<double> exosphere;
-			exosphere.center = {0, 0, 0};
-			exosphere.radius = reference_body->radius + reference_atmosphere->exosphere_altitude;
-			
-			auto intersection_result = geom::ray_sphere_intersection(sample_ray, exosphere);
-			
-			if (std::get<0>(intersection_result))
-			{
-				double3 sample_start = sample_ray.origin;
-				double3 sample_end = sample_ray.extrapolate(std::get<2>(intersection_result));
-				
-				double optical_depth_r = physics::atmosphere::optical_depth(sample_start, sample_end, reference_body->radius, reference_atmosphere->rayleigh_scale_height, 32);
-				double optical_depth_k = physics::atmosphere::optical_depth(sample_start, sample_end, reference_body->radius, reference_atmosphere->mie_scale_height, 32);
-				double optical_depth_o = 0.0;
-				
-				atmospheric_transmittance = transmittance(optical_depth_r, optical_depth_k, optical_depth_o, reference_atmosphere->rayleigh_scattering, reference_atmosphere->mie_scattering);
-			}
+			const double cos_zenith = math::normalize(blackbody_position_topocentric).y;
+			atmospheric_transmittance = math::type_cast<double>
+			(
+				reference_atmosphere->transmittance_lut->sample
+				(
+					static_cast<float>(observer_location[0]),
+					static_cast<float>(cos_zenith)
+				)
+			);
 		}
 		
 		if (sun_light != nullptr)
@@ -216,6 +188,7 @@ void astronomy::update(double t, double dt)
 			sky_pass->set_scattering_coefficients(math::type_cast<float>(reference_atmosphere->rayleigh_scattering), math::type_cast<float>(reference_atmosphere->mie_scattering));
 			sky_pass->set_mie_anisotropy(reference_atmosphere->mie_anisotropy);
 			sky_pass->set_atmosphere_radii(reference_body->radius, reference_body->radius + reference_atmosphere->exosphere_altitude);
+			sky_pass->set_transmittance_lut(reference_atmosphere->transmittance_lut);
 		}
 	}
 }
@@ -18,7 +18,11 @@
  */
 
 #include "entity/systems/atmosphere.hpp"
+#include "entity/components/celestial-body.hpp"
 #include "physics/atmosphere.hpp"
+#include <algorithm>
+#include <thread>
+#include <vector>
 
 namespace entity {
 namespace system {
@@ -26,10 +30,16 @@ namespace system {
 atmosphere::atmosphere(entity::registry& registry):
 	updatable(registry),
 	rgb_wavelengths_nm{0, 0, 0},
-	rgb_wavelengths_m{0, 0, 0}
+	rgb_wavelengths_m{0, 0, 0},
+	transmittance_lut_width(256),
+	transmittance_lut_height(64),
+	transmittance_lut_samples(32)
 {
 	registry.on_construct<entity::component::atmosphere>().connect<&atmosphere::on_atmosphere_construct>(this);
 	registry.on_replace<entity::component::atmosphere>().connect<&atmosphere::on_atmosphere_replace>(this);
+	registry.on_construct<entity::component::celestial_body>().connect<&atmosphere::on_celestial_body_construct>(this);
+	registry.on_replace<entity::component::celestial_body>().connect<&atmosphere::on_celestial_body_replace>(this);
+	registry.on_destroy<entity::component::celestial_body>().connect<&atmosphere::on_celestial_body_destroy>(this);
 }
 
 void atmosphere::update(double t, double dt)
@@ -41,6 +51,13 @@ void atmosphere::set_rgb_wavelengths(const double3& wavelengths)
 	rgb_wavelengths_m = wavelengths * 1e-9;
 }
 
+void atmosphere::set_transmittance_lut_resolution(std::size_t width, std::size_t height, std::size_t samples)
+{
+	transmittance_lut_width = std::max<std::size_t>(2, width);
+	transmittance_lut_height = std::max<std::size_t>(2, height);
+	transmittance_lut_samples = std::max<std::size_t>(1, samples);
+}
+
 void atmosphere::update_coefficients(entity::id entity_id)
 {
 	// Abort if entity has no atmosphere component
@@ -70,6 +87,65 @@ void atmosphere::update_coefficients(entity::id entity_id)
 		mie_scattering,
 		mie_scattering
 	};
+	
+	update_transmittance_lut(entity_id);
+}
+
+void atmosphere::update_transmittance_lut(entity::id entity_id)
+{
+	// Transmittance depends on the radius of the planet
+	if (!registry.has<component::celestial_body>(entity_id))
+	{
+		registry.get<component::atmosphere>(entity_id).transmittance_lut = nullptr;
+		return;
+	}
+	
+	update_transmittance_lut(entity_id, registry.get<component::celestial_body>(entity_id).radius);
+}
+
+void atmosphere::update_transmittance_lut(entity::id entity_id, double inner_radius)
+{
+	component::atmosphere& atmosphere = registry.get<component::atmosphere>(entity_id);
+	
+	const double outer_radius = inner_radius + atmosphere.exosphere_altitude;
+	
+	// Mie extinction is approximately 1.1 times Mie scattering
+	const float3 extinction_r = math::type_cast<float>(atmosphere.rayleigh_scattering);
+	const float3 extinction_m = math::type_cast<float>(atmosphere.mie_scattering * 1.1);
+	const float sh_r = static_cast<float>(atmosphere.rayleigh_scale_height);
+	const float sh_m = static_cast<float>(atmosphere.mie_scale_height);
+	
+	auto lut = std::make_shared<physics::atmosphere::transmittance_lut<float>>
+	(
+		transmittance_lut_width,
+		transmittance_lut_height,
+		static_cast<float>(inner_radius),
+		static_cast<float>(outer_radius)
+	);
+	
+	// Generate rows of the table in parallel
+	const std::size_t thread_count = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, transmittance_lut_height);
+	const std::size_t rows_per_thread = (transmittance_lut_height + thread_count - 1) / thread_count;
+	std::vector<std::thread> threads;
+	for (std::size_t i = 0; i < thread_count; ++i)
+	{
+		const std::size_t row_begin = i * rows_per_thread;
+		const std::size_t row_end = std::min(row_begin + rows_per_thread, transmittance_lut_height);
+		if (row_begin >= row_end)
+			break;
+		
+		threads.emplace_back
+		(
+			[&, row_begin, row_end]()
+			{
+				lut->generate(extinction_r, extinction_m, sh_r, sh_m, transmittance_lut_samples, row_begin, row_end);
+			}
+		);
+	}
+	for (std::thread& thread: threads)
+		thread.join();
+	
+	atmosphere.transmittance_lut = std::move(lut);
 }
 
 void atmosphere::on_atmosphere_construct(entity::registry& registry, entity::id entity_id, entity::component::atmosphere& atmosphere)
@@ -82,5 +158,28 @@ void atmosphere::on_atmosphere_replace(entity::registry& registry, entity::id en
 	update_coefficients(entity_id);
 }
 
+void atmosphere::on_celestial_body_construct(entity::registry& registry, entity::id entity_id, entity::component::celestial_body& celestial_body)
+{
+	on_celestial_body_replace(registry, entity_id, celestial_body);
+}
+
+void atmosphere::on_celestial_body_replace(entity::registry& registry, entity::id entity_id, entity::component::celestial_body& celestial_body)
+{
+	if (!registry.has<component::atmosphere>(entity_id))
+		return;
+	
+	// Rebuild the transmittance LUT only if the radius it was built for has changed, as bodies are replaced for other reasons too
+	const component::atmosphere& atmosphere = registry.get<component::atmosphere>(entity_id);
+	if (!atmosphere.transmittance_lut || atmosphere.transmittance_lut->get_inner_radius() != static_cast<float>(celestial_body.radius))
+		update_transmittance_lut(entity_id, celestial_body.radius);
+}
+
+void atmosphere::on_celestial_body_destroy(entity::registry& registry, entity::id entity_id)
+{
+	// Transmittance can't be tabulated without the radius of the body
+	if (registry.has<component::atmosphere>(entity_id))
+		registry.get<component::atmosphere>(entity_id).transmittance_lut = nullptr;
+}
+
 } // namespace system
 } // namespace entity
@@ -24,6 +24,7 @@
 #include "entity/id.hpp"
 #include "utility/fundamental-types.hpp"
 #include "entity/components/atmosphere.hpp"
+#include "entity/components/celestial-body.hpp"
 
 namespace entity {
 namespace system {
@@ -46,14 +47,31 @@ public:
 	 */
 	void set_rgb_wavelengths(const double3& wavelengths);
 	
+	/**
+	 * Sets the resolution of generated transmittance lookup tables.
+	 *
+	 * @param width Number of zenith angle samples.
+	 * @param height Number of altitude samples.
+	 * @param samples Number of optical depth samples per texel.
+	 */
+	void set_transmittance_lut_resolution(std::size_t width, std::size_t height, std::size_t samples);
+	
 private:
 	void update_coefficients(entity::id entity_id);
+	void update_transmittance_lut(entity::id entity_id);
+	void update_transmittance_lut(entity::id entity_id, double inner_radius);
 	
 	void on_atmosphere_construct(entity::registry& registry, entity::id entity_id, entity::component::atmosphere& atmosphere);
 	void on_atmosphere_replace(entity::registry& registry, entity::id entity_id, entity::component::atmosphere& atmosphere);
+	void on_celestial_body_construct(entity::registry& registry, entity::id entity_id, entity::component::celestial_body& celestial_body);
+	void on_celestial_body_replace(entity::registry& registry, entity::id entity_id, entity::component::celestial_body& celestial_body);
+	void on_celestial_body_destroy(entity::registry& registry, entity::id entity_id);
 	
 	double3 rgb_wavelengths_nm;
 	double3 rgb_wavelengths_m;
+	std::size_t transmittance_lut_width;
+	std::size_t transmittance_lut_height;
+	std::size_t transmittance_lut_samples;
 };
 
 } // namespace system
@@ -19,29 +19,167 @@
 
 #include "entity/systems/behavior.hpp"
 #include "entity/components/behavior.hpp"
+#include "entity/components/model.hpp"
+#include "entity/components/observer.hpp"
+#include "entity/components/transform.hpp"
 #include "entity/id.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace entity {
 namespace system {
 
+/// Number of LOD distance multiples added to entities which no observer can see.
+static constexpr float hidden_distance_offset = 2.0f;
+
 behavior::behavior(entity::registry& registry):
-	updatable(registry)
-{}
+	updatable(registry),
+	spatial_system(nullptr),
+	lod_distance(50.0f),
+	max_period(32),
+	update_budget(0),
+	tick(0)
+{
+	registry.on_construct<component::behavior>().connect<&behavior::on_behavior_construct>(this);
+}
 
 void behavior::update(double t, double dt)
 {
-	ebt::context context;
-	context.registry = &registry;
-
+	// Hold the neighbor snapshot for the duration of the update
+	std::shared_ptr<const geom::spatial_hash> neighbors;
+	if (spatial_system)
+		neighbors = spatial_system->get_neighbor_snapshot();
+	
+	// Gather active observer cameras
+	observers.clear();
+	registry.view<component::observer>().each(
+		[&](entity::id, const auto& observer)
+		{
+			if (observer.camera && observer.camera->is_active())
+				observers.push_back({observer.camera, observer.layers});
+		});
+	
+	// Find entities due for execution. Entities are due once per period, on the ticks selected by their phase, or as soon as they've been idle for longer than their period.
+	++tick;
+	due_entities.clear();
+	aggregate_entities.clear();
 	registry.view<component::behavior>().each(
 		[&](entity::id entity_id, auto& behavior)
 		{
-			if (behavior.behavior_tree)
+			if (!behavior.behavior_tree)
+				return;
+			
+			++behavior.idle_ticks;
+			behavior.idle_time += dt;
+			
+			const std::uint32_t period = get_period(entity_id);
+			if (aggregate_callback && period >= max_period)
 			{
-				context.entity_id = entity_id;
-				behavior.behavior_tree->execute(context);
+				aggregate_entities.push_back(entity_id);
+				behavior.idle_ticks = 0;
+				behavior.idle_time = 0.0;
+			}
+			else if ((tick + behavior.phase) % period == 0 || behavior.idle_ticks > period)
+			{
+				const std::int64_t overdue = static_cast<std::int64_t>(behavior.idle_ticks) - static_cast<std::int64_t>(period);
+				due_entities.emplace_back(overdue, entity_id);
 			}
 		});
+	
+	// Defer the least overdue entities if over budget
+	if (update_budget && due_entities.size() > update_budget)
+	{
+		std::nth_element(due_entities.begin(), due_entities.begin() + update_budget, due_entities.end(),
+			[](const auto& a, const auto& b)
+			{
+				return a.first > b.first;
+			});
+		due_entities.resize(update_budget);
+	}
+	
+	// Execute due behavior trees
+	ebt::context context;
+	context.registry = &registry;
+	context.neighbors = neighbors.get();
+	for (const auto& [overdue, entity_id]: due_entities)
+	{
+		component::behavior& behavior = registry.get<component::behavior>(entity_id);
+		
+		context.entity_id = entity_id;
+		context.dt = behavior.idle_time;
+		behavior.idle_ticks = 0;
+		behavior.idle_time = 0.0;
+		
+		behavior.behavior_tree->execute(context);
+	}
+	
+	// Update distant entities in aggregate
+	if (!aggregate_entities.empty())
+		aggregate_callback(aggregate_entities, dt);
+}
+
+void behavior::set_spatial_system(const system::spatial* spatial_system)
+{
+	this->spatial_system = spatial_system;
+}
+
+void behavior::set_lod_distance(float distance)
+{
+	lod_distance = distance;
+}
+
+void behavior::set_max_period(std::uint32_t period)
+{
+	max_period = std::max<std::uint32_t>(period, 1);
+}
+
+void behavior::set_update_budget(std::size_t budget)
+{
+	update_budget = budget;
+}
+
+void behavior::set_aggregate_callback(const aggregate_callback_type& callback)
+{
+	aggregate_callback = callback;
+}
+
+std::uint32_t behavior::get_period(entity::id entity_id) const
+{
+	// Execute entities every tick if they can't be located or there is no one to observe them
+	if (observers.empty() || !registry.has<component::transform>(entity_id))
+		return 1;
+	
+	const float3& position = registry.get<component::transform>(entity_id).world.translation;
+	const unsigned int layers = registry.has<component::model>(entity_id) ? registry.get<component::model>(entity_id).layers : ~0u;
+	
+	// Find distance to the nearest observer, and whether any observer can see the entity
+	float distance = std::numeric_limits<float>::infinity();
+	bool visible = false;
+	for (const observer_view& observer: observers)
+	{
+		distance = std::min(distance, math::length(position - observer.camera->get_translation()));
+		if (!visible && (layers & observer.layers))
+			visible = observer.camera->get_view_frustum().get_bounds().contains(position);
+	}
+	
+	// Double the period with each multiple of the LOD distance
+	float bands = distance / lod_distance;
+	if (!visible)
+		bands += hidden_distance_offset;
+	if (!(bands < 31.0f))
+		return max_period;
+	
+	const std::uint32_t period = static_cast<std::uint32_t>(1) << static_cast<std::uint32_t>(bands);
+	return std::min(period, max_period);
+}
+
+void behavior::on_behavior_construct(entity::registry&, entity::id entity_id, component::behavior& behavior)
+{
+	// Stagger executions by assigning each entity a pseudorandom phase
+	behavior.idle_ticks = 0;
+	behavior.phase = static_cast<std::uint32_t>(entity_id) * 2654435761u;
+	behavior.idle_time = 0.0;
 }
 
 } // namespace system
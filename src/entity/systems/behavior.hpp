@@ -21,16 +21,73 @@
 #define ANTKEEPER_ENTITY_SYSTEM_BEHAVIOR_HPP
 
 #include "entity/systems/updatable.hpp"
+#include "entity/systems/spatial.hpp"
+#include "entity/components/behavior.hpp"
+#include "entity/id.hpp"
+#include "scene/camera.hpp"
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
 
 namespace entity {
 namespace system {
 
+/**
+ * Executes entity behavior trees, at a level of detail which depends on how closely the entities are observed.
+ *
+ * Entities near an observer's camera are executed every tick. Each multiple of the LOD distance further away doubles the period between executions, and entities outside of every camera's view frustum, or on render layers no camera sees, are treated as two multiples further away. Executions of entities with equal periods are staggered across ticks, and an optional budget caps the number of executions per tick, deferring the least overdue entities.
+ *
+ * If an aggregate callback is set, entities at the maximum period are not executed individually; instead they are passed together to the callback each tick, so that they may be simulated statistically.
+ */
 class behavior:
 	public updatable
 {
 public:
+	/// Function which updates a group of distant entities at once, given the entities and the elapsed time.
+	typedef std::function<void(const std::vector<entity::id>&, double)> aggregate_callback_type;
+	
 	behavior(entity::registry& registry);
 	virtual void update(double t, double dt);
+	
+	/// Sets the spatial system whose neighbor snapshots are used for neighbor queries.
+	void set_spatial_system(const system::spatial* spatial_system);
+	
+	/// Sets the distance from an observer at which the execution period doubles.
+	void set_lod_distance(float distance);
+	
+	/// Sets the maximum number of ticks between executions of an entity's behavior tree.
+	void set_max_period(std::uint32_t period);
+	
+	/// Sets the maximum number of behavior trees executed per tick, or `0` for no limit.
+	void set_update_budget(std::size_t budget);
+	
+	/// Sets the function which updates entities at the maximum period in aggregate, or an empty function to execute them individually.
+	void set_aggregate_callback(const aggregate_callback_type& callback);
+
+private:
+	/// Returns the number of ticks between executions of an entity's behavior tree.
+	std::uint32_t get_period(entity::id entity_id) const;
+	
+	void on_behavior_construct(entity::registry& registry, entity::id entity_id, entity::component::behavior& behavior);
+	
+	/// Observer camera state, gathered each tick.
+	struct observer_view
+	{
+		const scene::camera* camera;
+		unsigned int layers;
+	};
+	
+	const system::spatial* spatial_system;
+	float lod_distance;
+	std::uint32_t max_period;
+	std::size_t update_budget;
+	aggregate_callback_type aggregate_callback;
+	std::uint64_t tick;
+	
+	std::vector<observer_view> observers;
+	std::vector<std::pair<std::int64_t, entity::id>> due_entities;
+	std::vector<entity::id> aggregate_entities;
 };
 
 } // namespace system
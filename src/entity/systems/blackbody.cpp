@@ -35,6 +35,20 @@ blackbody::blackbody(entity::registry& registry):
 	visible_wavelengths_nm.resize(780 - 280);
 	std::iota(visible_wavelengths_nm.begin(), visible_wavelengths_nm.end(), 280);
 	
+	// Tabulate CIE XYZ luminous efficacy over the range of stellar temperatures
+	efficacy_lut = new physics::light::blackbody::efficacy_lut<double>
+	(
+		1000.0,
+		100000.0,
+		1024,
+		[](double wavelength_nm)
+		{
+			return color::xyz::match(wavelength_nm);
+		},
+		visible_wavelengths_nm.begin(),
+		visible_wavelengths_nm.end()
+	);
+	
 	registry.on_construct<entity::component::blackbody>().connect<&blackbody::on_blackbody_construct>(this);
 	registry.on_replace<entity::component::blackbody>().connect<&blackbody::on_blackbody_replace>(this);
 	
@@ -42,6 +56,11 @@ blackbody::blackbody(entity::registry& registry):
 	registry.on_replace<entity::component::celestial_body>().connect<&blackbody::on_celestial_body_replace>(this);
 }
 
+blackbody::~blackbody()
+{
+	delete efficacy_lut;
+}
+
 void blackbody::update(double t, double dt)
 {}
 
@@ -73,6 +92,13 @@ void blackbody::update_luminous_intensity(entity::id entity_id)
 	// Calculate (spherical) surface area of the celestial body
 	const double surface_area = 4.0 * math::pi<double> * celestial_body.radius * celestial_body.radius;
 	
+	// Look up luminous intensity if the temperature lies within the efficacy table
+	if (efficacy_lut->contains(blackbody.temperature))
+	{
+		blackbody.luminous_intensity = color::xyz::to_acescg(efficacy_lut->luminous_intensity(blackbody.temperature, surface_area));
+		return;
+	}
+	
 	// Construct a lambda function which calculates the blackbody's RGB luminous intensity of a given wavelength
 	auto rgb_luminous_intensity = [blackbody, surface_area](double wavelength_nm) -> double3
 	{
@@ -25,6 +25,7 @@
 #include "utility/fundamental-types.hpp"
 #include "entity/components/blackbody.hpp"
 #include "entity/components/celestial-body.hpp"
+#include "physics/light/blackbody-lut.hpp"
 #include <vector>
 
 namespace entity {
@@ -32,12 +33,15 @@ namespace system {
 
 /**
  * Calculates the RGB luminous intensity of blackbody radiators.
+ *
+ * Luminous intensities are looked up from a temperature-indexed table of luminous efficacy, which is built once on construction. Temperatures outside the range of the table fall back to integrating the spectrum directly.
  */
 class blackbody:
 	public updatable
 {
 public:
 	blackbody(entity::registry& registry);
+	~blackbody();
 	
 	virtual void update(double t, double dt);
 	
@@ -48,6 +52,9 @@ public:
 	 */
 	void set_rgb_wavelengths(const double3& wavelengths);
 	
+	/// Returns the CIE XYZ luminous efficacy lookup table used to calculate luminous intensities.
+	const physics::light::blackbody::efficacy_lut<double>& get_efficacy_lut() const;
+	
 private:
 	void update_luminous_intensity(entity::id entity_id);
 	
@@ -60,8 +67,14 @@ private:
 	double3 rgb_wavelengths_nm;
 	double3 rgb_wavelengths_m;
 	std::vector<double> visible_wavelengths_nm;
+	physics::light::blackbody::efficacy_lut<double>* efficacy_lut;
 };
 
+inline const physics::light::blackbody::efficacy_lut<double>& blackbody::get_efficacy_lut() const
+{
+	return *efficacy_lut;
+}
+
 } // namespace system
 } // namespace entity
 
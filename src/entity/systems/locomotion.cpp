@@ -22,20 +22,357 @@
 #include "entity/components/locomotion.hpp"
 #include "entity/components/transform.hpp"
 #include "entity/id.hpp"
+#include "geom/mesh-functions.hpp"
+#include "math/math.hpp"
+#include <algorithm>
 
 namespace entity {
 namespace system {
 
+/// Maximum number of edges an entity may cross in a single step.
+static constexpr std::size_t max_edge_crossings = 8;
+
 locomotion::locomotion(entity::registry& registry):
-	updatable(registry)
-{}
+	updatable(registry),
+	next_chunk(0),
+	generation(0),
+	busy_worker_count(0),
+	stopping(false)
+{
+	registry.on_replace<component::collision>().connect<&locomotion::on_collision_replace>(this);
+	registry.on_destroy<component::collision>().connect<&locomotion::on_collision_destroy>(this);
+}
+
+locomotion::~locomotion()
+{
+	registry.on_replace<component::collision>().disconnect<&locomotion::on_collision_replace>(this);
+	registry.on_destroy<component::collision>().disconnect<&locomotion::on_collision_destroy>(this);
+	
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	condition.notify_all();
+	
+	for (std::thread& worker: workers)
+		worker.join();
+}
 
 void locomotion::update(double t, double dt)
 {
+	// Empty batches, retaining their storage
+	for (auto& [surface_id, surface]: surfaces)
+	{
+		surface.entities.clear();
+		surface.faces.clear();
+		surface.u.clear();
+		surface.v.clear();
+		surface.w.clear();
+		surface.displacement_x.clear();
+		surface.displacement_y.clear();
+		surface.displacement_z.clear();
+	}
+	
+	// Gather walking state into per-surface batches
+	std::size_t entity_count = 0;
 	registry.view<component::transform, component::locomotion>().each(
-		[&](entity::id entity_id, auto& transform, auto& locomotion)
+		[&](entity::id entity_id, auto&, auto& locomotion)
 		{
+			if (!locomotion.triangle || !registry.valid(locomotion.surface) || !registry.has<component::collision>(locomotion.surface))
+				return;
+			
+			const component::collision& collision = registry.get<component::collision>(locomotion.surface);
+			if (!collision.mesh)
+				return;
+			
+			surface& surface = surfaces[locomotion.surface];
+			if (surface.mesh != collision.mesh)
+				build_surface(surface, *collision.mesh);
+			
+			const float3 displacement = locomotion.velocity * static_cast<float>(dt);
+			surface.entities.push_back(entity_id);
+			surface.faces.push_back(static_cast<geom::indexed_mesh::index_type>(locomotion.triangle->index));
+			surface.u.push_back(locomotion.barycentric_position.x);
+			surface.v.push_back(locomotion.barycentric_position.y);
+			surface.w.push_back(locomotion.barycentric_position.z);
+			surface.displacement_x.push_back(displacement.x);
+			surface.displacement_y.push_back(displacement.y);
+			surface.displacement_z.push_back(displacement.z);
+			
+			++entity_count;
 		});
+	
+	if (!entity_count)
+		return;
+	
+	// Split batches into chunks, one per thread where possible
+	const std::size_t thread_count = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, std::max<std::size_t>(entity_count / 1024, 1));
+	const std::size_t chunk_size = (entity_count + thread_count - 1) / thread_count;
+	chunks.clear();
+	for (auto& [surface_id, surface]: surfaces)
+	{
+		const std::size_t count = surface.entities.size();
+		for (std::size_t begin = 0; begin < count; begin += chunk_size)
+			chunks.emplace_back(&surface, begin, std::min(begin + chunk_size, count));
+	}
+	
+	// Step chunks in parallel
+	if (thread_count == 1)
+	{
+		for (const auto& [surface, begin, end]: chunks)
+			step(*surface, begin, end);
+	}
+	else
+	{
+		// Start worker threads, leaving one hardware thread for the updating thread, which steps chunks as well
+		if (workers.empty())
+		{
+			const std::size_t worker_count = std::max<std::size_t>(std::thread::hardware_concurrency(), 2) - 1;
+			for (std::size_t i = 0; i < worker_count; ++i)
+				workers.emplace_back(&locomotion::work, this);
+		}
+		
+		// Wake the workers
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			next_chunk = 0;
+			busy_worker_count = workers.size();
+			++generation;
+		}
+		condition.notify_all();
+		
+		step_chunks();
+		
+		// Wait until every worker has finished, so no chunk is stepped after the batches are scattered
+		std::unique_lock<std::mutex> lock(mutex);
+		done_condition.wait(lock, [this]{return !busy_worker_count;});
+	}
+	
+	// Scatter walking state back into components
+	for (auto& [surface_id, surface]: surfaces)
+	{
+		if (surface.entities.empty())
+			continue;
+		
+		math::transform<float> surface_transform = math::identity_transform<float>;
+		if (registry.has<component::transform>(surface_id))
+			surface_transform = registry.get<component::transform>(surface_id).local;
+		
+		const std::vector<geom::mesh::face*>& mesh_faces = surface.mesh->get_faces();
+		for (std::size_t i = 0; i < surface.entities.size(); ++i)
+		{
+			const entity::id entity_id = surface.entities[i];
+			component::locomotion& locomotion = registry.get<component::locomotion>(entity_id);
+			component::transform& transform = registry.get<component::transform>(entity_id);
+			
+			const geom::indexed_mesh::index_type face = surface.faces[i];
+			const surface_triangle& triangle = surface.triangles[face];
+			locomotion.triangle = mesh_faces[face];
+			locomotion.barycentric_position = {surface.u[i], surface.v[i], surface.w[i]};
+			
+			const float3 position = triangle.origin + triangle.edges[0] * surface.v[i] + triangle.edges[1] * surface.w[i];
+			transform.local.translation = surface_transform * position;
+			
+			// Carry velocity across creases, and face the direction of travel standing on the triangle
+			const float3 heading = {surface.displacement_x[i], surface.displacement_y[i], surface.displacement_z[i]};
+			if (math::dot(heading, heading) > 0.0f)
+			{
+				locomotion.velocity = math::normalize(heading) * math::length(locomotion.velocity);
+				transform.local.rotation = surface_transform.rotation * math::look_rotation(math::normalize(heading), triangle.normal);
+			}
+		}
+	}
+}
+
+void locomotion::build_surface(surface& surface, const geom::mesh& mesh)
+{
+	geom::indexed_mesh indexed;
+	geom::convert_mesh(indexed, mesh);
+	
+	const std::vector<float3>& positions = indexed.get_positions();
+	const std::vector<geom::indexed_mesh::index_type>& edge_vertices = indexed.get_edge_vertices();
+	const std::vector<geom::indexed_mesh::index_type>& edge_next = indexed.get_edge_next();
+	const std::vector<geom::indexed_mesh::index_type>& edge_previous = indexed.get_edge_previous();
+	const std::vector<geom::indexed_mesh::index_type>& face_edges = indexed.get_face_edges();
+	
+	surface.mesh = &mesh;
+	surface.edge_faces = indexed.get_edge_faces();
+	surface.triangles.resize(indexed.get_face_count());
+	
+	for (std::size_t i = 0; i < surface.triangles.size(); ++i)
+	{
+		surface_triangle& triangle = surface.triangles[i];
+		
+		triangle.corner_edges[0] = face_edges[i];
+		triangle.corner_edges[1] = edge_next[triangle.corner_edges[0]];
+		triangle.corner_edges[2] = edge_previous[triangle.corner_edges[0]];
+		
+		const float3& a = positions[edge_vertices[triangle.corner_edges[0]]];
+		const float3& b = positions[edge_vertices[triangle.corner_edges[1]]];
+		const float3& c = positions[edge_vertices[triangle.corner_edges[2]]];
+		
+		triangle.origin = a;
+		triangle.edges[0] = b - a;
+		triangle.edges[1] = c - a;
+		
+		const float3 normal = math::cross(triangle.edges[0], triangle.edges[1]);
+		const float normal_length = math::length(normal);
+		triangle.normal = (normal_length > 0.0f) ? normal / normal_length : float3{0, 0, 0};
+		
+		const float d00 = math::dot(triangle.edges[0], triangle.edges[0]);
+		const float d01 = math::dot(triangle.edges[0], triangle.edges[1]);
+		const float d11 = math::dot(triangle.edges[1], triangle.edges[1]);
+		const float determinant = d00 * d11 - d01 * d01;
+		const float inverse_determinant = (determinant > 0.0f) ? 1.0f / determinant : 0.0f;
+		triangle.inverse_gram[0] = d11 * inverse_determinant;
+		triangle.inverse_gram[1] = -d01 * inverse_determinant;
+		triangle.inverse_gram[2] = d00 * inverse_determinant;
+	}
+}
+
+void locomotion::step(surface& surface, std::size_t begin, std::size_t end) const
+{
+	for (std::size_t i = begin; i < end; ++i)
+	{
+		geom::indexed_mesh::index_type face = surface.faces[i];
+		float b[3] = {surface.u[i], surface.v[i], surface.w[i]};
+		float3 displacement = {surface.displacement_x[i], surface.displacement_y[i], surface.displacement_z[i]};
+		float distance = math::length(displacement);
+		float3 heading = {0, 0, 0};
+		
+		for (std::size_t crossing = 0; crossing < max_edge_crossings && distance > 0.0f; ++crossing)
+		{
+			const surface_triangle& triangle = surface.triangles[face];
+			
+			// Project the remaining displacement onto the triangle, preserving its length
+			float3 tangent = displacement - triangle.normal * math::dot(displacement, triangle.normal);
+			const float tangent_length = math::length(tangent);
+			if (tangent_length <= 0.0f)
+				break;
+			tangent *= distance / tangent_length;
+			heading = tangent;
+			
+			// Convert the displacement into barycentric space
+			const float d0 = math::dot(tangent, triangle.edges[0]);
+			const float d1 = math::dot(tangent, triangle.edges[1]);
+			float db[3];
+			db[1] = triangle.inverse_gram[0] * d0 + triangle.inverse_gram[1] * d1;
+			db[2] = triangle.inverse_gram[1] * d0 + triangle.inverse_gram[2] * d1;
+			db[0] = -db[1] - db[2];
+			
+			// Find the fraction of the step at which a barycentric coordinate first reaches zero
+			float fraction = 1.0f;
+			int exit_vertex = -1;
+			for (int j = 0; j < 3; ++j)
+			{
+				if (b[j] + db[j] < 0.0f)
+				{
+					const float crossing_fraction = b[j] / -db[j];
+					if (crossing_fraction < fraction)
+					{
+						fraction = crossing_fraction;
+						exit_vertex = j;
+					}
+				}
+			}
+			
+			for (int j = 0; j < 3; ++j)
+				b[j] = std::max(0.0f, b[j] + db[j] * fraction);
+			
+			// Stop if the step ends inside the triangle
+			if (exit_vertex < 0)
+				break;
+			
+			// Move onto the exit edge and renormalize
+			b[exit_vertex] = 0.0f;
+			const float sum = b[0] + b[1] + b[2];
+			if (sum > 0.0f)
+			{
+				b[0] /= sum;
+				b[1] /= sum;
+				b[2] /= sum;
+			}
+			distance *= 1.0f - fraction;
+			displacement = tangent * (1.0f - fraction);
+			
+			// Find the triangle across the edge opposite the exit vertex, stopping at boundaries
+			const int edge_start = (exit_vertex + 1) % 3;
+			const int edge_end = (exit_vertex + 2) % 3;
+			const geom::indexed_mesh::index_type edge = geom::indexed_mesh::symmetric(triangle.corner_edges[edge_start]);
+			const geom::indexed_mesh::index_type next_face = surface.edge_faces[edge];
+			if (next_face == geom::indexed_mesh::null_index)
+				break;
+			
+			// Transfer coordinates along the shared edge, which runs in the opposite direction in the adjacent triangle
+			const surface_triangle& next_triangle = surface.triangles[next_face];
+			int k = 0;
+			while (next_triangle.corner_edges[k] != edge)
+				++k;
+			
+			float next_b[3];
+			next_b[k] = b[edge_end];
+			next_b[(k + 1) % 3] = b[edge_start];
+			next_b[(k + 2) % 3] = 0.0f;
+			b[0] = next_b[0];
+			b[1] = next_b[1];
+			b[2] = next_b[2];
+			face = next_face;
+			
+			// Unfold the remaining displacement about the shared edge, so entities continue straight over creases
+			if (math::dot(triangle.normal, next_triangle.normal) > -0.999f)
+				displacement = math::rotation(triangle.normal, next_triangle.normal) * displacement;
+		}
+		
+		surface.faces[i] = face;
+		surface.u[i] = b[0];
+		surface.v[i] = b[1];
+		surface.w[i] = b[2];
+		surface.displacement_x[i] = heading.x;
+		surface.displacement_y[i] = heading.y;
+		surface.displacement_z[i] = heading.z;
+	}
+}
+
+void locomotion::step_chunks()
+{
+	for (std::size_t i = next_chunk++; i < chunks.size(); i = next_chunk++)
+		step(*std::get<0>(chunks[i]), std::get<1>(chunks[i]), std::get<2>(chunks[i]));
+}
+
+void locomotion::work()
+{
+	std::size_t last_generation = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [&]{return stopping || generation != last_generation;});
+			if (stopping)
+				return;
+			
+			last_generation = generation;
+		}
+		
+		step_chunks();
+		
+		bool done;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			done = !--busy_worker_count;
+		}
+		if (done)
+			done_condition.notify_one();
+	}
+}
+
+void locomotion::on_collision_replace(entity::registry&, entity::id entity_id, component::collision&)
+{
+	surfaces.erase(entity_id);
+}
+
+void locomotion::on_collision_destroy(entity::registry&, entity::id entity_id)
+{
+	surfaces.erase(entity_id);
 }
 
 } // namespace system
@@ -21,19 +21,105 @@
 #define ANTKEEPER_ENTITY_SYSTEM_LOCOMOTION_HPP
 
 #include "entity/systems/updatable.hpp"
+#include "entity/components/collision.hpp"
+#include "entity/id.hpp"
+#include "geom/indexed-mesh.hpp"
+#include "geom/mesh.hpp"
+#include "utility/fundamental-types.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
 namespace entity {
 namespace system {
 
+/**
+ * Moves entities across the triangles of collision meshes.
+ *
+ * Rather than ray casting against a surface each step, entities step through barycentric space and cross into neighboring triangles through half-edge adjacency, so each step costs O(1). The walking state of every entity on a surface is gathered into structure-of-arrays batches, which are stepped in parallel chunks by the updating thread and a set of worker threads. The workers are started the first time there are enough entities to split, and are reused by every later update.
+ */
 class locomotion:
 	public updatable
 {
 public:
 	locomotion(entity::registry& registry);
+	
+	/// Stops the worker threads.
+	~locomotion();
+	
 	virtual void update(double t, double dt);
+
+private:
+	/// Walking geometry of a triangle.
+	struct surface_triangle
+	{
+		/// Position of the first vertex.
+		float3 origin;
+		
+		/// Vectors from the first vertex to the second and third vertices.
+		float3 edges[2];
+		
+		/// Unit normal.
+		float3 normal;
+		
+		/// Inverse of the Gram matrix of the edge vectors, which converts displacements into barycentric coordinates.
+		float inverse_gram[3];
+		
+		/// Half-edges of the triangle, where half-edge `i` starts at vertex `i`.
+		geom::indexed_mesh::index_type corner_edges[3];
+	};
+	
+	/// Collision mesh and the entities walking on it.
+	struct surface
+	{
+		const geom::mesh* mesh;
+		std::vector<geom::indexed_mesh::index_type> edge_faces;
+		std::vector<surface_triangle> triangles;
+		
+		// Walking state of each entity on the surface. Displacements are replaced by final headings after stepping.
+		std::vector<entity::id> entities;
+		std::vector<geom::indexed_mesh::index_type> faces;
+		std::vector<float> u;
+		std::vector<float> v;
+		std::vector<float> w;
+		std::vector<float> displacement_x;
+		std::vector<float> displacement_y;
+		std::vector<float> displacement_z;
+	};
+	
+	void build_surface(surface& surface, const geom::mesh& mesh);
+	void step(surface& surface, std::size_t begin, std::size_t end) const;
+	
+	/// Steps unclaimed chunks until none remain.
+	void step_chunks();
+	
+	/// Worker thread function.
+	void work();
+	
+	void on_collision_replace(entity::registry& registry, entity::id entity_id, entity::component::collision& collision);
+	void on_collision_destroy(entity::registry& registry, entity::id entity_id);
+	
+	std::unordered_map<entity::id, surface> surfaces;
+	std::vector<std::tuple<surface*, std::size_t, std::size_t>> chunks;
+	
+	// State shared with worker threads
+	std::atomic<std::size_t> next_chunk;
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::condition_variable done_condition;
+	std::vector<std::thread> workers;
+	std::size_t generation;
+	std::size_t busy_worker_count;
+	bool stopping;
 };
 
 } // namespace system
 } // namespace entity
 
 #endif // ANTKEEPER_ENTITY_SYSTEM_LOCOMOTION_HPP
+
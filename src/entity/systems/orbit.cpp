@@ -21,62 +21,39 @@
 #include "entity/components/orbit.hpp"
 #include "entity/id.hpp"
 #include "physics/orbit/orbit.hpp"
+#include <stdexcept>
 
 namespace entity {
 namespace system {
 
-orbit::orbit(entity::registry& registry):
+orbit::orbit(entity::registry& registry, double mu):
 	updatable(registry),
 	universal_time(0.0),
 	time_scale(1.0),
-	ke_iterations(10),
-	ke_tolerance(1e-6)
-{}
+	gravitational_parameter(0.0)
+{
+	set_gravitational_parameter(mu);
+	propagator.set_kepler_solver(10, 1e-6);
+	
+	registry.on_construct<entity::component::orbit>().connect<&orbit::on_orbit_construct>(this);
+	registry.on_replace<entity::component::orbit>().connect<&orbit::on_orbit_replace>(this);
+	registry.on_destroy<entity::component::orbit>().connect<&orbit::on_orbit_destroy>(this);
+}
 
 void orbit::update(double t, double dt)
 {
 	// Add scaled timestep to current time
 	set_universal_time(universal_time + dt * time_scale);
 	
-	// Update the orbital state of orbiting bodies
-	registry.view<component::orbit>().each(
-	[&](entity::id entity_id, auto& orbit)
+	// Propagate all orbits to the current time
+	propagator.propagate(universal_time);
+	
+	// Update orbital state of components
+	for (std::size_t i = 0; i < propagator_entities.size(); ++i)
 	{
-		// Calculate semi-minor axis (b)
-		const double b = physics::orbit::derive_semiminor_axis(orbit.elements.a, orbit.elements.e);
-		
-		// Solve Kepler's equation for eccentric anomaly (E)
-		const double ea = physics::orbit::kepler_ea(orbit.elements.e, orbit.elements.ta, ke_iterations, ke_tolerance);
-		
-		// Calculate radial distance and true anomaly (nu)
-		const double xv = orbit.elements.a * (std::cos(ea) - orbit.elements.e);
-		const double yv = b * std::sin(ea);
-		const double distance = std::sqrt(xv * xv + yv * yv);
-		const double ta = std::atan2(yv, xv);
-		
-		// Calculate Cartesian position (r) in perifocal space
-		const math::vector3<double> r_perifocal = math::quaternion<double>::rotate_z(ta) * math::vector3<double>{distance, 0, 0};
-		
-		/// @TODO Calculate Cartesian velocity (v) in perifocal space
-		//const math::vector3<double> v_perifocal = ...
-		
-		// Construct perifocal to inertial reference frame
-		const physics::frame<double> perifocal_to_inertial = physics::orbit::inertial::to_perifocal
-		(
-			{0, 0, 0},
-			orbit.elements.raan,
-			orbit.elements.i,
-			orbit.elements.w
-		).inverse();
-		
-		// Transform orbital state vectors from perifocal space to the parent inertial space
-		const math::vector3<double> r_inertial = perifocal_to_inertial.transform(r_perifocal);
-		//const math::vector3<double> v_inertial = perifocal_frame.transform(v_perifocal);
-		
-		// Update orbital state of component
-		orbit.state.r = r_inertial;
-		//orbit.state.v = v_inertial;
-	});
+		component::orbit& orbit = registry.get<component::orbit>(propagator_entities[i]);
+		orbit.state = propagator.get_state(i);
+	}
 }
 
 void orbit::set_universal_time(double time)
@@ -89,5 +66,58 @@ void orbit::set_time_scale(double scale)
 	time_scale = scale;
 }
 
+void orbit::set_gravitational_parameter(double mu)
+{
+	if (!(mu > 0.0))
+		throw std::invalid_argument("Gravitational parameter must be positive");
+	
+	gravitational_parameter = mu;
+	
+	// Recalculate mean motion of all orbits
+	for (std::size_t i = 0; i < propagator_entities.size(); ++i)
+	{
+		const component::orbit& orbit = registry.get<component::orbit>(propagator_entities[i]);
+		propagator.set(i, orbit.elements, derive_mean_motion(orbit.elements));
+	}
+}
+
+double orbit::derive_mean_motion(const physics::orbit::elements<double>& elements) const
+{
+	if (elements.a <= 0.0)
+		return 0.0;
+	
+	return physics::orbit::derive_mean_motion(elements.a, gravitational_parameter);
+}
+
+void orbit::on_orbit_construct(entity::registry& registry, entity::id entity_id, entity::component::orbit& orbit)
+{
+	propagator_indices[entity_id] = propagator.add(orbit.elements, derive_mean_motion(orbit.elements));
+	propagator_entities.push_back(entity_id);
+}
+
+void orbit::on_orbit_replace(entity::registry& registry, entity::id entity_id, entity::component::orbit& orbit)
+{
+	if (auto it = propagator_indices.find(entity_id); it != propagator_indices.end())
+		propagator.set(it->second, orbit.elements, derive_mean_motion(orbit.elements));
+}
+
+void orbit::on_orbit_destroy(entity::registry& registry, entity::id entity_id)
+{
+	if (auto it = propagator_indices.find(entity_id); it != propagator_indices.end())
+	{
+		const std::size_t index = it->second;
+		propagator_indices.erase(it);
+		
+		// Propagator moves its last orbit into the vacated index
+		propagator.remove(index);
+		if (index != propagator_entities.size() - 1)
+		{
+			propagator_entities[index] = propagator_entities.back();
+			propagator_indices[propagator_entities[index]] = index;
+		}
+		propagator_entities.pop_back();
+	}
+}
+
 } // namespace system
 } // namespace entity
@@ -21,19 +21,34 @@
 #define ANTKEEPER_ENTITY_SYSTEM_SOLAR_HPP
 
 #include "entity/systems/updatable.hpp"
+#include "entity/components/orbit.hpp"
+#include "entity/id.hpp"
+#include "physics/orbit/propagator.hpp"
 #include "utility/fundamental-types.hpp"
+#include <unordered_map>
+#include <vector>
 
 namespace entity {
 namespace system {
 
 /**
  * Updates the Cartesian position and velocity of orbiting bodies given their Keplerian orbital elements and the current time.
+ *
+ * Orbits are mirrored into a batched propagator when orbit components are constructed or replaced. Orbital elements modified in place will not take effect until the component is replaced.
  */
 class orbit:
 	public updatable
 {
 public:
-	orbit(entity::registry& registry);
+	/**
+	 * Creates an orbit system.
+	 *
+	 * @param registry Entity registry.
+	 * @param mu Standard gravitational parameter (GM) of the central body, in cubic units of the semimajor axis per day squared.
+	 *
+	 * @exception std::invalid_argument Gravitational parameter is not positive.
+	 */
+	orbit(entity::registry& registry, double mu);
 	
 	/**
 	 * Scales then adds the timestep `dt` to the current time, then recalculates the positions of orbiting bodies.
@@ -57,11 +72,28 @@ public:
 	 */
 	void set_time_scale(double scale);
 	
+	/**
+	 * Sets the standard gravitational parameter (GM) of the central body, which determines the mean motion of each orbit.
+	 *
+	 * @param mu Standard gravitational parameter, in cubic units of the semimajor axis per day squared.
+	 *
+	 * @exception std::invalid_argument Gravitational parameter is not positive.
+	 */
+	void set_gravitational_parameter(double mu);
+	
 private:
+	double derive_mean_motion(const physics::orbit::elements<double>& elements) const;
+	
+	void on_orbit_construct(entity::registry& registry, entity::id entity_id, entity::component::orbit& orbit);
+	void on_orbit_replace(entity::registry& registry, entity::id entity_id, entity::component::orbit& orbit);
+	void on_orbit_destroy(entity::registry& registry, entity::id entity_id);
+	
 	double universal_time;
 	double time_scale;
-	std::size_t ke_iterations;
-	double ke_tolerance;
+	double gravitational_parameter;
+	physics::orbit::propagator<double> propagator;
+	std::vector<entity::id> propagator_entities;
+	std::unordered_map<entity::id, std::size_t> propagator_indices;
 };
 
 } // namespace system
@@ -19,55 +19,205 @@
 
 #include "entity/systems/proteome.hpp"
 #include "entity/components/proteome.hpp"
-#include "genetics/sequence.hpp"
 #include "genetics/standard-code.hpp"
+#include <algorithm>
 
 namespace entity {
 namespace system {
 
+/**
+ * Generates a 64-bit FNV-1a hash of a packed sequence.
+ */
+static std::uint64_t hash_chromosome(const genetics::packed_sequence& chromosome)
+{
+	std::uint64_t hash = 0xcbf29ce484222325;
+	auto mix = [&hash](std::uint64_t value)
+	{
+		hash ^= value;
+		hash *= 0x100000001b3;
+	};
+	
+	mix(chromosome.size());
+	for (std::uint64_t word: chromosome.get_words())
+		mix(word);
+	for (const auto& exception: chromosome.get_exceptions())
+		mix((exception.first << 8) | static_cast<unsigned char>(exception.second));
+	
+	return hash;
+}
+
+/**
+ * Translates every ORF in a chromosome.
+ */
+static std::shared_ptr<const std::vector<std::string>> translate_chromosome(const genetics::packed_sequence& chromosome)
+{
+	auto proteins = std::make_shared<std::vector<std::string>>();
+	
+	// Find all ORFs in the chromosome
+	std::vector<genetics::sequence::orf<std::size_t>> orfs;
+	genetics::sequence::find_orfs(chromosome, genetics::standard_code, orfs);
+	proteins->reserve(orfs.size());
+	
+	// Translate the base sequence of each ORF into an amino acid sequence (protein)
+	for (const auto& orf: orfs)
+	{
+		std::string protein;
+		genetics::sequence::translate(chromosome, orf.start, orf.stop, genetics::standard_code, protein);
+		proteins->push_back(std::move(protein));
+	}
+	
+	return proteins;
+}
+
 proteome::proteome(entity::registry& registry):
-	updatable(registry)
+	updatable(registry),
+	cache_capacity(1024),
+	next_serial(0),
+	stopping(false)
 {
 	registry.on_construct<entity::component::genome>().connect<&proteome::on_genome_construct>(this);
 	registry.on_replace<entity::component::genome>().connect<&proteome::on_genome_replace>(this);
+	
+	// Start worker threads, leaving one hardware thread for the main thread
+	const std::size_t worker_count = std::max<std::size_t>(std::thread::hardware_concurrency(), 2) - 1;
+	for (std::size_t i = 0; i < worker_count; ++i)
+		workers.emplace_back(&proteome::work, this);
+}
+
+proteome::~proteome()
+{
+	registry.on_construct<entity::component::genome>().disconnect<&proteome::on_genome_construct>(this);
+	registry.on_replace<entity::component::genome>().disconnect<&proteome::on_genome_replace>(this);
+	
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	condition.notify_all();
+	
+	for (std::thread& worker: workers)
+		worker.join();
 }
 
 void proteome::update(double t, double dt)
-{}
+{
+	// Publish finished translations
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto& result: results)
+			result.first->proteins = std::move(result.second);
+		results.clear();
+	}
+	
+	// Commit proteomes whose chromosomes have all been translated
+	auto committed = std::remove_if(requests.begin(), requests.end(),
+		[&](const request& pending) -> bool
+		{
+			for (const auto& translation: pending.translations)
+				if (!translation->proteins)
+					return false;
+			
+			// Skip requests superseded by a later genome, or whose entity has been destroyed
+			auto serial = request_serials.find(pending.entity_id);
+			if (serial == request_serials.end() || serial->second != pending.serial)
+				return true;
+			request_serials.erase(serial);
+			if (!registry.valid(pending.entity_id))
+				return true;
+			
+			entity::component::proteome component;
+			component.chromosomes.reserve(pending.translations.size());
+			for (const auto& translation: pending.translations)
+				component.chromosomes.push_back(translation->proteins);
+			registry.assign_or_replace<entity::component::proteome>(pending.entity_id, std::move(component));
+			
+			return true;
+		});
+	requests.erase(committed, requests.end());
+	
+	// Evict translations which are no longer referenced by any proteome or request
+	if (cache.size() > cache_capacity)
+	{
+		for (auto it = cache.begin(); it != cache.end();)
+		{
+			if (it->second.use_count() == 1 && it->second->proteins && it->second->proteins.use_count() == 1)
+				it = cache.erase(it);
+			else
+				++it;
+		}
+	}
+}
 
-void proteome::on_genome_construct(entity::registry& registry, entity::id entity_id, entity::component::genome& genome)
+void proteome::set_cache_capacity(std::size_t capacity)
 {
-	on_genome_replace(registry, entity_id, genome);
+	cache_capacity = capacity;
 }
 
-void proteome::on_genome_replace(entity::registry& registry, entity::id entity_id, entity::component::genome& genome)
+std::shared_ptr<proteome::translation> proteome::find_or_translate(const genetics::packed_sequence& chromosome)
 {
-	// Allocate a proteome component
-	entity::component::proteome proteome_component;
+	const std::uint64_t hash = hash_chromosome(chromosome);
 	
-	// For each chromosome in the genome
-	for (const std::string& chromosome: genome.chromosomes)
+	// Return memoized translation, if any
+	auto range = cache.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+		if (it->second->chromosome == chromosome)
+			return it->second;
+	
+	// Queue a new translation
+	auto entry = std::make_shared<translation>();
+	entry->chromosome = chromosome;
+	cache.emplace(hash, entry);
 	{
-		// Find the first ORF in the chromosome
-		auto orf = genetics::sequence::find_orf(chromosome.begin(), chromosome.end(), genetics::standard_code);
-		
-		// While the ORF is valid
-		while (orf.start != chromosome.end())
+		std::lock_guard<std::mutex> lock(mutex);
+		jobs.push_back(entry);
+	}
+	condition.notify_one();
+	
+	return entry;
+}
+
+void proteome::work()
+{
+	for (;;)
+	{
+		std::shared_ptr<translation> job;
 		{
-			// Translate the base sequence into an amino acid sequence (protein)
-			std::string protein;
-			genetics::sequence::translate(orf.start, orf.stop, std::back_inserter(protein), genetics::standard_code);
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this]{return stopping || !jobs.empty();});
+			if (stopping)
+				return;
 			
-			// Append protein to the proteome
-			proteome_component.proteins.push_back(protein);
-			
-			// Find the next ORF
-			orf = genetics::sequence::find_orf(orf.stop, chromosome.end(), genetics::standard_code);
+			job = std::move(jobs.front());
+			jobs.pop_front();
 		}
+		
+		// The chromosome of a queued translation is never modified, so it can be read without locking
+		auto proteins = translate_chromosome(job->chromosome);
+		
+		std::lock_guard<std::mutex> lock(mutex);
+		results.emplace_back(std::move(job), std::move(proteins));
 	}
+}
+
+void proteome::on_genome_construct(entity::registry& registry, entity::id entity_id, entity::component::genome& genome)
+{
+	on_genome_replace(registry, entity_id, genome);
+}
+
+void proteome::on_genome_replace(entity::registry& registry, entity::id entity_id, entity::component::genome& genome)
+{
+	request pending;
+	pending.entity_id = entity_id;
+	pending.serial = next_serial++;
+	pending.translations.reserve(genome.chromosomes.size());
+	
+	// Look up or queue the translation of each chromosome
+	for (const genetics::packed_sequence& chromosome: genome.chromosomes)
+		pending.translations.push_back(find_or_translate(chromosome));
 	
-	// Assign or replace the entity's proteome component
-	registry.assign_or_replace<entity::component::proteome>(entity_id, proteome_component);
+	// Supersede any pending request for this entity
+	request_serials[entity_id] = pending.serial;
+	requests.push_back(std::move(pending));
 }
 
 } // namespace system
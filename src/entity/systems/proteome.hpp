@@ -23,12 +23,25 @@
 #include "entity/systems/updatable.hpp"
 #include "entity/components/genome.hpp"
 #include "entity/id.hpp"
+#include "genetics/packed-sequence.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace entity {
 namespace system {
 
 /**
  * Generates proteomes for every genome.
+ *
+ * Chromosomes are translated on a pool of worker threads, and the resulting proteomes are assigned to their entities during update(). Translations are memoized by chromosome, so organisms which share chromosomes share the same immutable protein sets and each unique chromosome is translated only once.
  */
 class proteome:
 	public updatable
@@ -36,17 +49,63 @@ class proteome:
 public:
 	proteome(entity::registry& registry);
 	
+	/// Stops the worker threads.
+	~proteome();
+	
 	/**
-	 * Scales then adds the timestep `dt` to the current time, then recalculates the positions of proteomeing bodies.
+	 * Assigns proteome components to entities whose chromosomes have been translated.
 	 *
 	 * @param t Time, in seconds.
 	 * @param dt Delta time, in seconds.
 	 */
 	virtual void update(double t, double dt);
 	
+	/**
+	 * Sets the number of translated chromosomes above which unreferenced translations are evicted from the cache.
+	 *
+	 * @param capacity Cache capacity, in chromosomes.
+	 */
+	void set_cache_capacity(std::size_t capacity);
+	
 private:
+	/// Memoized translation of a chromosome.
+	struct translation
+	{
+		/// Translated chromosome.
+		genetics::packed_sequence chromosome;
+		
+		/// Proteins encoded by the chromosome, or `nullptr` if the translation is in progress.
+		std::shared_ptr<const std::vector<std::string>> proteins;
+	};
+	
+	/// Proteome awaiting the translation of its chromosomes.
+	struct request
+	{
+		entity::id entity_id;
+		std::uint32_t serial;
+		std::vector<std::shared_ptr<translation>> translations;
+	};
+	
+	std::shared_ptr<translation> find_or_translate(const genetics::packed_sequence& chromosome);
+	void work();
+	
 	void on_genome_construct(entity::registry& registry, entity::id entity_id, entity::component::genome& genome);
 	void on_genome_replace(entity::registry& registry, entity::id entity_id, entity::component::genome& genome);
+	
+	// Main thread state
+	std::unordered_multimap<std::uint64_t, std::shared_ptr<translation>> cache;
+	std::size_t cache_capacity;
+	std::vector<request> requests;
+	std::unordered_map<entity::id, std::uint32_t> request_serials;
+	std::uint32_t next_serial;
+	
+	// State shared with worker threads
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<std::shared_ptr<translation>> jobs;
+	std::vector<std::pair<std::shared_ptr<translation>, std::shared_ptr<const std::vector<std::string>>>> results;
+	std::vector<std::thread> workers;
+	bool stopping;
 };
 
 } // namespace system
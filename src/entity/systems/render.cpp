@@ -31,7 +31,8 @@ namespace system {
 
 render::render(entity::registry& registry):
 	updatable(registry),
-	renderer(nullptr)
+	renderer(nullptr),
+	deferred(false)
 {
 	registry.on_construct<component::model>().connect<&render::on_model_construct>(this);
 	registry.on_replace<component::model>().connect<&render::on_model_replace>(this);
@@ -44,6 +45,9 @@ render::render(entity::registry& registry):
 
 void render::update(double t, double dt)
 {
+	// Create, change, and destroy scene objects of components which changed since the last update
+	apply_deferred_changes();
+	
 	// Update model instance transforms
 	registry.view<component::transform, component::model>().each
 	(
@@ -105,6 +109,21 @@ void render::set_renderer(::renderer* renderer)
 	this->renderer = renderer;
 }
 
+void render::set_deferred(bool deferred)
+{
+	this->deferred = deferred;
+	if (!deferred)
+		apply_deferred_changes();
+}
+
+void render::handle_event(const window_resized_event& event)
+{
+	if (renderer)
+	{
+		renderer->set_viewport_height(static_cast<float>(event.h));
+	}
+}
+
 scene::model_instance* render::get_model_instance(entity::id entity_id)
 {
 	if (auto it = model_instances.find(entity_id); it != model_instances.end())
@@ -176,19 +195,14 @@ void render::update_light(entity::id entity_id, entity::component::light& compon
 	}
 }
 
-void render::on_model_construct(entity::registry& registry, entity::id entity_id, component::model& model)
+void render::add_model_instance(entity::id entity_id, component::model& model)
 {
 	scene::model_instance* model_instance = new scene::model_instance();	
 	model_instances[entity_id] = model_instance;
 	update_model_and_materials(entity_id, model);
 }
 
-void render::on_model_replace(entity::registry& registry, entity::id entity_id, component::model& model)
-{
-	update_model_and_materials(entity_id, model);
-}
-
-void render::on_model_destroy(entity::registry& registry, entity::id entity_id)
+void render::remove_model_instance(entity::id entity_id)
 {
 	if (auto it = model_instances.find(entity_id); it != model_instances.end())
 	{
@@ -203,7 +217,7 @@ void render::on_model_destroy(entity::registry& registry, entity::id entity_id)
 	}
 }
 
-void render::on_light_construct(entity::registry& registry, entity::id entity_id, component::light& component)
+void render::add_light(entity::id entity_id, component::light& component)
 {
 	scene::light* light = nullptr;
 	
@@ -239,12 +253,7 @@ void render::on_light_construct(entity::registry& registry, entity::id entity_id
 	}
 }
 
-void render::on_light_replace(entity::registry& registry, entity::id entity_id, component::light& light)
-{
-	update_light(entity_id, light);
-}
-
-void render::on_light_destroy(entity::registry& registry, entity::id entity_id)
+void render::remove_light(entity::id entity_id)
 {
 	if (auto it = lights.find(entity_id); it != lights.end())
 	{
@@ -258,5 +267,92 @@ void render::on_light_destroy(entity::registry& registry, entity::id entity_id)
 	}
 }
 
+void render::apply_deferred_changes()
+{
+	// Bring model instances in line with the current model components
+	for (entity::id entity_id: deferred_models)
+	{
+		if (registry.valid(entity_id) && registry.has<component::model>(entity_id))
+		{
+			component::model& model = registry.get<component::model>(entity_id);
+			if (model_instances.find(entity_id) == model_instances.end())
+				add_model_instance(entity_id, model);
+			else
+				update_model_and_materials(entity_id, model);
+		}
+		else
+		{
+			remove_model_instance(entity_id);
+		}
+	}
+	deferred_models.clear();
+	
+	// Bring lights in line with the current light components
+	for (entity::id entity_id: deferred_lights)
+	{
+		if (registry.valid(entity_id) && registry.has<component::light>(entity_id))
+		{
+			component::light& light = registry.get<component::light>(entity_id);
+			if (lights.find(entity_id) == lights.end())
+				add_light(entity_id, light);
+			else
+				update_light(entity_id, light);
+		}
+		else
+		{
+			remove_light(entity_id);
+		}
+	}
+	deferred_lights.clear();
+}
+
+void render::on_model_construct(entity::registry& registry, entity::id entity_id, component::model& model)
+{
+	if (deferred)
+		deferred_models.insert(entity_id);
+	else
+		add_model_instance(entity_id, model);
+}
+
+void render::on_model_replace(entity::registry& registry, entity::id entity_id, component::model& model)
+{
+	if (deferred)
+		deferred_models.insert(entity_id);
+	else
+		update_model_and_materials(entity_id, model);
+}
+
+void render::on_model_destroy(entity::registry& registry, entity::id entity_id)
+{
+	if (deferred)
+		deferred_models.insert(entity_id);
+	else
+		remove_model_instance(entity_id);
+}
+
+void render::on_light_construct(entity::registry& registry, entity::id entity_id, component::light& component)
+{
+	if (deferred)
+		deferred_lights.insert(entity_id);
+	else
+		add_light(entity_id, component);
+}
+
+void render::on_light_replace(entity::registry& registry, entity::id entity_id, component::light& light)
+{
+	if (deferred)
+		deferred_lights.insert(entity_id);
+	else
+		update_light(entity_id, light);
+}
+
+void render::on_light_destroy(entity::registry& registry, entity::id entity_id)
+{
+	if (deferred)
+		deferred_lights.insert(entity_id);
+	else
+		remove_light(entity_id);
+}
+
 } // namespace system
 } // namespace entity
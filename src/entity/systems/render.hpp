@@ -21,6 +21,8 @@
 #define ANTKEEPER_ENTITY_SYSTEM_RENDER_HPP
 
 #include "entity/systems/updatable.hpp"
+#include "event/event-handler.hpp"
+#include "event/window-events.hpp"
 #include "scene/collection.hpp"
 #include "scene/model-instance.hpp"
 #include "scene/light.hpp"
@@ -28,6 +30,7 @@
 #include "entity/components/light.hpp"
 #include "entity/id.hpp"
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 class renderer;
@@ -35,11 +38,14 @@ class renderer;
 namespace entity {
 namespace system {
 
-class render: public updatable
+class render:
+	public updatable,
+	public event_handler<window_resized_event>
 {
 public:
 	render(entity::registry& registry);
 	virtual void update(double t, double dt);
+	virtual void handle_event(const window_resized_event& event);
 	
 	void draw(double alpha);
 	
@@ -49,12 +55,24 @@ public:
 	
 	void set_renderer(::renderer* renderer);
 	
+	/**
+	 * Enables or disables deferred scene changes. When deferred, scene objects are not created, changed, or destroyed when model and light components are, but on the next update. This allows components to be changed on an update thread while the scene is rendered.
+	 *
+	 * @param deferred `true` to defer scene changes until the next update, `false` to apply them immediately.
+	 */
+	void set_deferred(bool deferred);
+	
 	scene::model_instance* get_model_instance(entity::id entity_id);
 	scene::light* get_light(entity::id entity_id);
 
 private:	
+	void add_model_instance(entity::id entity_id, entity::component::model& model);
+	void remove_model_instance(entity::id entity_id);
 	void update_model_and_materials(entity::id entity_id, entity::component::model& model);
+	void add_light(entity::id entity_id, entity::component::light& component);
+	void remove_light(entity::id entity_id);
 	void update_light(entity::id entity_id, entity::component::light& component);
+	void apply_deferred_changes();
 	
 	void on_model_construct(entity::registry& registry, entity::id entity_id, entity::component::model& model);
 	void on_model_replace(entity::registry& registry, entity::id entity_id, entity::component::model& model);
@@ -68,6 +86,9 @@ private:
 	std::vector<scene::collection*> layers;
 	std::unordered_map<entity::id, scene::model_instance*> model_instances;
 	std::unordered_map<entity::id, scene::light*> lights;
+	bool deferred;
+	std::unordered_set<entity::id> deferred_models;
+	std::unordered_set<entity::id> deferred_lights;
 };
 
 } // namespace system
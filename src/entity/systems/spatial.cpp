@@ -20,12 +20,15 @@
 #include "spatial.hpp"
 #include "entity/components/parent.hpp"
 #include "entity/components/transform.hpp"
+#include <cmath>
 
 namespace entity {
 namespace system {
 
 spatial::spatial(entity::registry& registry):
-	updatable(registry)
+	updatable(registry),
+	neighbor_cell_size(1.0f),
+	neighbor_snapshot(std::make_shared<geom::spatial_hash>())
 {}
 
 void spatial::update(double t, double dt)
@@ -54,6 +57,39 @@ void spatial::update(double t, double dt)
 				transform.warp = parent_transform.warp;
 			}
 		});
+	
+	// Gather world-space translations
+	neighbor_positions.clear();
+	neighbor_values.clear();
+	registry.view<component::transform>().each(
+		[&](entity::id entity_id, auto& transform)
+		{
+			// Skip entities which can't be hashed
+			const float3& translation = transform.world.translation;
+			if (!std::isfinite(translation.x) || !std::isfinite(translation.y) || !std::isfinite(translation.z))
+				return;
+			
+			neighbor_positions.push_back(translation);
+			neighbor_values.push_back(static_cast<geom::spatial_hash::value_type>(entity_id));
+		});
+	
+	// Rebuild the neighbor hash, reusing the previous-but-one snapshot once no one else holds it
+	std::shared_ptr<geom::spatial_hash> hash;
+	if (neighbor_spare && neighbor_spare.use_count() == 1)
+		hash = std::move(neighbor_spare);
+	else
+		hash = std::make_shared<geom::spatial_hash>();
+	hash->set_cell_size(neighbor_cell_size);
+	hash->build(neighbor_positions.data(), neighbor_values.data(), neighbor_positions.size());
+	
+	// Publish the new snapshot
+	neighbor_spare = std::move(neighbor_snapshot);
+	neighbor_snapshot = std::move(hash);
+}
+
+void spatial::set_neighbor_cell_size(float size)
+{
+	neighbor_cell_size = size;
 }
 
 } // namespace system
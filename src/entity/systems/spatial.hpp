@@ -21,6 +21,10 @@
 #define ANTKEEPER_ENTITY_SYSTEM_SPATIAL_HPP
 
 #include "entity/systems/updatable.hpp"
+#include "geom/spatial-hash.hpp"
+#include "utility/fundamental-types.hpp"
+#include <memory>
+#include <vector>
 
 namespace entity {
 namespace system {
@@ -31,8 +35,30 @@ class spatial:
 public:
 	spatial(entity::registry& registry);
 	virtual void update(double t, double dt);
+	
+	/// Sets the cell size of the neighbor hash. Takes effect on the next update.
+	void set_neighbor_cell_size(float size);
+	
+	/**
+	 * Returns a spatial hash of the world-space translations of all transformed entities, as of the last update. The value of each point is its entity ID.
+	 *
+	 * Published snapshots are never modified, so they may be shared with systems on other threads and remain valid for as long as they are held. Snapshots should be acquired on the update thread.
+	 */
+	std::shared_ptr<const geom::spatial_hash> get_neighbor_snapshot() const;
+
+private:
+	float neighbor_cell_size;
+	std::shared_ptr<geom::spatial_hash> neighbor_snapshot;
+	std::shared_ptr<geom::spatial_hash> neighbor_spare;
+	std::vector<float3> neighbor_positions;
+	std::vector<geom::spatial_hash::value_type> neighbor_values;
 };
 
+inline std::shared_ptr<const geom::spatial_hash> spatial::get_neighbor_snapshot() const
+{
+	return neighbor_snapshot;
+}
+
 } // namespace system
 } // namespace entity
 
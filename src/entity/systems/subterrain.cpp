@@ -24,174 +24,31 @@
 #include "renderer/model.hpp"
 #include "renderer/material.hpp"
 #include "geom/mesh-functions.hpp"
+#include "renderer/geometry-optimization.hpp"
 #include "renderer/vertex-attributes.hpp"
+#include "renderer/vertex-quantization.hpp"
 #include "gl/vertex-attribute-type.hpp"
 #include "gl/drawing-mode.hpp"
 #include "gl/vertex-buffer.hpp"
 #include "resources/resource-manager.hpp"
-#include "geom/marching-cubes.hpp"
-#include "geom/intersection.hpp"
+#include "geom/sdf-brick-map.hpp"
 #include "utility/fundamental-types.hpp"
-#include <array>
+#include <algorithm>
+#include <cstring>
 #include <limits>
+#include <thread>
 
 namespace entity {
 namespace system {
 
-/**
- * An octree containing cubes for the marching cubes algorithm.
- */
-struct cube_tree
-{
-public:
-	cube_tree(const geom::aabb<float>& bounds, int max_depth);
-	~cube_tree();
-
-	const bool is_leaf() const;
-	const geom::aabb<float>& get_bounds() const;
-
-	/// Subdivides all nodes intersecting with a region to the max depth.
-	void subdivide_max(const geom::aabb<float>& region);
-
-	/// Fills a list with all leaf nodes that intersect with a region.
-	void query_leaves(std::list<cube_tree*>& nodes, const geom::aabb<float>& region);
-	void visit_leaves(const geom::aabb<float>& region, const std::function<void(cube_tree&)>& f);
-
-	/// Counts then number of nodes in the octree.
-	std::size_t size() const;
-
-	cube_tree* children[8];
-	float3 corners[8];
-	float distances[8];
-	const int max_depth;
-	const int depth;
-	const geom::aabb<float> bounds;
-
-private:
-	cube_tree(const geom::aabb<float>& bounds, int max_depth, int depth);
-	void subdivide();
-};
-
-cube_tree::cube_tree(const geom::aabb<float>& bounds, int max_depth):
-	cube_tree(bounds, max_depth, 0)
-{}
-
-cube_tree::cube_tree(const geom::aabb<float>& bounds, int max_depth, int depth):
-	bounds(bounds),
-	max_depth(max_depth),
-	depth(depth)
-{
-	corners[0] = {bounds.min_point.x, bounds.min_point.y, bounds.min_point.z};
-	corners[1] = {bounds.max_point.x, bounds.min_point.y, bounds.min_point.z};
-	corners[2] = {bounds.max_point.x, bounds.max_point.y, bounds.min_point.z};
-	corners[3] = {bounds.min_point.x, bounds.max_point.y, bounds.min_point.z};
-	corners[4] = {bounds.min_point.x, bounds.min_point.y, bounds.max_point.z};
-	corners[5] = {bounds.max_point.x, bounds.min_point.y, bounds.max_point.z};
-	corners[6] = {bounds.max_point.x, bounds.max_point.y, bounds.max_point.z};
-	corners[7] = {bounds.min_point.x, bounds.max_point.y, bounds.max_point.z};
-
-	for (int i = 0; i < 8; ++i)
-	{
-		children[i] = nullptr;
-		distances[i] = -std::numeric_limits<float>::infinity();
-
-		// For outside normals
-		//distances[i] = std::numeric_limits<float>::infinity();
-	}
-}
-
-cube_tree::~cube_tree()
-{
-	for (cube_tree* child: children)
-		delete child;
-}
-
-void cube_tree::subdivide_max(const geom::aabb<float>& region)
-{
-	if (depth != max_depth && aabb_aabb_intersection(bounds, region))
-	{
-		if (is_leaf())
-			subdivide();
-
-		for (cube_tree* child: children)
-			child->subdivide_max(region);
-	}
-}
-
-void cube_tree::query_leaves(std::list<cube_tree*>& nodes, const geom::aabb<float>& region)
-{
-	if (aabb_aabb_intersection(bounds, region))
-	{
-		if (is_leaf())
-		{
-			nodes.push_back(this);
-		}
-		else
-		{
-			for (cube_tree* child: children)
-				child->query_leaves(nodes, region);
-		}
-	}
-}
-
-void cube_tree::visit_leaves(const geom::aabb<float>& region, const std::function<void(cube_tree&)>& f)
-{
-	if (aabb_aabb_intersection(bounds, region))
-	{
-		if (is_leaf())
-		{
-			f(*this);
-		}
-		else
-		{
-			for (cube_tree* child: children)
-				child->visit_leaves(region, f);
-		}
-	}
-}
-
-std::size_t cube_tree::size() const
-{
-	std::size_t node_count = 1;
-	if (!is_leaf())
-	{
-		for (cube_tree* child: children)
-			node_count += child->size();
-	}
-
-	return node_count;
-}
-
-inline const bool cube_tree::is_leaf() const
-{
-	return (children[0] == nullptr);
-}
-
-inline const geom::aabb<float>& cube_tree::get_bounds() const
-{
-	return bounds;
-}
-
-void cube_tree::subdivide()
-{
-	const float3 center = (bounds.min_point + bounds.max_point) * 0.5f;
-
-	for (int i = 0; i < 8; ++i)
-	{
-		geom::aabb<float> child_bounds;
-		for (int j = 0; j < 3; ++j)
-		{
-			child_bounds.min_point[j] = std::min<float>(corners[i][j], center[j]);
-			child_bounds.max_point[j] = std::max<float>(corners[i][j], center[j]);
-		}
-
-		children[i] = new cube_tree(child_bounds, max_depth, depth + 1);
-	}
-}
-
 subterrain::subterrain(entity::registry& registry, ::resource_manager* resource_manager):
 	updatable(registry),
-	resource_manager(resource_manager)
+	resource_manager(resource_manager),
+	partition_count(1),
+	next_partition(0),
+	generation(0),
+	busy_worker_count(0),
+	stopping(false)
 {
 
 	// Load subterrain materials
@@ -215,20 +72,19 @@ subterrain::subterrain(entity::registry& registry, ::resource_manager* resource_
 	subterrain_outside_group->set_start_index(0);
 	subterrain_outside_group->set_index_count(0);
 
-	// Determine vertex size (position, normal, barycentric)
-	subterrain_model_vertex_size = 3 + 3 + 3;
-	subterrain_model_vertex_stride = subterrain_model_vertex_size * sizeof(float);
+	// Determine vertex stride (position, normal, barycentric)
+	subterrain_model_vertex_stride = sizeof(float) * 3 + sizeof(float) * 3 + sizeof(std::uint8_t) * 4;
 	
 	// Bind vertex attributes
 	gl::vertex_buffer* vbo = subterrain_model->get_vertex_buffer();
 	gl::vertex_array* vao = subterrain_model->get_vertex_array();
 	std::size_t offset = 0;
 	vao->bind_attribute(VERTEX_POSITION_LOCATION, *vbo, 3, gl::vertex_attribute_type::float_32, subterrain_model_vertex_stride, 0);
-	offset += 3;
-	vao->bind_attribute(VERTEX_NORMAL_LOCATION, *vbo, 3, gl::vertex_attribute_type::float_32, subterrain_model_vertex_stride, sizeof(float) * offset);
-	offset += 3;
-	vao->bind_attribute(VERTEX_BARYCENTRIC_LOCATION, *vbo, 3, gl::vertex_attribute_type::float_32, subterrain_model_vertex_stride, sizeof(float) * offset);
-	offset += 3;
+	offset += sizeof(float) * 3;
+	vao->bind_attribute(VERTEX_NORMAL_LOCATION, *vbo, 3, gl::vertex_attribute_type::float_32, subterrain_model_vertex_stride, offset);
+	offset += sizeof(float) * 3;
+	vao->bind_attribute(VERTEX_BARYCENTRIC_LOCATION, *vbo, 3, gl::vertex_attribute_type::unorm_8, subterrain_model_vertex_stride, offset);
+	offset += sizeof(std::uint8_t) * 4;
 
 	// Calculate adjusted bounds to fit isosurface resolution
 	//isosurface_resolution = 0.325f;
@@ -244,19 +100,26 @@ subterrain::subterrain(entity::registry& registry, ::resource_manager* resource_
 	// Set subterrain model bounds
 	subterrain_model->set_bounds(subterrain_bounds);
 
-	// Allocate cube tree
-	cube_tree = new entity::system::cube_tree(subterrain_bounds, octree_depth);
-
-	// Allocate mesh
-	subterrain_mesh = new geom::mesh();
+	// Allocate distance field, with a band of two cells about the isosurface
+	const std::uint32_t cell_count = static_cast<std::uint32_t>(1) << octree_depth;
+	subterrain_field = new geom::sdf_brick_map(subterrain_bounds.min_point, isosurface_resolution, uint3{cell_count, cell_count, cell_count}, isosurface_resolution * 2.0f);
 
 	first_run = true;
 }
 
 subterrain::~subterrain()
 {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	condition.notify_all();
+	
+	for (std::thread& worker: workers)
+		worker.join();
+	
 	delete subterrain_model;
-	delete subterrain_mesh;
+	delete subterrain_field;
 }
 
 void subterrain::update(double t, double dt)
@@ -302,184 +165,177 @@ void subterrain::set_scene(scene::collection* collection)
 
 void subterrain::regenerate_subterrain_mesh()
 {
-	delete subterrain_mesh;
-	subterrain_mesh = new geom::mesh();
 	subterrain_vertices.clear();
 	subterrain_triangles.clear();
-	subterrain_vertex_map.clear();
 
 	//std::cout << "marching...\n";
-	merged = 0;
-	march(cube_tree);
-	//std::cout << "merged " << merged << " vertices\n";
+	subterrain_field->polygonize(subterrain_vertices, subterrain_triangles);
 	//std::cout << "marching...done\n";
 
-	//std::cout << "vertex count: " << subterrain_vertices.size() << std::endl;
-	//std::cout << "triangle count: " << subterrain_triangles.size() << std::endl;
-
-	//std::cout << "creating mesh...\n";
-	create_triangle_mesh(*subterrain_mesh, subterrain_vertices, subterrain_triangles);
-	//std::cout << "creating mesh... done\n";
+	//std::cout << "vertex count: " << subterrain_vertices.size() / 3 << std::endl;
+	//std::cout << "triangle count: " << subterrain_triangles.size() / 3 << std::endl;
 }
 
-void subterrain::march(entity::system::cube_tree* node)
+void subterrain::regenerate_subterrain_model()
 {
-	if (!node->is_leaf())
-	{
-		for (entity::system::cube_tree* child: node->children)
-			march(child);
-		return;
-	}
-	else if (node->depth != node->max_depth)
+	const std::size_t vertex_count = subterrain_vertices.size() / 3;
+	const std::size_t index_count = subterrain_triangles.size();
+	const float3* positions = reinterpret_cast<const float3*>(subterrain_vertices.data());
+	
+	// Accumulate area-weighted face normals into per-partition partial sums, so triangles can be scattered without contention
+	const std::size_t triangle_count = index_count / 3;
+	partition_count = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, std::max<std::size_t>(triangle_count / 4096, 1));
+	subterrain_normals.resize(vertex_count * partition_count);
+	if (partition_count == 1)
 	{
-		return;
+		accumulate_normals(0);
 	}
-
-	// Get node bounds
-	const geom::aabb<float>& bounds = node->get_bounds();
-
-	// Polygonize cube
-	float vertex_buffer[12 * 3];
-	std::uint_fast8_t vertex_count;
-	std::int_fast8_t triangle_buffer[5 * 3];
-	std::uint_fast8_t triangle_count;
-	const float* corners = &node->corners[0][0];
-	const float* distances = &node->distances[0];
-	geom::mc::polygonize(vertex_buffer, &vertex_count, triangle_buffer, &triangle_count, corners, distances);
-
-	// Remap local vertex buffer indices (0-11) to mesh vertex indices
-	std::uint_fast32_t vertex_remap[12];
-	for (int i = 0; i < vertex_count; ++i)
+	else
 	{
-		const float3& vertex = reinterpret_cast<const float3&>(vertex_buffer[i * 3]);
-
-		if (auto it = subterrain_vertex_map.find(vertex); it != subterrain_vertex_map.end())
+		// Start worker threads, leaving one hardware thread for the updating thread, which accumulates partitions as well
+		if (workers.empty())
 		{
-			vertex_remap[i] = it->second;
-			++merged;
+			const std::size_t worker_count = std::max<std::size_t>(std::thread::hardware_concurrency(), 2) - 1;
+			for (std::size_t i = 0; i < worker_count; ++i)
+				workers.emplace_back(&subterrain::work, this);
 		}
-		else
+		
+		// Wake the workers
 		{
-			vertex_remap[i] = subterrain_vertices.size();
-			subterrain_vertex_map[vertex] = subterrain_vertices.size();
-			subterrain_vertices.push_back(vertex);
+			std::lock_guard<std::mutex> lock(mutex);
+			next_partition = 0;
+			busy_worker_count = workers.size();
+			++generation;
 		}
+		condition.notify_all();
+		
+		accumulate_partitions();
+		
+		// Wait until every worker has finished, so no partition is written while they are reduced
+		std::unique_lock<std::mutex> lock(mutex);
+		done_condition.wait(lock, [this]{return !busy_worker_count;});
 	}
-
-	// Add triangles
-	for (std::uint_fast32_t i = 0; i < triangle_count; ++i)
+	
+	// Reduce partial sums into the first partition
+	for (std::size_t i = 1; i < partition_count; ++i)
 	{
-		subterrain_triangles.push_back(
-			{
-				vertex_remap[triangle_buffer[i * 3]],
-				vertex_remap[triangle_buffer[i * 3 + 1]],
-				vertex_remap[triangle_buffer[i * 3 + 2]]
-			});
+		const float3* normals = subterrain_normals.data() + i * vertex_count;
+		for (std::size_t j = 0; j < vertex_count; ++j)
+			subterrain_normals[j] += normals[j];
 	}
-}
-
-void subterrain::regenerate_subterrain_model()
-{
-	float3* face_normals = new float3[subterrain_mesh->get_faces().size()];
-	calculate_face_normals(face_normals, *subterrain_mesh);
-
-	static const float3 barycentric_coords[3] =
+	
+	// Build interleaved vertices (position, normal, barycentric)
+	const std::size_t vertex_size = 9;
+	subterrain_model_vertices.resize(vertex_count * vertex_size);
+	for (std::size_t i = 0; i < vertex_count; ++i)
 	{
-		float3{1, 0, 0},
-		float3{0, 1, 0},
-		float3{0, 0, 1}
-	};
-
-	float* vertex_data = new float[subterrain_model_vertex_size * subterrain_mesh->get_faces().size() * 3];
-	float* v = vertex_data;
-	for (std::size_t i = 0; i < subterrain_mesh->get_faces().size(); ++i)
+		const float3& position = positions[i];
+		const float3& normal = subterrain_normals[i];
+		const float normal_length = math::length(normal);
+		const float normal_scale = (normal_length > 0.0f) ? 1.0f / normal_length : 0.0f;
+		
+		float* v = &subterrain_model_vertices[i * vertex_size];
+		v[0] = position.x;
+		v[1] = position.y;
+		v[2] = position.z;
+		v[3] = normal.x * normal_scale;
+		v[4] = normal.y * normal_scale;
+		v[5] = normal.z * normal_scale;
+		v[6] = 0.0f;
+		v[7] = 0.0f;
+		v[8] = 0.0f;
+	}
+	
+	// Assign barycentric coordinates, duplicating vertices where necessary
+	subterrain_model_indices.assign(subterrain_triangles.begin(), subterrain_triangles.end());
+	const std::size_t model_vertex_count = assign_barycentric_coordinates(subterrain_model_vertices, vertex_size, 6, subterrain_model_indices.data(), index_count);
+	
+	// Pack vertices
+	subterrain_model_vertex_data.resize(model_vertex_count * subterrain_model_vertex_stride);
+	for (std::size_t i = 0; i < model_vertex_count; ++i)
 	{
-		geom::mesh::face* face = subterrain_mesh->get_faces()[i];
-		geom::mesh::edge* ab = face->edge;
-		geom::mesh::edge* bc = face->edge->next;
-		geom::mesh::edge* ca = face->edge->previous;
-		geom::mesh::vertex* a = ab->vertex;
-		geom::mesh::vertex* b = bc->vertex;
-		geom::mesh::vertex* c = ca->vertex;
-		geom::mesh::vertex* vertices[3] = {a, b, c};
-
-		for (std::size_t j = 0; j < 3; ++j)
-		{
-			geom::mesh::vertex* vertex = vertices[j];
-
-			float3 n = {0, 0, 0};
-			geom::mesh::edge* start = vertex->edge;
-			geom::mesh::edge* edge = start;
-			do
-			{
-				if (edge->face)
-				{
-					n += face_normals[edge->face->index];
-				}
-
-				edge = edge->previous->symmetric;
-			}
-			while (edge != start);
-			n = math::normalize(n);
-
-			//float3 n = reinterpret_cast<const float3&>(face_normals[i * 3]);
-
-			*(v++) = vertex->position[0];
-			*(v++) = vertex->position[1];
-			*(v++) = vertex->position[2];
-
-			*(v++) = n[0];
-			*(v++) = n[1];
-			*(v++) = n[2];
-
-			*(v++) = barycentric_coords[j][0];
-			*(v++) = barycentric_coords[j][1];
-			*(v++) = barycentric_coords[j][2];
-		}
+		const float* v = &subterrain_model_vertices[i * vertex_size];
+		std::uint8_t* destination = &subterrain_model_vertex_data[i * subterrain_model_vertex_stride];
+		std::memcpy(destination, v, sizeof(float) * 6);
+		encode_barycentric(destination + sizeof(float) * 6, float3{v[6], v[7], v[8]});
 	}
-
-	// Resized VBO and upload vertex data
+	
+	// Upload vertices, growing the VBO geometrically when it's too small
 	gl::vertex_buffer* vbo = subterrain_model->get_vertex_buffer();
-	vbo->resize(subterrain_mesh->get_faces().size() * 3 * subterrain_model_vertex_stride, vertex_data);
-
-	// Deallocate vertex data
-	delete[] face_normals;
-	delete[] vertex_data;
-
+	const std::size_t vertex_data_size = subterrain_model_vertex_data.size();
+	if (vertex_data_size > vbo->get_size())
+		vbo->resize(vertex_data_size + vertex_data_size / 2);
+	vbo->update(0, vertex_data_size, subterrain_model_vertex_data.data());
+	
+	// Upload indices
+	subterrain_model->set_indices(subterrain_model_indices.data(), index_count, model_vertex_count);
+	
 	// Update model groups
-	subterrain_inside_group->set_index_count(subterrain_mesh->get_faces().size() * 3);
-	subterrain_outside_group->set_index_count(subterrain_mesh->get_faces().size() * 3);
+	subterrain_inside_group->set_index_count(index_count);
+	subterrain_outside_group->set_index_count(index_count);
 }
 
-void subterrain::dig(const float3& position, float radius)
+void subterrain::accumulate_normals(std::size_t partition)
 {
-	// Construct region containing the cavity sphere
-	geom::aabb<float> region = {position, position};
-	for (int i = 0; i < 3; ++i)
+	const std::size_t vertex_count = subterrain_vertices.size() / 3;
+	const std::size_t triangle_count = subterrain_triangles.size() / 3;
+	const float3* positions = reinterpret_cast<const float3*>(subterrain_vertices.data());
+	const std::uint32_t* triangles = subterrain_triangles.data();
+	
+	const std::size_t triangles_per_partition = (triangle_count + partition_count - 1) / partition_count;
+	const std::size_t triangle_begin = std::min(partition * triangles_per_partition, triangle_count);
+	const std::size_t triangle_end = std::min(triangle_begin + triangles_per_partition, triangle_count);
+	float3* normals = subterrain_normals.data() + partition * vertex_count;
+	
+	std::fill(normals, normals + vertex_count, float3{0, 0, 0});
+	for (std::size_t i = triangle_begin; i < triangle_end; ++i)
 	{
-		region.min_point[i] -= radius + isosurface_resolution;
-		region.max_point[i] += radius + isosurface_resolution;
+		const std::uint32_t a = triangles[i * 3];
+		const std::uint32_t b = triangles[i * 3 + 1];
+		const std::uint32_t c = triangles[i * 3 + 2];
+		const float3 n = math::cross(positions[b] - positions[a], positions[c] - positions[a]);
+		normals[a] += n;
+		normals[b] += n;
+		normals[c] += n;
 	}
+}
 
-	// Subdivide the octree to the maximum depth within the region
-	cube_tree->subdivide_max(region);
+void subterrain::accumulate_partitions()
+{
+	for (std::size_t i = next_partition++; i < partition_count; i = next_partition++)
+		accumulate_normals(i);
+}
 
-	// Query all octree leaf nodes within the region
-	std::list<entity::system::cube_tree*> nodes;
-	cube_tree->visit_leaves(region,
-		[&position, radius](entity::system::cube_tree& node)
+void subterrain::work()
+{
+	std::size_t last_generation = 0;
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [&]{return stopping || generation != last_generation;});
+			if (stopping)
+				return;
+			
+			last_generation = generation;
+		}
+		
+		accumulate_partitions();
+		
+		bool done;
 		{
-			for (int i = 0; i < 8; ++i)
-			{
-				// For outside normals (also set node initial distance to +infinity)
-				//float distance = math::length(node->corners[i] - position) - radius;
-				// if (distance < node->distances[i])
+			std::lock_guard<std::mutex> lock(mutex);
+			done = !--busy_worker_count;
+		}
+		if (done)
+			done_condition.notify_one();
+	}
+}
 
-				float distance = radius - math::length(node.corners[i] - position);
-				if (distance > node.distances[i])
-					node.distances[i] = distance;
-			}
-		});
+void subterrain::dig(const float3& position, float radius)
+{
+	// Carve the cavity sphere out of the distance field
+	subterrain_field->stamp_sphere(position, radius);
 }
 
 } // namespace system
@@ -21,12 +21,17 @@
 #define ANTKEEPER_ENTITY_SYSTEM_SUBTERRAIN_HPP
 
 #include "entity/systems/updatable.hpp"
-#include "geom/mesh.hpp"
 #include "geom/aabb.hpp"
+#include "geom/sdf-brick-map.hpp"
 #include "scene/collection.hpp"
 #include "scene/model-instance.hpp"
 #include "utility/fundamental-types.hpp"
-#include <unordered_map>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 class resource_manager;
 class model;
@@ -36,60 +41,17 @@ class material;
 namespace entity {
 namespace system {
 
-struct cube_tree;
-
-template <std::int64_t Mantissa, std::int64_t Exponent>
-struct epsilon
-{
-	static const double value;
-};
-
-template <std::int64_t Mantissa, std::int64_t Exponent>
-const double epsilon<Mantissa, Exponent>::value = static_cast<double>(Mantissa) * std::pow(10.0, Exponent);
-
-typedef epsilon<1, -5> epsilon_1en5;
-
-template <class Epsilon, class T, std::size_t N>
-struct vector_hasher
-{
-	typedef math::vector<T, N> vector_type;
-
-	std::size_t operator()(const vector_type& v) const noexcept
-	{
-		static const T inverse_epsilon = T(1) / Epsilon::value;
-
-		std::size_t hash = 0;
-		for (std::size_t i = 0; i < N; ++i)
-		{
-			std::int64_t j = static_cast<std::int64_t>(v[i] * inverse_epsilon);
-			hash ^= std::hash<std::int64_t>()(j) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
-		}
-
-		return hash;
-	}
-};
-
-template <class Epsilon, class T, std::size_t N>
-struct vector_equals
-{
-	typedef math::vector<T, N> vector_type;
-
-	bool operator()(const vector_type& a, const vector_type& b) const noexcept
-	{
-		for (std::size_t i = 0; i < N; ++i)
-		{
-			if (std::fabs(b[i] - a[i]) >= Epsilon::value)
-				return false;
-		}
-
-		return true;
-	}
-};
-
+/**
+ * Carves cavities out of a distance field and polygonizes it into the subterrain model.
+ *
+ * Vertex normals are accumulated in parallel partitions by the updating thread and a set of worker threads. The workers are started the first time a mesh is large enough to split, and are reused by every later regeneration.
+ */
 class subterrain: public updatable
 {
 public:
 	subterrain(entity::registry& registry, ::resource_manager* resource_manager);
+	
+	/// Stops the worker threads.
 	~subterrain();
 	virtual void update(double t, double dt);
 	
@@ -97,36 +59,49 @@ public:
 
 private:
 	void regenerate_subterrain_mesh();
-	void march(cube_tree* node);
 	void regenerate_subterrain_model();
 	void dig(const float3&position, float radius);
-	float distance(const cube_tree& node, const float3& sample) const;
+	
+	/// Accumulates the area-weighted face normals of a partition of the triangles into that partition's normals.
+	void accumulate_normals(std::size_t partition);
+	
+	/// Accumulates unclaimed partitions until none remain.
+	void accumulate_partitions();
+	
+	/// Worker thread function.
+	void work();
 
 	resource_manager* resource_manager;
-	geom::mesh* subterrain_mesh;
 	model* subterrain_model;
 	material* subterrain_inside_material;
 	material* subterrain_outside_material;
 	model_group* subterrain_inside_group;
 	model_group* subterrain_outside_group;
-	int subterrain_model_vertex_size;
 	int subterrain_model_vertex_stride;
 	geom::aabb<float> subterrain_bounds;
-	cube_tree* cube_tree;
-	std::vector<float3> subterrain_vertices;
-	std::vector<std::array<std::uint_fast32_t, 3>> subterrain_triangles;
+	geom::sdf_brick_map* subterrain_field;
+	std::vector<float> subterrain_vertices;
+	std::vector<std::uint32_t> subterrain_triangles;
+	std::vector<float3> subterrain_normals;
+	std::vector<float> subterrain_model_vertices;
+	std::vector<std::uint32_t> subterrain_model_indices;
+	std::vector<std::uint8_t> subterrain_model_vertex_data;
 	float isosurface_resolution;
 	bool first_run;
-	int merged;
-
-	std::unordered_map<
-		float3,
-		std::uint_fast32_t,
-		vector_hasher<epsilon_1en5, float, 3>,
-		vector_equals<epsilon_1en5, float, 3>> subterrain_vertex_map;
 	
 	scene::collection* collection;
 	scene::model_instance* subterrain_model_instance;
+	
+	// State shared with worker threads
+	std::size_t partition_count;
+	std::atomic<std::size_t> next_partition;
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::condition_variable done_condition;
+	std::vector<std::thread> workers;
+	std::size_t generation;
+	std::size_t busy_worker_count;
+	bool stopping;
 };
 
 } // namespace system
@@ -30,9 +30,14 @@
 #include "math/constants.hpp"
 #include "math/quaternion-operators.hpp"
 #include "renderer/vertex-attributes.hpp"
+#include "renderer/geometry-optimization.hpp"
+#include "renderer/vertex-quantization.hpp"
 #include "utility/fundamental-types.hpp"
+#include <algorithm>
+#include <cstring>
 #include <functional>
 #include <iostream>
+#include <limits>
 
 namespace entity {
 namespace system {
@@ -40,12 +45,15 @@ namespace system {
 terrain::terrain(entity::registry& registry):
 	updatable(registry),
 	patch_subdivisions(0),
-	patch_base_mesh(nullptr),
-	patch_vertex_size(0),
+	patch_vertex_stride(0),
 	patch_vertex_count(0),
 	patch_vertex_data(nullptr),
+	patch_index_count(0),
+	patch_index_buffer(nullptr),
+	patch_index_type(gl::element_array_type::uint_16),
 	patch_scene_collection(nullptr),
-	max_error(0.0)
+	max_error(0.0),
+	deferred(false)
 {
 	// Build set of quaternions to rotate quadtree cube coordinates into BCBF space according to face index
 	face_rotations[0] = math::quaternion<double>::identity();                       // +x
@@ -55,10 +63,9 @@ terrain::terrain(entity::registry& registry):
 	face_rotations[4] = math::quaternion<double>::rotate_y(-math::half_pi<double>); // +z
 	face_rotations[5] = math::quaternion<double>::rotate_y( math::half_pi<double>); // -z
 	
-	// Specify vertex size and stride
+	// Specify vertex stride
 	// (position + uv + normal + tangent + barycentric + target)
-	patch_vertex_size = 3 + 2 + 3 + 4 + 3 + 3;
-	patch_vertex_stride = patch_vertex_size * sizeof(float);
+	patch_vertex_stride = sizeof(float) * 3 + sizeof(float) * 2 + sizeof(float) * 3 + sizeof(float) * 4 + sizeof(std::uint8_t) * 4 + sizeof(float) * 3;
 	
 	// Init patch subdivisions to zero
 	set_patch_subdivisions(0);
@@ -68,10 +75,21 @@ terrain::terrain(entity::registry& registry):
 }
 
 terrain::~terrain()
-{}
+{
+	for (terrain_quadsphere* quadsphere: deferred_quadspheres)
+		destroy_quadsphere(quadsphere);
+	
+	delete[] patch_vertex_data;
+	delete patch_index_buffer;
+}
 
 void terrain::update(double t, double dt)
 {
+	// Free the quadspheres of terrain components which were destroyed while deferred
+	for (terrain_quadsphere* quadsphere: deferred_quadspheres)
+		destroy_quadsphere(quadsphere);
+	deferred_quadspheres.clear();
+	
 	// Refine the level of detail of each terrain quadsphere
 	registry.view<component::terrain, component::celestial_body>().each(
 	[&](entity::id terrain_eid, const auto& terrain_component, const auto& terrain_body)
@@ -207,12 +225,12 @@ void terrain::update(double t, double dt)
 					// Construct a terrain patch
 					terrain_patch* patch = new terrain_patch();
 					
-					// Generate a patch mesh
-					patch->mesh = generate_patch_mesh(i, *node_it, terrain_body.radius, terrain_component.elevation);
-					//patch->mesh = generate_patch_mesh(i, *node_it, 50.0, terrain_component.elevation);
+					// Generate patch vertices
+					generate_patch_vertices(i, *node_it, terrain_body.radius, terrain_component);
+					//generate_patch_vertices(i, *node_it, 50.0, terrain_component);
 					
 					// Generate a patch model
-					patch->model = generate_patch_model(*patch->mesh, terrain_component.patch_material);
+					patch->model = generate_patch_model(terrain_component.patch_material);
 					
 					// Construct patch model instance
 					patch->model_instance = new scene::model_instance(patch->model);
@@ -246,13 +264,12 @@ void terrain::set_patch_subdivisions(std::uint8_t n)
 	
 	// Rebuid patch base mesh
 	{
-		delete patch_base_mesh;
-		patch_base_mesh = geom::meshes::grid_xy(2.0f, patch_subdivisions, patch_subdivisions);
+		geom::mesh* grid = geom::meshes::grid_xy(2.0f, patch_subdivisions, patch_subdivisions);
 		
 		// Convert quads to triangle fans
-		for (std::size_t i = 0; i < patch_base_mesh->get_faces().size(); ++i)
+		for (std::size_t i = 0; i < grid->get_faces().size(); ++i)
 		{
-			geom::mesh::face* face = patch_base_mesh->get_faces()[i];
+			geom::mesh::face* face = grid->get_faces()[i];
 			
 			std::size_t edge_count = 1;
 			for (geom::mesh::edge* edge = face->edge->next; edge != face->edge; edge = edge->next)
@@ -260,26 +277,96 @@ void terrain::set_patch_subdivisions(std::uint8_t n)
 			
 			if (edge_count > 3)
 			{
-				geom::poke_face(*patch_base_mesh, face->index);
+				geom::poke_face(*grid, face->index);
 				--i;
 			}
 		}
+		
+		// Transform grid coordinates to match the front face of a BCBF cube, where x = 1
+		const math::quaternion<float> xy_to_zy = math::quaternion<float>::rotate_y(-math::half_pi<float>);
+		const std::vector<geom::mesh::vertex*>& grid_vertices = grid->get_vertices();
+		patch_base_y.resize(grid_vertices.size());
+		patch_base_z.resize(grid_vertices.size());
+		for (std::size_t i = 0; i < grid_vertices.size(); ++i)
+		{
+			const float3 position = xy_to_zy * grid_vertices[i]->position;
+			patch_base_y[i] = static_cast<double>(position.y);
+			patch_base_z[i] = static_cast<double>(position.z);
+		}
+		
+		// Store grid triangles
+		patch_base_triangles.clear();
+		patch_base_triangles.reserve(grid->get_faces().size() * 3);
+		for (const geom::mesh::face* face: grid->get_faces())
+		{
+			patch_base_triangles.push_back(static_cast<std::uint32_t>(face->edge->vertex->index));
+			patch_base_triangles.push_back(static_cast<std::uint32_t>(face->edge->next->vertex->index));
+			patch_base_triangles.push_back(static_cast<std::uint32_t>(face->edge->previous->vertex->index));
+		}
+		
+		delete grid;
 	}
 	
-	// Transform patch base mesh coordinates to match the front face of a BCBF cube
-	const math::quaternion<float> xy_to_zy = math::quaternion<float>::rotate_y(-math::half_pi<float>);
-	for (geom::mesh::vertex* vertex: patch_base_mesh->get_vertices())
+	// Resize patch generation buffers
+	const std::size_t base_vertex_count = patch_base_y.size();
+	patch_x.resize(base_vertex_count);
+	patch_y.resize(base_vertex_count);
+	patch_z.resize(base_vertex_count);
+	patch_latitudes.resize(base_vertex_count);
+	patch_longitudes.resize(base_vertex_count);
+	patch_elevations.resize(base_vertex_count);
+	patch_positions.resize(base_vertex_count);
+	patch_normals.resize(base_vertex_count);
+	
+	// Build patch triangle list from base grid vertex indices
+	std::vector<std::uint32_t> indices(patch_base_triangles);
+	patch_index_count = indices.size();
+	
+	// Optimize triangle order for the vertex cache
+	optimize_vertex_cache(indices.data(), indices.size(), base_vertex_count);
+	
+	// Assign barycentric coordinates along the optimized triangle order, splitting shared vertices where necessary. Each vertex is tagged with the index of its source base mesh vertex.
+	std::vector<float> vertices(base_vertex_count * 4, 0.0f);
+	for (std::size_t i = 0; i < base_vertex_count; ++i)
+		vertices[i * 4] = static_cast<float>(i);
+	std::size_t vertex_count = assign_barycentric_coordinates(vertices, 4, 1, indices.data(), indices.size());
+	
+	// Reoptimize triangle order for the vertex cache and order vertices by first use
+	optimize_vertex_cache(indices.data(), indices.size(), vertex_count);
+	std::vector<std::uint32_t> remap(vertex_count);
+	patch_vertex_count = optimize_vertex_fetch(remap.data(), indices.data(), indices.size(), vertex_count);
+	remap_indices(indices.data(), indices.size(), remap.data());
+	
+	// Build per-vertex source and barycentric corner tables
+	patch_vertex_sources.resize(patch_vertex_count);
+	patch_vertex_corners.resize(patch_vertex_count);
+	for (std::size_t i = 0; i < vertex_count; ++i)
 	{
-		vertex->position = xy_to_zy * vertex->position;
-		vertex->position.x = 1.0f;
+		if (remap[i] == ~std::uint32_t(0))
+			continue;
+		
+		const float* vertex = &vertices[i * 4];
+		patch_vertex_sources[remap[i]] = static_cast<std::uint32_t>(vertex[0]);
+		patch_vertex_corners[remap[i]] = (vertex[1] > 0.0f) ? 0 : ((vertex[2] > 0.0f) ? 1 : 2);
 	}
 	
-	// Recalculate number of vertices per patch
-	patch_vertex_count = patch_base_mesh->get_faces().size() * 3;
+	// Upload patch indices, which are shared by all patches
+	delete patch_index_buffer;
+	if (patch_vertex_count <= 0x10000)
+	{
+		std::vector<std::uint16_t> short_indices(indices.begin(), indices.end());
+		patch_index_buffer = new gl::vertex_buffer(short_indices.size() * sizeof(std::uint16_t), short_indices.data());
+		patch_index_type = gl::element_array_type::uint_16;
+	}
+	else
+	{
+		patch_index_buffer = new gl::vertex_buffer(indices.size() * sizeof(std::uint32_t), indices.data());
+		patch_index_type = gl::element_array_type::uint_32;
+	}
 	
 	// Resize patch vertex data buffer
 	delete[] patch_vertex_data;
-	patch_vertex_data = new float[patch_vertex_count * patch_vertex_size];
+	patch_vertex_data = new std::uint8_t[patch_vertex_count * patch_vertex_stride];
 }
 
 void terrain::set_patch_scene_collection(scene::collection* collection)
@@ -292,6 +379,11 @@ void terrain::set_max_error(double error)
 	max_error = error;
 }
 
+void terrain::set_deferred(bool deferred)
+{
+	this->deferred = deferred;
+}
+
 void terrain::on_terrain_construct(entity::registry& registry, entity::id entity_id, component::terrain& component)
 {
 	terrain_quadsphere* quadsphere = new terrain_quadsphere();
@@ -302,40 +394,47 @@ void terrain::on_terrain_destroy(entity::registry& registry, entity::id entity_i
 {
 	// Find terrain quadsphere for the given entity ID
 	auto quadsphere_it = terrain_quadspheres.find(entity_id);
+	if (quadsphere_it == terrain_quadspheres.end())
+		return;
+	
+	terrain_quadsphere* quadsphere = quadsphere_it->second;
+	
+	// Remove terrain quadsphere from the map
+	terrain_quadspheres.erase(quadsphere_it);
 	
-	if (quadsphere_it != terrain_quadspheres.end())
+	// Free the terrain quadsphere now, or on the next update if deferred
+	if (deferred)
+		deferred_quadspheres.push_back(quadsphere);
+	else
+		destroy_quadsphere(quadsphere);
+}
+
+void terrain::destroy_quadsphere(terrain_quadsphere* quadsphere)
+{
+	// For each terrain quadsphere face
+	for (int i = 0; i < 6; ++i)
 	{
-		terrain_quadsphere* quadsphere = quadsphere_it->second;
+		terrain_quadsphere_face& quadsphere_face = quadsphere->faces[i];
 		
-		// For each terrain quadsphere face
-		for (int i = 0; i < 6; ++i)
+		for (auto patch_it = quadsphere_face.patches.begin(); patch_it != quadsphere_face.patches.end(); ++patch_it)
 		{
-			terrain_quadsphere_face& quadsphere_face = quadsphere->faces[i];
+			terrain_patch* patch = patch_it->second;
 			
-			for (auto patch_it = quadsphere_face.patches.begin(); patch_it != quadsphere_face.patches.end(); ++patch_it)
-			{
-				terrain_patch* patch = patch_it->second;
-				
-				if (patch_scene_collection)
-					patch_scene_collection->remove_object(patch->model_instance);
-				
-				delete patch->model_instance;
-				delete patch->model;
-				delete patch->mesh;
-				
-				delete patch;
-			}
+			if (patch_scene_collection)
+				patch_scene_collection->remove_object(patch->model_instance);
+			
+			delete patch->model_instance;
+			delete patch->model;
+			
+			delete patch;
 		}
-		
-		// Free terrain quadsphere
-		delete quadsphere;
 	}
 	
-	// Remove terrain quadsphere from the map
-	terrain_quadspheres.erase(quadsphere_it);
+	// Free terrain quadsphere
+	delete quadsphere;
 }
 
-geom::mesh* terrain::generate_patch_mesh(std::uint8_t face_index, quadtree_node_type node, double body_radius, const std::function<double(double, double)>& elevation) const
+void terrain::generate_patch_vertices(std::uint8_t face_index, quadtree_node_type node, double body_radius, const entity::component::terrain& terrain_component)
 {
 	// Extract node depth
 	const quadtree_type::node_type depth = quadtree_type::depth(node);
@@ -358,54 +457,100 @@ geom::mesh* terrain::generate_patch_mesh(std::uint8_t face_index, quadtree_node_
 	offset_y += static_cast<double>(location_x) * node_width;
 	offset_z += static_cast<double>(location_y) * node_width;
 	
-	// Copy base mesh
-	geom::mesh* patch_mesh = new geom::mesh(*patch_base_mesh);
+	// Rotate cube face axes once per patch, rather than rotating every vertex
+	const math::quaternion<double>& rotation = face_rotations[face_index];
+	const double3 axis_x = rotation * double3{1.0, 0.0, 0.0};
+	const double3 axis_y = rotation * double3{0.0, 1.0, 0.0};
+	const double3 axis_z = rotation * double3{0.0, 0.0, 1.0};
+	
+	const std::size_t vertex_count = patch_base_y.size();
+	const double* base_y = patch_base_y.data();
+	const double* base_z = patch_base_z.data();
+	double* x = patch_x.data();
+	double* y = patch_y.data();
+	double* z = patch_z.data();
 	
-	// Modify patch mesh vertex positions
-	for (geom::mesh::vertex* v: patch_mesh->get_vertices())
+	// Offset and scale base grid coordinates, then rotate according to cube face
+	for (std::size_t i = 0; i < vertex_count; ++i)
 	{
-		double3 position = math::type_cast<double>(v->position);
-		
-		// Offset and scale vertex position
-		position.y *= scale_yz;
-		position.z *= scale_yz;
-		position.y += offset_y;
-		position.z += offset_z;
-
-		// Rotate according to cube face
-		position = face_rotations[face_index] * position;
-		
-		// Project onto unit sphere
-		//position = math::normalize(position);
-		
-		// Cartesian Spherical Cube projection (KSC)
-		/// @see https://catlikecoding.com/unity/tutorials/cube-sphere/
-		/// @see https://core.ac.uk/download/pdf/228552506.pdf
-		double xx = position.x * position.x;
-		double yy = position.y * position.y;
-		double zz = position.z * position.z;
-		position.x *= std::sqrt(std::max(0.0, 1.0 - yy * 0.5 - zz * 0.5 + yy * zz / 3.0));
-		position.y *= std::sqrt(std::max(0.0, 1.0 - xx * 0.5 - zz * 0.5 + xx * zz / 3.0));
-		position.z *= std::sqrt(std::max(0.0, 1.0 - xx * 0.5 - yy * 0.5 + xx * yy / 3.0));
-		
-		// Calculate latitude and longitude of vertex position
-		const double latitude = std::atan2(position.z, std::sqrt(position.x * position.x + position.y * position.y));
-		const double longitude = std::atan2(position.y, position.x);
-		
-		// Look up elevation at latitude and longitude and use to calculate radial distance
-		const double radial_distance = body_radius + elevation(latitude, longitude);
-		
-		// Scale vertex position by radial distance
-		position *= radial_distance;
-		position.y -= body_radius;
-		
-		v->position = math::type_cast<float>(position);
+		const double v = base_y[i] * scale_yz + offset_y;
+		const double w = base_z[i] * scale_yz + offset_z;
+		x[i] = axis_x.x + axis_y.x * v + axis_z.x * w;
+		y[i] = axis_x.y + axis_y.y * v + axis_z.y * w;
+		z[i] = axis_x.z + axis_y.z * v + axis_z.z * w;
+	}
+	
+	// Cartesian Spherical Cube projection (KSC)
+	/// @see https://catlikecoding.com/unity/tutorials/cube-sphere/
+	/// @see https://core.ac.uk/download/pdf/228552506.pdf
+	for (std::size_t i = 0; i < vertex_count; ++i)
+	{
+		const double xx = x[i] * x[i];
+		const double yy = y[i] * y[i];
+		const double zz = z[i] * z[i];
+		const double sx = 1.0 - yy * 0.5 - zz * 0.5 + yy * zz / 3.0;
+		const double sy = 1.0 - xx * 0.5 - zz * 0.5 + xx * zz / 3.0;
+		const double sz = 1.0 - xx * 0.5 - yy * 0.5 + xx * yy / 3.0;
+		x[i] *= std::sqrt((sx > 0.0) ? sx : 0.0);
+		y[i] *= std::sqrt((sy > 0.0) ? sy : 0.0);
+		z[i] *= std::sqrt((sz > 0.0) ? sz : 0.0);
+	}
+	
+	// Calculate latitude and longitude of each vertex position
+	for (std::size_t i = 0; i < vertex_count; ++i)
+	{
+		patch_latitudes[i] = std::atan2(z[i], std::sqrt(x[i] * x[i] + y[i] * y[i]));
+		patch_longitudes[i] = std::atan2(y[i], x[i]);
+	}
+	
+	// Look up elevations at latitudes and longitudes
+	if (terrain_component.batch_elevation)
+	{
+		terrain_component.batch_elevation(patch_latitudes.data(), patch_longitudes.data(), patch_elevations.data(), vertex_count);
+	}
+	else if (terrain_component.elevation)
+	{
+		for (std::size_t i = 0; i < vertex_count; ++i)
+			patch_elevations[i] = terrain_component.elevation(patch_latitudes[i], patch_longitudes[i]);
+	}
+	else
+	{
+		std::fill(patch_elevations.begin(), patch_elevations.end(), 0.0);
+	}
+	
+	// Scale vertex positions by radial distance
+	for (std::size_t i = 0; i < vertex_count; ++i)
+	{
+		const double radial_distance = body_radius + patch_elevations[i];
+		patch_positions[i] =
+		{
+			static_cast<float>(x[i] * radial_distance),
+			static_cast<float>(y[i] * radial_distance - body_radius),
+			static_cast<float>(z[i] * radial_distance)
+		};
 	}
 	
-	return patch_mesh;
+	// Calculate area-weighted vertex normals
+	std::fill(patch_normals.begin(), patch_normals.end(), float3{0.0f, 0.0f, 0.0f});
+	for (std::size_t i = 0; i < patch_base_triangles.size(); i += 3)
+	{
+		const std::uint32_t ia = patch_base_triangles[i];
+		const std::uint32_t ib = patch_base_triangles[i + 1];
+		const std::uint32_t ic = patch_base_triangles[i + 2];
+		const float3& a = patch_positions[ia];
+		const float3& b = patch_positions[ib];
+		const float3& c = patch_positions[ic];
+		
+		const float3 normal = math::cross(b - a, c - a);
+		patch_normals[ia] += normal;
+		patch_normals[ib] += normal;
+		patch_normals[ic] += normal;
+	}
+	for (float3& normal: patch_normals)
+		normal = math::normalize(normal);
 }
 
-model* terrain::generate_patch_model(const geom::mesh& patch_mesh, material* patch_material) const
+model* terrain::generate_patch_model(material* patch_material)
 {
 	// Barycentric coordinates
 	static const float3 barycentric[3] =
@@ -416,93 +561,91 @@ model* terrain::generate_patch_model(const geom::mesh& patch_mesh, material* pat
 	};
 	
 	// Fill vertex data buffer
-	float* v = patch_vertex_data;
-	for (const geom::mesh::face* face: patch_mesh.get_faces())
+	std::uint8_t* v = patch_vertex_data;
+	for (std::size_t i = 0; i < patch_vertex_count; ++i)
 	{
-		const geom::mesh::vertex* a = face->edge->vertex;
-		const geom::mesh::vertex* b = face->edge->next->vertex;
-		const geom::mesh::vertex* c = face->edge->previous->vertex;
-		const geom::mesh::vertex* face_vertices[] = {a, b, c};
+		const std::uint32_t source = patch_vertex_sources[i];
 		
-		// Calculate facted normal
-		float3 normal = math::normalize(math::cross(b->position - a->position, c->position - a->position));
+		// Vertex position
+		std::memcpy(v, &patch_positions[source].x, sizeof(float) * 3);
+		v += sizeof(float) * 3;
 		
-		for (std::size_t i = 0; i < 3; ++i)
+		// Vertex UV coordinates (latitude, longitude)
+		const float uv[2] =
 		{
-			const geom::mesh::vertex* vertex = face_vertices[i];
-			
-			// Vertex position
-			const float3& position = vertex->position;
-			*(v++) = position.x;
-			*(v++) = position.y;
-			*(v++) = position.z;
-			
-			// Vertex UV coordinates (latitude, longitude)
-			const float latitude = std::atan2(position.z, std::sqrt(position.x * position.x + position.y * position.y));
-			const float longitude = std::atan2(position.y, position.x);
-			*(v++) = latitude;
-			*(v++) = longitude;
-			
-			// Vertex normal
-			*(v++) = normal.x;
-			*(v++) = normal.y;
-			*(v++) = normal.z;
-			
-			/// @TODO Vertex tangent
-			*(v++) = 0.0f;
-			*(v++) = 0.0f;
-			*(v++) = 0.0f;
-			*(v++) = 0.0f;
-			
-			// Vertex barycentric coordinates
-			*(v++) = barycentric[i].x;
-			*(v++) = barycentric[i].y;
-			*(v++) = barycentric[i].z;
-			
-			// Vertex morph target (LOD transition)
-			*(v++) = 0.0f;
-			*(v++) = 0.0f;
-			*(v++) = 0.0f;
-		}
+			static_cast<float>(patch_latitudes[source]),
+			static_cast<float>(patch_longitudes[source])
+		};
+		std::memcpy(v, uv, sizeof(uv));
+		v += sizeof(uv);
+		
+		// Vertex normal
+		std::memcpy(v, &patch_normals[source].x, sizeof(float) * 3);
+		v += sizeof(float) * 3;
+		
+		/// @TODO Vertex tangent
+		std::memset(v, 0, sizeof(float) * 4);
+		v += sizeof(float) * 4;
+		
+		// Vertex barycentric coordinates
+		encode_barycentric(v, barycentric[patch_vertex_corners[i]]);
+		v += sizeof(std::uint8_t) * 4;
+		
+		// Vertex morph target (LOD transition)
+		std::memset(v, 0, sizeof(float) * 3);
+		v += sizeof(float) * 3;
 	}
 	
-	// Get triangle count of patch mesh
-	std::size_t patch_triangle_count = patch_mesh.get_faces().size();
-	
 	// Allocate patch model
 	model* patch_model = new model();
 
 	// Resize model VBO and upload vertex data
 	gl::vertex_buffer* vbo = patch_model->get_vertex_buffer();
-	vbo->resize(patch_triangle_count * 3 * patch_vertex_stride, patch_vertex_data);
+	vbo->resize(patch_vertex_count * patch_vertex_stride, patch_vertex_data);
+	
+	// Bind shared patch index buffer
+	patch_model->set_index_buffer(*patch_index_buffer, patch_index_type);
 	
 	// Bind vertex attributes to model VAO
 	gl::vertex_array* vao = patch_model->get_vertex_array();
 	std::size_t offset = 0;
 	vao->bind_attribute(VERTEX_POSITION_LOCATION, *vbo, 3, gl::vertex_attribute_type::float_32, patch_vertex_stride, 0);
-	offset += 3;
-	vao->bind_attribute(VERTEX_TEXCOORD_LOCATION, *vbo, 2, gl::vertex_attribute_type::float_32, patch_vertex_stride, sizeof(float) * offset);
-	offset += 2;
-	vao->bind_attribute(VERTEX_NORMAL_LOCATION, *vbo, 3, gl::vertex_attribute_type::float_32, patch_vertex_stride, sizeof(float) * offset);
-	offset += 3;
-	vao->bind_attribute(VERTEX_TANGENT_LOCATION, *vbo, 4, gl::vertex_attribute_type::float_32, patch_vertex_stride, sizeof(float) * offset);
-	offset += 4;
-	vao->bind_attribute(VERTEX_BARYCENTRIC_LOCATION, *vbo, 3, gl::vertex_attribute_type::float_32, patch_vertex_stride, sizeof(float) * offset);
-	offset += 3;
-	vao->bind_attribute(VERTEX_TARGET_LOCATION, *vbo, 3, gl::vertex_attribute_type::float_32, patch_vertex_stride, sizeof(float) * offset);
-	offset += 3;
+	offset += sizeof(float) * 3;
+	vao->bind_attribute(VERTEX_TEXCOORD_LOCATION, *vbo, 2, gl::vertex_attribute_type::float_32, patch_vertex_stride, offset);
+	offset += sizeof(float) * 2;
+	vao->bind_attribute(VERTEX_NORMAL_LOCATION, *vbo, 3, gl::vertex_attribute_type::float_32, patch_vertex_stride, offset);
+	offset += sizeof(float) * 3;
+	vao->bind_attribute(VERTEX_TANGENT_LOCATION, *vbo, 4, gl::vertex_attribute_type::float_32, patch_vertex_stride, offset);
+	offset += sizeof(float) * 4;
+	vao->bind_attribute(VERTEX_BARYCENTRIC_LOCATION, *vbo, 3, gl::vertex_attribute_type::unorm_8, patch_vertex_stride, offset);
+	offset += sizeof(std::uint8_t) * 4;
+	vao->bind_attribute(VERTEX_TARGET_LOCATION, *vbo, 3, gl::vertex_attribute_type::float_32, patch_vertex_stride, offset);
+	offset += sizeof(float) * 3;
 	
 	// Create model group
 	model_group* patch_model_group = patch_model->add_group("terrain");
 	patch_model_group->set_material(patch_material);
 	patch_model_group->set_drawing_mode(gl::drawing_mode::triangles);
 	patch_model_group->set_start_index(0);
-	patch_model_group->set_index_count(patch_triangle_count * 3);
+	patch_model_group->set_index_count(patch_index_count);
 	
 	// Calculate model bounds
-	geom::aabb<float> bounds = geom::calculate_bounds(patch_mesh);
+	geom::aabb<float> bounds;
+	bounds.min_point = {std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()};
+	bounds.max_point = -bounds.min_point;
+	for (const float3& position: patch_positions)
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			bounds.min_point[i] = std::min<float>(bounds.min_point[i], position[i]);
+			bounds.max_point[i] = std::max<float>(bounds.max_point[i], position[i]);
+		}
+	}
 	patch_model->set_bounds(bounds);
 	
+	// Use patch triangles as occluder
+	patch_model->set_occluder(std::vector<float3>(patch_positions), std::vector<std::uint32_t>(patch_base_triangles));
+	
 	return patch_model;
 }
 
@@ -25,13 +25,16 @@
 #include "entity/id.hpp"
 #include "math/quaternion-type.hpp"
 #include "geom/quadtree.hpp"
-#include "geom/mesh.hpp"
 #include "utility/fundamental-types.hpp"
 #include "renderer/model.hpp"
 #include "renderer/material.hpp"
 #include "scene/model-instance.hpp"
 #include "scene/collection.hpp"
+#include "gl/vertex-buffer.hpp"
+#include "gl/element-array-type.hpp"
+#include <cstdint>
 #include <unordered_map>
+#include <vector>
 
 namespace entity {
 namespace system {
@@ -67,6 +70,13 @@ public:
 	 * @param error Maximum tolerable screen-space error.
 	 */
 	void set_max_error(double error);
+	
+	/**
+	 * Enables or disables deferred scene changes. When deferred, the patches of destroyed terrain components are not removed from the scene and freed when the components are destroyed, but on the next update. This allows terrain components to be destroyed on an update thread while the scene is rendered.
+	 *
+	 * @param deferred `true` to defer scene changes until the next update, `false` to apply them immediately.
+	 */
+	void set_deferred(bool deferred);
 
 private:
 	typedef geom::quadtree64 quadtree_type;
@@ -74,7 +84,6 @@ private:
 	
 	struct terrain_patch
 	{
-		geom::mesh* mesh;
 		model* model;
 		scene::model_instance* model_instance;
 		float error;
@@ -105,30 +114,57 @@ private:
 	void on_terrain_destroy(entity::registry& registry, entity::id entity_id);
 	
 	/**
-	 * Generates a mesh for a terrain patch given the patch's quadtree node
+	 * Removes the patches of a terrain quadsphere from the scene, then frees the patches and the quadsphere.
+	 */
+	void destroy_quadsphere(terrain_quadsphere* quadsphere);
+	
+	/**
+	 * Generates the vertex positions, normals, and coordinates of a terrain patch given the patch's quadtree node. The results are stored in the patch generation buffers.
 	 */
-	geom::mesh* generate_patch_mesh(std::uint8_t face_index, quadtree_node_type node, double body_radius, const std::function<double(double, double)>& elevation) const;
+	void generate_patch_vertices(std::uint8_t face_index, quadtree_node_type node, double body_radius, const entity::component::terrain& terrain_component);
 	
 	/**
-	 * Generates a model for a terrain patch given the patch's mesh.
+	 * Generates a model for a terrain patch from the patch generation buffers.
 	 */
-	model* generate_patch_model(const geom::mesh& patch_mesh, material* patch_material) const;
+	model* generate_patch_model(material* patch_material);
 	
 	
 	
 	/// @TODO horizon culling
 	
 	std::uint8_t patch_subdivisions;
-	std::size_t patch_vertex_size;
 	std::size_t patch_vertex_stride;
 	std::size_t patch_vertex_count;
-	float* patch_vertex_data;
+	std::uint8_t* patch_vertex_data;
+	std::vector<std::uint32_t> patch_vertex_sources;
+	std::vector<std::uint8_t> patch_vertex_corners;
+	std::size_t patch_index_count;
+	gl::vertex_buffer* patch_index_buffer;
+	gl::element_array_type patch_index_type;
 	math::quaternion<double> face_rotations[6];
-	geom::mesh* patch_base_mesh;
+	
+	// Patch base grid, in the yz-plane of the front face of a BCBF cube
+	std::vector<double> patch_base_y;
+	std::vector<double> patch_base_z;
+	std::vector<std::uint32_t> patch_base_triangles;
+	
+	// Patch generation buffers, one element per base grid vertex
+	std::vector<double> patch_x;
+	std::vector<double> patch_y;
+	std::vector<double> patch_z;
+	std::vector<double> patch_latitudes;
+	std::vector<double> patch_longitudes;
+	std::vector<double> patch_elevations;
+	std::vector<float3> patch_positions;
+	std::vector<float3> patch_normals;
+	
 	scene::collection* patch_scene_collection;
 	double max_error;
 	
 	std::unordered_map<entity::id, terrain_quadsphere*> terrain_quadspheres;
+	
+	bool deferred;
+	std::vector<terrain_quadsphere*> deferred_quadspheres;
 };
 
 } // namespace system
@@ -37,7 +37,8 @@ tracking::tracking(entity::registry& registry, ::event_dispatcher* event_dispatc
 	updatable(registry),
 	event_dispatcher(event_dispatcher),
 	resource_manager(resource_manager),
-	scene_collection(nullptr)
+	scene_collection(nullptr),
+	deferred(false)
 {
 	registry.on_construct<component::trackable>().connect<&tracking::on_component_construct>(this);
 	registry.on_destroy<component::trackable>().connect<&tracking::on_component_destroy>(this);
@@ -72,12 +73,20 @@ tracking::~tracking()
 		delete it->second;
 	}
 	
+	for (scene::model_instance* tracker: deferred_trackers)
+		destroy_tracker(tracker);
+	
 	delete[] paint_ball_materials;
 }
 
 
 void tracking::update(double t, double dt)
 {
+	// Free the trackers of trackable components which were destroyed while deferred
+	for (scene::model_instance* tracker: deferred_trackers)
+		destroy_tracker(tracker);
+	deferred_trackers.clear();
+	
 	for (auto it = trackers.begin(); it != trackers.end(); ++it)
 	{
 		const component::transform& transform = registry.get<component::transform>(it->first);
@@ -98,6 +107,11 @@ void tracking::set_scene(scene::collection* collection)
 	this->scene_collection = collection;
 }
 
+void tracking::set_deferred(bool deferred)
+{
+	this->deferred = deferred;
+}
+
 void tracking::on_component_construct(entity::registry& registry, entity::id entity_id, component::trackable& component)
 {
 
@@ -107,19 +121,24 @@ void tracking::on_component_destroy(entity::registry& registry, entity::id entit
 {
 	if (auto it = trackers.find(entity_id); it != trackers.end())
 	{
-		// Remove model instance from all layers
-		/*
-		for (std::size_t i = 0; i < layers.size(); ++i)
-		{
-			layers[i]->remove_object(it->second);
-		}
-		*/
-		
-		delete it->second;
+		scene::model_instance* tracker = it->second;
 		trackers.erase(it);
+		
+		// Free the tracker now, or on the next update if deferred
+		if (deferred)
+			deferred_trackers.push_back(tracker);
+		else
+			destroy_tracker(tracker);
 	}
 }
 
+void tracking::destroy_tracker(scene::model_instance* tracker)
+{
+	if (scene_collection)
+		scene_collection->remove_object(tracker);
+	delete tracker;
+}
+
 void tracking::handle_event(const tool_pressed_event& event)
 {
 	if (registry.has<component::marker>(event.entity_id))
@@ -26,6 +26,7 @@
 #include "event/event-handler.hpp"
 #include "game/events/tool-events.hpp"
 #include <unordered_map>
+#include <vector>
 #include "scene/collection.hpp"
 #include "scene/model-instance.hpp"
 
@@ -49,9 +50,17 @@ public:
 	void set_scene(scene::collection* collection);
 	void set_viewport(const float4& viewport);
 	
+	/**
+	 * Enables or disables deferred scene changes. When deferred, the trackers of destroyed trackable components are not removed from the scene and freed when the components are destroyed, but on the next update. This allows trackable components to be destroyed on an update thread while the scene is rendered.
+	 *
+	 * @param deferred `true` to defer scene changes until the next update, `false` to apply them immediately.
+	 */
+	void set_deferred(bool deferred);
+	
 private:
 	void on_component_construct(entity::registry& registry, entity::id entity_id, entity::component::trackable& component);
 	void on_component_destroy(entity::registry& registry, entity::id entity_id);
+	void destroy_tracker(scene::model_instance* tracker);
 	virtual void handle_event(const tool_pressed_event& event);
 	virtual void handle_event(const tool_released_event& event);
 	
@@ -62,6 +71,8 @@ private:
 	model* paint_ball_model;
 	material** paint_ball_materials;
 	std::unordered_map<entity::id, scene::model_instance*> trackers;
+	bool deferred;
+	std::vector<scene::model_instance*> deferred_trackers;
 };
 
 } // namespace system
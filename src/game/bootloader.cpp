@@ -101,6 +101,8 @@
 #include "utility/timestamp.hpp"
 
 static constexpr double seconds_per_day = 24.0 * 60.0 * 60.0;
+/// Standard gravitational parameter of the sun, in cubic meters per day squared.
+static constexpr double solar_gravitational_parameter = 1.32712440018e20 * seconds_per_day * seconds_per_day;
 
 static void parse_options(game::context* ctx, int argc, char** argv);
 static void setup_resources(game::context* ctx);
@@ -115,6 +117,8 @@ static void setup_systems(game::context* ctx);
 static void setup_controls(game::context* ctx);
 static void setup_cli(game::context* ctx);
 static void setup_callbacks(game::context* ctx);
+static void update_tweens(game::context* ctx, double t);
+static void update_frame(game::context* ctx, double t, double dt);
 
 int bootloader(application* app, int argc, char** argv)
 {
@@ -179,6 +183,8 @@ void parse_options(game::context* ctx, int argc, char** argv)
 			("c,continue", "Continues from the last save")
 			("d,data", "Sets the data package path", cxxopts::value<std::string>())
 			("f,fullscreen", "Starts in fullscreen mode")
+			("fast-forward", "Runs the simulation as fast as possible, rendering at the given interval in seconds", cxxopts::value<double>())
+			("headless", "Runs the simulation as fast as possible without showing the window or rendering")
 			("n,new-game", "Starts a new game")
 			("q,quick-start", "Skips to the main menu")
 			("r,reset", "Restores all settings to default")
@@ -202,6 +208,14 @@ void parse_options(game::context* ctx, int argc, char** argv)
 		if (result.count("fullscreen"))
 			ctx->option_fullscreen = true;
 		
+		// --fast-forward
+		if (result.count("fast-forward"))
+			ctx->option_fast_forward = result["fast-forward"].as<double>();
+		
+		// --headless
+		if (result.count("headless"))
+			ctx->option_headless = true;
+		
 		// --new-game
 		if (result.count("new-game"))
 			ctx->option_new_game = true;
@@ -434,6 +448,14 @@ void setup_window(game::context* ctx)
 		vsync = (ctx->option_vsync.value() != 0);
 	else if (config->has("vsync"))
 		vsync = (config->get<int>("vsync") != 0);
+	
+	// Keep the window hidden in headless mode, and don't let v-sync throttle it
+	if (ctx->option_headless.has_value())
+	{
+		app->set_headless(true);
+		vsync = false;
+	}
+	
 	app->set_vsync(vsync);
 	
 	// Set title
@@ -481,7 +503,7 @@ void setup_rendering(game::context* ctx)
 	ctx->shadow_map_framebuffer = new gl::framebuffer(shadow_map_resolution, shadow_map_resolution);
 	ctx->shadow_map_framebuffer->attach(gl::framebuffer_attachment_type::depth, ctx->shadow_map_depth_texture);
 	
-	// Create bloom pingpong framebuffers (16F color, no depth)
+	// Create bloom framebuffer (16F color, no depth), which is the first level of the bloom mip chain
 	int bloom_width = viewport_dimensions[0] >> 1;
 	int bloom_height = viewport_dimensions[1] >> 1;
 	ctx->bloom_texture = new gl::texture_2d(bloom_width, bloom_height, gl::pixel_type::float_16, gl::pixel_format::rgb);
@@ -498,9 +520,6 @@ void setup_rendering(game::context* ctx)
 	ctx->fallback_material = ctx->resource_manager->load<material>("fallback.mtl");
 	
 	// Setup overworld compositor
-	ctx->overworld_shadow_map_clear_pass = new clear_pass(ctx->rasterizer, ctx->shadow_map_framebuffer);
-	ctx->overworld_shadow_map_clear_pass->set_cleared_buffers(false, true, false);
-	ctx->overworld_shadow_map_clear_pass->set_clear_depth(1.0f);
 	ctx->overworld_shadow_map_pass = new shadow_map_pass(ctx->rasterizer, ctx->shadow_map_framebuffer, ctx->resource_manager);
 	ctx->overworld_shadow_map_pass->set_split_scheme_weight(0.75f);
 	ctx->overworld_clear_pass = new clear_pass(ctx->rasterizer, ctx->framebuffer_hdr);
@@ -518,17 +537,23 @@ void setup_rendering(game::context* ctx)
 	ctx->overworld_outline_pass->set_outline_width(0.25f);
 	ctx->overworld_outline_pass->set_outline_color(float4{1.0f, 1.0f, 1.0f, 1.0f});
 	ctx->overworld_outline_pass->set_enabled(false);
+	float bloom_threshold = 1.0f;
+	if (ctx->config->has("bloom_threshold"))
+		bloom_threshold = ctx->config->get<float>("bloom_threshold");
+	int bloom_mip_count = 1;
+	if (ctx->config->has("bloom_mip_count"))
+		bloom_mip_count = ctx->config->get<int>("bloom_mip_count");
 	ctx->overworld_bloom_pass = new bloom_pass(ctx->rasterizer, ctx->framebuffer_bloom, ctx->resource_manager);
 	ctx->overworld_bloom_pass->set_source_texture(ctx->framebuffer_hdr_color);
-	ctx->overworld_bloom_pass->set_brightness_threshold(1.0f);
+	ctx->overworld_bloom_pass->set_brightness_threshold(bloom_threshold);
 	ctx->overworld_bloom_pass->set_blur_iterations(5);
+	ctx->overworld_bloom_pass->set_mip_count(bloom_mip_count);
 	ctx->overworld_bloom_pass->set_enabled(true);
 	ctx->overworld_final_pass = new ::final_pass(ctx->rasterizer, &ctx->rasterizer->get_default_framebuffer(), ctx->resource_manager);
 	ctx->overworld_final_pass->set_color_texture(ctx->framebuffer_hdr_color);
 	ctx->overworld_final_pass->set_bloom_texture(ctx->bloom_texture);
 	ctx->overworld_final_pass->set_blue_noise_texture(blue_noise_map);
 	ctx->overworld_compositor = new compositor();
-	ctx->overworld_compositor->add_pass(ctx->overworld_shadow_map_clear_pass);
 	ctx->overworld_compositor->add_pass(ctx->overworld_shadow_map_pass);
 	ctx->overworld_compositor->add_pass(ctx->overworld_clear_pass);
 	ctx->overworld_compositor->add_pass(ctx->overworld_sky_pass);
@@ -600,6 +625,15 @@ void setup_rendering(game::context* ctx)
 	// Create renderer
 	ctx->renderer = new renderer();
 	ctx->renderer->set_billboard_vao(ctx->billboard_vao);
+	ctx->renderer->set_viewport_height(static_cast<float>(ctx->app->get_viewport_dimensions()[1]));
+	
+	// Enable occlusion culling
+	bool occlusion_culling = true;
+	if (ctx->config->has("occlusion_culling"))
+	{
+		occlusion_culling = ctx->config->get<bool>("occlusion_culling");
+	}
+	ctx->renderer->set_occlusion_culling_enabled(occlusion_culling);
 	
 	logger->pop_task(EXIT_SUCCESS);
 }
@@ -858,6 +892,7 @@ void setup_systems(game::context* ctx)
 	
 	// Setup spatial system
 	ctx->spatial_system = new entity::system::spatial(*ctx->entity_registry);
+	ctx->behavior_system->set_spatial_system(ctx->spatial_system);
 	
 	// Setup constraint system
 	ctx->constraint_system = new entity::system::constraint(*ctx->entity_registry);
@@ -871,7 +906,7 @@ void setup_systems(game::context* ctx)
 	ctx->painting_system->set_scene(ctx->overworld_scene);
 	
 	// Setup solar system
-	ctx->orbit_system = new entity::system::orbit(*ctx->entity_registry);
+	ctx->orbit_system = new entity::system::orbit(*ctx->entity_registry, solar_gravitational_parameter);
 	
 	// Setup blackbody system
 	ctx->blackbody_system = new entity::system::blackbody(*ctx->entity_registry);
@@ -904,6 +939,7 @@ void setup_systems(game::context* ctx)
 	ctx->render_system->add_layer(ctx->underworld_scene);
 	ctx->render_system->add_layer(ctx->ui_scene);
 	ctx->render_system->set_renderer(ctx->renderer);
+	event_dispatcher->subscribe<window_resized_event>(ctx->render_system);
 	
 	// Setup control system
 	ctx->control_system = new entity::system::control(*ctx->entity_registry);
@@ -1247,66 +1283,92 @@ void setup_cli(game::context* ctx)
 
 void setup_callbacks(game::context* ctx)
 {
-	// Set update callback
-	ctx->app->set_update_callback
-	(
-		[ctx](double t, double dt)
-		{
-			// Update tweens
-			ctx->time_tween->update();
-			ctx->overworld_sky_pass->update_tweens();
-			ctx->overworld_scene->update_tweens();
-			ctx->underworld_scene->update_tweens();
-			ctx->ui_scene->update_tweens();
-			ctx->focal_point_tween->update();
-			ctx->underworld_final_pass->get_material()->update_tweens();
-			
-			// Set time tween time
-			(*ctx->time_tween)[1] = t;
-						
-			ctx->timeline->advance(dt);
-			
-			ctx->control_system->update(t, dt);
-			ctx->terrain_system->update(t, dt);
-			//ctx->vegetation_system->update(t, dt);
-			ctx->snapping_system->update(t, dt);
-			ctx->nest_system->update(t, dt);
-			ctx->subterrain_system->update(t, dt);
-			ctx->collision_system->update(t, dt);
-			ctx->samara_system->update(t, dt);
-			ctx->behavior_system->update(t, dt);
-			ctx->locomotion_system->update(t, dt);
-			ctx->camera_system->update(t, dt);
-			ctx->tool_system->update(t, dt);
-			
-			ctx->orbit_system->update(t, dt);
-			ctx->blackbody_system->update(t, dt);
-			ctx->atmosphere_system->update(t, dt);
-			ctx->astronomy_system->update(t, dt);
-			ctx->spatial_system->update(t, dt);
-			ctx->constraint_system->update(t, dt);
-			ctx->tracking_system->update(t, dt);
-			ctx->painting_system->update(t, dt);
-			ctx->proteome_system->update(t, dt);
-			
-			//(*ctx->focal_point_tween)[1] = ctx->orbit_cam->get_focal_point();
-			
-			auto xf = entity::command::get_world_transform(*ctx->entity_registry, ctx->lens_entity);
-			//ctx->lens_spot_light->look_at(xf.translation, xf.translation + ctx->sun_direct->get_direction(), {0, 1, 0});
-			
-			xf = entity::command::get_world_transform(*ctx->entity_registry, ctx->flashlight_entity);
-			//ctx->flashlight_spot_light->set_transform(xf);
-			ctx->flashlight_spot_light->look_at(xf.translation, xf.translation + xf.rotation * float3{0, 0, 1}, {0, 0, -1});
-			
-			ctx->ui_system->update(dt);
-			ctx->render_system->update(t, dt);
-			ctx->animator->animate(dt);
-			
-			ctx->application_controls->update();
-			ctx->menu_controls->update();
-			ctx->camera_controls->update();
-		}
-	);
+	// Pipeline updates with rendering, if enabled. Scene changes of components changed on the update thread are then deferred until the next snapshot, and rendering interpolates the transform tweens published by the last snapshot.
+	bool pipelined = false;
+	if (ctx->config->has("pipelined"))
+		pipelined = ctx->config->get<bool>("pipelined");
+	
+	if (pipelined)
+	{
+		// Set update callback, which only advances the simulation so that it may run on an update thread
+		ctx->app->set_update_callback
+		(
+			[ctx](double t, double dt)
+			{
+				ctx->snapping_system->update(t, dt);
+				ctx->nest_system->update(t, dt);
+				ctx->collision_system->update(t, dt);
+				ctx->samara_system->update(t, dt);
+				ctx->behavior_system->update(t, dt);
+				ctx->locomotion_system->update(t, dt);
+				ctx->orbit_system->update(t, dt);
+				ctx->blackbody_system->update(t, dt);
+				ctx->atmosphere_system->update(t, dt);
+				ctx->spatial_system->update(t, dt);
+				ctx->constraint_system->update(t, dt);
+				ctx->proteome_system->update(t, dt);
+			}
+		);
+		
+		// Set snapshot callback, which handles input and publishes the simulation state to the scene and rendering resources
+		ctx->app->set_snapshot_callback
+		(
+			[ctx](double t, double dt)
+			{
+				update_tweens(ctx, t);
+				ctx->timeline->advance(dt);
+				
+				ctx->control_system->update(t, dt);
+				ctx->terrain_system->update(t, dt);
+				//ctx->vegetation_system->update(t, dt);
+				ctx->subterrain_system->update(t, dt);
+				ctx->camera_system->update(t, dt);
+				ctx->tool_system->update(t, dt);
+				ctx->astronomy_system->update(t, dt);
+				ctx->tracking_system->update(t, dt);
+				ctx->painting_system->update(t, dt);
+				
+				update_frame(ctx, t, dt);
+			}
+		);
+	}
+	else
+	{
+		// Set update callback, which handles input before advancing the simulation
+		ctx->app->set_update_callback
+		(
+			[ctx](double t, double dt)
+			{
+				update_tweens(ctx, t);
+				ctx->timeline->advance(dt);
+				
+				ctx->control_system->update(t, dt);
+				ctx->terrain_system->update(t, dt);
+				//ctx->vegetation_system->update(t, dt);
+				ctx->snapping_system->update(t, dt);
+				ctx->nest_system->update(t, dt);
+				ctx->subterrain_system->update(t, dt);
+				ctx->collision_system->update(t, dt);
+				ctx->samara_system->update(t, dt);
+				ctx->behavior_system->update(t, dt);
+				ctx->locomotion_system->update(t, dt);
+				ctx->camera_system->update(t, dt);
+				ctx->tool_system->update(t, dt);
+				
+				ctx->orbit_system->update(t, dt);
+				ctx->blackbody_system->update(t, dt);
+				ctx->atmosphere_system->update(t, dt);
+				ctx->astronomy_system->update(t, dt);
+				ctx->spatial_system->update(t, dt);
+				ctx->constraint_system->update(t, dt);
+				ctx->tracking_system->update(t, dt);
+				ctx->painting_system->update(t, dt);
+				ctx->proteome_system->update(t, dt);
+				
+				update_frame(ctx, t, dt);
+			}
+		);
+	}
 	
 	// Set render callback
 	ctx->app->set_render_callback
@@ -1316,4 +1378,60 @@ void setup_callbacks(game::context* ctx)
 			ctx->render_system->draw(alpha);
 		}
 	);
+	
+	ctx->render_system->set_deferred(pipelined);
+	ctx->terrain_system->set_deferred(pipelined);
+	ctx->tracking_system->set_deferred(pipelined);
+	ctx->app->set_pipelined(pipelined);
+	
+	// Run updates as fast as possible if fast-forwarding, rendering only every render interval, or never if headless
+	if (ctx->option_headless.has_value())
+	{
+		ctx->app->set_render_interval(0.0);
+		ctx->app->set_fast_forward(true);
+	}
+	else if (ctx->option_fast_forward.has_value())
+	{
+		ctx->app->set_render_interval(ctx->option_fast_forward.value());
+		ctx->app->set_fast_forward(true);
+	}
+}
+
+void update_tweens(game::context* ctx, double t)
+{
+	// Update tweens
+	ctx->time_tween->update();
+	ctx->overworld_sky_pass->update_tweens();
+	scene::object_base::update_transform_tweens();
+	ctx->overworld_scene->update_tweens();
+	ctx->underworld_scene->update_tweens();
+	ctx->ui_scene->update_tweens();
+	ctx->focal_point_tween->update();
+	ctx->underworld_final_pass->get_material()->update_tweens();
+	
+	// Set time tween time
+	(*ctx->time_tween)[1] = t;
+}
+
+void update_frame(game::context* ctx, double t, double dt)
+{
+	//(*ctx->focal_point_tween)[1] = ctx->orbit_cam->get_focal_point();
+	
+	auto xf = entity::command::get_world_transform(*ctx->entity_registry, ctx->lens_entity);
+	//ctx->lens_spot_light->look_at(xf.translation, xf.translation + ctx->sun_direct->get_direction(), {0, 1, 0});
+	
+	xf = entity::command::get_world_transform(*ctx->entity_registry, ctx->flashlight_entity);
+	//ctx->flashlight_spot_light->set_transform(xf);
+	ctx->flashlight_spot_light->look_at(xf.translation, xf.translation + xf.rotation * float3{0, 0, 1}, {0, 0, -1});
+	
+	ctx->ui_system->update(dt);
+	ctx->render_system->update(t, dt);
+	ctx->animator->animate(dt);
+	
+	ctx->application_controls->update();
+	ctx->menu_controls->update();
+	ctx->camera_controls->update();
+	
+	// Publish the transform tweens of this frame, from which the following renders interpolate
+	scene::object_base::publish_transform_tweens();
 }
@@ -106,6 +106,14 @@ namespace entity
 
 namespace game {
 
+/// Bit masks of the render layers, in the order in which the layers are added to the render system.
+enum render_layer: unsigned int
+{
+	overworld_layer = 1u << 0,
+	underworld_layer = 1u << 1,
+	ui_layer = 1u << 2
+};
+
 /// Structure containing the state of a game.
 struct context
 {
@@ -117,7 +125,9 @@ struct context
 	std::optional<std::string> option_biome;
 	std::optional<bool> option_continue;
 	std::optional<std::string> option_data;
+	std::optional<double> option_fast_forward;
 	std::optional<bool> option_fullscreen;
+	std::optional<bool> option_headless;
 	std::optional<bool> option_new_game;
 	std::optional<bool> option_quick_start;
 	std::optional<bool> option_reset;
@@ -166,7 +176,6 @@ struct context
 	// Compositing
 	bloom_pass* overworld_bloom_pass;
 	clear_pass* overworld_clear_pass;
-	clear_pass* overworld_shadow_map_clear_pass;
 	clear_pass* ui_clear_pass;
 	clear_pass* underworld_clear_pass;
 	final_pass* overworld_final_pass;
@@ -28,6 +28,7 @@
 #include "entity/components/terrain.hpp"
 #include "entity/components/transform.hpp"
 #include "entity/systems/astronomy.hpp"
+#include "entity/systems/blackbody.hpp"
 #include "entity/systems/orbit.hpp"
 #include "game/states/nuptial-flight.hpp"
 #include "game/states/play.hpp"
@@ -46,6 +47,7 @@
 #include "resources/resource-manager.hpp"
 #include "scene/ambient-light.hpp"
 #include "scene/directional-light.hpp"
+#include <algorithm>
 
 namespace game {
 namespace state {
@@ -242,7 +244,11 @@ void planetogenesis(game::context* ctx)
 	orbit.elements.raan = math::radians(0.0);
 	const double longitude_periapsis = math::radians(102.93768193);
 	orbit.elements.w = longitude_periapsis - orbit.elements.raan;
-	orbit.elements.ta = math::radians(100.46457166) - longitude_periapsis;
+	
+	// Convert mean anomaly at epoch to true anomaly
+	const double mean_anomaly = math::radians(100.46457166) - longitude_periapsis;
+	const double eccentric_anomaly = physics::orbit::kepler_ea(orbit.elements.e, mean_anomaly, 10, 1e-12);
+	orbit.elements.ta = physics::orbit::derive_true_anomaly(orbit.elements.e, eccentric_anomaly);
 	ctx->entity_registry->assign<entity::component::orbit>(planet_eid, orbit);
 	
 	// Assign planetary terrain component
@@ -252,6 +258,10 @@ void planetogenesis(game::context* ctx)
 		//return math::random<double>(0.0, 1.0);
 		return 0.0;
 	};
+	terrain.batch_elevation = [](const double*, const double*, double* elevations, std::size_t count)
+	{
+		std::fill(elevations, elevations + count, 0.0);
+	};
 	terrain.max_lod = 18;
 	terrain.patch_material = ctx->resource_manager->load<material>("desert-terrain.mtl");
 	ctx->entity_registry->assign<entity::component::terrain>(planet_eid, terrain);
@@ -306,6 +316,9 @@ void extrasolar_heliogenesis(game::context* ctx)
 	float* star_vertex_data = new float[star_count * star_vertex_size];
 	float* star_vertex = star_vertex_data;
 	
+	// Get blackbody luminous efficacy table, which gives star colors from color temperatures
+	const physics::light::blackbody::efficacy_lut<double>& blackbody_lut = ctx->blackbody_system->get_efficacy_lut();
+	
 	// Build star catalog vertex data
 	for (std::size_t i = 1; i < star_catalog->size(); ++i)
 	{
@@ -344,7 +357,7 @@ void extrasolar_heliogenesis(game::context* ctx)
 		double cct = color::index::bv_to_cct(bv_color);
 		
 		// Calculate XYZ color from color temperature
-		double3 color_xyz = color::cct::to_xyz(cct);
+		double3 color_xyz = (blackbody_lut.contains(cct)) ? blackbody_lut.chromaticity(cct) : color::cct::to_xyz(cct);
 		
 		// Transform XYZ color to ACEScg colorspace
 		double3 color_acescg = color::xyz::to_acescg(color_xyz);
@@ -59,6 +59,7 @@ void enter(game::context* ctx)
 		observer.latitude = 0.0;
 		observer.longitude = 0.0;
 		observer.camera = ctx->overworld_camera;
+		observer.layers = game::overworld_layer;
 		ctx->entity_registry->assign<entity::component::observer>(observer_eid, observer);
 		
 		// Set reference location of astronomy system
@@ -85,6 +86,8 @@ void enter(game::context* ctx)
 	entity::system::control* control_system = ctx->control_system;
 	control_system->update(0.0, 0.0);
 	
+	scene::object_base::update_transform_tweens();
+	scene::object_base::publish_transform_tweens();
 	ctx->overworld_scene->update_tweens();
 	
 	// Pause motion of celestial objects
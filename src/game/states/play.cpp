@@ -52,6 +52,7 @@ void enter(game::context* ctx)
 		observer.latitude = 0.0;
 		observer.longitude = 0.0;
 		observer.camera = ctx->overworld_camera;
+		observer.layers = game::overworld_layer;
 		ctx->entity_registry->assign<entity::component::observer>(observer_eid, observer);
 		
 		// Set reference location of astronomy system
@@ -86,6 +87,8 @@ void enter(game::context* ctx)
 		entity::command::warp_to(*ctx->entity_registry, larva_eid, {50, 0.1935f, 0});
 	}
 	
+	scene::object_base::update_transform_tweens();
+	scene::object_base::publish_transform_tweens();
 	ctx->overworld_scene->update_tweens();
 	
 	// Start fade in
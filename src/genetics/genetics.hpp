@@ -27,6 +27,7 @@ namespace genetics {}
 #include "base.hpp"
 #include "codon.hpp"
 #include "matrix.hpp"
+#include "packed-sequence.hpp"
 #include "protein.hpp"
 #include "sequence.hpp"
 #include "standard-code.hpp"
@@ -0,0 +1,382 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "packed-sequence.hpp"
+#include <algorithm>
+
+namespace genetics {
+
+typedef packed_sequence::word_type word_type;
+
+/// Mask of the least significant bit of every two-bit lane.
+static constexpr word_type lane_bits = 0x5555555555555555;
+
+/// Words with every lane set to each of the four packed bases.
+static constexpr word_type base_patterns[4] =
+{
+	0x0000000000000000,
+	0x5555555555555555,
+	0xaaaaaaaaaaaaaaaa,
+	0xffffffffffffffff
+};
+
+/// Lane masks, where each mask marks the lanes with an index congruent to the mask's index, modulo three.
+static constexpr word_type frame_masks[3] =
+{
+	0x1041041041041041,
+	0x4104104104104104,
+	0x0410410410410410
+};
+
+/// Lookup table for the index of the least significant set bit, using a de Bruijn sequence.
+static constexpr int debruijn_table[64] =
+{
+	 0,  1, 48,  2, 57, 49, 28,  3, 61, 58, 50, 42, 38, 29, 17,  4,
+	62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12,  5,
+	63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+	46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19,  9, 13,  8,  7,  6
+};
+
+/// Packed base symbols, in TCAG order.
+static constexpr char base_symbols[4] = {'T', 'C', 'A', 'G'};
+
+/**
+ * Returns the packed value of an IUPAC base symbol.
+ *
+ * @param symbol IUPAC base symbol.
+ * @return Packed value of the base, or a negative value if the symbol can't be packed.
+ */
+static inline int pack_base(char symbol)
+{
+	switch (symbol)
+	{
+		case 'U':
+		case 'T':
+			return 0;
+		case 'C':
+			return 1;
+		case 'A':
+			return 2;
+		case 'G':
+			return 3;
+	}
+	
+	return -1;
+}
+
+/**
+ * Returns the index of the least significant set bit of a non-zero word.
+ */
+static inline int lowest_bit(word_type x)
+{
+	return debruijn_table[((x & (~x + 1)) * word_type(0x03f79d71b4cb0a89)) >> 58];
+}
+
+/**
+ * Returns a mask marking the lanes of a word which are equal to a base.
+ *
+ * @param x Word of packed bases.
+ * @param pattern Word with every lane set to the base.
+ * @return Mask with the least significant bit of every matching lane set.
+ */
+static inline word_type match_lanes(word_type x, word_type pattern)
+{
+	x ^= pattern;
+	return ~(x | (x >> 1)) & lane_bits;
+}
+
+packed_sequence::packed_sequence():
+	length(0)
+{}
+
+packed_sequence::packed_sequence(const std::string& symbols):
+	length(0)
+{
+	assign(symbols);
+}
+
+void packed_sequence::assign(const std::string& symbols)
+{
+	length = symbols.size();
+	words.assign((length + bases_per_word - 1) / bases_per_word, 0);
+	exceptions.clear();
+	
+	for (std::size_t i = 0; i < length; ++i)
+	{
+		int base = pack_base(symbols[i]);
+		if (base < 0)
+		{
+			exceptions.emplace_back(i, symbols[i]);
+			continue;
+		}
+		
+		words[i >> 5] |= word_type(base) << ((i & 31) << 1);
+	}
+}
+
+void packed_sequence::clear()
+{
+	words.clear();
+	exceptions.clear();
+	length = 0;
+}
+
+std::string packed_sequence::to_string() const
+{
+	std::string symbols(length, 'T');
+	
+	for (std::size_t i = 0; i < length; ++i)
+		symbols[i] = base_symbols[(words[i >> 5] >> ((i & 31) << 1)) & 3];
+	
+	for (const auto& exception: exceptions)
+		symbols[exception.first] = exception.second;
+	
+	return symbols;
+}
+
+char packed_sequence::operator[](std::size_t i) const
+{
+	if (!exceptions.empty())
+	{
+		auto it = std::lower_bound(exceptions.begin(), exceptions.end(), std::pair<std::size_t, char>(i, '\0'));
+		if (it != exceptions.end() && it->first == i)
+			return it->second;
+	}
+	
+	return base_symbols[(words[i >> 5] >> ((i & 31) << 1)) & 3];
+}
+
+namespace sequence {
+
+static constexpr std::size_t npos = ~std::size_t(0);
+
+/**
+ * Scans a range of words for codons matching either of two sets of codons.
+ *
+ * @param sequence Packed sequence to scan.
+ * @param table Genetic code translation table.
+ * @param first,last Range of words to scan.
+ * @param starts Start codon masks, indexed by word.
+ * @param stops Stop codon masks, indexed by word.
+ */
+static void scan_words(const packed_sequence& sequence, const codon::table& table, std::size_t first, std::size_t last, word_type* starts, word_type* stops)
+{
+	// Build lists of start and stop codons, as triplets of packed bases
+	int start_codons[64][3];
+	int stop_codons[64][3];
+	int start_count = 0;
+	int stop_count = 0;
+	for (int i = 0; i < 64; ++i)
+	{
+		const int codon[3] = {i >> 4, (i >> 2) & 3, i & 3};
+		
+		if (table.starts[i] != '-' && table.starts[i] != '*')
+			std::copy(codon, codon + 3, start_codons[start_count++]);
+		if (table.aas[i] == '*')
+			std::copy(codon, codon + 3, stop_codons[stop_count++]);
+	}
+	
+	const std::vector<word_type>& words = sequence.get_words();
+	const std::size_t word_count = words.size();
+	const std::size_t length = sequence.size();
+	const std::size_t codon_count = (length >= 3) ? length - 2 : 0;
+	
+	for (std::size_t k = first; k < last; ++k)
+	{
+		const word_type current = words[k];
+		const word_type next = (k + 1 < word_count) ? words[k + 1] : 0;
+		
+		// For each base, mark lanes where the first, second, and third base of a codon match
+		word_type matches[3][4];
+		for (int b = 0; b < 4; ++b)
+		{
+			const word_type a = match_lanes(current, base_patterns[b]);
+			const word_type c = match_lanes(next, base_patterns[b]);
+			matches[0][b] = a;
+			matches[1][b] = (a >> 2) | (c << 62);
+			matches[2][b] = (a >> 4) | (c << 60);
+		}
+		
+		// Test all codon positions in the word against each start and stop codon
+		word_type start_mask = 0;
+		for (int i = 0; i < start_count; ++i)
+			start_mask |= matches[0][start_codons[i][0]] & matches[1][start_codons[i][1]] & matches[2][start_codons[i][2]];
+		word_type stop_mask = 0;
+		for (int i = 0; i < stop_count; ++i)
+			stop_mask |= matches[0][stop_codons[i][0]] & matches[1][stop_codons[i][1]] & matches[2][stop_codons[i][2]];
+		
+		// Discard codons which extend past the end of the sequence
+		const std::size_t position = k * packed_sequence::bases_per_word;
+		if (position + packed_sequence::bases_per_word > codon_count)
+		{
+			const std::size_t valid = (codon_count > position) ? codon_count - position : 0;
+			const word_type valid_mask = (word_type(1) << (valid << 1)) - 1;
+			start_mask &= valid_mask;
+			stop_mask &= valid_mask;
+		}
+		
+		starts[k] = start_mask;
+		stops[k] = stop_mask;
+	}
+	
+	// Discard codons containing bases which could not be packed
+	const std::size_t range_begin = first * packed_sequence::bases_per_word;
+	const std::size_t range_end = last * packed_sequence::bases_per_word + 2;
+	for (const auto& exception: sequence.get_exceptions())
+	{
+		if (exception.first < range_begin || exception.first >= range_end)
+			continue;
+		
+		const std::size_t p0 = (exception.first >= 2) ? exception.first - 2 : 0;
+		const std::size_t p1 = std::min(exception.first, last * packed_sequence::bases_per_word - 1);
+		for (std::size_t p = std::max(p0, range_begin); p <= p1; ++p)
+		{
+			const word_type mask = ~(word_type(1) << ((p & 31) << 1));
+			starts[p >> 5] &= mask;
+			stops[p >> 5] &= mask;
+		}
+	}
+}
+
+/**
+ * Finds the first set codon mask bit at or after a position.
+ *
+ * @param masks Codon masks.
+ * @param first Position at which to begin the search.
+ * @param frame Reading frame (position modulo three) to which the search should be restricted, or a negative value to search all reading frames.
+ * @return Position of the first marked codon, or `npos` if none was found.
+ */
+static std::size_t find_codon(const std::vector<word_type>& masks, std::size_t first, int frame)
+{
+	std::size_t k = first >> 5;
+	if (k >= masks.size())
+		return npos;
+	
+	word_type mask = masks[k] & (~word_type(0) << ((first & 31) << 1));
+	for (;;)
+	{
+		// Lane j of word k is in frame if (32k + j) mod 3 equals the frame
+		if (frame >= 0)
+			mask &= frame_masks[(frame + 3 - (k << 1) % 3) % 3];
+		
+		if (mask)
+			return (k << 5) + (lowest_bit(mask) >> 1);
+		
+		if (++k >= masks.size())
+			return npos;
+		mask = masks[k];
+	}
+}
+
+void scan_codons(const packed_sequence& sequence, const codon::table& table, std::vector<word_type>& starts, std::vector<word_type>& stops)
+{
+	const std::size_t word_count = sequence.get_words().size();
+	starts.resize(word_count);
+	stops.resize(word_count);
+	scan_words(sequence, table, 0, word_count, starts.data(), stops.data());
+}
+
+orf<std::size_t> find_orf(const packed_sequence& sequence, std::size_t first, const codon::table& table)
+{
+	const std::size_t length = sequence.size();
+	const std::size_t word_count = sequence.get_words().size();
+	const std::size_t first_word = first >> 5;
+	
+	if (first_word < word_count)
+	{
+		std::vector<word_type> starts(word_count, 0);
+		std::vector<word_type> stops(word_count, 0);
+		scan_words(sequence, table, first_word, word_count, starts.data(), stops.data());
+		
+		const std::size_t start = find_codon(starts, first, -1);
+		if (start != npos)
+		{
+			const std::size_t stop = find_codon(stops, start + 3, static_cast<int>(start % 3));
+			if (stop != npos)
+				return {start, stop};
+		}
+	}
+	
+	return {length, length};
+}
+
+void find_orfs(const packed_sequence& sequence, const codon::table& table, std::vector<orf<std::size_t>>& orfs)
+{
+	std::vector<word_type> starts;
+	std::vector<word_type> stops;
+	scan_codons(sequence, table, starts, stops);
+	
+	std::size_t position = 0;
+	for (;;)
+	{
+		const std::size_t start = find_codon(starts, position, -1);
+		if (start == npos)
+			break;
+		
+		const std::size_t stop = find_codon(stops, start + 3, static_cast<int>(start % 3));
+		if (stop == npos)
+			break;
+		
+		orfs.push_back({start, stop});
+		position = stop;
+	}
+}
+
+void translate(const packed_sequence& sequence, std::size_t first, std::size_t last, const codon::table& table, std::string& protein)
+{
+	if (last <= first || last - first < 3)
+		return;
+	
+	const std::size_t codon_count = (last - first) / 3;
+	const word_type* words = sequence.get_words().data();
+	const std::size_t word_count = sequence.get_words().size();
+	const auto& exceptions = sequence.get_exceptions();
+	auto exception = std::lower_bound(exceptions.begin(), exceptions.end(), std::pair<std::size_t, char>(first, '\0'));
+	
+	std::size_t offset = protein.size();
+	protein.resize(offset + codon_count);
+	char* output = &protein[offset];
+	
+	const char* aas = table.starts;
+	for (std::size_t i = 0, p = first; i < codon_count; ++i, p += 3)
+	{
+		// Extract the three packed bases, possibly spanning two words
+		const std::size_t k = p >> 5;
+		const unsigned int shift = static_cast<unsigned int>((p & 31) << 1);
+		word_type bits = words[k] >> shift;
+		if (shift > 58 && k + 1 < word_count)
+			bits |= words[k + 1] << (64 - shift);
+		
+		// Reorder the bases from first-in-low-bits to the TCAG table index
+		const unsigned int field = static_cast<unsigned int>(bits) & 63;
+		const unsigned int index = ((field & 3) << 4) | (field & 12) | (field >> 4);
+		
+		output[i] = aas[index];
+		aas = table.aas;
+		
+		// Codons containing unpacked bases are invalid
+		while (exception != exceptions.end() && exception->first < p)
+			++exception;
+		if (exception != exceptions.end() && exception->first < p + 3)
+			output[i] = '-';
+	}
+}
+
+} // namespace sequence
+} // namespace genetics
@@ -0,0 +1,184 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTKEEPER_GENETICS_PACKED_SEQUENCE_HPP
+#define ANTKEEPER_GENETICS_PACKED_SEQUENCE_HPP
+
+#include "codon.hpp"
+#include "sequence.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace genetics {
+
+/**
+ * Sequence of DNA bases packed into two bits per base.
+ *
+ * Bases are stored in TCAG order (`T` = 0, `C` = 1, `A` = 2, `G` = 3), with the first base of each word in its least significant bits. `U` is packed as `T`. Symbols other than `T`, `U`, `C`, `A`, and `G` are kept in a sparse list of exceptions so that conversion back to a string is lossless, and codons containing such symbols are neither start nor stop codons and translate to `-`.
+ */
+class packed_sequence
+{
+public:
+	/// Type of a word of packed bases.
+	typedef std::uint64_t word_type;
+	
+	/// Number of bases per word.
+	static constexpr std::size_t bases_per_word = 32;
+	
+	/// Constructs an empty sequence.
+	packed_sequence();
+	
+	/**
+	 * Constructs a sequence from a string of IUPAC base symbols.
+	 *
+	 * @param symbols String of IUPAC base symbols.
+	 */
+	explicit packed_sequence(const std::string& symbols);
+	
+	/**
+	 * Replaces the contents of the sequence with a string of IUPAC base symbols.
+	 *
+	 * @param symbols String of IUPAC base symbols.
+	 */
+	void assign(const std::string& symbols);
+	
+	/// Removes all bases from the sequence.
+	void clear();
+	
+	/// Returns the sequence as a string of IUPAC DNA base symbols.
+	std::string to_string() const;
+	
+	/**
+	 * Returns the IUPAC DNA base symbol at a position in the sequence.
+	 *
+	 * @param i Position of the base.
+	 * @return IUPAC DNA base symbol.
+	 */
+	char operator[](std::size_t i) const;
+	
+	/// Returns the number of bases in the sequence.
+	std::size_t size() const;
+	
+	/// Returns `true` if the sequence contains no bases, `false` otherwise.
+	bool empty() const;
+	
+	/// Returns the words of packed bases.
+	const std::vector<word_type>& get_words() const;
+	
+	/// Returns the positions and symbols of bases which could not be packed, sorted by position.
+	const std::vector<std::pair<std::size_t, char>>& get_exceptions() const;
+	
+	/// Returns `true` if two sequences contain the same bases, `false` otherwise.
+	bool operator==(const packed_sequence& other) const;
+	
+	/// Returns `true` if two sequences differ, `false` otherwise.
+	bool operator!=(const packed_sequence& other) const;
+	
+private:
+	std::vector<word_type> words;
+	std::vector<std::pair<std::size_t, char>> exceptions;
+	std::size_t length;
+};
+
+inline std::size_t packed_sequence::size() const
+{
+	return length;
+}
+
+inline bool packed_sequence::empty() const
+{
+	return !length;
+}
+
+inline const std::vector<packed_sequence::word_type>& packed_sequence::get_words() const
+{
+	return words;
+}
+
+inline const std::vector<std::pair<std::size_t, char>>& packed_sequence::get_exceptions() const
+{
+	return exceptions;
+}
+
+inline bool packed_sequence::operator==(const packed_sequence& other) const
+{
+	return length == other.length && words == other.words && exceptions == other.exceptions;
+}
+
+inline bool packed_sequence::operator!=(const packed_sequence& other) const
+{
+	return !(*this == other);
+}
+
+namespace sequence {
+
+/**
+ * Scans all three reading frames of a packed sequence for start and stop codons.
+ *
+ * Thirty-two codon positions are tested per word operation. Bit `2 * j` of mask word `k` is set if the codon beginning at position `32 * k + j` is a start (or stop) codon.
+ *
+ * @param sequence Packed sequence to scan.
+ * @param table Genetic code translation table.
+ * @param[out] starts Start codon masks, one per word of the sequence.
+ * @param[out] stops Stop codon masks, one per word of the sequence.
+ */
+void scan_codons(const packed_sequence& sequence, const codon::table& table, std::vector<packed_sequence::word_type>& starts, std::vector<packed_sequence::word_type>& stops);
+
+/**
+ * Searches a packed sequence for an open reading frame (ORF).
+ *
+ * @param sequence Packed sequence to search.
+ * @param first Position at which to begin the search.
+ * @param table Genetic code translation table.
+ * @return First ORF in the sequence at or after @p first, or an ORF with both positions equal to the size of the sequence if no ORF was found.
+ *
+ * @see find_orf(ForwardIt, ForwardIt, const codon::table&)
+ */
+orf<std::size_t> find_orf(const packed_sequence& sequence, std::size_t first, const codon::table& table);
+
+/**
+ * Finds consecutive open reading frames (ORFs) in a packed sequence, each search beginning at the stop codon of the previous ORF.
+ *
+ * The sequence is scanned once, so this is preferable to repeated calls to find_orf(const packed_sequence&, std::size_t, const codon::table&).
+ *
+ * @param sequence Packed sequence to search.
+ * @param table Genetic code translation table.
+ * @param[out] orfs Vector to which the ORFs will be appended.
+ */
+void find_orfs(const packed_sequence& sequence, const codon::table& table, std::vector<orf<std::size_t>>& orfs);
+
+/**
+ * Translates a range of a packed sequence into a sequence of IUPAC amino acid symbols. The first codon is translated as a start codon.
+ *
+ * @param sequence Packed sequence to translate.
+ * @param first,last Range of positions to translate.
+ * @param table Genetic code translation table.
+ * @param[out] protein String to which the amino acid symbols will be appended.
+ *
+ * @see translate(InputIt, InputIt, OutputIt, const codon::table&)
+ */
+void translate(const packed_sequence& sequence, std::size_t first, std::size_t last, const codon::table& table, std::string& protein);
+
+} // namespace sequence
+} // namespace genetics
+
+#endif // ANTKEEPER_GENETICS_PACKED_SEQUENCE_HPP
@@ -0,0 +1,330 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTKEEPER_GEOM_CULLING_HPP
+#define ANTKEEPER_GEOM_CULLING_HPP
+
+#include "geom/aabb.hpp"
+#include "geom/convex-hull.hpp"
+#include "geom/sphere.hpp"
+#include "math/simd.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace geom {
+
+/**
+ * Structure of arrays of axis-aligned bounding boxes, for bulk culling.
+ *
+ * @tparam T Scalar type.
+ */
+template <class T>
+struct aabb_array
+{
+	std::vector<T> min_x;
+	std::vector<T> min_y;
+	std::vector<T> min_z;
+	std::vector<T> max_x;
+	std::vector<T> max_y;
+	std::vector<T> max_z;
+	
+	/// Appends an AABB to the arrays.
+	void push_back(const aabb<T>& aabb);
+	
+	/// Removes all AABBs from the arrays.
+	void clear();
+	
+	/// Returns the number of AABBs in the arrays.
+	std::size_t size() const;
+};
+
+/**
+ * Structure of arrays of bounding spheres, for bulk culling.
+ *
+ * @tparam T Scalar type.
+ */
+template <class T>
+struct sphere_array
+{
+	std::vector<T> center_x;
+	std::vector<T> center_y;
+	std::vector<T> center_z;
+	std::vector<T> radius;
+	
+	/// Appends a sphere to the arrays.
+	void push_back(const sphere<T>& sphere);
+	
+	/// Removes all spheres from the arrays.
+	void clear();
+	
+	/// Returns the number of spheres in the arrays.
+	std::size_t size() const;
+};
+
+/**
+ * Tests an array of AABBs for intersection with a convex hull.
+ *
+ * AABBs are tested in blocks of 64, one plane at a time, with branch-free loops which compilers vectorize to the enabled SIMD width. If ANTKEEPER_MATH_AVX is defined, single-precision AABBs and spheres are instead tested eight at a time with AVX intrinsics.
+ *
+ * @param hull Convex hull, such as the bounds of a view frustum.
+ * @param aabbs Array of AABBs to test.
+ * @param[out] mask Bitmask in which bit `i % 64` of word `i / 64` is set if AABB `i` intersects the hull.
+ *
+ * @see convex_hull::intersects(const aabb<T>&) const
+ */
+template <class T>
+void cull(const convex_hull<T>& hull, const aabb_array<T>& aabbs, std::vector<std::uint64_t>& mask);
+
+/**
+ * Tests an array of spheres for intersection with a convex hull.
+ *
+ * @param hull Convex hull, such as the bounds of a view frustum.
+ * @param spheres Array of spheres to test.
+ * @param[out] mask Bitmask in which bit `i % 64` of word `i / 64` is set if sphere `i` intersects the hull.
+ *
+ * @see convex_hull::intersects(const sphere<T>&) const
+ */
+template <class T>
+void cull(const convex_hull<T>& hull, const sphere_array<T>& spheres, std::vector<std::uint64_t>& mask);
+
+template <class T>
+void aabb_array<T>::push_back(const aabb<T>& aabb)
+{
+	min_x.push_back(aabb.min_point.x);
+	min_y.push_back(aabb.min_point.y);
+	min_z.push_back(aabb.min_point.z);
+	max_x.push_back(aabb.max_point.x);
+	max_y.push_back(aabb.max_point.y);
+	max_z.push_back(aabb.max_point.z);
+}
+
+template <class T>
+void aabb_array<T>::clear()
+{
+	min_x.clear();
+	min_y.clear();
+	min_z.clear();
+	max_x.clear();
+	max_y.clear();
+	max_z.clear();
+}
+
+template <class T>
+inline std::size_t aabb_array<T>::size() const
+{
+	return min_x.size();
+}
+
+template <class T>
+void sphere_array<T>::push_back(const sphere<T>& sphere)
+{
+	center_x.push_back(sphere.center.x);
+	center_y.push_back(sphere.center.y);
+	center_z.push_back(sphere.center.z);
+	radius.push_back(sphere.radius);
+}
+
+template <class T>
+void sphere_array<T>::clear()
+{
+	center_x.clear();
+	center_y.clear();
+	center_z.clear();
+	radius.clear();
+}
+
+template <class T>
+inline std::size_t sphere_array<T>::size() const
+{
+	return center_x.size();
+}
+
+template <class T>
+void cull(const convex_hull<T>& hull, const aabb_array<T>& aabbs, std::vector<std::uint64_t>& mask)
+{
+	const std::size_t count = aabbs.size();
+	mask.resize((count + 63) / 64);
+	
+	for (std::size_t first = 0; first < count; first += 64)
+	{
+		const std::size_t n = std::min<std::size_t>(64, count - first);
+		
+		// Visibility flags are as wide as the scalars, so the tests can be vectorized without widening
+		std::uint32_t inside[64];
+		std::fill(inside, inside + n, 1);
+		
+		for (const plane<T>& plane: hull.planes)
+		{
+			// Select the coordinates of the positive vertex, which is farthest along the plane normal
+			const T* px = (plane.normal.x > T(0)) ? &aabbs.max_x[first] : &aabbs.min_x[first];
+			const T* py = (plane.normal.y > T(0)) ? &aabbs.max_y[first] : &aabbs.min_y[first];
+			const T* pz = (plane.normal.z > T(0)) ? &aabbs.max_z[first] : &aabbs.min_z[first];
+			const T nx = plane.normal.x;
+			const T ny = plane.normal.y;
+			const T nz = plane.normal.z;
+			const T d = plane.distance;
+			
+			for (std::size_t i = 0; i < n; ++i)
+				inside[i] &= static_cast<std::uint32_t>(nx * px[i] + ny * py[i] + nz * pz[i] + d >= T(0));
+		}
+		
+		std::uint64_t word = 0;
+		for (std::size_t i = 0; i < n; ++i)
+			word |= static_cast<std::uint64_t>(inside[i]) << i;
+		mask[first / 64] = word;
+	}
+}
+
+template <class T>
+void cull(const convex_hull<T>& hull, const sphere_array<T>& spheres, std::vector<std::uint64_t>& mask)
+{
+	const std::size_t count = spheres.size();
+	mask.resize((count + 63) / 64);
+	
+	for (std::size_t first = 0; first < count; first += 64)
+	{
+		const std::size_t n = std::min<std::size_t>(64, count - first);
+		const T* cx = &spheres.center_x[first];
+		const T* cy = &spheres.center_y[first];
+		const T* cz = &spheres.center_z[first];
+		const T* r = &spheres.radius[first];
+		
+		std::uint32_t inside[64];
+		std::fill(inside, inside + n, 1);
+		
+		for (const plane<T>& plane: hull.planes)
+		{
+			const T nx = plane.normal.x;
+			const T ny = plane.normal.y;
+			const T nz = plane.normal.z;
+			const T d = plane.distance;
+			
+			for (std::size_t i = 0; i < n; ++i)
+				inside[i] &= static_cast<std::uint32_t>(nx * cx[i] + ny * cy[i] + nz * cz[i] + d >= -r[i]);
+		}
+		
+		std::uint64_t word = 0;
+		for (std::size_t i = 0; i < n; ++i)
+			word |= static_cast<std::uint64_t>(inside[i]) << i;
+		mask[first / 64] = word;
+	}
+}
+
+#if defined(ANTKEEPER_MATH_AVX)
+
+template <>
+inline void cull<float>(const convex_hull<float>& hull, const aabb_array<float>& aabbs, std::vector<std::uint64_t>& mask)
+{
+	const std::size_t count = aabbs.size();
+	mask.resize((count + 63) / 64);
+	
+	for (std::size_t first = 0; first < count; first += 64)
+	{
+		const std::size_t n = std::min<std::size_t>(64, count - first);
+		const std::size_t lane_count = n & ~std::size_t(7);
+		
+		__m256 inside[8];
+		std::fill(inside, inside + 8, _mm256_cmp_ps(_mm256_setzero_ps(), _mm256_setzero_ps(), _CMP_EQ_OQ));
+		std::uint32_t tail_inside[8] = {1, 1, 1, 1, 1, 1, 1, 1};
+		
+		for (const plane<float>& plane: hull.planes)
+		{
+			// Select the coordinates of the positive vertex, which is farthest along the plane normal
+			const float* px = (plane.normal.x > 0.0f) ? &aabbs.max_x[first] : &aabbs.min_x[first];
+			const float* py = (plane.normal.y > 0.0f) ? &aabbs.max_y[first] : &aabbs.min_y[first];
+			const float* pz = (plane.normal.z > 0.0f) ? &aabbs.max_z[first] : &aabbs.min_z[first];
+			const __m256 nx = _mm256_set1_ps(plane.normal.x);
+			const __m256 ny = _mm256_set1_ps(plane.normal.y);
+			const __m256 nz = _mm256_set1_ps(plane.normal.z);
+			const __m256 d = _mm256_set1_ps(plane.distance);
+			
+			// Sum in the same order as plane::signed_distance(), so results match the scalar tests
+			for (std::size_t i = 0; i < lane_count; i += 8)
+			{
+				__m256 distance = _mm256_add_ps(_mm256_mul_ps(nx, _mm256_loadu_ps(px + i)), _mm256_mul_ps(ny, _mm256_loadu_ps(py + i)));
+				distance = _mm256_add_ps(_mm256_add_ps(distance, _mm256_mul_ps(nz, _mm256_loadu_ps(pz + i))), d);
+				inside[i / 8] = _mm256_and_ps(inside[i / 8], _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+			}
+			
+			for (std::size_t i = lane_count; i < n; ++i)
+				tail_inside[i - lane_count] &= static_cast<std::uint32_t>(plane.normal.x * px[i] + plane.normal.y * py[i] + plane.normal.z * pz[i] + plane.distance >= 0.0f);
+		}
+		
+		std::uint64_t word = 0;
+		for (std::size_t i = 0; i < lane_count; i += 8)
+			word |= static_cast<std::uint64_t>(_mm256_movemask_ps(inside[i / 8])) << i;
+		for (std::size_t i = lane_count; i < n; ++i)
+			word |= static_cast<std::uint64_t>(tail_inside[i - lane_count]) << i;
+		mask[first / 64] = word;
+	}
+}
+
+template <>
+inline void cull<float>(const convex_hull<float>& hull, const sphere_array<float>& spheres, std::vector<std::uint64_t>& mask)
+{
+	const std::size_t count = spheres.size();
+	mask.resize((count + 63) / 64);
+	
+	for (std::size_t first = 0; first < count; first += 64)
+	{
+		const std::size_t n = std::min<std::size_t>(64, count - first);
+		const std::size_t lane_count = n & ~std::size_t(7);
+		const float* cx = &spheres.center_x[first];
+		const float* cy = &spheres.center_y[first];
+		const float* cz = &spheres.center_z[first];
+		const float* r = &spheres.radius[first];
+		
+		__m256 inside[8];
+		std::fill(inside, inside + 8, _mm256_cmp_ps(_mm256_setzero_ps(), _mm256_setzero_ps(), _CMP_EQ_OQ));
+		std::uint32_t tail_inside[8] = {1, 1, 1, 1, 1, 1, 1, 1};
+		
+		for (const plane<float>& plane: hull.planes)
+		{
+			const __m256 nx = _mm256_set1_ps(plane.normal.x);
+			const __m256 ny = _mm256_set1_ps(plane.normal.y);
+			const __m256 nz = _mm256_set1_ps(plane.normal.z);
+			const __m256 d = _mm256_set1_ps(plane.distance);
+			
+			for (std::size_t i = 0; i < lane_count; i += 8)
+			{
+				__m256 distance = _mm256_add_ps(_mm256_mul_ps(nx, _mm256_loadu_ps(cx + i)), _mm256_mul_ps(ny, _mm256_loadu_ps(cy + i)));
+				distance = _mm256_add_ps(_mm256_add_ps(distance, _mm256_mul_ps(nz, _mm256_loadu_ps(cz + i))), d);
+				const __m256 negative_radius = _mm256_xor_ps(_mm256_loadu_ps(r + i), _mm256_set1_ps(-0.0f));
+				inside[i / 8] = _mm256_and_ps(inside[i / 8], _mm256_cmp_ps(distance, negative_radius, _CMP_GE_OQ));
+			}
+			
+			for (std::size_t i = lane_count; i < n; ++i)
+				tail_inside[i - lane_count] &= static_cast<std::uint32_t>(plane.normal.x * cx[i] + plane.normal.y * cy[i] + plane.normal.z * cz[i] + plane.distance >= -r[i]);
+		}
+		
+		std::uint64_t word = 0;
+		for (std::size_t i = 0; i < lane_count; i += 8)
+			word |= static_cast<std::uint64_t>(_mm256_movemask_ps(inside[i / 8])) << i;
+		for (std::size_t i = lane_count; i < n; ++i)
+			word |= static_cast<std::uint64_t>(tail_inside[i - lane_count]) << i;
+		mask[first / 64] = word;
+	}
+}
+
+#endif // ANTKEEPER_MATH_AVX
+
+} // namespace geom
+
+#endif // ANTKEEPER_GEOM_CULLING_HPP
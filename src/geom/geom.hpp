@@ -28,17 +28,22 @@ namespace geom {}
 #include "convex-hull.hpp"
 #include "cartesian.hpp"
 #include "csg.hpp"
+#include "culling.hpp"
+#include "indexed-mesh.hpp"
 #include "intersection.hpp"
 #include "marching-cubes.hpp"
 #include "mesh.hpp"
 #include "mesh-accelerator.hpp"
 #include "mesh-functions.hpp"
+#include "mesh-simplification.hpp"
 #include "morton.hpp"
 #include "octree.hpp"
 #include "plane.hpp"
 #include "projection.hpp"
 #include "ray.hpp"
 #include "sdf.hpp"
+#include "sdf-brick-map.hpp"
+#include "spatial-hash.hpp"
 #include "sphere.hpp"
 #include "spherical.hpp"
 #include "view-frustum.hpp"
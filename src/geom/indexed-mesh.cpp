@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "indexed-mesh.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace geom {
+
+void indexed_mesh::clear()
+{
+	positions.clear();
+	vertex_edges.clear();
+	edge_vertices.clear();
+	edge_faces.clear();
+	edge_next.clear();
+	edge_previous.clear();
+	face_edges.clear();
+}
+
+void indexed_mesh::reserve(std::size_t vertex_count, std::size_t triangle_count)
+{
+	// A closed triangle mesh has three half-edges per triangle, an open one up to six
+	const std::size_t edge_count = triangle_count * 3 + (triangle_count * 3) / 2;
+	
+	positions.reserve(vertex_count);
+	vertex_edges.reserve(vertex_count);
+	edge_vertices.reserve(edge_count);
+	edge_faces.reserve(edge_count);
+	edge_next.reserve(edge_count);
+	edge_previous.reserve(edge_count);
+	face_edges.reserve(triangle_count);
+}
+
+indexed_mesh::index_type indexed_mesh::add_vertex(const float3& position)
+{
+	const index_type index = static_cast<index_type>(positions.size());
+	positions.push_back(position);
+	vertex_edges.push_back(null_index);
+	return index;
+}
+
+indexed_mesh::index_type indexed_mesh::add_edge(index_type a, index_type b)
+{
+	const index_type ab = static_cast<index_type>(edge_vertices.size());
+	const index_type ba = ab + 1;
+	
+	edge_vertices.push_back(a);
+	edge_vertices.push_back(b);
+	edge_faces.push_back(null_index);
+	edge_faces.push_back(null_index);
+	edge_next.push_back(ba);
+	edge_next.push_back(ab);
+	edge_previous.push_back(ba);
+	edge_previous.push_back(ab);
+	
+	if (vertex_edges[a] == null_index)
+		vertex_edges[a] = ab;
+	if (vertex_edges[b] == null_index)
+		vertex_edges[b] = ba;
+	
+	return ab;
+}
+
+indexed_mesh::index_type indexed_mesh::add_face(const index_type* loop, std::size_t count)
+{
+	const index_type face = static_cast<index_type>(face_edges.size());
+	face_edges.push_back(loop[0]);
+	
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const index_type edge = loop[i];
+		edge_faces[edge] = face;
+		edge_next[edge] = loop[(i + 1) % count];
+		edge_previous[edge] = loop[(i + count - 1) % count];
+	}
+	
+	return face;
+}
+
+void indexed_mesh::build(const float3* positions, std::size_t vertex_count, const index_type* indices, std::size_t triangle_count)
+{
+	clear();
+	
+	this->positions.assign(positions, positions + vertex_count);
+	vertex_edges.assign(vertex_count, null_index);
+	
+	// Key each triangle corner by the undirected edge which leaves it
+	const std::size_t corner_count = triangle_count * 3;
+	build_edges.resize(corner_count);
+	for (std::size_t i = 0; i < corner_count; ++i)
+	{
+		const index_type a = indices[i];
+		const index_type b = indices[(i % 3 == 2) ? i - 2 : i + 1];
+		if (a >= vertex_count || b >= vertex_count)
+		{
+			build_edges.clear();
+			throw std::runtime_error("Triangle vertex index out of range");
+		}
+		
+		const std::uint64_t key = (static_cast<std::uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+		build_edges[i] = {key, static_cast<index_type>(i)};
+	}
+	
+	// Sort corners so that corners which share an edge become adjacent
+	std::sort(build_edges.begin(), build_edges.end());
+	
+	// Allocate a pair of half-edges for each run of equal keys
+	const std::size_t edge_capacity = corner_count * 2;
+	edge_vertices.reserve(edge_capacity);
+	edge_faces.reserve(edge_capacity);
+	build_corner_edges.resize(corner_count);
+	for (std::size_t i = 0; i < corner_count;)
+	{
+		std::size_t run = 1;
+		while (i + run < corner_count && build_edges[i + run].first == build_edges[i].first)
+			++run;
+		
+		const index_type c0 = build_edges[i].second;
+		const index_type a = indices[c0];
+		const index_type b = indices[(c0 % 3 == 2) ? c0 - 2 : c0 + 1];
+		const index_type edge = static_cast<index_type>(edge_vertices.size());
+		
+		edge_vertices.push_back(a);
+		edge_faces.push_back(c0 / 3);
+		edge_vertices.push_back(b);
+		build_corner_edges[c0] = edge;
+		
+		if (run == 1)
+		{
+			// Boundary edge
+			edge_faces.push_back(null_index);
+		}
+		else if (run == 2 && indices[build_edges[i + 1].second] == b)
+		{
+			// Interior edge, shared with an oppositely wound triangle
+			const index_type c1 = build_edges[i + 1].second;
+			edge_faces.push_back(c1 / 3);
+			build_corner_edges[c1] = edge + 1;
+		}
+		else
+		{
+			clear();
+			build_edges.clear();
+			build_corner_edges.clear();
+			throw std::runtime_error("Non-manifold mesh");
+		}
+		
+		i += run;
+	}
+	build_edges.clear();
+	
+	// Link the half-edges of each triangle
+	const std::size_t edge_count = edge_vertices.size();
+	edge_next.assign(edge_count, null_index);
+	edge_previous.assign(edge_count, null_index);
+	face_edges.resize(triangle_count);
+	for (std::size_t i = 0; i < triangle_count; ++i)
+	{
+		const index_type* edges = &build_corner_edges[i * 3];
+		for (std::size_t j = 0; j < 3; ++j)
+		{
+			edge_next[edges[j]] = edges[(j + 1) % 3];
+			edge_previous[edges[j]] = edges[(j + 2) % 3];
+			vertex_edges[edge_vertices[edges[j]]] = edges[j];
+		}
+		face_edges[i] = edges[0];
+	}
+	build_corner_edges.clear();
+	
+	// Gather boundary half-edges, keyed by the vertex at which they start and the vertex at which they end
+	for (index_type i = 1; i < edge_count; i += 2)
+	{
+		if (edge_faces[i] == null_index)
+		{
+			build_edges.push_back({edge_vertices[i], i});
+			build_boundary_edges.push_back({edge_vertices[i - 1], i});
+		}
+	}
+	
+	// Link each incoming boundary half-edge to an outgoing boundary half-edge of the same vertex
+	std::sort(build_edges.begin(), build_edges.end());
+	std::sort(build_boundary_edges.begin(), build_boundary_edges.end());
+	for (std::size_t i = 0; i < build_edges.size(); ++i)
+	{
+		const auto [outgoing_vertex, outgoing] = build_edges[i];
+		const auto [incoming_vertex, incoming] = build_boundary_edges[i];
+		if (outgoing_vertex != incoming_vertex)
+		{
+			clear();
+			build_edges.clear();
+			build_boundary_edges.clear();
+			throw std::runtime_error("Non-manifold mesh");
+		}
+		
+		edge_next[incoming] = outgoing;
+		edge_previous[outgoing] = incoming;
+		
+		// Boundary vertices start at a boundary half-edge
+		vertex_edges[outgoing_vertex] = outgoing;
+	}
+	build_edges.clear();
+	build_boundary_edges.clear();
+}
+
+void indexed_mesh::build(const std::vector<float3>& positions, const std::vector<std::array<std::uint_fast32_t, 3>>& triangles)
+{
+	std::vector<index_type> indices(triangles.size() * 3);
+	for (std::size_t i = 0; i < triangles.size(); ++i)
+	{
+		indices[i * 3] = static_cast<index_type>(triangles[i][0]);
+		indices[i * 3 + 1] = static_cast<index_type>(triangles[i][1]);
+		indices[i * 3 + 2] = static_cast<index_type>(triangles[i][2]);
+	}
+	
+	build(positions.data(), positions.size(), indices.data(), triangles.size());
+}
+
+} // namespace geom
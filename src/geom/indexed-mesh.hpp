@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTKEEPER_GEOM_INDEXED_MESH_HPP
+#define ANTKEEPER_GEOM_INDEXED_MESH_HPP
+
+#include "utility/fundamental-types.hpp"
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace geom {
+
+class mesh;
+
+/**
+ * Index-based half-edge mesh.
+ *
+ * Vertices, half-edges, and faces are stored in contiguous structure-of-arrays, and refer to each other with 32-bit indices rather than pointers. The two half-edges of an edge are stored adjacently, so the symmetric of half-edge `e` is always `e ^ 1`. Copying a mesh copies its arrays, and clearing a mesh retains their capacity, so meshes which are rebuilt frequently do not allocate once they have grown to size.
+ *
+ * @see geom::mesh
+ */
+class indexed_mesh
+{
+public:
+	/// Vertex, half-edge, and face index type.
+	typedef std::uint32_t index_type;
+	
+	/// Index which refers to no element, such as the face of a boundary half-edge.
+	static constexpr index_type null_index = ~index_type(0);
+	
+	/// Returns the symmetric of a half-edge.
+	static constexpr index_type symmetric(index_type edge) noexcept;
+	
+	/// Removes all vertices, edges, and faces from the mesh, retaining allocated storage.
+	void clear();
+	
+	/**
+	 * Reserves storage for a number of vertices and triangles.
+	 *
+	 * @param vertex_count Number of vertices.
+	 * @param triangle_count Number of triangles.
+	 */
+	void reserve(std::size_t vertex_count, std::size_t triangle_count);
+	
+	/**
+	 * Adds a vertex to the mesh. This vertex initially has a null edge.
+	 *
+	 * @param position Position of the vertex.
+	 * @return Index of the added vertex.
+	 */
+	index_type add_vertex(const float3& position);
+	
+	/**
+	 * Adds an edge to the mesh. The two half-edges of the new edge are linked to each other and have null faces.
+	 *
+	 * @param a Index of the vertex from which the edge originates.
+	 * @param b Index of the vertex at which the edge ends.
+	 * @return Index of the half-edge from @p a to @p b. Its symmetric is the half-edge from @p b to @p a.
+	 */
+	index_type add_edge(index_type a, index_type b);
+	
+	/**
+	 * Adds a face to the mesh, bounded by a loop of existing half-edges. Edge adjacency is not validated.
+	 *
+	 * @param loop Half-edges which form the face, in order.
+	 * @param count Number of half-edges in the loop.
+	 * @return Index of the added face.
+	 */
+	index_type add_face(const index_type* loop, std::size_t count);
+	
+	/**
+	 * Replaces the contents of the mesh with a triangle mesh.
+	 *
+	 * Half-edges are paired by sorting their undirected vertex keys, rather than by searching a hash map. Unpaired half-edges receive a boundary symmetric with a null face, and boundary half-edges are linked into loops.
+	 *
+	 * @param positions Vertex positions.
+	 * @param vertex_count Number of vertices.
+	 * @param indices Triangle vertex indices, three per triangle.
+	 * @param triangle_count Number of triangles.
+	 *
+	 * @exception std::runtime_error Triangle vertex index out of range.
+	 * @exception std::runtime_error Non-manifold mesh.
+	 */
+	void build(const float3* positions, std::size_t vertex_count, const index_type* indices, std::size_t triangle_count);
+	
+	/// @copydoc build(const float3*, std::size_t, const index_type*, std::size_t)
+	void build(const std::vector<float3>& positions, const std::vector<std::array<std::uint_fast32_t, 3>>& triangles);
+	
+	/// Returns the number of vertices in the mesh.
+	std::size_t get_vertex_count() const;
+	
+	/// Returns the number of half-edges in the mesh.
+	std::size_t get_edge_count() const;
+	
+	/// Returns the number of faces in the mesh.
+	std::size_t get_face_count() const;
+	
+	/// Returns the vertex positions.
+	const std::vector<float3>& get_positions() const;
+	
+	/// @copydoc get_positions() const
+	std::vector<float3>& get_positions();
+	
+	/// Returns the index of an outgoing half-edge of each vertex.
+	const std::vector<index_type>& get_vertex_edges() const;
+	
+	/// Returns the index of the vertex at which each half-edge starts.
+	const std::vector<index_type>& get_edge_vertices() const;
+	
+	/// Returns the index of the face on the left of each half-edge.
+	const std::vector<index_type>& get_edge_faces() const;
+	
+	/// Returns the index of the next half-edge in the parent face of each half-edge.
+	const std::vector<index_type>& get_edge_next() const;
+	
+	/// Returns the index of the previous half-edge in the parent face of each half-edge.
+	const std::vector<index_type>& get_edge_previous() const;
+	
+	/// Returns the index of the first half-edge of each face.
+	const std::vector<index_type>& get_face_edges() const;
+	
+	/**
+	 * Returns the indices of the three vertices of a triangular face.
+	 *
+	 * @param face Index of a triangular face.
+	 * @param[out] vertices Array in which the vertex indices will be stored.
+	 */
+	void get_triangle(index_type face, index_type* vertices) const;
+
+private:
+	friend void convert_mesh(indexed_mesh& indexed, const mesh& mesh);
+	
+	std::vector<float3> positions;
+	std::vector<index_type> vertex_edges;
+	std::vector<index_type> edge_vertices;
+	std::vector<index_type> edge_faces;
+	std::vector<index_type> edge_next;
+	std::vector<index_type> edge_previous;
+	std::vector<index_type> face_edges;
+	
+	// Scratch buffers used during construction, emptied afterwards so they are not copied
+	std::vector<std::pair<std::uint64_t, index_type>> build_edges;
+	std::vector<std::pair<std::uint64_t, index_type>> build_boundary_edges;
+	std::vector<index_type> build_corner_edges;
+};
+
+constexpr indexed_mesh::index_type indexed_mesh::symmetric(index_type edge) noexcept
+{
+	return edge ^ 1;
+}
+
+inline std::size_t indexed_mesh::get_vertex_count() const
+{
+	return positions.size();
+}
+
+inline std::size_t indexed_mesh::get_edge_count() const
+{
+	return edge_vertices.size();
+}
+
+inline std::size_t indexed_mesh::get_face_count() const
+{
+	return face_edges.size();
+}
+
+inline const std::vector<float3>& indexed_mesh::get_positions() const
+{
+	return positions;
+}
+
+inline std::vector<float3>& indexed_mesh::get_positions()
+{
+	return positions;
+}
+
+inline const std::vector<indexed_mesh::index_type>& indexed_mesh::get_vertex_edges() const
+{
+	return vertex_edges;
+}
+
+inline const std::vector<indexed_mesh::index_type>& indexed_mesh::get_edge_vertices() const
+{
+	return edge_vertices;
+}
+
+inline const std::vector<indexed_mesh::index_type>& indexed_mesh::get_edge_faces() const
+{
+	return edge_faces;
+}
+
+inline const std::vector<indexed_mesh::index_type>& indexed_mesh::get_edge_next() const
+{
+	return edge_next;
+}
+
+inline const std::vector<indexed_mesh::index_type>& indexed_mesh::get_edge_previous() const
+{
+	return edge_previous;
+}
+
+inline const std::vector<indexed_mesh::index_type>& indexed_mesh::get_face_edges() const
+{
+	return face_edges;
+}
+
+inline void indexed_mesh::get_triangle(index_type face, index_type* vertices) const
+{
+	const index_type edge = face_edges[face];
+	vertices[0] = edge_vertices[edge];
+	vertices[1] = edge_vertices[edge_next[edge]];
+	vertices[2] = edge_vertices[edge_previous[edge]];
+}
+
+} // namespace geom
+
+#endif // ANTKEEPER_GEOM_INDEXED_MESH_HPP
@@ -18,11 +18,14 @@
  */
 
 #include "marching-cubes.hpp"
+#include <algorithm>
 #include <cmath>
 
 namespace geom {
 namespace mc {
 
+static float interpolation_ratio(float f_a, float f_b);
+
 static constexpr std::uint_fast8_t vertex_table[12][2] =
 {
 	{0, 1},
@@ -39,6 +42,23 @@ static constexpr std::uint_fast8_t vertex_table[12][2] =
 	{3, 7}
 };
 
+/// Offset of the first corner of each edge from the first corner of its cell, followed by the axis along which the edge lies.
+static constexpr std::uint_fast8_t edge_offsets[12][4] =
+{
+	{0, 0, 0, 0},
+	{1, 0, 0, 1},
+	{0, 1, 0, 0},
+	{0, 0, 0, 1},
+	{0, 0, 1, 0},
+	{1, 0, 1, 1},
+	{0, 1, 1, 0},
+	{0, 0, 1, 1},
+	{0, 0, 0, 2},
+	{1, 0, 0, 2},
+	{1, 1, 0, 2},
+	{0, 1, 0, 2}
+};
+
 static constexpr std::uint_fast16_t edge_table[256] =
 {
 	0x000, 0x109, 0x203, 0x30a, 0x406, 0x50f, 0x605, 0x70c,
@@ -369,16 +389,7 @@ void polygonize(float* vertices, std::uint_fast8_t* vertex_count, std::int_fast8
 			float f_b = distances[b];
 
 			// Determine interpolation ratio
-			static const float epsilon = 0.00001f;
-			float t;
-			if (std::fabs(f_a) < epsilon)
-				t = 1.0f;
-			else if (std::fabs(f_b) < epsilon)
-				t = 0.0f;
-			else if (std::fabs(f_b - f_a) < epsilon)
-				t = 0.5f; // Paul Bourke suggested this be 1.0f? Why?
-			else
-				t = (-f_a) / (f_b - f_a);	
+			const float t = interpolation_ratio(f_a, f_b);
 
 			// Interpolate between vertices
 			float* v = vertex_buffer + i * 3;
@@ -414,5 +425,128 @@ void polygonize(float* vertices, std::uint_fast8_t* vertex_count, std::int_fast8
 	}
 }
 
+void polygonize(std::vector<float>& vertices, std::vector<std::uint32_t>& triangles, std::vector<std::uint32_t>* vertex_edges, const float* distances, const std::uint32_t* size, const float* origin, float spacing)
+{
+	const std::uint32_t size_x = size[0];
+	const std::uint32_t size_y = size[1];
+	const std::uint32_t size_z = size[2];
+	if (size_x < 2 || size_y < 2 || size_z < 2)
+		return;
+	
+	const std::size_t slice_size = static_cast<std::size_t>(size_x) * size_y;
+	const std::size_t strides[3] = {1, size_x, slice_size};
+	const std::uint32_t cell_count_x = size_x - 1;
+	const std::uint32_t cell_count_y = size_y - 1;
+	static constexpr std::uint32_t no_vertex = ~std::uint32_t(0);
+	
+	// Inside flags of the two sample slices bounding the current slab
+	std::vector<std::uint8_t> inside(slice_size * 2);
+	
+	// Case indices of the cells in the current slab
+	std::vector<std::uint8_t> cases(static_cast<std::size_t>(cell_count_x) * cell_count_y);
+	
+	// Vertex caches for the x- and y-edges of the two bounding slices, and the z-edges of the slab
+	std::vector<std::uint32_t> edge_vertices(slice_size * 5, no_vertex);
+	
+	// Returns the vertex on an edge, generating it if necessary
+	auto edge_vertex = [&](std::uint32_t x, std::uint32_t y, std::uint32_t z, std::uint_fast8_t edge) -> std::uint32_t
+	{
+		const std::uint_fast8_t* offset = edge_offsets[edge];
+		const std::uint32_t sx = x + offset[0];
+		const std::uint32_t sy = y + offset[1];
+		const std::uint32_t sz = z + offset[2];
+		const std::uint_fast8_t axis = offset[3];
+		
+		const std::size_t slice_index = static_cast<std::size_t>(sy) * size_x + sx;
+		std::uint32_t& cached = (axis == 2) ? edge_vertices[slice_size * 4 + slice_index] : edge_vertices[slice_size * ((sz & 1) * 2 + axis) + slice_index];
+		if (cached != no_vertex)
+			return cached;
+		
+		const std::size_t sample = static_cast<std::size_t>(sz) * slice_size + slice_index;
+		const float t = interpolation_ratio(distances[sample], distances[sample + strides[axis]]);
+		
+		float position[3] =
+		{
+			static_cast<float>(sx),
+			static_cast<float>(sy),
+			static_cast<float>(sz)
+		};
+		position[axis] += t;
+		
+		cached = static_cast<std::uint32_t>(vertices.size() / 3);
+		for (int i = 0; i < 3; ++i)
+			vertices.push_back(origin[i] + position[i] * spacing);
+		if (vertex_edges)
+			vertex_edges->push_back(static_cast<std::uint32_t>(sample * 3 + axis));
+		
+		return cached;
+	};
+	
+	// Classify first slice
+	for (std::size_t i = 0; i < slice_size; ++i)
+		inside[i] = (distances[i] < 0.0f);
+	
+	for (std::uint32_t z = 0; z < size_z - 1; ++z)
+	{
+		const std::size_t next = (z + 1) & 1;
+		const std::uint8_t* inside0 = &inside[slice_size * (z & 1)];
+		std::uint8_t* inside1 = &inside[slice_size * next];
+		
+		// Classify next slice
+		const float* next_distances = distances + slice_size * (z + 1);
+		for (std::size_t i = 0; i < slice_size; ++i)
+			inside1[i] = (next_distances[i] < 0.0f);
+		
+		// Reset vertex caches of the next slice and the slab
+		std::fill(edge_vertices.begin() + slice_size * next * 2, edge_vertices.begin() + slice_size * (next * 2 + 2), no_vertex);
+		std::fill(edge_vertices.begin() + slice_size * 4, edge_vertices.end(), no_vertex);
+		
+		// Form case indices of a row of cells at a time
+		for (std::uint32_t y = 0; y < cell_count_y; ++y)
+		{
+			const std::uint8_t* a0 = inside0 + static_cast<std::size_t>(y) * size_x;
+			const std::uint8_t* b0 = a0 + size_x;
+			const std::uint8_t* a1 = inside1 + static_cast<std::size_t>(y) * size_x;
+			const std::uint8_t* b1 = a1 + size_x;
+			std::uint8_t* row = &cases[static_cast<std::size_t>(y) * cell_count_x];
+			
+			for (std::uint32_t x = 0; x < cell_count_x; ++x)
+			{
+				row[x] = static_cast<std::uint8_t>(
+					a0[x] | (a0[x + 1] << 1) | (b0[x + 1] << 2) | (b0[x] << 3) |
+					(a1[x] << 4) | (a1[x + 1] << 5) | (b1[x + 1] << 6) | (b1[x] << 7));
+			}
+		}
+		
+		// Form triangles
+		for (std::uint32_t y = 0; y < cell_count_y; ++y)
+		{
+			const std::uint8_t* row = &cases[static_cast<std::size_t>(y) * cell_count_x];
+			for (std::uint32_t x = 0; x < cell_count_x; ++x)
+			{
+				if (!edge_table[row[x]])
+					continue;
+				
+				for (const std::int_fast8_t* edge = triangle_table[row[x]]; *edge != -1; ++edge)
+					triangles.push_back(edge_vertex(x, y, z, static_cast<std::uint_fast8_t>(*edge)));
+			}
+		}
+	}
+}
+
+float interpolation_ratio(float f_a, float f_b)
+{
+	static const float epsilon = 0.00001f;
+	
+	if (std::fabs(f_a) < epsilon)
+		return 0.0f;
+	else if (std::fabs(f_b) < epsilon)
+		return 1.0f;
+	else if (std::fabs(f_b - f_a) < epsilon)
+		return 0.5f; // Paul Bourke suggested this be 1.0f? Why?
+	
+	return (-f_a) / (f_b - f_a);
+}
+
 } // namespace mc
 } // namespace geom
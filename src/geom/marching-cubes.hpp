@@ -21,6 +21,7 @@
 #define ANTKEEPER_GEOM_MARCHING_CUBES_HPP
 
 #include <cstdint>
+#include <vector>
 
 namespace geom {
 
@@ -37,6 +38,21 @@ namespace mc {
  */
 void polygonize(float* vertices, std::uint_fast8_t* vertex_count, std::int_fast8_t* triangles, std::uint_fast8_t* triangle_count, const float* corners, const float* distances);
 
+/**
+ * Uses the marching cubes algorithm to polygonize a dense grid of samples.
+ *
+ * The grid is processed one slab of cells at a time. Vertices are cached per grid edge, so a vertex shared by neighboring cells is generated once, and triangles index into the generated vertices.
+ *
+ * @param[out] vertices Vector to which vertex positions will be appended, three floats per vertex.
+ * @param[out] triangles Vector to which triangle vertex indices will be appended, three indices per triangle. Indices account for any vertices already in @p vertices.
+ * @param[out] vertex_edges Optional vector to which the grid edge of each generated vertex will be appended, as `sample * 3 + axis`, where `sample` is the index of the first sample of the edge.
+ * @param distances Signed sample distances, indexed by `(z * size[1] + y) * size[0] + x`. Negative distances are inside the surface.
+ * @param size Number of samples along each axis.
+ * @param origin Position of the first sample.
+ * @param spacing Distance between adjacent samples.
+ */
+void polygonize(std::vector<float>& vertices, std::vector<std::uint32_t>& triangles, std::vector<std::uint32_t>* vertex_edges, const float* distances, const std::uint32_t* size, const float* origin, float spacing);
+
 /**
  * Vertices of a unit cube.
  */
@@ -87,6 +87,23 @@ void calculate_face_normals(float3* normals, const mesh& mesh)
 	}
 }
 
+void calculate_face_normals(float3* normals, const indexed_mesh& mesh)
+{
+	const std::vector<float3>& positions = mesh.get_positions();
+	const std::size_t face_count = mesh.get_face_count();
+	
+	for (std::size_t i = 0; i < face_count; ++i)
+	{
+		indexed_mesh::index_type triangle[3];
+		mesh.get_triangle(static_cast<indexed_mesh::index_type>(i), triangle);
+		const float3& a = positions[triangle[0]];
+		const float3& b = positions[triangle[1]];
+		const float3& c = positions[triangle[2]];
+		
+		normals[i] = math::normalize(math::cross(b - a, c - a));
+	}
+}
+
 float3 calculate_face_normal(const mesh::face& face)
 {
 	const float3& a = face.edge->vertex->position;
@@ -184,6 +201,115 @@ aabb<float> calculate_bounds(const mesh& mesh)
 	return aabb<float>{bounds_min, bounds_max};
 }
 
+aabb<float> calculate_bounds(const indexed_mesh& mesh)
+{
+	float3 bounds_min;
+	float3 bounds_max;
+	for (int i = 0; i < 3; ++i)
+	{
+		bounds_min[i] = std::numeric_limits<float>::infinity();
+		bounds_max[i] = -std::numeric_limits<float>::infinity();
+	}
+	
+	for (const float3& position: mesh.get_positions())
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			bounds_min[i] = std::min<float>(bounds_min[i], position[i]);
+			bounds_max[i] = std::max<float>(bounds_max[i], position[i]);
+		}
+	}
+	
+	return aabb<float>{bounds_min, bounds_max};
+}
+
+void convert_mesh(indexed_mesh& indexed, const mesh& mesh)
+{
+	typedef indexed_mesh::index_type index_type;
+	
+	const std::vector<mesh::vertex*>& vertices = mesh.get_vertices();
+	const std::vector<mesh::edge*>& edges = mesh.get_edges();
+	const std::vector<mesh::face*>& faces = mesh.get_faces();
+	
+	// Maps a pointer-based half-edge to its indexed half-edge
+	auto edge_index = [&edges](const mesh::edge* edge) -> index_type
+	{
+		if (!edge)
+			return indexed_mesh::null_index;
+		return static_cast<index_type>(edge->index * 2 + (edge != edges[edge->index]));
+	};
+	
+	indexed.clear();
+	
+	// Copy vertices
+	indexed.positions.resize(vertices.size());
+	indexed.vertex_edges.resize(vertices.size());
+	for (std::size_t i = 0; i < vertices.size(); ++i)
+	{
+		indexed.positions[i] = vertices[i]->position;
+		indexed.vertex_edges[i] = edge_index(vertices[i]->edge);
+	}
+	
+	// Copy edges
+	const std::size_t edge_count = edges.size() * 2;
+	indexed.edge_vertices.resize(edge_count);
+	indexed.edge_faces.resize(edge_count);
+	indexed.edge_next.resize(edge_count);
+	indexed.edge_previous.resize(edge_count);
+	for (std::size_t i = 0; i < edges.size(); ++i)
+	{
+		const mesh::edge* edge = edges[i];
+		for (std::size_t j = i * 2; j < i * 2 + 2; ++j)
+		{
+			indexed.edge_vertices[j] = static_cast<index_type>(edge->vertex->index);
+			indexed.edge_faces[j] = (edge->face) ? static_cast<index_type>(edge->face->index) : indexed_mesh::null_index;
+			indexed.edge_next[j] = edge_index(edge->next);
+			indexed.edge_previous[j] = edge_index(edge->previous);
+			edge = edge->symmetric;
+		}
+	}
+	
+	// Copy faces
+	indexed.face_edges.resize(faces.size());
+	for (std::size_t i = 0; i < faces.size(); ++i)
+		indexed.face_edges[i] = edge_index(faces[i]->edge);
+}
+
+void convert_mesh(mesh& mesh, const indexed_mesh& indexed)
+{
+	const std::vector<float3>& positions = indexed.get_positions();
+	const std::vector<indexed_mesh::index_type>& edge_vertices = indexed.get_edge_vertices();
+	const std::vector<indexed_mesh::index_type>& edge_next = indexed.get_edge_next();
+	const std::vector<indexed_mesh::index_type>& face_edges = indexed.get_face_edges();
+	
+	mesh.clear();
+	
+	for (const float3& position: positions)
+		mesh.add_vertex(position);
+	
+	// Add edges in order, so that indexed half-edge 2i maps to edge i
+	const std::vector<mesh::vertex*>& vertices = mesh.get_vertices();
+	for (std::size_t i = 0; i < edge_vertices.size(); i += 2)
+		mesh.add_edge(vertices[edge_vertices[i]], vertices[edge_vertices[i + 1]]);
+	
+	// Add faces from their half-edge loops
+	const std::vector<mesh::edge*>& edges = mesh.get_edges();
+	mesh::loop loop;
+	for (indexed_mesh::index_type first: face_edges)
+	{
+		loop.clear();
+		indexed_mesh::index_type edge = first;
+		do
+		{
+			loop.push_back((edge & 1) ? edges[edge >> 1]->symmetric : edges[edge >> 1]);
+			edge = edge_next[edge];
+		}
+		while (edge != first);
+		
+		mesh.add_face(loop);
+	}
+}
+
 mesh::vertex* poke_face(mesh& mesh, std::size_t index)
 {
 	mesh::face* face = mesh.get_faces()[index];
@@ -21,6 +21,7 @@
 #define ANTKEEPER_GEOM_MESH_FUNCTIONS_HPP
 
 #include "geom/aabb.hpp"
+#include "geom/indexed-mesh.hpp"
 #include "geom/mesh.hpp"
 #include "utility/fundamental-types.hpp"
 #include <array>
@@ -45,6 +46,9 @@ void create_triangle_mesh(mesh& mesh, const std::vector<float3>& vertices, const
  */
 void calculate_face_normals(float3* normals, const mesh& mesh);
 
+/// @copydoc calculate_face_normals(float3*, const mesh&)
+void calculate_face_normals(float3* normals, const indexed_mesh& mesh);
+
 float3 calculate_face_normal(const mesh::face& face);
 
 /**
@@ -61,6 +65,25 @@ void calculate_vertex_tangents(float4* tangents, const float2* texcoords, const
  */
 aabb<float> calculate_bounds(const mesh& mesh);
 
+/// @copydoc calculate_bounds(const mesh&)
+aabb<float> calculate_bounds(const indexed_mesh& mesh);
+
+/**
+ * Copies a pointer-based mesh into an indexed mesh. Vertex, face, and edge indices are preserved; edge `i` of the source mesh becomes half-edge `2i`, and its symmetric half-edge `2i + 1`.
+ *
+ * @param[out] indexed Indexed mesh to overwrite.
+ * @param mesh Source mesh.
+ */
+void convert_mesh(indexed_mesh& indexed, const mesh& mesh);
+
+/**
+ * Copies an indexed mesh into a pointer-based mesh, for use with functions which operate on pointer-based meshes.
+ *
+ * @param[out] mesh Mesh to overwrite.
+ * @param indexed Source indexed mesh.
+ */
+void convert_mesh(mesh& mesh, const indexed_mesh& indexed);
+
 /**
  * Triangulates a face by adding a new vertex in the center, then creating triangles between the edges of the original face and the new vertex.
  *
@@ -0,0 +1,386 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "geom/mesh-simplification.hpp"
+#include "geom/mesh-functions.hpp"
+#include "math/math.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace geom {
+
+namespace {
+
+/// Symmetric 4x4 error quadric, stored as its upper triangle.
+struct quadric
+{
+	double a[10] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+	
+	/// Adds the quadric of the plane `dot(n, x) + d = 0`.
+	void add_plane(const double3& n, double d)
+	{
+		a[0] += n.x * n.x; a[1] += n.x * n.y; a[2] += n.x * n.z; a[3] += n.x * d;
+		a[4] += n.y * n.y; a[5] += n.y * n.z; a[6] += n.y * d;
+		a[7] += n.z * n.z; a[8] += n.z * d;
+		a[9] += d * d;
+	}
+	
+	quadric& operator+=(const quadric& other)
+	{
+		for (int i = 0; i < 10; ++i)
+			a[i] += other.a[i];
+		return *this;
+	}
+	
+	/// Returns the sum of squared distances between a point and the planes of the quadric.
+	double evaluate(const double3& p) const
+	{
+		return a[0] * p.x * p.x + 2.0 * a[1] * p.x * p.y + 2.0 * a[2] * p.x * p.z + 2.0 * a[3] * p.x
+			+ a[4] * p.y * p.y + 2.0 * a[5] * p.y * p.z + 2.0 * a[6] * p.y
+			+ a[7] * p.z * p.z + 2.0 * a[8] * p.z
+			+ a[9];
+	}
+	
+	/// Finds the point which minimizes the quadric error, returning `false` if the quadric is singular.
+	bool minimize(double3& p) const
+	{
+		const math::matrix<double, 3, 3> m =
+		{{
+			{a[0], a[1], a[2]},
+			{a[1], a[4], a[5]},
+			{a[2], a[5], a[7]}
+		}};
+		
+		const double det = math::determinant(m);
+		if (std::abs(det) < 1e-12)
+			return false;
+		
+		p = math::inverse(m) * double3{-a[3], -a[6], -a[8]};
+		return true;
+	}
+};
+
+/// Candidate edge collapse, which moves vertex `u` to `position` and merges vertex `v` into it.
+struct collapse
+{
+	double cost;
+	std::uint32_t u;
+	std::uint32_t v;
+	std::uint32_t u_version;
+	std::uint32_t v_version;
+	double3 position;
+	
+	bool operator<(const collapse& other) const
+	{
+		// Order the priority queue by increasing cost
+		return cost > other.cost;
+	}
+};
+
+} // namespace
+
+static double3 triangle_normal(const double3& a, const double3& b, const double3& c)
+{
+	return math::cross(b - a, c - a);
+}
+
+float simplify(mesh& mesh, std::size_t face_count, float max_error)
+{
+	// Triangulate mesh faces
+	std::vector<double3> positions;
+	positions.reserve(mesh.get_vertices().size());
+	for (const mesh::vertex* vertex: mesh.get_vertices())
+		positions.push_back(math::type_cast<double>(vertex->position));
+	
+	std::vector<std::array<std::uint32_t, 3>> triangles;
+	for (const mesh::face* face: mesh.get_faces())
+	{
+		const std::uint32_t first = static_cast<std::uint32_t>(face->edge->vertex->index);
+		for (const mesh::edge* edge = face->edge->next; edge->next != face->edge; edge = edge->next)
+		{
+			triangles.push_back({first, static_cast<std::uint32_t>(edge->vertex->index), static_cast<std::uint32_t>(edge->next->vertex->index)});
+		}
+	}
+	
+	const std::size_t vertex_count = positions.size();
+	std::vector<quadric> quadrics(vertex_count);
+	std::vector<std::vector<std::uint32_t>> vertex_triangles(vertex_count);
+	std::vector<std::uint32_t> versions(vertex_count, 0);
+	std::vector<bool> vertex_alive(vertex_count, true);
+	std::vector<bool> boundary(vertex_count, false);
+	std::vector<bool> triangle_alive(triangles.size(), true);
+	std::size_t triangle_count = triangles.size();
+	
+	// Count the triangles adjacent to each undirected edge
+	std::unordered_map<std::uint64_t, std::uint32_t> edge_triangles;
+	auto edge_key = [](std::uint32_t a, std::uint32_t b) -> std::uint64_t
+	{
+		return (static_cast<std::uint64_t>(std::min(a, b)) << 32) | std::max(a, b);
+	};
+	for (std::uint32_t i = 0; i < triangles.size(); ++i)
+	{
+		for (int j = 0; j < 3; ++j)
+		{
+			vertex_triangles[triangles[i][j]].push_back(i);
+			++edge_triangles[edge_key(triangles[i][j], triangles[i][(j + 1) % 3])];
+		}
+	}
+	
+	// Accumulate face plane quadrics, and boundary edge plane quadrics
+	for (const auto& triangle: triangles)
+	{
+		const double3& a = positions[triangle[0]];
+		const double3& b = positions[triangle[1]];
+		const double3& c = positions[triangle[2]];
+		
+		double3 normal = triangle_normal(a, b, c);
+		const double area = math::length(normal);
+		if (area <= 0.0)
+			continue;
+		normal /= area;
+		
+		quadric face_quadric;
+		face_quadric.add_plane(normal, -math::dot(normal, a));
+		for (int j = 0; j < 3; ++j)
+			quadrics[triangle[j]] += face_quadric;
+		
+		for (int j = 0; j < 3; ++j)
+		{
+			const std::uint32_t start = triangle[j];
+			const std::uint32_t end = triangle[(j + 1) % 3];
+			if (edge_triangles[edge_key(start, end)] != 1)
+				continue;
+			
+			boundary[start] = true;
+			boundary[end] = true;
+			
+			double3 boundary_normal = math::cross(positions[end] - positions[start], normal);
+			const double length = math::length(boundary_normal);
+			if (length <= 0.0)
+				continue;
+			boundary_normal /= length;
+			
+			quadric boundary_quadric;
+			boundary_quadric.add_plane(boundary_normal, -math::dot(boundary_normal, positions[start]));
+			quadrics[start] += boundary_quadric;
+			quadrics[end] += boundary_quadric;
+		}
+	}
+	
+	// Queue a collapse for every edge
+	std::priority_queue<collapse> queue;
+	auto push_collapse = [&](std::uint32_t u, std::uint32_t v)
+	{
+		quadric q = quadrics[u];
+		q += quadrics[v];
+		
+		collapse c;
+		c.u = u;
+		c.v = v;
+		c.u_version = versions[u];
+		c.v_version = versions[v];
+		
+		// Boundary vertices are kept on the boundary
+		if (!q.minimize(c.position) || (boundary[u] != boundary[v]))
+		{
+			c.position = boundary[v] && !boundary[u] ? positions[v] : positions[u];
+			if (boundary[u] == boundary[v])
+			{
+				const double3 midpoint = (positions[u] + positions[v]) * 0.5;
+				if (q.evaluate(positions[v]) < q.evaluate(c.position))
+					c.position = positions[v];
+				if (q.evaluate(midpoint) < q.evaluate(c.position))
+					c.position = midpoint;
+			}
+		}
+		c.cost = std::max(0.0, q.evaluate(c.position));
+		
+		queue.push(c);
+	};
+	for (const auto& edge: edge_triangles)
+	{
+		push_collapse(static_cast<std::uint32_t>(edge.first >> 32), static_cast<std::uint32_t>(edge.first & 0xffffffff));
+	}
+	
+	std::vector<std::uint32_t> u_neighbors;
+	std::vector<std::uint32_t> v_neighbors;
+	auto gather_neighbors = [&](std::uint32_t vertex, std::vector<std::uint32_t>& neighbors)
+	{
+		neighbors.clear();
+		for (std::uint32_t t: vertex_triangles[vertex])
+			for (std::uint32_t w: triangles[t])
+				if (w != vertex)
+					neighbors.push_back(w);
+		std::sort(neighbors.begin(), neighbors.end());
+		neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+	};
+	
+	double error = 0.0;
+	const double max_cost = static_cast<double>(max_error) * static_cast<double>(max_error);
+	
+	while (triangle_count > face_count && !queue.empty())
+	{
+		const collapse c = queue.top();
+		queue.pop();
+		
+		// Skip collapses which were invalidated by previous collapses
+		if (!vertex_alive[c.u] || !vertex_alive[c.v] || versions[c.u] != c.u_version || versions[c.v] != c.v_version)
+			continue;
+		
+		if (c.cost > max_cost)
+			break;
+		
+		// Count the triangles which share the edge
+		std::size_t shared_count = 0;
+		for (std::uint32_t t: vertex_triangles[c.v])
+		{
+			const auto& triangle = triangles[t];
+			if (triangle[0] == c.u || triangle[1] == c.u || triangle[2] == c.u)
+				++shared_count;
+		}
+		
+		// Reject non-manifold edges, and interior edges between boundary vertices
+		if (!shared_count || shared_count > 2 || (shared_count == 2 && boundary[c.u] && boundary[c.v]))
+			continue;
+		
+		// Reject collapses which violate the link condition
+		gather_neighbors(c.u, u_neighbors);
+		gather_neighbors(c.v, v_neighbors);
+		std::size_t common_count = 0;
+		for (std::size_t i = 0, j = 0; i < u_neighbors.size() && j < v_neighbors.size();)
+		{
+			if (u_neighbors[i] < v_neighbors[j])
+				++i;
+			else if (u_neighbors[i] > v_neighbors[j])
+				++j;
+			else
+			{
+				++common_count;
+				++i;
+				++j;
+			}
+		}
+		if (common_count != shared_count)
+			continue;
+		
+		// Reject collapses which fold triangles over
+		bool folds = false;
+		for (std::uint32_t vertex: {c.u, c.v})
+		{
+			for (std::uint32_t t: vertex_triangles[vertex])
+			{
+				const auto& triangle = triangles[t];
+				std::array<double3, 3> moved;
+				bool shared = false;
+				for (int j = 0; j < 3; ++j)
+				{
+					shared |= (triangle[j] == (vertex == c.u ? c.v : c.u));
+					moved[j] = (triangle[j] == vertex) ? c.position : positions[triangle[j]];
+				}
+				if (shared)
+					continue;
+				
+				const double3 old_normal = triangle_normal(positions[triangle[0]], positions[triangle[1]], positions[triangle[2]]);
+				const double3 new_normal = triangle_normal(moved[0], moved[1], moved[2]);
+				if (math::dot(old_normal, new_normal) <= 0.0 || math::length_squared(new_normal) <= 0.0)
+				{
+					folds = true;
+					break;
+				}
+			}
+			
+			if (folds)
+				break;
+		}
+		if (folds)
+			continue;
+		
+		// Collapse v into u
+		positions[c.u] = c.position;
+		quadrics[c.u] += quadrics[c.v];
+		boundary[c.u] = boundary[c.u] || boundary[c.v];
+		for (std::uint32_t t: vertex_triangles[c.v])
+		{
+			auto& triangle = triangles[t];
+			if (triangle[0] == c.u || triangle[1] == c.u || triangle[2] == c.u)
+			{
+				// Remove the triangles which share the edge
+				triangle_alive[t] = false;
+				--triangle_count;
+				for (std::uint32_t w: triangle)
+				{
+					if (w != c.v)
+					{
+						auto& list = vertex_triangles[w];
+						list.erase(std::remove(list.begin(), list.end(), t), list.end());
+					}
+				}
+			}
+			else
+			{
+				for (std::uint32_t& w: triangle)
+					if (w == c.v)
+						w = c.u;
+				vertex_triangles[c.u].push_back(t);
+			}
+		}
+		vertex_triangles[c.v].clear();
+		vertex_alive[c.v] = false;
+		++versions[c.u];
+		
+		error = std::max(error, c.cost);
+		
+		// Queue new collapses for the edges of u
+		gather_neighbors(c.u, u_neighbors);
+		for (std::uint32_t w: u_neighbors)
+			push_collapse(c.u, w);
+	}
+	
+	// Compact remaining vertices and triangles
+	std::vector<std::uint_fast32_t> remap(vertex_count, 0);
+	std::vector<float3> simplified_vertices;
+	for (std::uint32_t i = 0; i < vertex_count; ++i)
+	{
+		if (vertex_alive[i] && !vertex_triangles[i].empty())
+		{
+			remap[i] = simplified_vertices.size();
+			simplified_vertices.push_back(math::type_cast<float>(positions[i]));
+		}
+	}
+	std::vector<std::array<std::uint_fast32_t, 3>> simplified_triangles;
+	simplified_triangles.reserve(triangle_count);
+	for (std::size_t i = 0; i < triangles.size(); ++i)
+	{
+		if (triangle_alive[i])
+			simplified_triangles.push_back({remap[triangles[i][0]], remap[triangles[i][1]], remap[triangles[i][2]]});
+	}
+	
+	// Rebuild mesh
+	mesh.clear();
+	create_triangle_mesh(mesh, simplified_vertices, simplified_triangles);
+	
+	return static_cast<float>(std::sqrt(error));
+}
+
+} // namespace geom
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTKEEPER_GEOM_MESH_SIMPLIFICATION_HPP
+#define ANTKEEPER_GEOM_MESH_SIMPLIFICATION_HPP
+
+#include "geom/mesh.hpp"
+#include <limits>
+
+namespace geom {
+
+/**
+ * Simplifies a triangle mesh by collapsing edges in order of increasing quadric error. Faces with more than three edges are triangulated before simplification.
+ *
+ * Each vertex accumulates the quadrics of the planes of its original faces, and of planes perpendicular to its boundary edges. Collapses which would fold a face over, or make the mesh non-manifold, are rejected.
+ *
+ * @param[in,out] mesh Mesh to simplify. The mesh is rebuilt from the simplified triangles, so pointers to its vertices, edges, and faces are invalidated.
+ * @param face_count Number of faces at which simplification stops.
+ * @param max_error Error at which simplification stops.
+ * @return Upper bound on the distance between the simplified mesh and the planes of the original faces, in mesh units.
+ *
+ * @see Garland, M., & Heckbert, P. S. (1997). Surface simplification using quadric error metrics.
+ */
+float simplify(mesh& mesh, std::size_t face_count, float max_error = std::numeric_limits<float>::infinity());
+
+} // namespace geom
+
+#endif // ANTKEEPER_GEOM_MESH_SIMPLIFICATION_HPP
@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "sdf-brick-map.hpp"
+#include "geom/marching-cubes.hpp"
+#include "geom/morton.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace geom {
+
+sdf_brick_map::sdf_brick_map(const float3& origin, float spacing, const uint3& cell_count, float band):
+	origin(origin),
+	spacing(spacing),
+	cell_count(cell_count),
+	quantization_scale(127.0f / band),
+	dequantization_scale(band / 127.0f)
+{
+	// Samples span one more than the cell count along each axis
+	for (int i = 0; i < 3; ++i)
+		brick_count[i] = cell_count[i] / brick_size + 1;
+}
+
+void sdf_brick_map::clear()
+{
+	samples.clear();
+	brick_codes.clear();
+	brick_indices.clear();
+}
+
+void sdf_brick_map::stamp_sphere(const float3& center, float radius)
+{
+	// Find the range of bricks within reach of the sphere, extended by one sample so that every cell it intersects has its first corner in an allocated brick
+	const float reach = radius + spacing;
+	std::uint32_t brick_min[3];
+	std::uint32_t brick_max[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		const float lower = (center[i] - reach - origin[i]) / spacing;
+		const float upper = (center[i] + reach - origin[i]) / spacing;
+		if (upper < 0.0f || lower > static_cast<float>(cell_count[i]))
+			return;
+		
+		const std::uint32_t sample_min = (lower <= 0.0f) ? 0 : static_cast<std::uint32_t>(lower);
+		const std::uint32_t sample_max = std::min<std::uint32_t>(static_cast<std::uint32_t>(std::ceil(upper)), cell_count[i]);
+		brick_min[i] = sample_min / brick_size;
+		brick_max[i] = sample_max / brick_size;
+	}
+	
+	const float brick_extent = spacing * static_cast<float>(brick_size);
+	
+	for (std::uint32_t bz = brick_min[2]; bz <= brick_max[2]; ++bz)
+	{
+		for (std::uint32_t by = brick_min[1]; by <= brick_max[1]; ++by)
+		{
+			for (std::uint32_t bx = brick_min[0]; bx <= brick_max[0]; ++bx)
+			{
+				sample_type* brick = &samples[find_or_allocate_brick(bx, by, bz) * brick_volume];
+				
+				// Squared distances from the sphere center to each sample of a brick slice, in the xy-plane
+				const float x0 = origin.x + static_cast<float>(bx) * brick_extent - center.x;
+				const float y0 = origin.y + static_cast<float>(by) * brick_extent - center.y;
+				float dxy[brick_size * brick_size];
+				for (std::uint32_t y = 0; y < brick_size; ++y)
+				{
+					const float dy = y0 + static_cast<float>(y) * spacing;
+					for (std::uint32_t x = 0; x < brick_size; ++x)
+					{
+						const float dx = x0 + static_cast<float>(x) * spacing;
+						dxy[y * brick_size + x] = dx * dx + dy * dy;
+					}
+				}
+				
+				for (std::uint32_t z = 0; z < brick_size; ++z)
+				{
+					const float dz = origin.z + static_cast<float>(bz) * brick_extent + static_cast<float>(z) * spacing - center.z;
+					const float dzz = dz * dz;
+					sample_type* slice = brick + z * brick_size * brick_size;
+					
+					// Branch-free so that the slice is vectorized
+					for (std::uint32_t i = 0; i < brick_size * brick_size; ++i)
+					{
+						float d = (radius - std::sqrt(dxy[i] + dzz)) * quantization_scale + sample_bias;
+						d = (d < 1.0f) ? 1.0f : d;
+						d = (d > 254.0f) ? 254.0f : d;
+						const sample_type q = static_cast<sample_type>(static_cast<std::int32_t>(d));
+						slice[i] = (q > slice[i]) ? q : slice[i];
+					}
+				}
+			}
+		}
+	}
+}
+
+void sdf_brick_map::polygonize(std::vector<float>& vertices, std::vector<std::uint32_t>& triangles) const
+{
+	// Dequantized brick samples, plus a one-sample apron borrowed from the neighboring bricks in the positive directions
+	constexpr std::uint32_t cache_size = brick_size + 1;
+	float cache[cache_size * cache_size * cache_size];
+	const float empty_distance = (static_cast<float>(empty_sample) + 0.5f - sample_bias) * dequantization_scale;
+	
+	std::vector<float> brick_vertices;
+	std::vector<std::uint32_t> brick_triangles;
+	std::vector<std::uint32_t> brick_edges;
+	std::vector<std::uint32_t> remap;
+	
+	// Vertices on brick faces, keyed by their global grid edge
+	std::unordered_map<std::uint64_t, std::uint32_t> seam_vertices;
+	const std::uint64_t sample_count_x = static_cast<std::uint64_t>(cell_count.x) + 1;
+	const std::uint64_t sample_count_y = static_cast<std::uint64_t>(cell_count.y) + 1;
+	
+	for (std::uint64_t code: brick_codes)
+	{
+		std::uint64_t bx;
+		std::uint64_t by;
+		std::uint64_t bz;
+		morton::decode(code, bx, by, bz);
+		
+		// Clip cells to the edge of the field
+		const std::uint32_t cell_begin[3] =
+		{
+			static_cast<std::uint32_t>(bx) * brick_size,
+			static_cast<std::uint32_t>(by) * brick_size,
+			static_cast<std::uint32_t>(bz) * brick_size
+		};
+		std::uint32_t size[3];
+		for (int i = 0; i < 3; ++i)
+			size[i] = std::min<std::uint32_t>(brick_size, cell_count[i] - std::min<std::uint32_t>(cell_count[i], cell_begin[i])) + 1;
+		if (size[0] < 2 || size[1] < 2 || size[2] < 2)
+			continue;
+		
+		// Find this brick and its seven neighbors in the positive directions
+		const sample_type* neighbors[8];
+		for (std::uint32_t i = 0; i < 8; ++i)
+		{
+			const std::int32_t index = find_brick(bx + (i & 1), by + ((i >> 1) & 1), bz + ((i >> 2) & 1));
+			neighbors[i] = (index < 0) ? nullptr : &samples[index * brick_volume];
+		}
+		
+		// Fill sample cache
+		float* sample = cache;
+		for (std::uint32_t z = 0; z < size[2]; ++z)
+		{
+			for (std::uint32_t y = 0; y < size[1]; ++y)
+			{
+				for (std::uint32_t x = 0; x < size[0]; ++x)
+				{
+					const sample_type* brick = neighbors[(x >> 3) | ((y >> 3) << 1) | ((z >> 3) << 2)];
+					*(sample++) = (brick) ? (static_cast<float>(brick[((z & 7) * brick_size + (y & 7)) * brick_size + (x & 7)]) + 0.5f - sample_bias) * dequantization_scale : empty_distance;
+				}
+			}
+		}
+		
+		// Polygonize brick
+		const float brick_origin[3] =
+		{
+			origin.x + static_cast<float>(cell_begin[0]) * spacing,
+			origin.y + static_cast<float>(cell_begin[1]) * spacing,
+			origin.z + static_cast<float>(cell_begin[2]) * spacing
+		};
+		brick_vertices.clear();
+		brick_triangles.clear();
+		brick_edges.clear();
+		mc::polygonize(brick_vertices, brick_triangles, &brick_edges, cache, size, brick_origin, spacing);
+		
+		// Append brick vertices, merging those on brick faces with vertices already generated by neighboring bricks
+		remap.resize(brick_edges.size());
+		for (std::size_t i = 0; i < brick_edges.size(); ++i)
+		{
+			const std::uint32_t edge_sample = brick_edges[i] / 3;
+			const std::uint32_t axis = brick_edges[i] % 3;
+			const std::uint32_t local[3] =
+			{
+				edge_sample % size[0],
+				(edge_sample / size[0]) % size[1],
+				edge_sample / (size[0] * size[1])
+			};
+			
+			bool seam = false;
+			for (std::uint32_t j = 0; j < 3; ++j)
+				seam |= (j != axis && (local[j] == 0 || local[j] == brick_size));
+			
+			const std::uint32_t index = static_cast<std::uint32_t>(vertices.size() / 3);
+			if (seam)
+			{
+				const std::uint64_t global_sample = ((cell_begin[2] + local[2]) * sample_count_y + (cell_begin[1] + local[1])) * sample_count_x + (cell_begin[0] + local[0]);
+				auto [it, inserted] = seam_vertices.try_emplace(global_sample * 3 + axis, index);
+				remap[i] = it->second;
+				if (!inserted)
+					continue;
+			}
+			else
+			{
+				remap[i] = index;
+			}
+			
+			vertices.insert(vertices.end(), brick_vertices.begin() + i * 3, brick_vertices.begin() + i * 3 + 3);
+		}
+		
+		for (std::uint32_t index: brick_triangles)
+			triangles.push_back(remap[index]);
+	}
+}
+
+std::int32_t sdf_brick_map::find_brick(std::uint32_t x, std::uint32_t y, std::uint32_t z) const
+{
+	if (x >= brick_count.x || y >= brick_count.y || z >= brick_count.z)
+		return -1;
+	
+	auto it = brick_indices.find(morton::encode<std::uint64_t>(x, y, z));
+	if (it == brick_indices.end())
+		return -1;
+	
+	return static_cast<std::int32_t>(it->second);
+}
+
+std::uint32_t sdf_brick_map::find_or_allocate_brick(std::uint32_t x, std::uint32_t y, std::uint32_t z)
+{
+	const std::uint64_t code = morton::encode<std::uint64_t>(x, y, z);
+	
+	auto [it, inserted] = brick_indices.try_emplace(code, static_cast<std::uint32_t>(brick_codes.size()));
+	if (inserted)
+	{
+		// Fill new brick with the most negative distance
+		brick_codes.push_back(code);
+		samples.resize(samples.size() + brick_volume, empty_sample);
+	}
+	
+	return it->second;
+}
+
+} // namespace geom
@@ -0,0 +1,121 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTKEEPER_GEOM_SDF_BRICK_MAP_HPP
+#define ANTKEEPER_GEOM_SDF_BRICK_MAP_HPP
+
+#include "utility/fundamental-types.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace geom {
+
+/**
+ * Sparse signed distance field, sampled on a regular lattice and stored in bricks of 8x8x8 samples.
+ *
+ * Bricks are allocated the first time a sphere is stamped over them, and looked up by the Morton code of their brick coordinates. Samples are quantized to 8 bits within a narrow band about the isosurface; distances beyond the band are clamped, which preserves their sign. Quantized samples are reconstructed at the centers of their quantization steps, so no sample reads as exactly zero and isosurface vertices never fall on cell corners. Unallocated space reads as the most negative distance.
+ */
+class sdf_brick_map
+{
+public:
+	/// Quantized sample type. Samples are stored as the floor of the scaled distance, offset by 128.
+	typedef std::uint8_t sample_type;
+	
+	/// Number of samples along each axis of a brick.
+	static constexpr std::uint32_t brick_size = 8;
+	
+	/// Number of samples in a brick.
+	static constexpr std::uint32_t brick_volume = brick_size * brick_size * brick_size;
+	
+	/**
+	 * Constructs an empty brick map.
+	 *
+	 * @param origin Position of the first sample.
+	 * @param spacing Distance between adjacent samples.
+	 * @param cell_count Number of cells along each axis. There is one more sample than cells along each axis.
+	 * @param band Largest representable distance magnitude.
+	 */
+	sdf_brick_map(const float3& origin, float spacing, const uint3& cell_count, float band);
+	
+	/// Deallocates all bricks.
+	void clear();
+	
+	/**
+	 * Raises the distance of every sample to at least its distance inside of a sphere, carving the sphere out of the field.
+	 *
+	 * @param center Center of the sphere.
+	 * @param radius Radius of the sphere.
+	 */
+	void stamp_sphere(const float3& center, float radius);
+	
+	/**
+	 * Extracts the isosurface of the field with the marching cubes algorithm.
+	 *
+	 * Each brick is polygonized as a dense grid. Vertices on the faces shared by neighboring bricks are generated once, so the resulting mesh is connected across bricks.
+	 *
+	 * @param[out] vertices Vector to which vertex positions will be appended, three floats per vertex.
+	 * @param[out] triangles Vector to which triangle vertex indices will be appended, three indices per triangle.
+	 */
+	void polygonize(std::vector<float>& vertices, std::vector<std::uint32_t>& triangles) const;
+	
+	/// Returns the number of allocated bricks.
+	std::size_t get_brick_count() const;
+	
+	/// Returns the number of bytes of sample storage.
+	std::size_t get_sample_memory() const;
+
+private:
+	/// Offset which maps quantized distances onto the range of the sample type.
+	static constexpr float sample_bias = 128.0f;
+	
+	/// Sample value of unallocated space, the most negative distance.
+	static constexpr sample_type empty_sample = 1;
+	
+	/// Returns the index of the brick at the given brick coordinates, or `-1` if it is not allocated.
+	std::int32_t find_brick(std::uint32_t x, std::uint32_t y, std::uint32_t z) const;
+	
+	/// Returns the index of the brick at the given brick coordinates, allocating it if necessary.
+	std::uint32_t find_or_allocate_brick(std::uint32_t x, std::uint32_t y, std::uint32_t z);
+	
+	float3 origin;
+	float spacing;
+	uint3 cell_count;
+	uint3 brick_count;
+	float quantization_scale;
+	float dequantization_scale;
+	
+	std::vector<sample_type> samples;
+	std::vector<std::uint64_t> brick_codes;
+	std::unordered_map<std::uint64_t, std::uint32_t> brick_indices;
+};
+
+inline std::size_t sdf_brick_map::get_brick_count() const
+{
+	return brick_codes.size();
+}
+
+inline std::size_t sdf_brick_map::get_sample_memory() const
+{
+	return samples.capacity() * sizeof(sample_type);
+}
+
+} // namespace geom
+
+#endif // ANTKEEPER_GEOM_SDF_BRICK_MAP_HPP
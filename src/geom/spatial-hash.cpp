@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "geom/spatial-hash.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace geom {
+
+spatial_hash::spatial_hash(float cell_size):
+	bucket_mask(0),
+	bucket_starts(2, 0)
+{
+	set_cell_size(cell_size);
+}
+
+void spatial_hash::build(const float3* positions, const value_type* values, std::size_t count)
+{
+	// Use a power-of-two number of buckets, about twice the number of points
+	std::uint32_t bucket_count = 64;
+	while (bucket_count < count * 2)
+		bucket_count <<= 1;
+	bucket_mask = bucket_count - 1;
+	
+	// Count points in each bucket
+	point_buckets.resize(count);
+	bucket_starts.assign(bucket_count + 1, 0);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const float3& position = positions[i];
+		if (!std::isfinite(position.x) || !std::isfinite(position.y) || !std::isfinite(position.z))
+		{
+			clear();
+			throw std::invalid_argument("Spatial hash point position is not finite");
+		}
+		
+		const std::uint32_t bucket = hash_cell(cell_coordinate(position.x), cell_coordinate(position.y), cell_coordinate(position.z));
+		point_buckets[i] = bucket;
+		++bucket_starts[bucket + 1];
+	}
+	
+	// Convert counts into bucket offsets
+	for (std::uint32_t i = 0; i < bucket_count; ++i)
+		bucket_starts[i + 1] += bucket_starts[i];
+	
+	// Scatter points into their buckets, advancing a copy of the bucket offsets
+	point_x.resize(count);
+	point_y.resize(count);
+	point_z.resize(count);
+	point_values.resize(count);
+	std::vector<std::uint32_t> offsets(bucket_starts.begin(), bucket_starts.end() - 1);
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const std::uint32_t p = offsets[point_buckets[i]]++;
+		point_x[p] = positions[i].x;
+		point_y[p] = positions[i].y;
+		point_z[p] = positions[i].z;
+		point_values[p] = values[i];
+	}
+}
+
+void spatial_hash::clear()
+{
+	bucket_mask = 0;
+	bucket_starts.assign(2, 0);
+	point_x.clear();
+	point_y.clear();
+	point_z.clear();
+	point_values.clear();
+	point_buckets.clear();
+}
+
+std::size_t spatial_hash::query_radius(const float3& center, float radius, std::vector<value_type>& values) const
+{
+	const std::size_t initial_size = values.size();
+	visit_radius(center, radius,
+		[&values](value_type value, const float3&, float)
+		{
+			values.push_back(value);
+		});
+	return values.size() - initial_size;
+}
+
+std::size_t spatial_hash::query_nearest(const float3& center, std::size_t k, float max_radius, std::vector<value_type>& values) const
+{
+	if (!k)
+		return 0;
+	
+	// Search spheres of doubling radius until enough points are found
+	std::vector<std::pair<float, value_type>> candidates;
+	float radius = std::min(cell_size, max_radius);
+	for (;;)
+	{
+		candidates.clear();
+		visit_radius(center, radius,
+			[&candidates](value_type value, const float3&, float distance_squared)
+			{
+				candidates.emplace_back(distance_squared, value);
+			});
+		
+		if (candidates.size() >= k || radius >= max_radius || candidates.size() == point_values.size())
+			break;
+		
+		radius = std::min(radius * 2.0f, max_radius);
+	}
+	
+	// Keep the nearest k candidates
+	const std::size_t count = std::min(k, candidates.size());
+	std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end());
+	for (std::size_t i = 0; i < count; ++i)
+		values.push_back(candidates[i].second);
+	
+	return count;
+}
+
+} // namespace geom
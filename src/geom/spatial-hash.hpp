@@ -0,0 +1,210 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTKEEPER_GEOM_SPATIAL_HASH_HPP
+#define ANTKEEPER_GEOM_SPATIAL_HASH_HPP
+
+#include "utility/fundamental-types.hpp"
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace geom {
+
+/**
+ * Uniform grid of points, hashed into a fixed number of buckets.
+ *
+ * Points are counting-sorted by bucket into contiguous arrays, so rebuilding is linear in the number of points and each bucket is a contiguous range. Cells are hashed rather than bounded, so points may lie anywhere. Queries don't modify the hash, so a built hash can be queried from any number of threads at once.
+ */
+class spatial_hash
+{
+public:
+	/// Type of the value associated with each point.
+	typedef std::uint32_t value_type;
+	
+	/**
+	 * Constructs an empty spatial hash.
+	 *
+	 * @param cell_size Edge length of the grid cells. Queries are fastest when their radius is close to the cell size.
+	 */
+	explicit spatial_hash(float cell_size = 1.0f);
+	
+	/**
+	 * Replaces the contents of the hash with a set of points.
+	 *
+	 * @param positions Point positions.
+	 * @param values Values associated with each point.
+	 * @param count Number of points.
+	 *
+	 * @exception std::invalid_argument A point position is not finite. The hash is left empty.
+	 */
+	void build(const float3* positions, const value_type* values, std::size_t count);
+	
+	/// Removes all points, retaining allocated storage.
+	void clear();
+	
+	/**
+	 * Calls a function for each point within a radius of a position.
+	 *
+	 * @param center Center of the query sphere.
+	 * @param radius Radius of the query sphere.
+	 * @param f Function called as `f(value, position, distance_squared)` for each point in the sphere, in no particular order. Nothing is visited if the center or radius is not finite.
+	 */
+	template <class Function>
+	void visit_radius(const float3& center, float radius, Function f) const;
+	
+	/**
+	 * Finds the points within a radius of a position.
+	 *
+	 * @param center Center of the query sphere.
+	 * @param radius Radius of the query sphere.
+	 * @param[out] values Vector to which the values of the found points will be appended, in no particular order.
+	 * @return Number of points found.
+	 */
+	std::size_t query_radius(const float3& center, float radius, std::vector<value_type>& values) const;
+	
+	/**
+	 * Finds the nearest points to a position.
+	 *
+	 * @param center Query position.
+	 * @param k Maximum number of points to find.
+	 * @param max_radius Distance beyond which points are ignored.
+	 * @param[out] values Vector to which the values of the found points will be appended, nearest first.
+	 * @return Number of points found.
+	 */
+	std::size_t query_nearest(const float3& center, std::size_t k, float max_radius, std::vector<value_type>& values) const;
+	
+	/// Sets the edge length of the grid cells. Takes effect the next time the hash is built.
+	void set_cell_size(float size);
+	
+	/// Returns the edge length of the grid cells.
+	float get_cell_size() const;
+	
+	/// Returns the number of points in the hash.
+	std::size_t size() const;
+
+private:
+	/// Returns the grid coordinate of a position along one axis, clamped to avoid overflow.
+	std::int32_t cell_coordinate(float x) const;
+	
+	/// Returns the bucket of a cell.
+	std::uint32_t hash_cell(std::int32_t x, std::int32_t y, std::int32_t z) const;
+	
+	float cell_size;
+	float inverse_cell_size;
+	std::uint32_t bucket_mask;
+	
+	std::vector<std::uint32_t> bucket_starts;
+	std::vector<float> point_x;
+	std::vector<float> point_y;
+	std::vector<float> point_z;
+	std::vector<value_type> point_values;
+	std::vector<std::uint32_t> point_buckets;
+};
+
+template <class Function>
+void spatial_hash::visit_radius(const float3& center, float radius, Function f) const
+{
+	if (point_values.empty() || !(radius >= 0.0f) || !std::isfinite(radius) || !std::isfinite(center.x) || !std::isfinite(center.y) || !std::isfinite(center.z))
+		return;
+	
+	const float radius_squared = radius * radius;
+	
+	const std::int32_t min_x = cell_coordinate(center.x - radius);
+	const std::int32_t min_y = cell_coordinate(center.y - radius);
+	const std::int32_t min_z = cell_coordinate(center.z - radius);
+	const std::int32_t max_x = cell_coordinate(center.x + radius);
+	const std::int32_t max_y = cell_coordinate(center.y + radius);
+	const std::int32_t max_z = cell_coordinate(center.z + radius);
+	
+	// Scan every point if the query covers more cells than there are buckets
+	const double cell_count = double(max_x - min_x + 1) * double(max_y - min_y + 1) * double(max_z - min_z + 1);
+	if (cell_count > double(bucket_starts.size() - 1))
+	{
+		for (std::size_t i = 0; i < point_values.size(); ++i)
+		{
+			const float dx = point_x[i] - center.x;
+			const float dy = point_y[i] - center.y;
+			const float dz = point_z[i] - center.z;
+			const float distance_squared = dx * dx + dy * dy + dz * dz;
+			if (distance_squared <= radius_squared)
+				f(point_values[i], float3{point_x[i], point_y[i], point_z[i]}, distance_squared);
+		}
+		return;
+	}
+	
+	for (std::int32_t k = min_z; k <= max_z; ++k)
+	{
+		for (std::int32_t j = min_y; j <= max_y; ++j)
+		{
+			for (std::int32_t i = min_x; i <= max_x; ++i)
+			{
+				const std::uint32_t bucket = hash_cell(i, j, k);
+				const std::uint32_t end = bucket_starts[bucket + 1];
+				for (std::uint32_t p = bucket_starts[bucket]; p < end; ++p)
+				{
+					const float dx = point_x[p] - center.x;
+					const float dy = point_y[p] - center.y;
+					const float dz = point_z[p] - center.z;
+					const float distance_squared = dx * dx + dy * dy + dz * dz;
+					if (distance_squared > radius_squared)
+						continue;
+					
+					// Skip points of other cells which share this bucket, so no point is visited twice
+					if (cell_coordinate(point_x[p]) != i || cell_coordinate(point_y[p]) != j || cell_coordinate(point_z[p]) != k)
+						continue;
+					
+					f(point_values[p], float3{point_x[p], point_y[p], point_z[p]}, distance_squared);
+				}
+			}
+		}
+	}
+}
+
+inline void spatial_hash::set_cell_size(float size)
+{
+	cell_size = size;
+	inverse_cell_size = 1.0f / size;
+}
+
+inline float spatial_hash::get_cell_size() const
+{
+	return cell_size;
+}
+
+inline std::size_t spatial_hash::size() const
+{
+	return point_values.size();
+}
+
+inline std::int32_t spatial_hash::cell_coordinate(float x) const
+{
+	const float cell = std::floor(x * inverse_cell_size);
+	return static_cast<std::int32_t>((cell < -1073741824.0f) ? -1073741824.0f : (cell > 1073741824.0f) ? 1073741824.0f : cell);
+}
+
+inline std::uint32_t spatial_hash::hash_cell(std::int32_t x, std::int32_t y, std::int32_t z) const
+{
+	return ((static_cast<std::uint32_t>(x) * 73856093u) ^ (static_cast<std::uint32_t>(y) * 19349663u) ^ (static_cast<std::uint32_t>(z) * 83492791u)) & bucket_mask;
+}
+
+} // namespace geom
+
+#endif // ANTKEEPER_GEOM_SPATIAL_HASH_HPP
+
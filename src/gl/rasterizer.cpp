@@ -163,4 +163,18 @@ void rasterizer::draw_elements(const vertex_array& vao, drawing_mode mode, std::
 	glDrawElements(gl_mode, static_cast<GLsizei>(count), gl_type, (const GLvoid*)offset);
 }
 
+void rasterizer::draw_elements_instanced(const vertex_array& vao, drawing_mode mode, std::size_t offset, std::size_t count, element_array_type type, std::size_t instance_count)
+{
+	GLenum gl_mode = drawing_mode_lut[static_cast<std::size_t>(mode)];
+	GLenum gl_type = element_array_type_lut[static_cast<std::size_t>(type)];
+
+	if (bound_vao != &vao)
+	{
+		glBindVertexArray(vao.gl_array_id);
+		bound_vao = &vao;
+	}
+
+	glDrawElementsInstanced(gl_mode, static_cast<GLsizei>(count), gl_type, (const GLvoid*)offset, static_cast<GLsizei>(instance_count));
+}
+
 } // namespace gl
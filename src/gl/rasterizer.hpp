@@ -117,6 +117,7 @@ public:
 	 *
 	 */
 	void draw_elements(const vertex_array& vao, drawing_mode mode, std::size_t offset, std::size_t count, element_array_type type);
+	void draw_elements_instanced(const vertex_array& vao, drawing_mode mode, std::size_t offset, std::size_t count, element_array_type type, std::size_t instance_count);
 
 	/**
 	 * Returns the default framebuffer associated with the OpenGL context of a window.
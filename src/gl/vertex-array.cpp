@@ -19,6 +19,7 @@
 
 #include "gl/vertex-array.hpp"
 #include "gl/vertex-buffer.hpp"
+#include <algorithm>
 #include <glad/glad.h>
 
 namespace gl {
@@ -33,7 +34,28 @@ static constexpr GLenum vertex_attribute_type_lut[] =
 	GL_UNSIGNED_INT,
 	GL_HALF_FLOAT,
 	GL_FLOAT,
-	GL_DOUBLE
+	GL_DOUBLE,
+	GL_BYTE,
+	GL_UNSIGNED_BYTE,
+	GL_SHORT,
+	GL_UNSIGNED_SHORT
+};
+
+static constexpr GLboolean vertex_attribute_normalized_lut[] =
+{
+	GL_FALSE,
+	GL_FALSE,
+	GL_FALSE,
+	GL_FALSE,
+	GL_FALSE,
+	GL_FALSE,
+	GL_FALSE,
+	GL_FALSE,
+	GL_FALSE,
+	GL_TRUE,
+	GL_TRUE,
+	GL_TRUE,
+	GL_TRUE
 };
 
 vertex_array::vertex_array():
@@ -50,17 +72,36 @@ vertex_array::~vertex_array()
 void vertex_array::bind_attribute(unsigned int index, const vertex_buffer& buffer, int size, vertex_attribute_type type, int stride, std::size_t offset)
 {
 	GLenum gl_type = vertex_attribute_type_lut[static_cast<std::size_t>(type)];
+	GLboolean gl_normalized = vertex_attribute_normalized_lut[static_cast<std::size_t>(type)];
 
 	glBindVertexArray(gl_array_id);
 	glBindBuffer(GL_ARRAY_BUFFER, buffer.gl_buffer_id);
-	glVertexAttribPointer(index, size, gl_type, GL_FALSE, stride, (const GLvoid*)offset); 
+	glVertexAttribPointer(index, size, gl_type, gl_normalized, stride, (const GLvoid*)offset); 
 	glEnableVertexAttribArray(index);
+	
+	track_buffer(buffer);
 }
 
 void vertex_array::bind_elements(const vertex_buffer& buffer)
 {
 	glBindVertexArray(gl_array_id);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.gl_buffer_id);
+	
+	track_buffer(buffer);
+}
+
+std::size_t vertex_array::get_revision() const
+{
+	std::size_t revision = 0;
+	for (const vertex_buffer* buffer: buffers)
+		revision += buffer->get_revision();
+	return revision;
+}
+
+void vertex_array::track_buffer(const vertex_buffer& buffer)
+{
+	if (std::find(buffers.begin(), buffers.end(), &buffer) == buffers.end())
+		buffers.push_back(&buffer);
 }
 
 } // namespace gl
@@ -21,6 +21,7 @@
 #define ANTKEEPER_GL_VERTEX_ARRAY_HPP
 
 #include <cstdlib>
+#include <vector>
 
 namespace gl {
 
@@ -39,11 +40,17 @@ public:
 
 	void bind_attribute(unsigned int index, const vertex_buffer& buffer, int size, vertex_attribute_type type, int stride, std::size_t offset);
 	void bind_elements(const vertex_buffer& buffer);
+	
+	/// Returns the sum of the revisions of the buffers bound to the array, which changes whenever the contents of any of them change. Bound buffers must outlive the array.
+	std::size_t get_revision() const;
 
 private:
 	friend class rasterizer;
+	
+	void track_buffer(const vertex_buffer& buffer);
 
 	unsigned int gl_array_id;
+	std::vector<const vertex_buffer*> buffers;
 };
 
 } // namespace gl
@@ -32,7 +32,19 @@ enum class vertex_attribute_type
 	uint_32,
 	float_16,
 	float_32,
-	float_64
+	float_64,
+	
+	/// Signed 8-bit integer, normalized to `[-1, 1]`.
+	snorm_8,
+	
+	/// Unsigned 8-bit integer, normalized to `[0, 1]`.
+	unorm_8,
+	
+	/// Signed 16-bit integer, normalized to `[-1, 1]`.
+	snorm_16,
+	
+	/// Unsigned 16-bit integer, normalized to `[0, 1]`.
+	unorm_16
 };
 
 } // namespace gl
@@ -38,7 +38,8 @@ static constexpr GLenum buffer_usage_lut[] =
 vertex_buffer::vertex_buffer(std::size_t size, const void* data, buffer_usage usage):
 	gl_buffer_id(0),
 	size(size),
-	usage(usage)
+	usage(usage),
+	revision(0)
 {
 	GLenum gl_usage = buffer_usage_lut[static_cast<std::size_t>(usage)];
 
@@ -60,6 +61,7 @@ void vertex_buffer::repurpose(std::size_t size, const void* data, buffer_usage u
 {
 	this->size = size;
 	this->usage = usage;
+	++revision;
 
 	GLenum gl_usage = buffer_usage_lut[static_cast<std::size_t>(usage)];
 
@@ -76,6 +78,7 @@ void vertex_buffer::update(int offset, std::size_t size, const void* data)
 {
 	glBindBuffer(GL_ARRAY_BUFFER, gl_buffer_id);
 	glBufferSubData(GL_ARRAY_BUFFER, offset, size, data);
+	++revision;
 }
 
 } // namespace gl
@@ -44,6 +44,9 @@ public:
 
 	std::size_t get_size() const;
 	buffer_usage get_usage() const;
+	
+	/// Returns a counter which is incremented each time the contents of the buffer are changed.
+	std::size_t get_revision() const;
 
 private:
 	friend class vertex_array;
@@ -51,6 +54,7 @@ private:
 	unsigned int gl_buffer_id;
 	std::size_t size;
 	buffer_usage usage;
+	std::size_t revision;
 };
 
 inline std::size_t vertex_buffer::get_size() const
@@ -63,6 +67,11 @@ inline buffer_usage vertex_buffer::get_usage() const
 	return usage;
 }
 
+inline std::size_t vertex_buffer::get_revision() const
+{
+	return revision;
+}
+
 } // namespace gl
 
 #endif // ANTKEEPER_GL_VERTEX_BUFFER_HPP
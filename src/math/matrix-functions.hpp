@@ -23,6 +23,7 @@
 #include "math/matrix-type.hpp"
 #include "math/vector-type.hpp"
 #include "math/vector-functions.hpp"
+#include "math/simd.hpp"
 #include <type_traits>
 
 namespace math {
@@ -88,6 +89,14 @@ matrix<T, 3, 3> inverse(const matrix<T, 3, 3>& m);
 template <class T>
 matrix<T, 4, 4> inverse(const matrix<T, 4, 4>& m);
 
+/**
+ * Calculates the transpose of the inverse of a matrix, such as the normal matrix of a linear transformation. This is cheaper than transposing the result of inverse().
+ *
+ * @param m Matrix of which to take the inverse transpose.
+ */
+template <class T>
+matrix<T, 3, 3> inverse_transpose(const matrix<T, 3, 3>& m);
+
 /**
  * Performs a component-wise multiplication of two matrices.
  *
@@ -461,6 +470,20 @@ matrix<T, 3, 3> inverse(const matrix<T, 3, 3>& m)
 		}};
 }
 
+template <class T>
+matrix<T, 3, 3> inverse_transpose(const matrix<T, 3, 3>& m)
+{
+	static_assert(std::is_floating_point<T>::value);
+	
+	// Columns of the inverse transpose are cross products of the columns, divided by the determinant
+	const vector<T, 3> c0 = cross(m[1], m[2]);
+	const vector<T, 3> c1 = cross(m[2], m[0]);
+	const vector<T, 3> c2 = cross(m[0], m[1]);
+	const T rd = T(1) / dot(m[0], c0);
+	
+	return {{c0 * rd, c1 * rd, c2 * rd}};
+}
+
 template <class T>
 matrix<T, 4, 4> inverse(const matrix<T, 4, 4>& m)
 {
@@ -933,6 +956,50 @@ matrix<T2, N, M> type_cast(const matrix<T1, N, M>& m)
 	return type_cast<T2>(m, std::make_index_sequence<N>{}); 
 }
 
+#if defined(ANTKEEPER_MATH_SSE)
+
+/// @private
+template <>
+inline matrix<float, 4, 4> mul(const matrix<float, 4, 4>& x, const matrix<float, 4, 4>& y)
+{
+	matrix<float, 4, 4> result;
+	
+	#if defined(ANTKEEPER_MATH_AVX)
+		// Compute two columns of the product at once, each 128-bit lane holding one column
+		const __m256 x0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(x[0].data()));
+		const __m256 x1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(x[1].data()));
+		const __m256 x2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(x[2].data()));
+		const __m256 x3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(x[3].data()));
+		for (std::size_t i = 0; i < 4; i += 2)
+		{
+			const __m256 y01 = _mm256_loadu_ps(y[i].data());
+			__m256 c = _mm256_mul_ps(x0, _mm256_shuffle_ps(y01, y01, _MM_SHUFFLE(0, 0, 0, 0)));
+			c = _mm256_add_ps(c, _mm256_mul_ps(x1, _mm256_shuffle_ps(y01, y01, _MM_SHUFFLE(1, 1, 1, 1))));
+			c = _mm256_add_ps(c, _mm256_mul_ps(x2, _mm256_shuffle_ps(y01, y01, _MM_SHUFFLE(2, 2, 2, 2))));
+			c = _mm256_add_ps(c, _mm256_mul_ps(x3, _mm256_shuffle_ps(y01, y01, _MM_SHUFFLE(3, 3, 3, 3))));
+			_mm256_storeu_ps(result[i].data(), c);
+		}
+	#else
+		const __m128 x0 = _mm_loadu_ps(x[0].data());
+		const __m128 x1 = _mm_loadu_ps(x[1].data());
+		const __m128 x2 = _mm_loadu_ps(x[2].data());
+		const __m128 x3 = _mm_loadu_ps(x[3].data());
+		for (std::size_t i = 0; i < 4; ++i)
+		{
+			const __m128 yi = _mm_loadu_ps(y[i].data());
+			__m128 c = _mm_mul_ps(x0, _mm_shuffle_ps(yi, yi, _MM_SHUFFLE(0, 0, 0, 0)));
+			c = _mm_add_ps(c, _mm_mul_ps(x1, _mm_shuffle_ps(yi, yi, _MM_SHUFFLE(1, 1, 1, 1))));
+			c = _mm_add_ps(c, _mm_mul_ps(x2, _mm_shuffle_ps(yi, yi, _MM_SHUFFLE(2, 2, 2, 2))));
+			c = _mm_add_ps(c, _mm_mul_ps(x3, _mm_shuffle_ps(yi, yi, _MM_SHUFFLE(3, 3, 3, 3))));
+			_mm_storeu_ps(result[i].data(), c);
+		}
+	#endif
+	
+	return result;
+}
+
+#endif // ANTKEEPER_MATH_SSE
+
 } // namespace math
 
 #endif // ANTKEEPER_MATH_MATRIX_FUNCTIONS_HPP
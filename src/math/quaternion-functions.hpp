@@ -24,6 +24,7 @@
 #include "math/quaternion-type.hpp"
 #include "math/vector-type.hpp"
 #include "math/vector-functions.hpp"
+#include "math/simd.hpp"
 #include <cmath>
 
 namespace math {
@@ -479,6 +480,59 @@ inline quaternion<T2> type_cast(const quaternion<T1>& q)
 	};
 }
 
+#if defined(ANTKEEPER_MATH_SSE)
+
+/// @private
+template <>
+inline quaternion<float> mul(const quaternion<float>& x, const quaternion<float>& y)
+{
+	// Sign masks which negate the lanes of (w, x, y, z) marked with a minus
+	const __m128 sign_x = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+	const __m128 sign_y = _mm_setr_ps(-0.0f, 0.0f, 0.0f, -0.0f);
+	const __m128 sign_z = _mm_setr_ps(-0.0f, -0.0f, 0.0f, 0.0f);
+	
+	const __m128 a = _mm_loadu_ps(&x.w);
+	const __m128 b = _mm_loadu_ps(&y.w);
+	
+	// Accumulate each component of x multiplied by a permutation of y
+	__m128 r = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), b);
+	r = _mm_add_ps(r, _mm_xor_ps(sign_x, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(2, 3, 0, 1)))));
+	r = _mm_add_ps(r, _mm_xor_ps(sign_y, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2)))));
+	r = _mm_add_ps(r, _mm_xor_ps(sign_z, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 1, 2, 3)))));
+	
+	quaternion<float> result;
+	_mm_storeu_ps(&result.w, r);
+	return result;
+}
+
+/// @private
+template <>
+inline vector<float, 3> mul(const quaternion<float>& q, const vector<float, 3>& v)
+{
+	// Rotate with v + w * t + i x t, where t = 2 * (i x v)
+	const __m128 i = _mm_setr_ps(q.x, q.y, q.z, 0.0f);
+	const __m128 w = _mm_set1_ps(q.w);
+	const __m128 u = _mm_setr_ps(v.x, v.y, v.z, 0.0f);
+	
+	const __m128 i_yzx = _mm_shuffle_ps(i, i, _MM_SHUFFLE(3, 0, 2, 1));
+	const __m128 u_yzx = _mm_shuffle_ps(u, u, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 t = _mm_sub_ps(_mm_mul_ps(i, u_yzx), _mm_mul_ps(i_yzx, u));
+	t = _mm_shuffle_ps(t, t, _MM_SHUFFLE(3, 0, 2, 1));
+	t = _mm_add_ps(t, t);
+	
+	const __m128 t_yzx = _mm_shuffle_ps(t, t, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 it = _mm_sub_ps(_mm_mul_ps(i, t_yzx), _mm_mul_ps(i_yzx, t));
+	it = _mm_shuffle_ps(it, it, _MM_SHUFFLE(3, 0, 2, 1));
+	
+	const __m128 r = _mm_add_ps(_mm_add_ps(u, _mm_mul_ps(w, t)), it);
+	
+	float result[4];
+	_mm_storeu_ps(result, r);
+	return {result[0], result[1], result[2]};
+}
+
+#endif // ANTKEEPER_MATH_SSE
+
 } // namespace math
 
 #endif // ANTKEEPER_MATH_QUATERNION_FUNCTIONS_HPP
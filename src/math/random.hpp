@@ -20,15 +20,30 @@
 #ifndef ANTKEEPER_MATH_RANDOM_HPP
 #define ANTKEEPER_MATH_RANDOM_HPP
 
-#include <cstdlib>
+#include "math/xoshiro256.hpp"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 #include <type_traits>
 
 namespace math {
 
 /**
- * Generates a pseudo-random floating point number on `[start, end)` using std::rand().
+ * Reseeds the per-thread random number generators. Each thread reseeds its generator on its next call to random_generator(); the generator of the `n`th thread to do so is seeded with @p seed and then jumped `n` times, so the threads draw from non-overlapping streams.
  *
- * @warning Don't forget to seed with std::srand() before using!
+ * @param seed Seed value.
+ *
+ * @note The order in which threads pick up their streams is not deterministic. Parallel jobs which must replay identically should copy a generator and call xoshiro256::jump() once per job instead.
+ */
+void seed_random(std::uint64_t seed);
+
+/**
+ * Returns the random number generator of the calling thread.
+ */
+xoshiro256& random_generator();
+
+/**
+ * Generates a pseudo-random floating point number on `[start, end)` using the random number generator of the calling thread.
  *
  * @param start Start of the range (inclusive).
  * @param end End of the range (exclusive).
@@ -37,12 +52,72 @@ namespace math {
 template <typename T = float>
 T random(T start, T end);
 
+namespace detail {
+
+/// Seed shared by the per-thread random number generators.
+struct random_seed_state
+{
+	std::mutex mutex;
+	std::uint64_t seed{xoshiro256::default_seed};
+	std::atomic<std::uint32_t> generation{1};
+	std::uint32_t thread_count{0};
+};
+
+inline random_seed_state& get_random_seed_state()
+{
+	static random_seed_state state;
+	return state;
+}
+
+} // namespace detail
+
+inline void seed_random(std::uint64_t seed)
+{
+	detail::random_seed_state& state = detail::get_random_seed_state();
+	std::lock_guard<std::mutex> lock(state.mutex);
+	
+	state.seed = seed;
+	state.thread_count = 0;
+	state.generation.fetch_add(1, std::memory_order_release);
+}
+
+inline xoshiro256& random_generator()
+{
+	thread_local xoshiro256 generator;
+	thread_local std::uint32_t generation = 0;
+	
+	detail::random_seed_state& state = detail::get_random_seed_state();
+	if (generation != state.generation.load(std::memory_order_acquire))
+	{
+		std::uint64_t seed;
+		std::uint32_t thread_index;
+		{
+			std::lock_guard<std::mutex> lock(state.mutex);
+			seed = state.seed;
+			thread_index = state.thread_count++;
+			generation = state.generation.load(std::memory_order_relaxed);
+		}
+		
+		generator.seed(seed);
+		for (std::uint32_t i = 0; i < thread_index; ++i)
+			generator.jump();
+	}
+	
+	return generator;
+}
+
 template <typename T>
 inline T random(T start, T end)
 {
 	static_assert(std::is_floating_point<T>::value);
-	constexpr T rand_max_inverse = T(1) / static_cast<T>(RAND_MAX);
-    return static_cast<T>(std::rand()) * rand_max_inverse * (end - start) + start;
+	
+	T x;
+	if constexpr (std::is_same<T, float>::value)
+		x = random_generator().uniform_float();
+	else
+		x = static_cast<T>(random_generator().uniform_double());
+	
+	return x * (end - start) + start;
 }
 
 } // namespace math
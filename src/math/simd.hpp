@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTKEEPER_MATH_SIMD_HPP
+#define ANTKEEPER_MATH_SIMD_HPP
+
+/**
+ * @def ANTKEEPER_MATH_SSE
+ * Defined if SSE intrinsics are available. Single-precision math functions are specialized with SSE implementations when defined.
+ *
+ * @def ANTKEEPER_MATH_SSE2
+ * Defined if SSE2 intrinsics are available. Used by the integer kernels, such as the lane streams of the random number generator.
+ *
+ * @def ANTKEEPER_MATH_AVX
+ * Defined if AVX intrinsics are available, which widens some of the SSE specializations. AVX must be enabled by the compiler flags, such as `-mavx2`, which the `ENABLE_AVX2` CMake option adds.
+ *
+ * @def ANTKEEPER_MATH_NO_SIMD
+ * If defined before this header is included, none of the above are defined and the generic implementations are used, such as to benchmark the specializations against them.
+ */
+
+#if !defined(ANTKEEPER_MATH_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1))
+	#define ANTKEEPER_MATH_SSE
+	#include <xmmintrin.h>
+#endif
+
+#if defined(ANTKEEPER_MATH_SSE) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define ANTKEEPER_MATH_SSE2
+	#include <emmintrin.h>
+#endif
+
+#if defined(ANTKEEPER_MATH_SSE) && defined(__AVX__)
+	#define ANTKEEPER_MATH_AVX
+	#include <immintrin.h>
+#endif
+
+#endif // ANTKEEPER_MATH_SIMD_HPP
+
@@ -24,6 +24,8 @@
 #include "math/vector-functions.hpp"
 #include "math/matrix-functions.hpp"
 #include "math/quaternion-functions.hpp"
+#include "math/simd.hpp"
+#include <cstddef>
 
 namespace math {
 
@@ -35,6 +37,17 @@ namespace math {
 template <class T>
 transform<T> inverse(const transform<T>& t);
 
+/**
+ * Interpolates between two transforms, linearly interpolating their translations and scales, and normalized linearly interpolating their rotations.
+ *
+ * @param x First transform.
+ * @param y Second transform.
+ * @param a Interpolation factor.
+ * @return Interpolated transform.
+ */
+template <class T>
+transform<T> lerp(const transform<T>& x, const transform<T>& y, T a);
+
 /**
  * Converts a transform to a transformation matrix.
  *
@@ -44,6 +57,16 @@ transform<T> inverse(const transform<T>& t);
 template <class T>
 matrix<T, 4, 4> matrix_cast(const transform<T>& t);
 
+/**
+ * Converts an array of transforms to transformation matrices.
+ *
+ * @param transforms Transforms to convert.
+ * @param[out] matrices Array in which the transformation matrices will be stored.
+ * @param count Number of transforms.
+ */
+template <class T>
+void matrix_cast(const transform<T>* transforms, matrix<T, 4, 4>* matrices, std::size_t count);
+
 /**
  * Multiplies two transforms.
  *
@@ -74,6 +97,17 @@ transform<T> inverse(const transform<T>& t)
 	return inverse_t;
 }
 
+template <class T>
+transform<T> lerp(const transform<T>& x, const transform<T>& y, T a)
+{
+	return
+		{
+			add(x.translation, mul(sub(y.translation, x.translation), a)),
+			nlerp(x.rotation, y.rotation, a),
+			add(x.scale, mul(sub(y.scale, x.scale), a))
+		};
+}
+
 template <class T>
 matrix<T, 4, 4> matrix_cast(const transform<T>& t)
 {
@@ -82,6 +116,13 @@ matrix<T, 4, 4> matrix_cast(const transform<T>& t)
 	return scale(transformation, t.scale);
 }
 
+template <class T>
+void matrix_cast(const transform<T>* transforms, matrix<T, 4, 4>* matrices, std::size_t count)
+{
+	for (std::size_t i = 0; i < count; ++i)
+		matrices[i] = matrix_cast(transforms[i]);
+}
+
 template <class T>
 transform<T> mul(const transform<T>& x, const transform<T>& y)
 {
@@ -99,6 +140,93 @@ vector<T, 3> mul(const transform<T>& t, const vector<T, 3>& v)
 	return t.translation + (t.rotation * (v * t.scale));
 }
 
+#if defined(ANTKEEPER_MATH_SSE)
+
+/// @private
+template <>
+inline void matrix_cast(const transform<float>* transforms, matrix<float, 4, 4>* matrices, std::size_t count)
+{
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+	
+	// Convert four transforms at a time, with one transform per lane
+	std::size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const transform<float>* t = transforms + i;
+		matrix<float, 4, 4>* m = matrices + i;
+		
+		const __m128 qw = _mm_setr_ps(t[0].rotation.w, t[1].rotation.w, t[2].rotation.w, t[3].rotation.w);
+		const __m128 qx = _mm_setr_ps(t[0].rotation.x, t[1].rotation.x, t[2].rotation.x, t[3].rotation.x);
+		const __m128 qy = _mm_setr_ps(t[0].rotation.y, t[1].rotation.y, t[2].rotation.y, t[3].rotation.y);
+		const __m128 qz = _mm_setr_ps(t[0].rotation.z, t[1].rotation.z, t[2].rotation.z, t[3].rotation.z);
+		const __m128 sx = _mm_setr_ps(t[0].scale.x, t[1].scale.x, t[2].scale.x, t[3].scale.x);
+		const __m128 sy = _mm_setr_ps(t[0].scale.y, t[1].scale.y, t[2].scale.y, t[3].scale.y);
+		const __m128 sz = _mm_setr_ps(t[0].scale.z, t[1].scale.z, t[2].scale.z, t[3].scale.z);
+		__m128 tx = _mm_setr_ps(t[0].translation.x, t[1].translation.x, t[2].translation.x, t[3].translation.x);
+		__m128 ty = _mm_setr_ps(t[0].translation.y, t[1].translation.y, t[2].translation.y, t[3].translation.y);
+		__m128 tz = _mm_setr_ps(t[0].translation.z, t[1].translation.z, t[2].translation.z, t[3].translation.z);
+		__m128 tw = one;
+		
+		const __m128 x2 = _mm_mul_ps(qx, two);
+		const __m128 y2 = _mm_mul_ps(qy, two);
+		const __m128 z2 = _mm_mul_ps(qz, two);
+		const __m128 wx = _mm_mul_ps(qw, x2);
+		const __m128 wy = _mm_mul_ps(qw, y2);
+		const __m128 wz = _mm_mul_ps(qw, z2);
+		const __m128 xx = _mm_mul_ps(qx, x2);
+		const __m128 xy = _mm_mul_ps(qx, y2);
+		const __m128 xz = _mm_mul_ps(qx, z2);
+		const __m128 yy = _mm_mul_ps(qy, y2);
+		const __m128 yz = _mm_mul_ps(qy, z2);
+		const __m128 zz = _mm_mul_ps(qz, z2);
+		
+		// Scaled rotation matrix columns
+		__m128 c0x = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx);
+		__m128 c0y = _mm_mul_ps(_mm_add_ps(xy, wz), sx);
+		__m128 c0z = _mm_mul_ps(_mm_sub_ps(xz, wy), sx);
+		__m128 c0w = zero;
+		__m128 c1x = _mm_mul_ps(_mm_sub_ps(xy, wz), sy);
+		__m128 c1y = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy);
+		__m128 c1z = _mm_mul_ps(_mm_add_ps(yz, wx), sy);
+		__m128 c1w = zero;
+		__m128 c2x = _mm_mul_ps(_mm_add_ps(xz, wy), sz);
+		__m128 c2y = _mm_mul_ps(_mm_sub_ps(yz, wx), sz);
+		__m128 c2z = _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz);
+		__m128 c2w = zero;
+		
+		// Transpose lanes into the columns of each matrix
+		_MM_TRANSPOSE4_PS(c0x, c0y, c0z, c0w);
+		_MM_TRANSPOSE4_PS(c1x, c1y, c1z, c1w);
+		_MM_TRANSPOSE4_PS(c2x, c2y, c2z, c2w);
+		_MM_TRANSPOSE4_PS(tx, ty, tz, tw);
+		
+		_mm_storeu_ps(m[0][0].data(), c0x);
+		_mm_storeu_ps(m[0][1].data(), c1x);
+		_mm_storeu_ps(m[0][2].data(), c2x);
+		_mm_storeu_ps(m[0][3].data(), tx);
+		_mm_storeu_ps(m[1][0].data(), c0y);
+		_mm_storeu_ps(m[1][1].data(), c1y);
+		_mm_storeu_ps(m[1][2].data(), c2y);
+		_mm_storeu_ps(m[1][3].data(), ty);
+		_mm_storeu_ps(m[2][0].data(), c0z);
+		_mm_storeu_ps(m[2][1].data(), c1z);
+		_mm_storeu_ps(m[2][2].data(), c2z);
+		_mm_storeu_ps(m[2][3].data(), tz);
+		_mm_storeu_ps(m[3][0].data(), c0w);
+		_mm_storeu_ps(m[3][1].data(), c1w);
+		_mm_storeu_ps(m[3][2].data(), c2w);
+		_mm_storeu_ps(m[3][3].data(), tw);
+	}
+	
+	// Convert remaining transforms individually
+	for (; i < count; ++i)
+		matrices[i] = matrix_cast(transforms[i]);
+}
+
+#endif // ANTKEEPER_MATH_SSE
+
 } // namespace math
 
 #endif // ANTKEEPER_MATH_TRANSFORM_FUNCTIONS_HPP
@@ -0,0 +1,362 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTKEEPER_MATH_XOSHIRO256_HPP
+#define ANTKEEPER_MATH_XOSHIRO256_HPP
+
+#include "math/simd.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace math {
+
+/**
+ * Pseudorandom number generator implementing xoshiro256++. Satisfies the *UniformRandomBitGenerator* requirements, so it can be passed to the standard distributions and to the genetic sequence functions.
+ *
+ * In addition to the scalar stream, the generator keeps a set of interleaved lane streams which are stepped together by the batched fill functions. The lane streams are stepped with SSE2 when ANTKEEPER_MATH_SSE2 is defined.
+ *
+ * @see https://prng.di.unimi.it/
+ */
+class xoshiro256
+{
+public:
+	/// Type of the generated integers.
+	typedef std::uint64_t result_type;
+	
+	/// Number of interleaved streams used by the batched fill functions.
+	static constexpr std::size_t lane_count = 8;
+	
+	/// Seed used by default-constructed generators.
+	static constexpr std::uint64_t default_seed = 0x853c49e6748fea9bull;
+	
+	/**
+	 * Creates a generator.
+	 *
+	 * @param seed Value from which the generator state is derived.
+	 */
+	explicit xoshiro256(std::uint64_t seed = default_seed);
+	
+	/**
+	 * Reseeds the generator. The state is expanded from the seed with SplitMix64, so similar seeds yield unrelated streams.
+	 *
+	 * @param seed Value from which the generator state is derived.
+	 */
+	void seed(std::uint64_t seed);
+	
+	/// Generates a pseudorandom 64-bit integer.
+	result_type operator()();
+	
+	/**
+	 * Advances the scalar stream.
+	 *
+	 * @param count Number of values to skip.
+	 */
+	void discard(unsigned long long count);
+	
+	/**
+	 * Advances the generator by 2^128 steps. Copies of a generator which are jumped a different number of times produce non-overlapping sequences, so each parallel job can be handed its own stream.
+	 */
+	void jump();
+	
+	/**
+	 * Advances the generator by 2^192 steps. Can be used to hand out starting points for groups of streams, each of which may then be split with jump().
+	 */
+	void long_jump();
+	
+	/// Generates a pseudorandom single-precision floating point number on `[0, 1)`.
+	float uniform_float();
+	
+	/// Generates a pseudorandom double-precision floating point number on `[0, 1)`.
+	double uniform_double();
+	
+	/**
+	 * Fills an array with uniformly distributed single-precision floating point numbers on `[start, end)`.
+	 *
+	 * @param output Array of @p count floats.
+	 * @param count Number of floats to generate.
+	 * @param start Start of the range (inclusive).
+	 * @param end End of the range (exclusive).
+	 */
+	void fill_uniform(float* output, std::size_t count, float start = 0.0f, float end = 1.0f);
+	
+	/**
+	 * Fills an array with normally distributed single-precision floating point numbers, using the Box-Muller transform.
+	 *
+	 * @param output Array of @p count floats.
+	 * @param count Number of floats to generate.
+	 * @param mean Mean of the distribution.
+	 * @param standard_deviation Standard deviation of the distribution.
+	 */
+	void fill_normal(float* output, std::size_t count, float mean = 0.0f, float standard_deviation = 1.0f);
+	
+	/// Returns the smallest value the generator can produce.
+	static constexpr result_type min();
+	
+	/// Returns the largest value the generator can produce.
+	static constexpr result_type max();
+	
+private:
+	static constexpr std::uint64_t rotl(std::uint64_t x, int k);
+	static std::uint64_t splitmix64(std::uint64_t& x);
+	static std::uint64_t next(std::uint64_t (&s)[4]);
+	static void jump(std::uint64_t (&s)[4], const std::uint64_t (&polynomial)[4]);
+	void jump(const std::uint64_t (&polynomial)[4]);
+	void next_lanes(std::uint64_t (&output)[lane_count]);
+	
+	std::uint64_t state[4];
+	alignas(16) std::uint64_t lanes[4][lane_count];
+};
+
+inline xoshiro256::xoshiro256(std::uint64_t seed)
+{
+	this->seed(seed);
+}
+
+inline void xoshiro256::seed(std::uint64_t seed)
+{
+	for (std::size_t i = 0; i < 4; ++i)
+		state[i] = splitmix64(seed);
+	
+	for (std::size_t i = 0; i < lane_count; ++i)
+		for (std::size_t j = 0; j < 4; ++j)
+			lanes[j][i] = splitmix64(seed);
+}
+
+inline xoshiro256::result_type xoshiro256::operator()()
+{
+	return next(state);
+}
+
+inline void xoshiro256::discard(unsigned long long count)
+{
+	for (; count; --count)
+		next(state);
+}
+
+inline void xoshiro256::jump()
+{
+	static constexpr std::uint64_t polynomial[4] =
+	{
+		0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull
+	};
+	jump(polynomial);
+}
+
+inline void xoshiro256::long_jump()
+{
+	static constexpr std::uint64_t polynomial[4] =
+	{
+		0x76e15d3efefdcbbfull, 0xc5004e441c522fb3ull, 0x77710069854ee241ull, 0x39109bb02acbe635ull
+	};
+	jump(polynomial);
+}
+
+inline float xoshiro256::uniform_float()
+{
+	return static_cast<float>(next(state) >> 40) * 0x1.0p-24f;
+}
+
+inline double xoshiro256::uniform_double()
+{
+	return static_cast<double>(next(state) >> 11) * 0x1.0p-53;
+}
+
+inline void xoshiro256::fill_uniform(float* output, std::size_t count, float start, float end)
+{
+	const float scale = (end - start) * 0x1.0p-24f;
+	std::uint64_t bits[lane_count];
+	
+	// Each 64-bit lane output supplies two 24-bit mantissas
+	while (count)
+	{
+		next_lanes(bits);
+		
+		if (count >= lane_count * 2)
+		{
+			for (std::size_t i = 0; i < lane_count; ++i)
+			{
+				output[i * 2] = static_cast<float>(static_cast<std::uint32_t>(bits[i] >> 40)) * scale + start;
+				output[i * 2 + 1] = static_cast<float>(static_cast<std::uint32_t>(bits[i] >> 8) & 0xffffff) * scale + start;
+			}
+			
+			output += lane_count * 2;
+			count -= lane_count * 2;
+		}
+		else
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				const std::uint32_t mantissa = (i & 1) ? static_cast<std::uint32_t>(bits[i >> 1] >> 8) & 0xffffff : static_cast<std::uint32_t>(bits[i >> 1] >> 40);
+				output[i] = static_cast<float>(mantissa) * scale + start;
+			}
+			
+			count = 0;
+		}
+	}
+}
+
+inline void xoshiro256::fill_normal(float* output, std::size_t count, float mean, float standard_deviation)
+{
+	constexpr float two_pi = 6.28318530717958647692f;
+	
+	// Generate uniform samples in place, then transform them in pairs
+	fill_uniform(output, count);
+	
+	for (std::size_t i = 0; i + 1 < count; i += 2)
+	{
+		const float radius = std::sqrt(-2.0f * std::log(1.0f - output[i])) * standard_deviation;
+		const float angle = output[i + 1] * two_pi;
+		output[i] = radius * std::cos(angle) + mean;
+		output[i + 1] = radius * std::sin(angle) + mean;
+	}
+	
+	// Odd count, draw a fresh pair for the last sample
+	if (count & 1)
+	{
+		const float radius = std::sqrt(-2.0f * std::log(1.0f - uniform_float())) * standard_deviation;
+		output[count - 1] = radius * std::cos(uniform_float() * two_pi) + mean;
+	}
+}
+
+constexpr xoshiro256::result_type xoshiro256::min()
+{
+	return std::numeric_limits<result_type>::min();
+}
+
+constexpr xoshiro256::result_type xoshiro256::max()
+{
+	return std::numeric_limits<result_type>::max();
+}
+
+constexpr std::uint64_t xoshiro256::rotl(std::uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+inline std::uint64_t xoshiro256::splitmix64(std::uint64_t& x)
+{
+	std::uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+inline std::uint64_t xoshiro256::next(std::uint64_t (&s)[4])
+{
+	const std::uint64_t result = rotl(s[0] + s[3], 23) + s[0];
+	const std::uint64_t t = s[1] << 17;
+	
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 45);
+	
+	return result;
+}
+
+inline void xoshiro256::jump(std::uint64_t (&s)[4], const std::uint64_t (&polynomial)[4])
+{
+	std::uint64_t jumped[4] = {0, 0, 0, 0};
+	
+	for (std::size_t i = 0; i < 4; ++i)
+	{
+		for (int b = 0; b < 64; ++b)
+		{
+			if (polynomial[i] & (std::uint64_t{1} << b))
+			{
+				jumped[0] ^= s[0];
+				jumped[1] ^= s[1];
+				jumped[2] ^= s[2];
+				jumped[3] ^= s[3];
+			}
+			
+			next(s);
+		}
+	}
+	
+	for (std::size_t i = 0; i < 4; ++i)
+		s[i] = jumped[i];
+}
+
+inline void xoshiro256::jump(const std::uint64_t (&polynomial)[4])
+{
+	jump(state, polynomial);
+	
+	// Jump each lane stream by the same distance
+	for (std::size_t i = 0; i < lane_count; ++i)
+	{
+		std::uint64_t s[4] = {lanes[0][i], lanes[1][i], lanes[2][i], lanes[3][i]};
+		jump(s, polynomial);
+		for (std::size_t j = 0; j < 4; ++j)
+			lanes[j][i] = s[j];
+	}
+}
+
+inline void xoshiro256::next_lanes(std::uint64_t (&output)[lane_count])
+{
+	#if defined(ANTKEEPER_MATH_SSE2)
+		for (std::size_t i = 0; i < lane_count; i += 2)
+		{
+			__m128i s0 = _mm_load_si128(reinterpret_cast<const __m128i*>(&lanes[0][i]));
+			__m128i s1 = _mm_load_si128(reinterpret_cast<const __m128i*>(&lanes[1][i]));
+			__m128i s2 = _mm_load_si128(reinterpret_cast<const __m128i*>(&lanes[2][i]));
+			__m128i s3 = _mm_load_si128(reinterpret_cast<const __m128i*>(&lanes[3][i]));
+			
+			const __m128i sum = _mm_add_epi64(s0, s3);
+			const __m128i result = _mm_add_epi64(_mm_or_si128(_mm_slli_epi64(sum, 23), _mm_srli_epi64(sum, 41)), s0);
+			const __m128i t = _mm_slli_epi64(s1, 17);
+			
+			s2 = _mm_xor_si128(s2, s0);
+			s3 = _mm_xor_si128(s3, s1);
+			s1 = _mm_xor_si128(s1, s2);
+			s0 = _mm_xor_si128(s0, s3);
+			s2 = _mm_xor_si128(s2, t);
+			s3 = _mm_or_si128(_mm_slli_epi64(s3, 45), _mm_srli_epi64(s3, 19));
+			
+			_mm_store_si128(reinterpret_cast<__m128i*>(&lanes[0][i]), s0);
+			_mm_store_si128(reinterpret_cast<__m128i*>(&lanes[1][i]), s1);
+			_mm_store_si128(reinterpret_cast<__m128i*>(&lanes[2][i]), s2);
+			_mm_store_si128(reinterpret_cast<__m128i*>(&lanes[3][i]), s3);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(&output[i]), result);
+		}
+	#else
+		for (std::size_t i = 0; i < lane_count; ++i)
+		{
+			const std::uint64_t result = rotl(lanes[0][i] + lanes[3][i], 23) + lanes[0][i];
+			const std::uint64_t t = lanes[1][i] << 17;
+			
+			lanes[2][i] ^= lanes[0][i];
+			lanes[3][i] ^= lanes[1][i];
+			lanes[1][i] ^= lanes[2][i];
+			lanes[0][i] ^= lanes[3][i];
+			lanes[2][i] ^= t;
+			lanes[3][i] = rotl(lanes[3][i], 45);
+			
+			output[i] = result;
+		}
+	#endif
+}
+
+} // namespace math
+
+#endif // ANTKEEPER_MATH_XOSHIRO256_HPP
@@ -22,7 +22,13 @@
 
 #include "physics/constants.hpp"
 #include "math/constants.hpp"
+#include "math/vector-type.hpp"
+#include "math/vector-functions.hpp"
+#include "math/vector-operators.hpp"
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <vector>
 
 namespace physics {
 
@@ -162,6 +168,186 @@ T optical_depth(const math::vector3<T>& a, const math::vector3<T>& b, T r, T sh,
 	return sum / T(2) * h;
 }
 
+/**
+ * Lookup table of the transmittance between points inside an atmosphere and the outer edge of the atmosphere.
+ *
+ * The table is parameterized by radial distance from the center of the planet and by the cosine of the zenith angle of the view ray, using the mapping of Bruneton (2017), which concentrates samples toward the horizon. Rows correspond to radial distance and columns correspond to the zenith angle. Texel `i` of an axis with `n` texels maps to the unit coordinate `i / (n - 1)`.
+ *
+ * @tparam T Scalar type.
+ *
+ * @see Bruneton, Eric. (2017). A Qualitative and Quantitative Evaluation of 8 Clear Sky Models.
+ * @see https://ebruneton.github.io/precomputed_atmospheric_scattering/
+ */
+template <class T>
+class transmittance_lut
+{
+public:
+	/// Vector type.
+	typedef math::vector3<T> vector_type;
+	
+	/**
+	 * Creates a transmittance lookup table.
+	 *
+	 * @param width Number of zenith angle samples.
+	 * @param height Number of altitude samples.
+	 * @param inner_radius Radius of the planet.
+	 * @param outer_radius Radius of the outer edge of the atmosphere.
+	 */
+	transmittance_lut(std::size_t width, std::size_t height, T inner_radius, T outer_radius);
+	
+	/**
+	 * Integrates the transmittance of a range of rows of the table. Disjoint row ranges may be generated concurrently.
+	 *
+	 * @param extinction_r Rayleigh extinction coefficients at sea level.
+	 * @param extinction_m Mie extinction coefficients at sea level.
+	 * @param sh_r Rayleigh scale height.
+	 * @param sh_m Mie scale height.
+	 * @param samples Number of optical depth samples per texel.
+	 * @param row_begin Index of the first row to generate.
+	 * @param row_end Index one past the last row to generate.
+	 */
+	void generate(const vector_type& extinction_r, const vector_type& extinction_m, T sh_r, T sh_m, std::size_t samples, std::size_t row_begin, std::size_t row_end);
+	
+	/**
+	 * Samples the table with bilinear interpolation.
+	 *
+	 * @param altitude Altitude of the view ray origin above sea level.
+	 * @param cos_zenith Cosine of the angle between the view ray and the zenith.
+	 * @return Transmittance along the view ray, or `0` if the view ray intersects the planet.
+	 */
+	vector_type sample(T altitude, T cos_zenith) const;
+	
+	/// Returns the number of zenith angle samples.
+	std::size_t get_width() const;
+	
+	/// Returns the number of altitude samples.
+	std::size_t get_height() const;
+	
+	/// Returns the radius of the planet.
+	T get_inner_radius() const;
+	
+	/// Returns the radius of the outer edge of the atmosphere.
+	T get_outer_radius() const;
+	
+	/// Returns the tabulated transmittance values, in row-major order.
+	const std::vector<vector_type>& get_data() const;
+	
+private:
+	std::size_t width;
+	std::size_t height;
+	T inner_radius;
+	T outer_radius;
+	std::vector<vector_type> data;
+};
+
+template <class T>
+transmittance_lut<T>::transmittance_lut(std::size_t width, std::size_t height, T inner_radius, T outer_radius):
+	width(width),
+	height(height),
+	inner_radius(inner_radius),
+	outer_radius(outer_radius),
+	data(width * height, vector_type{T(1), T(1), T(1)})
+{}
+
+template <class T>
+void transmittance_lut<T>::generate(const vector_type& extinction_r, const vector_type& extinction_m, T sh_r, T sh_m, std::size_t samples, std::size_t row_begin, std::size_t row_end)
+{
+	const T h = std::sqrt(outer_radius * outer_radius - inner_radius * inner_radius);
+	
+	for (std::size_t y = row_begin; y < row_end; ++y)
+	{
+		// Map row to radial distance
+		const T rho = h * T(y) / T(height - 1);
+		const T r = std::sqrt(rho * rho + inner_radius * inner_radius);
+		
+		// Distances to the outer edge of the atmosphere along the zenith and horizon
+		const T d_min = outer_radius - r;
+		const T d_max = rho + h;
+		
+		for (std::size_t x = 0; x < width; ++x)
+		{
+			// Map column to distance to the outer edge, then to the cosine of the zenith angle
+			const T d = d_min + (d_max - d_min) * T(x) / T(width - 1);
+			const T mu = (d <= T(0)) ? T(1) : std::clamp((h * h - rho * rho - d * d) / (T(2) * r * d), T(-1), T(1));
+			
+			const vector_type a = {T(0), r, T(0)};
+			const vector_type b = a + vector_type{std::sqrt(std::max(T(0), T(1) - mu * mu)), mu, T(0)} * d;
+			
+			const T depth_r = optical_depth(a, b, inner_radius, sh_r, samples);
+			const T depth_m = optical_depth(a, b, inner_radius, sh_m, samples);
+			
+			const vector_type tau = extinction_r * depth_r + extinction_m * depth_m;
+			data[y * width + x] = {std::exp(-tau.x), std::exp(-tau.y), std::exp(-tau.z)};
+		}
+	}
+}
+
+template <class T>
+typename transmittance_lut<T>::vector_type transmittance_lut<T>::sample(T altitude, T cos_zenith) const
+{
+	const T r = std::clamp(inner_radius + altitude, inner_radius, outer_radius);
+	const T mu = std::clamp(cos_zenith, T(-1), T(1));
+	
+	// View rays below the horizon intersect the planet
+	const T ratio = inner_radius / r;
+	if (mu < -std::sqrt(std::max(T(0), T(1) - ratio * ratio)))
+		return {T(0), T(0), T(0)};
+	
+	// Map radial distance and zenith angle to unit coordinates
+	const T h = std::sqrt(outer_radius * outer_radius - inner_radius * inner_radius);
+	const T rho = std::sqrt(std::max(T(0), r * r - inner_radius * inner_radius));
+	const T d = std::max(T(0), -r * mu + std::sqrt(std::max(T(0), r * r * (mu * mu - T(1)) + outer_radius * outer_radius)));
+	const T d_min = outer_radius - r;
+	const T d_max = rho + h;
+	const T u = (d_max > d_min) ? (d - d_min) / (d_max - d_min) : T(0);
+	const T v = rho / h;
+	
+	// Bilinearly interpolate texels
+	const T fx = std::clamp(u, T(0), T(1)) * T(width - 1);
+	const T fy = std::clamp(v, T(0), T(1)) * T(height - 1);
+	const std::size_t x0 = std::min(static_cast<std::size_t>(fx), width - 2);
+	const std::size_t y0 = std::min(static_cast<std::size_t>(fy), height - 2);
+	const T tx = fx - T(x0);
+	const T ty = fy - T(y0);
+	
+	const vector_type& t00 = data[y0 * width + x0];
+	const vector_type& t10 = data[y0 * width + x0 + 1];
+	const vector_type& t01 = data[(y0 + 1) * width + x0];
+	const vector_type& t11 = data[(y0 + 1) * width + x0 + 1];
+	
+	return (t00 * (T(1) - tx) + t10 * tx) * (T(1) - ty) + (t01 * (T(1) - tx) + t11 * tx) * ty;
+}
+
+template <class T>
+inline std::size_t transmittance_lut<T>::get_width() const
+{
+	return width;
+}
+
+template <class T>
+inline std::size_t transmittance_lut<T>::get_height() const
+{
+	return height;
+}
+
+template <class T>
+inline T transmittance_lut<T>::get_inner_radius() const
+{
+	return inner_radius;
+}
+
+template <class T>
+inline T transmittance_lut<T>::get_outer_radius() const
+{
+	return outer_radius;
+}
+
+template <class T>
+inline const std::vector<typename transmittance_lut<T>::vector_type>& transmittance_lut<T>::get_data() const
+{
+	return data;
+}
+
 } // namespace atmosphere
 
 } // namespace physics
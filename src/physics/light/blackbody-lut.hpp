@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTKEEPER_PHYSICS_LIGHT_BLACKBODY_LUT_HPP
+#define ANTKEEPER_PHYSICS_LIGHT_BLACKBODY_LUT_HPP
+
+#include "physics/light/blackbody.hpp"
+#include "physics/light/photometry.hpp"
+#include "math/math.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace physics {
+namespace light {
+namespace blackbody {
+
+/**
+ * Temperature-indexed lookup table of the tristimulus luminous efficacy of blackbody radiators.
+ *
+ * Each entry holds the integral of the spectral exitance of a blackbody, weighted by a color matching function, divided by the radiant exitance of the blackbody. Entries are therefore smooth in temperature and independent of surface area, and the luminous intensity of a blackbody reduces to one interpolated lookup scaled by its radiant intensity. Temperatures are spaced logarithmically.
+ *
+ * @tparam T Scalar type.
+ */
+template <class T>
+class efficacy_lut
+{
+public:
+	/// Tristimulus vector type.
+	typedef math::vector3<T> vector_type;
+	
+	/**
+	 * Builds a luminous efficacy lookup table.
+	 *
+	 * The spectrum is integrated with the same composite Simpson's rule as math::quadrature::simpson(), with the color matching function evaluated only once per sample wavelength.
+	 *
+	 * @param t_min Minimum temperature, in kelvin.
+	 * @param t_max Maximum temperature, in kelvin.
+	 * @param count Number of table entries.
+	 * @param cmf Unary function object that returns a tristimulus vector given a wavelength, in nanometers.
+	 * @param first,last Range of sample wavelengths, in nanometers.
+	 */
+	template <class UnaryOp, class InputIt>
+	efficacy_lut(T t_min, T t_max, std::size_t count, UnaryOp cmf, InputIt first, InputIt last);
+	
+	/**
+	 * Returns the tristimulus luminous efficacy of a blackbody, in lumen per watt of radiant flux.
+	 *
+	 * @param t Temperature of the blackbody, in kelvin. Clamped to the range of the table.
+	 */
+	vector_type efficacy(T t) const;
+	
+	/**
+	 * Calculates the tristimulus luminous intensity of a blackbody.
+	 *
+	 * @param t Temperature of the blackbody, in kelvin.
+	 * @param a Surface area of the blackbody, in square meters.
+	 * @return Luminous intensity, in candela.
+	 */
+	vector_type luminous_intensity(T t, T a) const;
+	
+	/**
+	 * Calculates the tristimulus luminous intensities of many blackbodies.
+	 *
+	 * @param t Array of temperatures, in kelvin.
+	 * @param a Array of surface areas, in square meters.
+	 * @param[out] intensity Array of luminous intensities, in candela.
+	 * @param count Number of blackbodies.
+	 */
+	void luminous_intensity(const T* t, const T* a, vector_type* intensity, std::size_t count) const;
+	
+	/**
+	 * Returns the tristimulus chromaticity of a blackbody, normalized such that the second (Y) component is `1`.
+	 *
+	 * @param t Temperature of the blackbody, in kelvin.
+	 */
+	vector_type chromaticity(T t) const;
+	
+	/// Returns `true` if a temperature lies within the range of the table.
+	bool contains(T t) const;
+	
+private:
+	T log_t_min;
+	T log_t_max;
+	T index_scale;
+	std::vector<vector_type> entries;
+};
+
+template <class T>
+template <class UnaryOp, class InputIt>
+efficacy_lut<T>::efficacy_lut(T t_min, T t_max, std::size_t count, UnaryOp cmf, InputIt first, InputIt last):
+	log_t_min(std::log(t_min)),
+	log_t_max(std::log(t_max)),
+	index_scale(T(std::max<std::size_t>(count, 2) - 1) / (std::log(t_max) - std::log(t_min))),
+	entries(std::max<std::size_t>(count, 2), vector_type{T(0), T(0), T(0)})
+{
+	// Gather Simpson's rule sample wavelengths, weights, and color matching function values
+	std::vector<T> wavelengths;
+	std::vector<T> weights;
+	std::vector<vector_type> colors;
+	const std::vector<T> nodes(first, last);
+	if (nodes.size() == 1)
+	{
+		wavelengths.push_back(nodes[0]);
+		weights.push_back(T(1));
+	}
+	for (std::size_t i = 1; i < nodes.size(); ++i)
+	{
+		const T h = nodes[i] - nodes[i - 1];
+		wavelengths.push_back(nodes[i - 1]);
+		weights.push_back(h / T(6));
+		wavelengths.push_back(nodes[i - 1] + h / T(2));
+		weights.push_back(h * T(4) / T(6));
+		wavelengths.push_back(nodes[i]);
+		weights.push_back(h / T(6));
+	}
+	colors.reserve(wavelengths.size());
+	for (T wavelength: wavelengths)
+		colors.push_back(cmf(wavelength));
+	
+	// Convert wavelengths from nanometers to meters
+	std::vector<T> wavelengths_m(wavelengths.size());
+	std::transform(wavelengths.begin(), wavelengths.end(), wavelengths_m.begin(), [](T x){return x * T(1e-9);});
+	
+	std::vector<T> exitance(wavelengths.size());
+	for (std::size_t i = 0; i < entries.size(); ++i)
+	{
+		const T t = std::exp(log_t_min + T(i) / index_scale);
+		
+		// Evaluate weighted spectral exitance at all sample wavelengths
+		for (std::size_t j = 0; j < wavelengths_m.size(); ++j)
+			exitance[j] = spectral_exitance<T>(t, wavelengths_m[j]) * weights[j];
+		
+		vector_type sum = {T(0), T(0), T(0)};
+		for (std::size_t j = 0; j < wavelengths_m.size(); ++j)
+			sum += colors[j] * exitance[j];
+		
+		// Normalize by radiant exitance and convert spectral units from per meter to per nanometer
+		entries[i] = sum * (T(1e-9) * max_luminous_efficacy<T> / radiant_exitance(t));
+	}
+}
+
+template <class T>
+typename efficacy_lut<T>::vector_type efficacy_lut<T>::efficacy(T t) const
+{
+	const T x = std::clamp((std::log(t) - log_t_min) * index_scale, T(0), T(entries.size() - 1));
+	const std::size_t i = std::min(static_cast<std::size_t>(x), entries.size() - 2);
+	const T f = x - T(i);
+	
+	return entries[i] * (T(1) - f) + entries[i + 1] * f;
+}
+
+template <class T>
+inline typename efficacy_lut<T>::vector_type efficacy_lut<T>::luminous_intensity(T t, T a) const
+{
+	return efficacy(t) * radiant_intensity(t, a);
+}
+
+template <class T>
+void efficacy_lut<T>::luminous_intensity(const T* t, const T* a, vector_type* intensity, std::size_t count) const
+{
+	const T max_x = T(entries.size() - 1);
+	const std::size_t max_i = entries.size() - 2;
+	
+	for (std::size_t k = 0; k < count; ++k)
+	{
+		const T x = std::clamp((std::log(t[k]) - log_t_min) * index_scale, T(0), max_x);
+		const std::size_t i = std::min(static_cast<std::size_t>(x), max_i);
+		const T f = x - T(i);
+		const T scale = radiant_intensity(t[k], a[k]);
+		
+		intensity[k] = (entries[i] * (T(1) - f) + entries[i + 1] * f) * scale;
+	}
+}
+
+template <class T>
+typename efficacy_lut<T>::vector_type efficacy_lut<T>::chromaticity(T t) const
+{
+	const vector_type x = efficacy(t);
+	return x / x.y;
+}
+
+template <class T>
+inline bool efficacy_lut<T>::contains(T t) const
+{
+	const T log_t = std::log(t);
+	return log_t >= log_t_min && log_t <= log_t_max;
+}
+
+} // namespace blackbody
+} // namespace light
+} // namespace physics
+
+#endif // ANTKEEPER_PHYSICS_LIGHT_BLACKBODY_LUT_HPP
@@ -28,6 +28,7 @@ namespace light {}
 } // namespace physics
 
 #include "blackbody.hpp"
+#include "blackbody-lut.hpp"
 #include "luminosity.hpp"
 #include "phase.hpp"
 #include "photometry.hpp"
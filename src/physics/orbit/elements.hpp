@@ -77,6 +77,26 @@ T derive_longitude_periapsis(T w, T raan);
 template <class T>
 T derive_semiminor_axis(T a, T e);
 
+/**
+ * Derives the mean motion (n) of an orbit.
+ *
+ * @param a Semimajor axis (a).
+ * @param mu Standard gravitational parameter (GM) of the central body.
+ * @return Mean motion (n), in radians per unit time.
+ */
+template <class T>
+T derive_mean_motion(T a, T mu);
+
+/**
+ * Derives the true anomaly (nu) of an orbit, given the eccentricity (e) and eccentric anomaly (E).
+ *
+ * @param e Eccentricity (e).
+ * @param ea Eccentric anomaly (E), in radians.
+ * @return True anomaly (nu), in radians.
+ */
+template <class T>
+T derive_true_anomaly(T e, T ea);
+
 template <class T>
 T derive_longitude_periapsis(T w, T raan)
 {
@@ -89,6 +109,18 @@ T derive_semiminor_axis(T a, T e)
 	return a * std::sqrt(T(1) - e * e);
 }
 
+template <class T>
+T derive_mean_motion(T a, T mu)
+{
+	return std::sqrt(mu / (a * a * a));
+}
+
+template <class T>
+T derive_true_anomaly(T e, T ea)
+{
+	return T(2) * std::atan2(std::sqrt(T(1) + e) * std::sin(ea * T(0.5)), std::sqrt(T(1) - e) * std::cos(ea * T(0.5)));
+}
+
 } // namespace orbit
 } // namespace physics
 
@@ -20,7 +20,10 @@
 #ifndef ANTKEEPER_PHYSICS_ORBIT_KEPLER_HPP
 #define ANTKEEPER_PHYSICS_ORBIT_KEPLER_HPP
 
+#include "math/constants.hpp"
 #include <cmath>
+#include <cstddef>
+#include <limits>
 
 namespace physics {
 namespace orbit {
@@ -37,6 +40,24 @@ namespace orbit {
 template <class T>
 T kepler_ea(T ec, T ma, std::size_t iterations, T tolerance = T(0));
 
+/**
+ * Iteratively solves Kepler's equation for the eccentric anomalies (E) of many elliptical orbits at once.
+ *
+ * Each orbit is started from the Danby starter `E0 = M + 0.85e * sign(sin M)` and refined with Halley's method. The sine and cosine of E are carried alongside E and rotated by each correction using short Taylor polynomials, so only the starter and the first iteration call `std::sin` and `std::cos`. The wrapping and Halley loops are branch-free over structure-of-arrays data, with no `std::floor` and no reductions, so that the compiler vectorizes them with SSE2. The arrays must not overlap. The `std::sin` and `std::cos` loops stay scalar, as there are no vector versions of them without a vector math library.
+ *
+ * @param ec Array of eccentricities (e), each on `[0, 1)`.
+ * @param ma Array of mean anomalies (M).
+ * @param[out] ea Array of eccentric anomalies (E), normalized to `[-pi, pi]` about the wrapped mean anomaly.
+ * @param[out] sin_ea Array of sines of the eccentric anomalies.
+ * @param[out] cos_ea Array of cosines of the eccentric anomalies.
+ * @param[out] error Array of the magnitudes of the last correction to each eccentric anomaly.
+ * @param count Number of orbits.
+ * @param iterations Maximum number of iterations.
+ * @param tolerance Solution error tolerance. Iteration stops once every correction in the batch is smaller than the tolerance.
+ */
+template <class T>
+void kepler_ea(const T* __restrict ec, const T* __restrict ma, T* __restrict ea, T* __restrict sin_ea, T* __restrict cos_ea, T* __restrict error, std::size_t count, std::size_t iterations, T tolerance = T(0));
+
 /**
  * Solves Kepler's equation for mean anomaly (M).
  *
@@ -67,6 +88,77 @@ T kepler_ea(T ec, T ma, std::size_t iterations, T tolerance)
 	return ea0;
 }
 
+template <class T>
+void kepler_ea(const T* __restrict ec, const T* __restrict ma, T* __restrict ea, T* __restrict sin_ea, T* __restrict cos_ea, T* __restrict error, std::size_t count, std::size_t iterations, T tolerance)
+{
+	if (!count)
+		return;
+	
+	// Adding and subtracting this rounds to the nearest integer. Unlike std::floor, it needs no SSE4.1 to be vectorized.
+	const T round_bias = T(1.5) * std::ldexp(T(1), std::numeric_limits<T>::digits - 1);
+	
+	// Wrap M to [-pi, pi] and apply starter
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const T revolutions = (ma[i] / math::two_pi<T> + round_bias) - round_bias;
+		const T m = ma[i] - math::two_pi<T> * revolutions;
+		ea[i] = m + std::copysign(T(0.85) * ec[i], m);
+	}
+	
+	// Evaluate sin(E) and cos(E) of the starter
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		sin_ea[i] = std::sin(ea[i]);
+		cos_ea[i] = std::cos(ea[i]);
+	}
+	
+	for (std::size_t k = 0; k < iterations; ++k)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			const T revolutions = (ma[i] / math::two_pi<T> + round_bias) - round_bias;
+			const T m = ma[i] - math::two_pi<T> * revolutions;
+			const T e = ec[i];
+			const T s = sin_ea[i];
+			const T c = cos_ea[i];
+			
+			// Halley step
+			const T f = ea[i] - e * s - m;
+			const T f1 = T(1) - e * c;
+			const T f2 = e * s;
+			const T d0 = -f / f1;
+			const T d = -f / (f1 + T(0.5) * d0 * f2);
+			
+			// Rotate sin(E) and cos(E) by the correction
+			const T d2 = d * d;
+			const T sin_d = d * (T(1) - d2 * (T(1.0 / 6.0) - d2 * (T(1.0 / 120.0) - d2 * T(1.0 / 5040.0))));
+			const T cos_d = T(1) - d2 * (T(0.5) - d2 * (T(1.0 / 24.0) - d2 * T(1.0 / 720.0)));
+			sin_ea[i] = s * cos_d + c * sin_d;
+			cos_ea[i] = c * cos_d - s * sin_d;
+			ea[i] += d;
+			
+			error[i] = std::abs(d);
+		}
+		
+		// Re-evaluate sin(E) and cos(E) exactly after the first step, which may be too large for the Taylor polynomials
+		if (!k)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				sin_ea[i] = std::sin(ea[i]);
+				cos_ea[i] = std::cos(ea[i]);
+			}
+		}
+		
+		// Stop once every correction is within tolerance. This is checked apart from the Halley loop, which is not vectorized with a reduction.
+		bool converged = true;
+		for (std::size_t i = 0; i < count && converged; ++i)
+			converged = (error[i] < tolerance);
+		if (converged)
+			break;
+	}
+}
+
 template <class T>
 T kepler_ma(T ec, T ea)
 {
@@ -34,6 +34,7 @@ namespace orbit {}
 #include "physics/orbit/elements.hpp"
 #include "physics/orbit/frames.hpp"
 #include "physics/orbit/kepler.hpp"
+#include "physics/orbit/propagator.hpp"
 #include "physics/orbit/state.hpp"
 
 #endif // ANTKEEPER_PHYSICS_ORBIT_HPP
@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTKEEPER_PHYSICS_ORBIT_PROPAGATOR_HPP
+#define ANTKEEPER_PHYSICS_ORBIT_PROPAGATOR_HPP
+
+#include "physics/orbit/elements.hpp"
+#include "physics/orbit/frames.hpp"
+#include "physics/orbit/kepler.hpp"
+#include "physics/orbit/state.hpp"
+#include "math/math.hpp"
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace physics {
+namespace orbit {
+
+/**
+ * Propagates the state vectors of many elliptical orbits at once.
+ *
+ * Orbits are stored in structure-of-arrays form. The perifocal basis of each orbit is derived once, when its elements are set, so propagation reduces to one batched solution of Kepler's equation followed by two scaled basis vectors per orbit. Velocities are evaluated analytically from the eccentric anomaly.
+ *
+ * @tparam T Scalar type.
+ */
+template <class T>
+class propagator
+{
+public:
+	/// Scalar type.
+	typedef T scalar_type;
+	
+	/// Vector type.
+	typedef math::vector3<T> vector_type;
+	
+	/// Creates a propagator.
+	propagator();
+	
+	/**
+	 * Adds an orbit to the propagator.
+	 *
+	 * @param elements Orbital elements.
+	 * @param mean_motion Mean motion (n), in radians per unit time.
+	 * @return Index of the added orbit.
+	 */
+	std::size_t add(const elements<T>& elements, T mean_motion);
+	
+	/**
+	 * Replaces the elements of an orbit.
+	 *
+	 * @param index Index of the orbit.
+	 * @param elements Orbital elements.
+	 * @param mean_motion Mean motion (n), in radians per unit time.
+	 */
+	void set(std::size_t index, const elements<T>& elements, T mean_motion);
+	
+	/**
+	 * Removes an orbit. The last orbit is moved into the vacated index.
+	 *
+	 * @param index Index of the orbit to remove.
+	 */
+	void remove(std::size_t index);
+	
+	/// Removes all orbits.
+	void clear();
+	
+	/**
+	 * Propagates all orbits to time @p t, relative to the epoch of their elements.
+	 *
+	 * @param t Time since epoch.
+	 */
+	void propagate(T t);
+	
+	/**
+	 * Sets the maximum number of iterations and error tolerance used to solve Kepler's equation.
+	 *
+	 * @param iterations Maximum number of iterations.
+	 * @param tolerance Solution error tolerance.
+	 */
+	void set_kepler_solver(std::size_t iterations, T tolerance);
+	
+	/// Returns the number of orbits.
+	std::size_t size() const;
+	
+	/// Returns the Cartesian position of an orbiting body in the parent inertial space, as of the last propagation.
+	vector_type get_position(std::size_t index) const;
+	
+	/// Returns the Cartesian velocity of an orbiting body in the parent inertial space, as of the last propagation.
+	vector_type get_velocity(std::size_t index) const;
+	
+	/// Returns the orbital state of an orbiting body, as of the last propagation.
+	state<T> get_state(std::size_t index) const;
+	
+private:
+	void resize(std::size_t size);
+	
+	std::size_t ke_iterations;
+	T ke_tolerance;
+	
+	// Per-orbit parameters
+	std::vector<T> ec;
+	std::vector<T> a;
+	std::vector<T> b;
+	std::vector<T> n;
+	std::vector<T> ma0;
+	
+	// Perifocal basis vectors (P and Q) in the parent inertial space
+	std::vector<vector_type> p;
+	std::vector<vector_type> q;
+	
+	// Propagation scratch
+	std::vector<T> ma;
+	std::vector<T> ea;
+	std::vector<T> sin_ea;
+	std::vector<T> cos_ea;
+	std::vector<T> ea_error;
+	
+	// Propagated state vectors
+	std::vector<vector_type> r;
+	std::vector<vector_type> v;
+};
+
+template <class T>
+propagator<T>::propagator():
+	ke_iterations(10),
+	ke_tolerance(T(1e-6))
+{}
+
+template <class T>
+std::size_t propagator<T>::add(const elements<T>& elements, T mean_motion)
+{
+	const std::size_t index = size();
+	resize(index + 1);
+	set(index, elements, mean_motion);
+	return index;
+}
+
+template <class T>
+void propagator<T>::set(std::size_t index, const elements<T>& elements, T mean_motion)
+{
+	ec[index] = elements.e;
+	a[index] = elements.a;
+	b[index] = derive_semiminor_axis(elements.a, elements.e);
+	n[index] = mean_motion;
+	
+	// Convert true anomaly at epoch to mean anomaly at epoch
+	const T ea_epoch = T(2) * std::atan2
+	(
+		std::sqrt(T(1) - elements.e) * std::sin(elements.ta * T(0.5)),
+		std::sqrt(T(1) + elements.e) * std::cos(elements.ta * T(0.5))
+	);
+	ma0[index] = kepler_ma(elements.e, ea_epoch);
+	
+	// Cache perifocal basis vectors in the parent inertial space
+	const physics::frame<T> perifocal_to_inertial = inertial::to_perifocal
+	(
+		vector_type{T(0), T(0), T(0)},
+		elements.raan,
+		elements.i,
+		elements.w
+	).inverse();
+	p[index] = perifocal_to_inertial.rotation * vector_type{T(1), T(0), T(0)};
+	q[index] = perifocal_to_inertial.rotation * vector_type{T(0), T(1), T(0)};
+	
+	r[index] = vector_type{T(0), T(0), T(0)};
+	v[index] = vector_type{T(0), T(0), T(0)};
+}
+
+template <class T>
+void propagator<T>::remove(std::size_t index)
+{
+	const std::size_t last = size() - 1;
+	if (index != last)
+	{
+		ec[index] = ec[last];
+		a[index] = a[last];
+		b[index] = b[last];
+		n[index] = n[last];
+		ma0[index] = ma0[last];
+		p[index] = p[last];
+		q[index] = q[last];
+		r[index] = r[last];
+		v[index] = v[last];
+	}
+	
+	resize(last);
+}
+
+template <class T>
+void propagator<T>::clear()
+{
+	resize(0);
+}
+
+template <class T>
+void propagator<T>::propagate(T t)
+{
+	const std::size_t count = size();
+	
+	// Advance mean anomalies
+	for (std::size_t i = 0; i < count; ++i)
+		ma[i] = ma0[i] + n[i] * t;
+	
+	// Solve Kepler's equation for all eccentric anomalies
+	kepler_ea(ec.data(), ma.data(), ea.data(), sin_ea.data(), cos_ea.data(), ea_error.data(), count, ke_iterations, ke_tolerance);
+	
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		// Perifocal position
+		const T x = a[i] * (cos_ea[i] - ec[i]);
+		const T y = b[i] * sin_ea[i];
+		
+		// Perifocal velocity, from the time derivative of E: dE/dt = n / (1 - e * cos(E))
+		const T de = n[i] / (T(1) - ec[i] * cos_ea[i]);
+		const T vx = -a[i] * sin_ea[i] * de;
+		const T vy = b[i] * cos_ea[i] * de;
+		
+		// Transform into parent inertial space
+		r[i] = p[i] * x + q[i] * y;
+		v[i] = p[i] * vx + q[i] * vy;
+	}
+}
+
+template <class T>
+void propagator<T>::set_kepler_solver(std::size_t iterations, T tolerance)
+{
+	ke_iterations = iterations;
+	ke_tolerance = tolerance;
+}
+
+template <class T>
+inline std::size_t propagator<T>::size() const
+{
+	return ec.size();
+}
+
+template <class T>
+inline typename propagator<T>::vector_type propagator<T>::get_position(std::size_t index) const
+{
+	return r[index];
+}
+
+template <class T>
+inline typename propagator<T>::vector_type propagator<T>::get_velocity(std::size_t index) const
+{
+	return v[index];
+}
+
+template <class T>
+inline state<T> propagator<T>::get_state(std::size_t index) const
+{
+	return state<T>{r[index], v[index]};
+}
+
+template <class T>
+void propagator<T>::resize(std::size_t size)
+{
+	ec.resize(size);
+	a.resize(size);
+	b.resize(size);
+	n.resize(size);
+	ma0.resize(size);
+	p.resize(size);
+	q.resize(size);
+	ma.resize(size);
+	ea.resize(size);
+	sin_ea.resize(size);
+	cos_ea.resize(size);
+	ea_error.resize(size);
+	r.resize(size);
+	v.resize(size);
+}
+
+} // namespace orbit
+} // namespace physics
+
+#endif // ANTKEEPER_PHYSICS_ORBIT_PROPAGATOR_HPP
@@ -0,0 +1,442 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "renderer/geometry-optimization.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+/// Number of entries in the simulated vertex cache.
+static constexpr std::size_t vertex_cache_size = 32;
+
+/// Number of entries in the FIFO vertex cache used to find cluster boundaries.
+static constexpr std::size_t cluster_cache_size = 16;
+
+static std::uint64_t hash_vertex(const float* vertex, std::size_t size);
+static float score_vertex(int cache_position, std::uint32_t live_triangle_count);
+
+std::size_t weld_vertices(std::uint32_t* remap, const float* vertices, std::size_t vertex_size, std::size_t vertex_count)
+{
+	const std::size_t vertex_bytes = vertex_size * sizeof(float);
+	
+	// Allocate an open-addressed hash table with a load factor of at most 0.5
+	std::size_t table_size = 1;
+	while (table_size < vertex_count * 2)
+		table_size <<= 1;
+	std::vector<std::uint32_t> table(table_size, ~std::uint32_t(0));
+	
+	std::size_t unique_count = 0;
+	for (std::size_t i = 0; i < vertex_count; ++i)
+	{
+		const float* vertex = vertices + i * vertex_size;
+		
+		std::size_t slot = hash_vertex(vertex, vertex_bytes) & (table_size - 1);
+		for (;;)
+		{
+			const std::uint32_t entry = table[slot];
+			if (entry == ~std::uint32_t(0))
+			{
+				// First occurrence of the vertex
+				table[slot] = static_cast<std::uint32_t>(i);
+				remap[i] = static_cast<std::uint32_t>(unique_count++);
+				break;
+			}
+			
+			if (!std::memcmp(vertices + entry * vertex_size, vertex, vertex_bytes))
+			{
+				// Duplicate of an earlier vertex
+				remap[i] = remap[entry];
+				break;
+			}
+			
+			slot = (slot + 1) & (table_size - 1);
+		}
+	}
+	
+	return unique_count;
+}
+
+void remap_vertices(float* destination, const float* vertices, std::size_t vertex_size, std::size_t vertex_count, const std::uint32_t* remap)
+{
+	for (std::size_t i = 0; i < vertex_count; ++i)
+	{
+		if (remap[i] != ~std::uint32_t(0))
+			std::memcpy(destination + remap[i] * vertex_size, vertices + i * vertex_size, vertex_size * sizeof(float));
+	}
+}
+
+void remap_indices(std::uint32_t* indices, std::size_t index_count, const std::uint32_t* remap)
+{
+	for (std::size_t i = 0; i < index_count; ++i)
+		indices[i] = remap[indices[i]];
+}
+
+std::size_t assign_barycentric_coordinates(std::vector<float>& vertices, std::size_t vertex_size, std::size_t offset, std::uint32_t* indices, std::size_t index_count)
+{
+	const std::uint32_t invalid = ~std::uint32_t(0);
+	const std::size_t vertex_count = vertices.size() / vertex_size;
+	
+	// For each original vertex, the index of its copy with each of the three colors
+	std::vector<std::array<std::uint32_t, 3>> variants(vertex_count, {invalid, invalid, invalid});
+	std::vector<int> colors(vertex_count, -1);
+	
+	for (std::size_t i = 0; i + 2 < index_count; i += 3)
+	{
+		std::uint32_t* triangle = indices + i;
+		int corner_colors[3];
+		unsigned int used = 0;
+		
+		// Keep the colors of corners which were already colored, if they don't conflict
+		for (int k = 0; k < 3; ++k)
+		{
+			const int color = colors[triangle[k]];
+			if (color >= 0 && !(used & (1u << color)))
+			{
+				corner_colors[k] = color;
+				used |= 1u << color;
+			}
+			else
+			{
+				corner_colors[k] = -1;
+			}
+		}
+		
+		// Color the remaining corners, preferring colors for which a copy of the vertex already exists
+		for (int k = 0; k < 3; ++k)
+		{
+			if (corner_colors[k] >= 0)
+				continue;
+			
+			const std::uint32_t vertex = triangle[k];
+			int color = -1;
+			for (int c = 0; c < 3 && color < 0; ++c)
+				if (!(used & (1u << c)) && variants[vertex][c] != invalid)
+					color = c;
+			for (int c = 0; c < 3 && color < 0; ++c)
+				if (!(used & (1u << c)))
+					color = c;
+			
+			corner_colors[k] = color;
+			used |= 1u << color;
+			
+			if (colors[vertex] < 0)
+			{
+				colors[vertex] = color;
+				variants[vertex][color] = vertex;
+			}
+			else if (variants[vertex][color] != invalid)
+			{
+				triangle[k] = variants[vertex][color];
+			}
+			else
+			{
+				// Duplicate the vertex with the new color
+				const std::uint32_t copy = static_cast<std::uint32_t>(vertices.size() / vertex_size);
+				vertices.resize(vertices.size() + vertex_size);
+				std::copy_n(vertices.begin() + vertex * vertex_size, vertex_size, vertices.begin() + copy * vertex_size);
+				variants[vertex][color] = copy;
+				triangle[k] = copy;
+			}
+		}
+	}
+	
+	// Write barycentric coordinates of the original vertices and their copies
+	for (std::size_t i = 0; i < vertex_count; ++i)
+	{
+		for (int c = 0; c < 3; ++c)
+		{
+			const std::uint32_t vertex = variants[i][c];
+			if (vertex == invalid)
+				continue;
+			
+			float* barycentric = vertices.data() + vertex * vertex_size + offset;
+			barycentric[0] = (c == 0) ? 1.0f : 0.0f;
+			barycentric[1] = (c == 1) ? 1.0f : 0.0f;
+			barycentric[2] = (c == 2) ? 1.0f : 0.0f;
+		}
+	}
+	
+	return vertices.size() / vertex_size;
+}
+
+void optimize_vertex_cache(std::uint32_t* indices, std::size_t index_count, std::size_t vertex_count)
+{
+	const std::size_t triangle_count = index_count / 3;
+	if (triangle_count < 2)
+		return;
+	
+	// Build vertex-triangle adjacency
+	std::vector<std::uint32_t> live_triangle_counts(vertex_count, 0);
+	for (std::size_t i = 0; i < triangle_count * 3; ++i)
+		++live_triangle_counts[indices[i]];
+	std::vector<std::uint32_t> adjacency_offsets(vertex_count + 1, 0);
+	for (std::size_t i = 0; i < vertex_count; ++i)
+		adjacency_offsets[i + 1] = adjacency_offsets[i] + live_triangle_counts[i];
+	std::vector<std::uint32_t> adjacency(triangle_count * 3);
+	{
+		std::vector<std::uint32_t> cursors(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+		for (std::size_t i = 0; i < triangle_count * 3; ++i)
+			adjacency[cursors[indices[i]]++] = static_cast<std::uint32_t>(i / 3);
+	}
+	
+	// Score vertices and triangles
+	std::vector<int> cache_positions(vertex_count, -1);
+	std::vector<float> vertex_scores(vertex_count);
+	for (std::size_t i = 0; i < vertex_count; ++i)
+		vertex_scores[i] = score_vertex(-1, live_triangle_counts[i]);
+	std::vector<float> triangle_scores(triangle_count);
+	std::size_t best_triangle = 0;
+	for (std::size_t i = 0; i < triangle_count; ++i)
+	{
+		const std::uint32_t* triangle = indices + i * 3;
+		triangle_scores[i] = vertex_scores[triangle[0]] + vertex_scores[triangle[1]] + vertex_scores[triangle[2]];
+		if (triangle_scores[i] > triangle_scores[best_triangle])
+			best_triangle = i;
+	}
+	
+	std::vector<bool> emitted(triangle_count, false);
+	std::vector<std::uint32_t> output(triangle_count * 3);
+	std::array<std::uint32_t, vertex_cache_size + 3> cache;
+	std::array<std::uint32_t, vertex_cache_size + 3> next_cache;
+	std::size_t cache_count = 0;
+	std::size_t scan_cursor = 0;
+	
+	for (std::size_t n = 0; n < triangle_count; ++n)
+	{
+		// If no triangle in the cache scores, continue with the next unemitted triangle
+		if (best_triangle == triangle_count)
+		{
+			while (emitted[scan_cursor])
+				++scan_cursor;
+			best_triangle = scan_cursor;
+		}
+		
+		// Emit the best triangle
+		const std::uint32_t* triangle = indices + best_triangle * 3;
+		std::copy_n(triangle, 3, output.begin() + n * 3);
+		emitted[best_triangle] = true;
+		
+		// Remove the triangle from the live adjacency of its vertices
+		for (int k = 0; k < 3; ++k)
+		{
+			const std::uint32_t vertex = triangle[k];
+			std::uint32_t* first = adjacency.data() + adjacency_offsets[vertex];
+			std::uint32_t* last = first + live_triangle_counts[vertex];
+			std::uint32_t* it = std::find(first, last, static_cast<std::uint32_t>(best_triangle));
+			if (it != last)
+			{
+				*it = *(last - 1);
+				--live_triangle_counts[vertex];
+			}
+		}
+		
+		// Move the triangle's vertices to the front of the cache
+		std::size_t next_cache_count = 0;
+		for (int k = 0; k < 3; ++k)
+			if (std::find(next_cache.begin(), next_cache.begin() + next_cache_count, triangle[k]) == next_cache.begin() + next_cache_count)
+				next_cache[next_cache_count++] = triangle[k];
+		for (std::size_t i = 0; i < cache_count; ++i)
+			if (cache[i] != triangle[0] && cache[i] != triangle[1] && cache[i] != triangle[2])
+				next_cache[next_cache_count++] = cache[i];
+		
+		// Rescore the vertices in the cache, including those which were pushed out
+		for (std::size_t i = 0; i < next_cache_count; ++i)
+		{
+			const std::uint32_t vertex = next_cache[i];
+			cache_positions[vertex] = (i < vertex_cache_size) ? static_cast<int>(i) : -1;
+			vertex_scores[vertex] = score_vertex(cache_positions[vertex], live_triangle_counts[vertex]);
+		}
+		
+		// Rescore the live triangles of the vertices in the cache, and find the best
+		best_triangle = triangle_count;
+		float best_score = -1.0f;
+		for (std::size_t i = 0; i < next_cache_count; ++i)
+		{
+			const std::uint32_t vertex = next_cache[i];
+			const std::uint32_t* first = adjacency.data() + adjacency_offsets[vertex];
+			for (std::uint32_t j = 0; j < live_triangle_counts[vertex]; ++j)
+			{
+				const std::uint32_t t = first[j];
+				const std::uint32_t* adjacent = indices + t * 3;
+				const float score = vertex_scores[adjacent[0]] + vertex_scores[adjacent[1]] + vertex_scores[adjacent[2]];
+				triangle_scores[t] = score;
+				if (score > best_score)
+				{
+					best_score = score;
+					best_triangle = t;
+				}
+			}
+		}
+		
+		cache_count = std::min(next_cache_count, vertex_cache_size);
+		std::copy_n(next_cache.begin(), cache_count, cache.begin());
+	}
+	
+	std::copy(output.begin(), output.end(), indices);
+}
+
+void optimize_overdraw(std::uint32_t* indices, std::size_t index_count, const float* positions, std::size_t vertex_size, std::size_t vertex_count)
+{
+	const std::size_t triangle_count = index_count / 3;
+	if (triangle_count < 2)
+		return;
+	
+	// Split triangles into clusters where all three vertices miss a simulated FIFO cache
+	std::vector<std::size_t> cluster_offsets;
+	std::vector<std::uint32_t> timestamps(vertex_count, 0);
+	std::uint32_t time = cluster_cache_size + 1;
+	for (std::size_t i = 0; i < triangle_count; ++i)
+	{
+		int misses = 0;
+		for (int k = 0; k < 3; ++k)
+		{
+			const std::uint32_t vertex = indices[i * 3 + k];
+			if (time - timestamps[vertex] > cluster_cache_size)
+			{
+				timestamps[vertex] = time++;
+				++misses;
+			}
+		}
+		
+		if (i == 0 || misses == 3)
+			cluster_offsets.push_back(i);
+	}
+	cluster_offsets.push_back(triangle_count);
+	
+	const std::size_t cluster_count = cluster_offsets.size() - 1;
+	if (cluster_count < 2)
+		return;
+	
+	auto position = [&](std::uint32_t vertex) -> const float*
+	{
+		return positions + vertex * vertex_size;
+	};
+	
+	// Calculate the area-weighted centroid and normal of each cluster, and of the mesh
+	std::vector<std::array<float, 6>> clusters(cluster_count, {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f});
+	float mesh_centroid[3] = {0.0f, 0.0f, 0.0f};
+	float mesh_area = 0.0f;
+	std::vector<float> cluster_areas(cluster_count, 0.0f);
+	for (std::size_t c = 0; c < cluster_count; ++c)
+	{
+		auto& cluster = clusters[c];
+		for (std::size_t i = cluster_offsets[c]; i < cluster_offsets[c + 1]; ++i)
+		{
+			const float* a = position(indices[i * 3]);
+			const float* b = position(indices[i * 3 + 1]);
+			const float* d = position(indices[i * 3 + 2]);
+			
+			const float ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+			const float ad[3] = {d[0] - a[0], d[1] - a[1], d[2] - a[2]};
+			const float normal[3] =
+			{
+				ab[1] * ad[2] - ab[2] * ad[1],
+				ab[2] * ad[0] - ab[0] * ad[2],
+				ab[0] * ad[1] - ab[1] * ad[0]
+			};
+			const float area = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			
+			for (int k = 0; k < 3; ++k)
+			{
+				const float centroid = (a[k] + b[k] + d[k]) / 3.0f;
+				cluster[k] += centroid * area;
+				cluster[3 + k] += normal[k];
+				mesh_centroid[k] += centroid * area;
+			}
+			cluster_areas[c] += area;
+			mesh_area += area;
+		}
+	}
+	if (mesh_area > 0.0f)
+		for (int k = 0; k < 3; ++k)
+			mesh_centroid[k] /= mesh_area;
+	
+	// Sort clusters by how far they face outward from the mesh centroid
+	std::vector<float> cluster_keys(cluster_count, 0.0f);
+	for (std::size_t c = 0; c < cluster_count; ++c)
+	{
+		const auto& cluster = clusters[c];
+		const float normal_length = std::sqrt(cluster[3] * cluster[3] + cluster[4] * cluster[4] + cluster[5] * cluster[5]);
+		if (normal_length <= 0.0f || cluster_areas[c] <= 0.0f)
+			continue;
+		
+		for (int k = 0; k < 3; ++k)
+			cluster_keys[c] += (cluster[k] / cluster_areas[c] - mesh_centroid[k]) * (cluster[3 + k] / normal_length);
+	}
+	std::vector<std::size_t> order(cluster_count);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b){return cluster_keys[a] > cluster_keys[b];});
+	
+	// Rewrite triangles in cluster order
+	std::vector<std::uint32_t> output;
+	output.reserve(triangle_count * 3);
+	for (std::size_t c: order)
+		output.insert(output.end(), indices + cluster_offsets[c] * 3, indices + cluster_offsets[c + 1] * 3);
+	std::copy(output.begin(), output.end(), indices);
+}
+
+std::size_t optimize_vertex_fetch(std::uint32_t* remap, const std::uint32_t* indices, std::size_t index_count, std::size_t vertex_count)
+{
+	std::fill(remap, remap + vertex_count, ~std::uint32_t(0));
+	
+	std::uint32_t next_vertex = 0;
+	for (std::size_t i = 0; i < index_count; ++i)
+	{
+		if (remap[indices[i]] == ~std::uint32_t(0))
+			remap[indices[i]] = next_vertex++;
+	}
+	
+	return next_vertex;
+}
+
+std::uint64_t hash_vertex(const float* vertex, std::size_t size)
+{
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(vertex);
+	std::uint64_t hash = 0xcbf29ce484222325;
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001b3;
+	}
+	return hash;
+}
+
+float score_vertex(int cache_position, std::uint32_t live_triangle_count)
+{
+	// Vertices without remaining triangles never contribute
+	if (!live_triangle_count)
+		return -1.0f;
+	
+	float score = 0.0f;
+	if (cache_position >= 0)
+	{
+		// The last triangle's vertices score equally, so the next triangle isn't biased toward one of its edges
+		if (cache_position < 3)
+			score = 0.75f;
+		else
+			score = std::pow(1.0f - static_cast<float>(cache_position - 3) / static_cast<float>(vertex_cache_size - 3), 1.5f);
+	}
+	
+	// Boost vertices with few remaining triangles, to finish them off
+	score += 2.0f / std::sqrt(static_cast<float>(live_triangle_count));
+	
+	return score;
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTKEEPER_GEOMETRY_OPTIMIZATION_HPP
+#define ANTKEEPER_GEOMETRY_OPTIMIZATION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Finds the unique vertices in an array of interleaved vertex data.
+ *
+ * @param[out] remap Array of `vertex_count` elements, in which the index of the unique vertex equal to each vertex will be stored. Unique vertices are numbered in order of first occurrence.
+ * @param vertices Interleaved vertex data.
+ * @param vertex_size Number of floats per vertex.
+ * @param vertex_count Number of vertices.
+ * @return Number of unique vertices.
+ */
+std::size_t weld_vertices(std::uint32_t* remap, const float* vertices, std::size_t vertex_size, std::size_t vertex_count);
+
+/**
+ * Moves vertices to the locations given by a remap table.
+ *
+ * @param[out] destination Interleaved vertex data to which remapped vertices will be written.
+ * @param vertices Interleaved vertex data to remap.
+ * @param vertex_size Number of floats per vertex.
+ * @param vertex_count Number of vertices to remap.
+ * @param remap Remap table. Vertices mapped to `~0` are discarded.
+ */
+void remap_vertices(float* destination, const float* vertices, std::size_t vertex_size, std::size_t vertex_count, const std::uint32_t* remap);
+
+/**
+ * Replaces each index with its entry in a remap table.
+ *
+ * @param[in,out] indices Indices to remap.
+ * @param index_count Number of indices.
+ * @param remap Remap table.
+ */
+void remap_indices(std::uint32_t* indices, std::size_t index_count, const std::uint32_t* remap);
+
+/**
+ * Assigns barycentric coordinates to the vertices of an indexed triangle list, such that the three corners of each triangle have the coordinates `(1, 0, 0)`, `(0, 1, 0)`, and `(0, 0, 1)` in some order. Vertices are duplicated where their neighborhood can't be colored otherwise.
+ *
+ * @param[in,out] vertices Interleaved vertex data, to which duplicated vertices will be appended.
+ * @param vertex_size Number of floats per vertex.
+ * @param offset Offset of the barycentric coordinates within a vertex, in floats.
+ * @param[in,out] indices Triangle indices, which will be updated to refer to duplicated vertices.
+ * @param index_count Number of indices.
+ * @return Number of vertices after duplication.
+ */
+std::size_t assign_barycentric_coordinates(std::vector<float>& vertices, std::size_t vertex_size, std::size_t offset, std::uint32_t* indices, std::size_t index_count);
+
+/**
+ * Reorders the triangles of an indexed triangle list to improve post-transform vertex cache locality.
+ *
+ * @param[in,out] indices Triangle indices.
+ * @param index_count Number of indices.
+ * @param vertex_count Number of vertices referenced by the indices.
+ *
+ * @see Forsyth, T. (2006). Linear-speed vertex cache optimisation.
+ */
+void optimize_vertex_cache(std::uint32_t* indices, std::size_t index_count, std::size_t vertex_count);
+
+/**
+ * Reorders clusters of cache-optimized triangles so that outward-facing clusters are drawn first, reducing overdraw. Clusters are split where the vertex cache is cold, so cache locality is mostly preserved.
+ *
+ * @param[in,out] indices Triangle indices, which should already be optimized for the vertex cache.
+ * @param index_count Number of indices.
+ * @param positions Pointer to the position of the first vertex.
+ * @param vertex_size Number of floats between consecutive vertex positions.
+ * @param vertex_count Number of vertices.
+ *
+ * @see Sander, P. V., Nehab, D., & Barczak, J. (2007). Fast triangle reordering for vertex locality and reduced overdraw.
+ */
+void optimize_overdraw(std::uint32_t* indices, std::size_t index_count, const float* positions, std::size_t vertex_size, std::size_t vertex_count);
+
+/**
+ * Generates a remap table which orders vertices by their first use in an indexed triangle list, improving vertex fetch locality.
+ *
+ * @param[out] remap Array of `vertex_count` elements, in which the new index of each vertex will be stored. Unused vertices are mapped to `~0`.
+ * @param indices Triangle indices.
+ * @param index_count Number of indices.
+ * @param vertex_count Number of vertices.
+ * @return Number of used vertices.
+ */
+std::size_t optimize_vertex_fetch(std::uint32_t* remap, const std::uint32_t* indices, std::size_t index_count, std::size_t vertex_count);
+
+#endif // ANTKEEPER_GEOMETRY_OPTIMIZATION_HPP
@@ -18,9 +18,17 @@
  */
 
 #include "renderer/model.hpp"
+#include "math/constants.hpp"
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 model::model():
-	bounds({0, 0, 0}, {0, 0, 0})
+	bounds({0, 0, 0}, {0, 0, 0}),
+	error(0.0f),
+	dequantization_transform(math::identity4x4<float>),
+	indexed(false),
+	index_type(gl::element_array_type::uint_32)
 {}
 
 model::~model()
@@ -115,4 +123,30 @@ model_group* model::get_group(const std::string& name)
 	return nullptr;
 }
 
+void model::set_occluder(std::vector<float3> positions, std::vector<std::uint32_t> indices)
+{
+	occluder_positions = std::move(positions);
+	occluder_indices = std::move(indices);
+}
 
+void model::set_indices(const std::uint32_t* indices, std::size_t index_count, std::size_t vertex_count)
+{
+	if (vertex_count <= 0x10000)
+	{
+		std::vector<std::uint16_t> short_indices(indices, indices + index_count);
+		ibo.resize(index_count * sizeof(std::uint16_t), short_indices.data());
+		set_index_buffer(ibo, gl::element_array_type::uint_16);
+	}
+	else
+	{
+		ibo.resize(index_count * sizeof(std::uint32_t), indices);
+		set_index_buffer(ibo, gl::element_array_type::uint_32);
+	}
+}
+
+void model::set_index_buffer(const gl::vertex_buffer& buffer, gl::element_array_type type)
+{
+	vao.bind_elements(buffer);
+	indexed = true;
+	index_type = type;
+}
@@ -23,7 +23,10 @@
 #include "gl/vertex-array.hpp"
 #include "gl/vertex-buffer.hpp"
 #include "gl/drawing-mode.hpp"
+#include "gl/element-array-type.hpp"
 #include "geom/aabb.hpp"
+#include "utility/fundamental-types.hpp"
+#include <cstdint>
 #include <map>
 #include <string>
 #include <vector>
@@ -128,6 +131,22 @@ public:
 	~model();
 	
 	void set_bounds(const aabb_type& bounds);
+	
+	/**
+	 * Sets the geometric error of the model, if it was simplified from a more detailed surface.
+	 *
+	 * @param error Maximum distance between the model and the surface from which it was simplified, in model space units.
+	 */
+	void set_error(float error);
+	
+	/**
+	 * Sets the transform which maps the model's quantized vertex positions into model space. The renderer applies it ahead of each instance transform.
+	 *
+	 * @param transform Position dequantization transform.
+	 *
+	 * @see position_dequantization_transform(const geom::aabb<float>&)
+	 */
+	void set_dequantization_transform(const float4x4& transform);
 
 	model_group* add_group(const std::string& name = std::string());
 
@@ -135,6 +154,12 @@ public:
 	bool remove_group(model_group* group);
 	
 	const aabb_type& get_bounds() const;
+	
+	/// Returns the geometric error of the model.
+	float get_error() const;
+	
+	/// Returns the transform which maps the model's quantized vertex positions into model space.
+	const float4x4& get_dequantization_transform() const;
 
 	const model_group* get_group(const std::string& name) const;
 	model_group* get_group(const std::string& name);
@@ -146,14 +171,66 @@ public:
 
 	const gl::vertex_buffer* get_vertex_buffer() const;
 	gl::vertex_buffer* get_vertex_buffer();
+	
+	/**
+	 * Uploads vertex indices to the model's index buffer and binds it to the model's vertex array. Afterwards, the start index and index count of each group refer to indices rather than vertices.
+	 *
+	 * Indices are stored as 16-bit integers if the vertex count allows, and as 32-bit integers otherwise.
+	 *
+	 * @param indices Array of vertex indices.
+	 * @param index_count Number of indices in the array.
+	 * @param vertex_count Number of vertices in the model's vertex buffer.
+	 */
+	void set_indices(const std::uint32_t* indices, std::size_t index_count, std::size_t vertex_count);
+	
+	/**
+	 * Binds an index buffer to the model's vertex array. The index buffer may be shared by other models with the same topology, and must outlive the model.
+	 *
+	 * @param buffer Index buffer.
+	 * @param type Type of the indices in the buffer.
+	 */
+	void set_index_buffer(const gl::vertex_buffer& buffer, gl::element_array_type type);
+	
+	/// Returns `true` if the model's vertices are indexed, `false` otherwise.
+	bool is_indexed() const;
+	
+	/// Returns the type of the indices in the model's index buffer.
+	gl::element_array_type get_index_type() const;
+	
+	const gl::vertex_buffer* get_index_buffer() const;
+	gl::vertex_buffer* get_index_buffer();
+	
+	/**
+	 * Sets the triangles which will be rasterized when the model is used as an occluder. Models without occluder triangles never occlude other objects.
+	 *
+	 * @param positions Model-space vertex positions.
+	 * @param indices Indices of triangle vertices.
+	 */
+	void set_occluder(std::vector<float3> positions, std::vector<std::uint32_t> indices);
+	
+	/// Returns `true` if the model has occluder triangles, `false` otherwise.
+	bool is_occluder() const;
+	
+	/// Returns the model-space vertex positions of the occluder triangles.
+	const std::vector<float3>& get_occluder_positions() const;
+	
+	/// Returns the indices of the occluder triangle vertices.
+	const std::vector<std::uint32_t>& get_occluder_indices() const;
 
 private:
 	aabb_type bounds;
+	float error;
+	float4x4 dequantization_transform;
 	std::vector<model_group*> groups;
 	std::map<std::string, model_group*> group_map;
 	gl::vertex_array vao;
 	gl::vertex_buffer vbo;
+	gl::vertex_buffer ibo;
+	bool indexed;
+	gl::element_array_type index_type;
 	skeleton* skeleton;
+	std::vector<float3> occluder_positions;
+	std::vector<std::uint32_t> occluder_indices;
 };
 
 inline void model::set_bounds(const aabb_type& bounds)
@@ -161,11 +238,31 @@ inline void model::set_bounds(const aabb_type& bounds)
 	this->bounds = bounds;
 }
 
+inline void model::set_error(float error)
+{
+	this->error = error;
+}
+
+inline void model::set_dequantization_transform(const float4x4& transform)
+{
+	dequantization_transform = transform;
+}
+
 inline const typename model::aabb_type& model::get_bounds() const
 {
 	return bounds;
 }
 
+inline float model::get_error() const
+{
+	return error;
+}
+
+inline const float4x4& model::get_dequantization_transform() const
+{
+	return dequantization_transform;
+}
+
 inline const std::vector<model_group*>* model::get_groups() const
 {
 	return &groups;
@@ -191,5 +288,40 @@ inline gl::vertex_buffer* model::get_vertex_buffer()
 	return &vbo;
 }
 
+inline bool model::is_indexed() const
+{
+	return indexed;
+}
+
+inline gl::element_array_type model::get_index_type() const
+{
+	return index_type;
+}
+
+inline const gl::vertex_buffer* model::get_index_buffer() const
+{
+	return &ibo;
+}
+
+inline gl::vertex_buffer* model::get_index_buffer()
+{
+	return &ibo;
+}
+
+inline bool model::is_occluder() const
+{
+	return !occluder_indices.empty();
+}
+
+inline const std::vector<float3>& model::get_occluder_positions() const
+{
+	return occluder_positions;
+}
+
+inline const std::vector<std::uint32_t>& model::get_occluder_indices() const
+{
+	return occluder_indices;
+}
+
 #endif // ANTKEEPER_MODEL_HPP
 
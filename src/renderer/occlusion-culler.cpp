@@ -0,0 +1,305 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "renderer/occlusion-culler.hpp"
+#include "geom/sphere.hpp"
+#include "math/math.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/// Minimum clip-space `w` of rasterized geometry. Triangles are clipped against this plane, and bounds which cross it are considered visible.
+static constexpr float near_w = 1e-2f;
+
+occlusion_culler::occlusion_culler(int width, int height):
+	view_projection(math::identity4x4<float>)
+{
+	resize(width, height);
+}
+
+void occlusion_culler::resize(int width, int height)
+{
+	levels.clear();
+	
+	width = std::max<int>(1, width);
+	height = std::max<int>(1, height);
+	for (;;)
+	{
+		levels.push_back({width, height, std::vector<float>(width * height, 0.0f)});
+		if (width == 1 && height == 1)
+			break;
+		
+		width = (width + 1) >> 1;
+		height = (height + 1) >> 1;
+	}
+}
+
+void occlusion_culler::clear(const float4x4& view_projection)
+{
+	this->view_projection = view_projection;
+	
+	for (level& level: levels)
+		std::fill(level.depths.begin(), level.depths.end(), 0.0f);
+}
+
+void occlusion_culler::rasterize(const float3* positions, const std::uint32_t* indices, std::size_t index_count, const float4x4& transform)
+{
+	const float4x4 model_view_projection = view_projection * transform;
+	
+	for (std::size_t i = 0; i + 2 < index_count; i += 3)
+	{
+		float4 clip[3];
+		for (int j = 0; j < 3; ++j)
+		{
+			const float3& position = positions[indices[i + j]];
+			clip[j] = model_view_projection * float4{position.x, position.y, position.z, 1.0f};
+		}
+		
+		// Reject triangles which are entirely outside one of the side planes of the view frustum
+		if ((clip[0].x > clip[0].w && clip[1].x > clip[1].w && clip[2].x > clip[2].w) ||
+			(clip[0].x < -clip[0].w && clip[1].x < -clip[1].w && clip[2].x < -clip[2].w) ||
+			(clip[0].y > clip[0].w && clip[1].y > clip[1].w && clip[2].y > clip[2].w) ||
+			(clip[0].y < -clip[0].w && clip[1].y < -clip[1].w && clip[2].y < -clip[2].w))
+		{
+			continue;
+		}
+		
+		rasterize_clipped(clip[0], clip[1], clip[2]);
+	}
+}
+
+void occlusion_culler::rasterize_clipped(const float4& a, const float4& b, const float4& c)
+{
+	const float4 input[3] = {a, b, c};
+	
+	// Clip triangle against the near plane
+	float4 output[4];
+	int count = 0;
+	for (int i = 0; i < 3; ++i)
+	{
+		const float4& p = input[i];
+		const float4& q = input[(i + 1) % 3];
+		const bool p_inside = (p.w >= near_w);
+		const bool q_inside = (q.w >= near_w);
+		
+		if (p_inside)
+			output[count++] = p;
+		if (p_inside != q_inside)
+			output[count++] = p + (q - p) * ((near_w - p.w) / (q.w - p.w));
+	}
+	
+	if (count >= 3)
+		rasterize_triangle(output[0], output[1], output[2]);
+	if (count == 4)
+		rasterize_triangle(output[0], output[2], output[3]);
+}
+
+void occlusion_culler::rasterize_triangle(const float4& a, const float4& b, const float4& c)
+{
+	level& target = levels[0];
+	const float width = static_cast<float>(target.width);
+	const float height = static_cast<float>(target.height);
+	
+	// Project vertices into screen space, keeping reciprocal w as depth
+	float za = 1.0f / a.w;
+	float zb = 1.0f / b.w;
+	float zc = 1.0f / c.w;
+	float ax = (a.x * za * 0.5f + 0.5f) * width;
+	float ay = (a.y * za * 0.5f + 0.5f) * height;
+	float bx = (b.x * zb * 0.5f + 0.5f) * width;
+	float by = (b.y * zb * 0.5f + 0.5f) * height;
+	float cx = (c.x * zc * 0.5f + 0.5f) * width;
+	float cy = (c.y * zc * 0.5f + 0.5f) * height;
+	
+	// Calculate screen-space bounds
+	const float min_x = std::min<float>(ax, std::min<float>(bx, cx));
+	const float max_x = std::max<float>(ax, std::max<float>(bx, cx));
+	const float min_y = std::min<float>(ay, std::min<float>(by, cy));
+	const float max_y = std::max<float>(ay, std::max<float>(by, cy));
+	if (max_x < 0.0f || max_y < 0.0f || min_x > width || min_y > height)
+		return;
+	const int x0 = std::max<int>(0, static_cast<int>(min_x));
+	const int x1 = std::min<int>(target.width - 1, static_cast<int>(max_x));
+	const int y0 = std::max<int>(0, static_cast<int>(min_y));
+	const int y1 = std::min<int>(target.height - 1, static_cast<int>(max_y));
+	
+	// Make winding counterclockwise, so occluders are rasterized regardless of facing
+	float area = (bx - ax) * (cy - ay) - (by - ay) * (cx - ax);
+	if (std::abs(area) < 1e-12f)
+		return;
+	if (area < 0.0f)
+	{
+		std::swap(bx, cx);
+		std::swap(by, cy);
+		std::swap(zb, zc);
+		area = -area;
+	}
+	
+	// Edge function coefficients, such that e = e_x * x + e_y * y + e_c is non-negative inside the triangle
+	const float e0_x = by - cy, e0_y = cx - bx;
+	const float e1_x = cy - ay, e1_y = ax - cx;
+	const float e2_x = ay - by, e2_y = bx - ax;
+	
+	// Shrink edges by half a texel along each axis, so a texel is only covered if all four of its corners are inside the triangle
+	const float e0_c = bx * cy - by * cx - 0.5f * (std::abs(e0_x) + std::abs(e0_y));
+	const float e1_c = cx * ay - cy * ax - 0.5f * (std::abs(e1_x) + std::abs(e1_y));
+	const float e2_c = ax * by - ay * bx - 0.5f * (std::abs(e2_x) + std::abs(e2_y));
+	
+	// Depth plane, biased away from the camera by half a texel along each axis so depths are never nearer than the occluder anywhere in a covered texel
+	const float inverse_area = 1.0f / area;
+	const float dz_dx = ((zb - za) * (cy - ay) - (zc - za) * (by - ay)) * inverse_area;
+	const float dz_dy = ((zc - za) * (bx - ax) - (zb - za) * (cx - ax)) * inverse_area;
+	const float z_c = za - dz_dx * ax - dz_dy * ay - 0.5f * (std::abs(dz_dx) + std::abs(dz_dy));
+	const float z_min = std::min<float>(za, std::min<float>(zb, zc));
+	
+	for (int y = y0; y <= y1; ++y)
+	{
+		const float py = static_cast<float>(y) + 0.5f;
+		const float row_e0 = e0_y * py + e0_c;
+		const float row_e1 = e1_y * py + e1_c;
+		const float row_e2 = e2_y * py + e2_c;
+		const float row_z = dz_dy * py + z_c;
+		float* row = &target.depths[y * target.width];
+		
+		// Branch-free span loop, written for auto-vectorization
+		for (int x = x0; x <= x1; ++x)
+		{
+			const float px = static_cast<float>(x) + 0.5f;
+			const bool inside = (e0_x * px + row_e0 >= 0.0f) & (e1_x * px + row_e1 >= 0.0f) & (e2_x * px + row_e2 >= 0.0f);
+			const float z = std::max<float>(dz_dx * px + row_z, z_min);
+			const float depth = row[x];
+			row[x] = (inside & (z > depth)) ? z : depth;
+		}
+	}
+}
+
+void occlusion_culler::update_hierarchy()
+{
+	// Each texel stores the farthest depth of the four texels beneath it
+	for (std::size_t i = 1; i < levels.size(); ++i)
+	{
+		const level& source = levels[i - 1];
+		level& destination = levels[i];
+		
+		for (int y = 0; y < destination.height; ++y)
+		{
+			const float* row0 = &source.depths[std::min<int>(y * 2, source.height - 1) * source.width];
+			const float* row1 = &source.depths[std::min<int>(y * 2 + 1, source.height - 1) * source.width];
+			float* output = &destination.depths[y * destination.width];
+			
+			for (int x = 0; x < destination.width; ++x)
+			{
+				const int x0 = std::min<int>(x * 2, source.width - 1);
+				const int x1 = std::min<int>(x * 2 + 1, source.width - 1);
+				output[x] = std::min<float>(std::min<float>(row0[x0], row0[x1]), std::min<float>(row1[x0], row1[x1]));
+			}
+		}
+	}
+}
+
+bool occlusion_culler::is_visible(const geom::aabb<float>& bounds) const
+{
+	const level& base = levels[0];
+	const float width = static_cast<float>(base.width);
+	const float height = static_cast<float>(base.height);
+	
+	// Project corners of the bounds into screen space and find the nearest depth
+	float min_x = std::numeric_limits<float>::infinity();
+	float min_y = std::numeric_limits<float>::infinity();
+	float max_x = -std::numeric_limits<float>::infinity();
+	float max_y = -std::numeric_limits<float>::infinity();
+	float max_z = 0.0f;
+	for (int i = 0; i < 8; ++i)
+	{
+		const float4 corner =
+		{
+			(i & 1) ? bounds.max_point.x : bounds.min_point.x,
+			(i & 2) ? bounds.max_point.y : bounds.min_point.y,
+			(i & 4) ? bounds.max_point.z : bounds.min_point.z,
+			1.0f
+		};
+		const float4 clip = view_projection * corner;
+		
+		// Bounds which cross the near plane are considered visible
+		if (clip.w < near_w)
+			return true;
+		
+		const float z = 1.0f / clip.w;
+		const float x = (clip.x * z * 0.5f + 0.5f) * width;
+		const float y = (clip.y * z * 0.5f + 0.5f) * height;
+		min_x = std::min<float>(min_x, x);
+		min_y = std::min<float>(min_y, y);
+		max_x = std::max<float>(max_x, x);
+		max_y = std::max<float>(max_y, y);
+		max_z = std::max<float>(max_z, z);
+	}
+	
+	// Leave bounds outside of the screen to frustum culling
+	if (max_x < 0.0f || max_y < 0.0f || min_x > width || min_y > height)
+		return true;
+	
+	int x0 = std::max<int>(0, static_cast<int>(min_x));
+	int y0 = std::max<int>(0, static_cast<int>(min_y));
+	int x1 = std::min<int>(base.width - 1, static_cast<int>(max_x));
+	int y1 = std::min<int>(base.height - 1, static_cast<int>(max_y));
+	
+	// Select the finest level at which the bounds cover at most 4x4 texels
+	std::size_t level_index = 0;
+	while (level_index + 1 < levels.size() && std::max<int>(x1 - x0, y1 - y0) > 3)
+	{
+		x0 >>= 1;
+		y0 >>= 1;
+		x1 >>= 1;
+		y1 >>= 1;
+		++level_index;
+	}
+	
+	// Bounds are occluded if their nearest depth is farther than all covered occluder depths
+	const level& level = levels[level_index];
+	for (int y = y0; y <= y1; ++y)
+	{
+		const float* row = &level.depths[y * level.width];
+		for (int x = x0; x <= x1; ++x)
+		{
+			if (max_z >= row[x])
+				return true;
+		}
+	}
+	
+	return false;
+}
+
+bool occlusion_culler::is_visible(const geom::bounding_volume<float>& volume) const
+{
+	switch (volume.get_bounding_volume_type())
+	{
+		case geom::bounding_volume_type::aabb:
+			return is_visible(static_cast<const geom::aabb<float>&>(volume));
+		
+		case geom::bounding_volume_type::sphere:
+		{
+			const geom::sphere<float>& sphere = static_cast<const geom::sphere<float>&>(volume);
+			const float3 extents = {sphere.radius, sphere.radius, sphere.radius};
+			return is_visible(geom::aabb<float>{sphere.center - extents, sphere.center + extents});
+		}
+		
+		default:
+			return true;
+	}
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTKEEPER_OCCLUSION_CULLER_HPP
+#define ANTKEEPER_OCCLUSION_CULLER_HPP
+
+#include "geom/aabb.hpp"
+#include "geom/bounding-volume.hpp"
+#include "utility/fundamental-types.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Software occlusion culler which rasterizes occluders into a low-resolution hierarchical depth buffer, then tests object bounds against it.
+ *
+ * Depths are stored as reciprocal clip-space `w`, so the culler is independent of the depth range and direction of the camera's projection. Occluders are rasterized conservatively: a texel is only written if it is entirely covered by a triangle, with the farthest depth of the triangle over the texel. Bounds which cross the near plane are always considered visible.
+ */
+class occlusion_culler
+{
+public:
+	/**
+	 * Creates an occlusion culler.
+	 *
+	 * @param width Width of the depth buffer, in pixels.
+	 * @param height Height of the depth buffer, in pixels.
+	 */
+	occlusion_culler(int width, int height);
+	
+	/**
+	 * Resizes the depth buffer.
+	 *
+	 * @param width Width of the depth buffer, in pixels.
+	 * @param height Height of the depth buffer, in pixels.
+	 */
+	void resize(int width, int height);
+	
+	/**
+	 * Clears the depth buffer and sets the view-projection matrix with which occluders and bounds will be projected.
+	 *
+	 * @param view_projection View-projection matrix of the camera.
+	 */
+	void clear(const float4x4& view_projection);
+	
+	/**
+	 * Rasterizes indexed triangles into the depth buffer.
+	 *
+	 * @param positions Vertex positions.
+	 * @param indices Indices of triangle vertices.
+	 * @param index_count Number of indices.
+	 * @param transform Model transformation matrix.
+	 */
+	void rasterize(const float3* positions, const std::uint32_t* indices, std::size_t index_count, const float4x4& transform);
+	
+	/// Rebuilds the depth hierarchy after occluders have been rasterized.
+	void update_hierarchy();
+	
+	/**
+	 * Tests whether an axis-aligned bounding box may be visible.
+	 *
+	 * @param bounds World-space axis-aligned bounding box.
+	 * @return `false` if the bounding box is fully occluded, `true` otherwise.
+	 */
+	bool is_visible(const geom::aabb<float>& bounds) const;
+	
+	/**
+	 * Tests whether a bounding volume may be visible.
+	 *
+	 * @param volume World-space bounding volume.
+	 * @return `false` if the bounding volume is fully occluded, `true` otherwise.
+	 */
+	bool is_visible(const geom::bounding_volume<float>& volume) const;
+	
+	/// Returns the width of the depth buffer, in pixels.
+	int get_width() const;
+	
+	/// Returns the height of the depth buffer, in pixels.
+	int get_height() const;
+	
+	/// Returns the number of levels in the depth hierarchy.
+	std::size_t get_level_count() const;
+	
+	/**
+	 * Returns the depths of a level in the depth hierarchy, as reciprocal clip-space `w`.
+	 *
+	 * @param level Index of a level in the depth hierarchy.
+	 */
+	const std::vector<float>& get_depths(std::size_t level) const;
+	
+private:
+	struct level
+	{
+		int width;
+		int height;
+		std::vector<float> depths;
+	};
+	
+	void rasterize_clipped(const float4& a, const float4& b, const float4& c);
+	void rasterize_triangle(const float4& a, const float4& b, const float4& c);
+	
+	std::vector<level> levels;
+	float4x4 view_projection;
+};
+
+inline int occlusion_culler::get_width() const
+{
+	return levels[0].width;
+}
+
+inline int occlusion_culler::get_height() const
+{
+	return levels[0].height;
+}
+
+inline std::size_t occlusion_culler::get_level_count() const
+{
+	return levels.size();
+}
+
+inline const std::vector<float>& occlusion_culler::get_depths(std::size_t level) const
+{
+	return levels[level].depths;
+}
+
+#endif // ANTKEEPER_OCCLUSION_CULLER_HPP
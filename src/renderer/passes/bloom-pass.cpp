@@ -32,15 +32,110 @@
 #include "gl/texture-filter.hpp"
 #include "renderer/vertex-attributes.hpp"
 #include "renderer/render-context.hpp"
+#include "renderer/shader-template.hpp"
 #include "math/math.hpp"
+#include <algorithm>
 #include <cmath>
 #include <glad/glad.h>
 
+/// Shader template which downsamples an image with a 13-tap filter, optionally applying a brightness threshold.
+static const char* downsample_shader_source = R"(#version 330 core
+#pragma define THRESHOLD
+#pragma vertex
+#pragma fragment
+
+#if defined(__VERTEX__)
+
+layout(location = 0) in vec3 vertex_position;
+out vec2 uv;
+
+void main()
+{
+	uv = vertex_position.xy * 0.5 + 0.5;
+	gl_Position = vec4(vertex_position, 1.0);
+}
+
+#elif defined(__FRAGMENT__)
+
+uniform sampler2D image;
+uniform vec2 texel_size;
+uniform float threshold;
+in vec2 uv;
+layout(location = 0) out vec4 fragment_color;
+
+vec3 tap(float x, float y)
+{
+	return texture(image, uv + vec2(x, y) * texel_size).rgb;
+}
+
+void main()
+{
+	// Four overlapping 4x4 boxes and one central 4x4 box, sampled with 13 bilinear taps
+	vec3 color = tap(0.0, 0.0) * 0.125;
+	color += (tap(-1.0, 1.0) + tap(1.0, 1.0) + tap(-1.0, -1.0) + tap(1.0, -1.0)) * 0.125;
+	color += (tap(0.0, 2.0) + tap(-2.0, 0.0) + tap(2.0, 0.0) + tap(0.0, -2.0)) * 0.0625;
+	color += (tap(-2.0, 2.0) + tap(2.0, 2.0) + tap(-2.0, -2.0) + tap(2.0, -2.0)) * 0.03125;
+	
+	#if defined(THRESHOLD)
+		// Keep the part of the brightness above the threshold, preserving hue
+		float brightness = max(color.r, max(color.g, color.b));
+		color *= max(brightness - threshold, 0.0) / max(brightness, 0.0001);
+	#endif
+	
+	fragment_color = vec4(color, 1.0);
+}
+
+#endif
+)";
+
+/// Shader template which upsamples an image with a 3x3 tent filter.
+static const char* upsample_shader_source = R"(#version 330 core
+#pragma vertex
+#pragma fragment
+
+#if defined(__VERTEX__)
+
+layout(location = 0) in vec3 vertex_position;
+out vec2 uv;
+
+void main()
+{
+	uv = vertex_position.xy * 0.5 + 0.5;
+	gl_Position = vec4(vertex_position, 1.0);
+}
+
+#elif defined(__FRAGMENT__)
+
+uniform sampler2D image;
+uniform vec2 texel_size;
+uniform float filter_radius;
+in vec2 uv;
+layout(location = 0) out vec4 fragment_color;
+
+vec3 tap(float x, float y)
+{
+	return texture(image, uv + vec2(x, y) * texel_size * filter_radius).rgb;
+}
+
+void main()
+{
+	vec3 color = tap(0.0, 0.0) * 4.0;
+	color += (tap(0.0, 1.0) + tap(-1.0, 0.0) + tap(1.0, 0.0) + tap(0.0, -1.0)) * 2.0;
+	color += tap(-1.0, 1.0) + tap(1.0, 1.0) + tap(-1.0, -1.0) + tap(1.0, -1.0);
+	
+	fragment_color = vec4(color * (1.0 / 16.0), 1.0);
+}
+
+#endif
+)";
+
 bloom_pass::bloom_pass(gl::rasterizer* rasterizer, const gl::framebuffer* framebuffer, resource_manager* resource_manager):
 	render_pass(rasterizer, framebuffer),
 	source_texture(nullptr),
 	brightness_threshold(1.0f),
-	blur_iterations(1)
+	blur_iterations(1),
+	mip_count(1),
+	filter_radius(1.0f)
 {
 	// Create clone of framebuffer texture
 	const gl::texture_2d* framebuffer_texture = framebuffer->get_color_attachment();
@@ -76,6 +171,21 @@ bloom_pass::bloom_pass(gl::rasterizer* rasterizer, const gl::framebuffer* frameb
 	blur_shader_image_input = blur_shader->get_input("image");
 	blur_shader_resolution_input = blur_shader->get_input("resolution");
 	blur_shader_direction_input = blur_shader->get_input("direction");
+	
+	// Build mip chain shaders
+	shader_template downsample_template(downsample_shader_source);
+	downsample_threshold_shader = downsample_template.build({{"THRESHOLD", std::string()}});
+	downsample_threshold_shader_image_input = downsample_threshold_shader->get_input("image");
+	downsample_threshold_shader_texel_size_input = downsample_threshold_shader->get_input("texel_size");
+	downsample_threshold_shader_threshold_input = downsample_threshold_shader->get_input("threshold");
+	downsample_shader = downsample_template.build({});
+	downsample_shader_image_input = downsample_shader->get_input("image");
+	downsample_shader_texel_size_input = downsample_shader->get_input("texel_size");
+	shader_template upsample_template(upsample_shader_source);
+	upsample_shader = upsample_template.build({});
+	upsample_shader_image_input = upsample_shader->get_input("image");
+	upsample_shader_texel_size_input = upsample_shader->get_input("texel_size");
+	upsample_shader_filter_radius_input = upsample_shader->get_input("filter_radius");
 
 	const float vertex_data[] =
 	{
@@ -98,6 +208,10 @@ bloom_pass::bloom_pass(gl::rasterizer* rasterizer, const gl::framebuffer* frameb
 
 bloom_pass::~bloom_pass()
 {
+	set_mip_count(1);
+	delete upsample_shader;
+	delete downsample_shader;
+	delete downsample_threshold_shader;
 	delete cloned_framebuffer;
 	delete cloned_framebuffer_texture;
 	delete quad_vao;
@@ -111,7 +225,76 @@ void bloom_pass::render(render_context* context) const
 	glDepthMask(GL_FALSE);
 	glEnable(GL_CULL_FACE);
 	glCullFace(GL_BACK);
+	
+	if (mip_count > 1)
+		render_mip_chain();
+	else
+		render_blur();
+}
+
+void bloom_pass::set_source_texture(const gl::texture_2d* texture)
+{
+	this->source_texture = texture;
+}
+
+void bloom_pass::set_brightness_threshold(float threshold)
+{
+	this->brightness_threshold = threshold;
+}
+
+void bloom_pass::set_blur_iterations(int iterations)
+{
+	this->blur_iterations = iterations;
+}
 
+void bloom_pass::set_mip_count(int count)
+{
+	// Limit mip count so the smallest mip level is at least one pixel in each dimension
+	const auto& dimensions = framebuffer->get_dimensions();
+	int max_count = 1;
+	while ((std::min(dimensions[0], dimensions[1]) >> max_count) > 0)
+		++max_count;
+	count = std::max(1, std::min(count, max_count));
+	
+	// Delete render targets of excess mip levels
+	while (static_cast<int>(mip_textures.size()) + 1 > count)
+	{
+		delete mip_framebuffers.back();
+		delete mip_textures.back();
+		mip_framebuffers.pop_back();
+		mip_textures.pop_back();
+	}
+	
+	// Create render targets of additional mip levels, in the format of the framebuffer
+	const gl::texture_2d* framebuffer_texture = framebuffer->get_color_attachment();
+	while (static_cast<int>(mip_textures.size()) + 1 < count)
+	{
+		const int level = static_cast<int>(mip_textures.size()) + 1;
+		const int width = std::max(1, dimensions[0] >> level);
+		const int height = std::max(1, dimensions[1] >> level);
+		
+		gl::texture_2d* texture = new gl::texture_2d(width, height, framebuffer_texture->get_pixel_type(), framebuffer_texture->get_pixel_format());
+		texture->set_wrapping(gl::texture_wrapping::extend, gl::texture_wrapping::extend);
+		texture->set_filters(gl::texture_min_filter::linear, gl::texture_mag_filter::linear);
+		texture->set_max_anisotropy(0.0f);
+		
+		gl::framebuffer* mip_framebuffer = new gl::framebuffer(width, height);
+		mip_framebuffer->attach(gl::framebuffer_attachment_type::color, texture);
+		
+		mip_textures.push_back(texture);
+		mip_framebuffers.push_back(mip_framebuffer);
+	}
+	
+	mip_count = count;
+}
+
+void bloom_pass::set_filter_radius(float radius)
+{
+	filter_radius = radius;
+}
+
+void bloom_pass::render_blur() const
+{
 	// Determine viewport based on framebuffer resolution
 	auto viewport = framebuffer->get_dimensions();
 	rasterizer->set_viewport(0, 0, std::get<0>(viewport), std::get<1>(viewport));
@@ -146,18 +329,56 @@ void bloom_pass::render(render_context* context) const
 	}
 }
 
-void bloom_pass::set_source_texture(const gl::texture_2d* texture)
+void bloom_pass::render_mip_chain() const
 {
-	this->source_texture = texture;
-}
-
-void bloom_pass::set_brightness_threshold(float threshold)
-{
-	this->brightness_threshold = threshold;
-}
-
-void bloom_pass::set_blur_iterations(int iterations)
-{
-	this->blur_iterations = iterations;
+	const gl::texture_2d* mip_0_texture = framebuffer->get_color_attachment();
+	auto mip_texture = [&](int level) -> const gl::texture_2d* {return (level) ? mip_textures[level - 1] : mip_0_texture;};
+	auto mip_framebuffer = [&](int level) -> const gl::framebuffer* {return (level) ? mip_framebuffers[level - 1] : framebuffer;};
+	auto texel_size = [](const gl::texture_2d* texture) -> float2
+	{
+		const auto& dimensions = texture->get_dimensions();
+		return {1.0f / static_cast<float>(std::get<0>(dimensions)), 1.0f / static_cast<float>(std::get<1>(dimensions))};
+	};
+	auto use_framebuffer = [&](const gl::framebuffer* target)
+	{
+		const auto& dimensions = target->get_dimensions();
+		rasterizer->use_framebuffer(*target);
+		rasterizer->set_viewport(0, 0, dimensions[0], dimensions[1]);
+	};
+	
+	// Downsample and threshold the source image into mip level 0
+	use_framebuffer(framebuffer);
+	rasterizer->use_program(*downsample_threshold_shader);
+	downsample_threshold_shader_image_input->upload(source_texture);
+	downsample_threshold_shader_texel_size_input->upload(texel_size(source_texture));
+	downsample_threshold_shader_threshold_input->upload(brightness_threshold);
+	rasterizer->draw_arrays(*quad_vao, gl::drawing_mode::triangles, 0, 6);
+	
+	// Downsample each mip level into the next
+	rasterizer->use_program(*downsample_shader);
+	for (int i = 1; i < mip_count; ++i)
+	{
+		use_framebuffer(mip_framebuffer(i));
+		downsample_shader_image_input->upload(mip_texture(i - 1));
+		downsample_shader_texel_size_input->upload(texel_size(mip_texture(i - 1)));
+		rasterizer->draw_arrays(*quad_vao, gl::drawing_mode::triangles, 0, 6);
+	}
+	
+	// Upsample each mip level and blend it with the previous, ending in mip level 0. Each level is weighted so that every level contributes equally to the result, keeping bloom brightness independent of the mip count.
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_CONSTANT_ALPHA, GL_ONE_MINUS_CONSTANT_ALPHA);
+	rasterizer->use_program(*upsample_shader);
+	upsample_shader_filter_radius_input->upload(filter_radius);
+	for (int i = mip_count - 1; i > 0; --i)
+	{
+		// Mip level i holds the average of the (mip_count - i) smallest levels
+		const float weight = static_cast<float>(mip_count - i) / static_cast<float>(mip_count - i + 1);
+		glBlendColor(0.0f, 0.0f, 0.0f, weight);
+		
+		use_framebuffer(mip_framebuffer(i - 1));
+		upsample_shader_image_input->upload(mip_texture(i));
+		upsample_shader_texel_size_input->upload(texel_size(mip_texture(i)));
+		rasterizer->draw_arrays(*quad_vao, gl::drawing_mode::triangles, 0, 6);
+	}
+	glDisable(GL_BLEND);
 }
-
@@ -27,11 +27,16 @@
 #include "gl/vertex-buffer.hpp"
 #include "gl/vertex-array.hpp"
 #include "gl/texture-2d.hpp"
+#include <vector>
 
 class resource_manager;
 
 /**
+ * Extracts bright regions of an HDR image and blurs them into the pass framebuffer.
  *
+ * By default, the thresholded image is blurred by iterative separable blurs at the resolution of the framebuffer. In mip chain mode, it is instead downsampled with a 13-tap filter into a chain of successively half-resolution render targets, starting with the framebuffer, then upsampled back up the chain with a 3x3 tent filter, each level being added to the next larger one. This produces wide and stable bloom at a fraction of the fill cost.
+ *
+ * @see Jimenez, J. (2014). Next generation post processing in Call of Duty: Advanced Warfare. SIGGRAPH 2014 Advances in Real-Time Rendering course.
  */
 class bloom_pass: public render_pass
 {
@@ -43,8 +48,25 @@ public:
 	void set_source_texture(const gl::texture_2d* texture);
 	void set_brightness_threshold(float threshold);
 	void set_blur_iterations(int iterations);
+	
+	/**
+	 * Sets the number of render targets in the mip chain, including the pass framebuffer. The count is limited so that the smallest target is at least one pixel wide and high.
+	 *
+	 * @param count Number of mip levels. If less than two, bloom is computed by iterative blurs instead of a mip chain. Upsampled levels are averaged rather than summed, so the mip count changes the spread of bloom but not its overall brightness.
+	 */
+	void set_mip_count(int count);
+	
+	/**
+	 * Sets the radius of the upsampling tent filter.
+	 *
+	 * @param radius Filter radius, in texels of the mip level being upsampled.
+	 */
+	void set_filter_radius(float radius);
 
 private:
+	void render_blur() const;
+	void render_mip_chain() const;
+	
 	gl::vertex_buffer* quad_vbo;
 	gl::vertex_array* quad_vao;
 	
@@ -63,9 +85,29 @@ private:
 	const gl::shader_input* blur_shader_resolution_input;
 	const gl::shader_input* blur_shader_direction_input;
 	
+	gl::shader_program* downsample_threshold_shader;
+	const gl::shader_input* downsample_threshold_shader_image_input;
+	const gl::shader_input* downsample_threshold_shader_texel_size_input;
+	const gl::shader_input* downsample_threshold_shader_threshold_input;
+	
+	gl::shader_program* downsample_shader;
+	const gl::shader_input* downsample_shader_image_input;
+	const gl::shader_input* downsample_shader_texel_size_input;
+	
+	gl::shader_program* upsample_shader;
+	const gl::shader_input* upsample_shader_image_input;
+	const gl::shader_input* upsample_shader_texel_size_input;
+	const gl::shader_input* upsample_shader_filter_radius_input;
+	
+	/// Render targets of mip levels 1 and up. Mip level 0 is the pass framebuffer.
+	std::vector<gl::texture_2d*> mip_textures;
+	std::vector<gl::framebuffer*> mip_framebuffers;
+	
 	const gl::texture_2d* source_texture;
 	float brightness_threshold;
 	int blur_iterations;
+	int mip_count;
+	float filter_radius;
 };
 
 #endif // ANTKEEPER_BLOOM_PASS_HPP
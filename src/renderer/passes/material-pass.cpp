@@ -181,7 +181,7 @@ void material_pass::render(render_context* context) const
 					// Pre-expose light
 					point_light_colors[point_light_count] = light->get_scaled_color_tween().interpolate(context->alpha) * camera_exposure;
 					
-					float3 position = light->get_transform_tween().interpolate(context->alpha).translation;
+					float3 position = light->interpolate_published_transform(context->alpha).translation;
 					point_light_positions[point_light_count] = position;
 					
 					point_light_attenuations[point_light_count] = static_cast<const scene::point_light*>(light)->get_attenuation_tween().interpolate(context->alpha);
@@ -209,7 +209,7 @@ void material_pass::render(render_context* context) const
 						directional_light_textures[directional_light_count] = directional_light->get_light_texture();
 						directional_light_texture_opacities[directional_light_count] = directional_light->get_light_texture_opacity_tween().interpolate(context->alpha);
 						
-						math::transform<float> light_transform = light->get_transform_tween().interpolate(context->alpha);
+						math::transform<float> light_transform = light->interpolate_published_transform(context->alpha);
 						float3 forward = light_transform.rotation * global_forward;
 						float3 up = light_transform.rotation * global_up;
 						float4x4 light_view = math::look_at(light_transform.translation, light_transform.translation + forward, up);
@@ -240,7 +240,7 @@ void material_pass::render(render_context* context) const
 					// Pre-expose light
 					spot_light_colors[spot_light_count] = light->get_scaled_color_tween().interpolate(context->alpha) * camera_exposure;
 					
-					float3 position = light->get_transform_tween().interpolate(context->alpha).translation;
+					float3 position = light->interpolate_published_transform(context->alpha).translation;
 					spot_light_positions[spot_light_count] = position;
 					
 					float3 direction = spot_light->get_direction_tween().interpolate(context->alpha);
@@ -511,8 +511,8 @@ void material_pass::render(render_context* context) const
 		model = operation.transform;
 		model_view_projection = view_projection * model;
 		model_view = view * model;
-		normal_model = math::transpose(math::inverse(math::resize<3, 3>(model)));
-		normal_model_view = math::transpose(math::inverse(math::resize<3, 3>(model_view)));
+		normal_model = math::inverse_transpose(math::resize<3, 3>(model));
+		normal_model_view = math::inverse_transpose(math::resize<3, 3>(model_view));
 
 		// Upload operation-dependent parameters
 		if (parameters->model)
@@ -531,10 +531,7 @@ void material_pass::render(render_context* context) const
 			parameters->log_depth_coef->upload(log_depth_coef);
 
 		// Draw geometry
-		if (operation.instance_count)
-			rasterizer->draw_arrays_instanced(*operation.vertex_array, operation.drawing_mode, operation.start_index, operation.index_count, operation.instance_count);
-		else
-			rasterizer->draw_arrays(*operation.vertex_array, operation.drawing_mode, operation.start_index, operation.index_count);
+		draw(operation, operation.instance_count);
 	}
 }
 
@@ -95,7 +95,7 @@ void outline_pass::render(render_context* context) const
 			model_view_projection = view_projection * operation.transform;
 			fill_model_view_projection_input->upload(model_view_projection);
 			
-			rasterizer->draw_arrays(*operation.vertex_array, operation.drawing_mode, operation.start_index, operation.index_count);
+			draw(operation);
 		}
 	}
 	
@@ -131,7 +131,7 @@ void outline_pass::render(render_context* context) const
 			model_view_projection = view_projection * operation.transform;
 			stroke_model_view_projection_input->upload(model_view_projection);
 			
-			rasterizer->draw_arrays(*operation.vertex_array, operation.drawing_mode, operation.start_index, operation.index_count);
+			draw(operation);
 		}
 	}
 	
@@ -25,18 +25,53 @@
 #include "gl/shader-input.hpp"
 #include "gl/drawing-mode.hpp"
 #include "renderer/render-context.hpp"
+#include "renderer/shader-template.hpp"
 #include "renderer/material.hpp"
 #include "renderer/material-flags.hpp"
 #include "scene/camera.hpp"
 #include "scene/light.hpp"
+#include "scene/collection.hpp"
+#include "scene/model-instance.hpp"
+#include "scene/lod-group.hpp"
+#include "renderer/model.hpp"
+#include "renderer/occlusion-culler.hpp"
 #include "geom/view-frustum.hpp"
+#include "geom/convex-hull.hpp"
 #include "geom/aabb.hpp"
+#include "geom/culling.hpp"
 #include "configuration.hpp"
 #include "math/math.hpp"
+#include <algorithm>
 #include <cmath>
 #include <glad/glad.h>
 
-static bool operation_compare(const render_operation& a, const render_operation& b);
+static bool operation_compare(const render_operation* a, const render_operation* b);
+static bool is_shadow_caster(const ::material* material);
+static bool shares_geometry(const render_operation& a, const render_operation& b);
+static std::uint64_t hash_bytes(std::uint64_t hash, const void* data, std::size_t size);
+
+/// Shader template which renders the depth of unskinned instances, each with its own model-view-projection matrix.
+static const char* instanced_depth_shader_source = R"(#version 330 core
+#pragma vertex
+#pragma fragment
+
+#if defined(__VERTEX__)
+
+layout(location = 0) in vec3 vertex_position;
+uniform mat4 model_view_projections[32];
+
+void main()
+{
+	gl_Position = model_view_projections[gl_InstanceID] * vec4(vertex_position, 1.0);
+}
+
+#elif defined(__FRAGMENT__)
+
+void main()
+{}
+
+#endif
+)";
 
 void shadow_map_pass::distribute_frustum_splits(float* split_distances, std::size_t split_count, float split_scheme, float near, float far)
 {
@@ -59,7 +94,10 @@ void shadow_map_pass::distribute_frustum_splits(float* split_distances, std::siz
 shadow_map_pass::shadow_map_pass(gl::rasterizer* rasterizer, const gl::framebuffer* framebuffer, resource_manager* resource_manager):
 	render_pass(rasterizer, framebuffer),
 	split_scheme_weight(0.5f),
-	light(nullptr)
+	light(nullptr),
+	cascade_signatures{0, 0, 0, 0},
+	cascade_cached{false, false, false, false},
+	first_cached_cascade(2)
 {
 	// Load skinned shader program
 	unskinned_shader_program = resource_manager->load<gl::shader_program>("depth-unskinned.glsl");
@@ -69,6 +107,11 @@ shadow_map_pass::shadow_map_pass(gl::rasterizer* rasterizer, const gl::framebuff
 	skinned_shader_program = resource_manager->load<gl::shader_program>("depth-skinned.glsl");
 	skinned_model_view_projection_input = skinned_shader_program->get_input("model_view_projection");
 	
+	// Build instanced unskinned shader program
+	shader_template instanced_template(instanced_depth_shader_source);
+	instanced_shader_program = instanced_template.build({});
+	instanced_model_view_projections_input = instanced_shader_program->get_input("model_view_projections");
+	
 	// Calculate bias-tile matrices
 	float4x4 bias_matrix = math::translate(math::identity4x4<float>, float3{0.5f, 0.5f, 0.5f}) * math::scale(math::identity4x4<float>, float3{0.5f, 0.5f, 0.5f});
 	float4x4 tile_scale = math::scale(math::identity4x4<float>, float3{0.5f, 0.5f, 1.0f});
@@ -82,7 +125,9 @@ shadow_map_pass::shadow_map_pass(gl::rasterizer* rasterizer, const gl::framebuff
 }
 
 shadow_map_pass::~shadow_map_pass()
-{}
+{
+	delete instanced_shader_program;
+}
 
 void shadow_map_pass::render(render_context* context) const
 {
@@ -106,6 +151,9 @@ void shadow_map_pass::render(render_context* context) const
 	glEnable(GL_CULL_FACE);
 	glCullFace(GL_FRONT);
 	
+	// Clamp depth, so casters between the light and a cascade's near plane are flattened onto it rather than clipped
+	glEnable(GL_DEPTH_CLAMP);
+	
 	// For half-z buffer
 	//glDepthRange(-1.0f, 1.0f);
 	
@@ -135,7 +183,7 @@ void shadow_map_pass::render(render_context* context) const
 	}
 	
 	// Calculate a view-projection matrix from the directional light's transform
-	math::transform<float> light_transform = light->get_transform_tween().interpolate(context->alpha);
+	math::transform<float> light_transform = light->interpolate_published_transform(context->alpha);
 	float3 forward = light_transform.rotation * global_forward;
 	float3 up = light_transform.rotation * global_up;
 	float4x4 light_view = math::look_at(light_transform.translation, light_transform.translation + forward, up);
@@ -147,12 +195,13 @@ void shadow_map_pass::render(render_context* context) const
 	
 	float4x4 crop_matrix;
 	float4x4 cropped_view_projection;
-	float4x4 model_view_projection;
 	
-	// Sort render operations
-	context->operations.sort(operation_compare);
+	// Gather shadow casters
+	gather_casters(context);
 	
-	gl::shader_program* active_shader_program = nullptr;
+	// Clear shadow map tiles individually, so cached tiles are preserved
+	rasterizer->set_clear_depth(1.0f);
+	glEnable(GL_SCISSOR_TEST);
 	
 	for (int i = 0; i < 4; ++i)
 	{
@@ -214,15 +263,267 @@ void shadow_map_pass::render(render_context* context) const
 		// Calculate shadow matrix
 		shadow_matrices[i] = bias_tile_matrices[i] * cropped_view_projection;
 		
-		for (const render_operation& operation: context->operations)
+		// Build the light volume of this cascade, omitting the near plane so casters between the light and the cascade are kept
+		geom::view_frustum<float> light_frustum(cropped_view_projection);
+		geom::convex_hull<float> light_volume(5);
+		light_volume.planes[0] = light_frustum.get_left();
+		light_volume.planes[1] = light_frustum.get_right();
+		light_volume.planes[2] = light_frustum.get_bottom();
+		light_volume.planes[3] = light_frustum.get_top();
+		light_volume.planes[4] = light_frustum.get_far();
+		
+		// Cull casters against the light volume
+		cull_casters(light_volume);
+		
+		// Sign the contents of the cascade
+		bool cacheable = (i >= first_cached_cascade);
+		std::uint64_t signature = hash_bytes(0xcbf29ce484222325, &cropped_view_projection, sizeof(float4x4));
+		signature = hash_bytes(signature, &viewport, sizeof(float4));
+		cascade_casters.clear();
+		for (std::size_t j = 0; j < casters.size(); ++j)
 		{
-			// Skip materials which don't cast shadows
-			const ::material* material = operation.material;
-			if (material && (material->get_flags() & MATERIAL_FLAG_NOT_SHADOW_CASTER))
-			{
+			if (!caster_visibility[j])
 				continue;
+			
+			const render_operation* caster = casters[j];
+			cascade_casters.push_back(caster);
+			
+			if (cacheable)
+			{
+				// Skinned casters can change shape without moving, and can't be cached
+				if (caster->pose)
+				{
+					cacheable = false;
+					continue;
+				}
+				
+				signature = hash_bytes(signature, &caster->vertex_array, sizeof(caster->vertex_array));
+				
+				// Buffers updated in place keep their vertex array, so sign their contents' revision as well
+				const std::size_t geometry_revision = caster->vertex_array->get_revision();
+				signature = hash_bytes(signature, &geometry_revision, sizeof(geometry_revision));
+				signature = hash_bytes(signature, &caster->start_index, sizeof(caster->start_index));
+				signature = hash_bytes(signature, &caster->index_count, sizeof(caster->index_count));
+				signature = hash_bytes(signature, &caster->instance_count, sizeof(caster->instance_count));
+				signature = hash_bytes(signature, &caster->transform, sizeof(caster->transform));
 			}
+		}
+		
+		// Skip cascade if its cached contents are still valid
+		if (cacheable && cascade_cached[i] && cascade_signatures[i] == signature)
+		{
+			continue;
+		}
+		cascade_cached[i] = cacheable;
+		cascade_signatures[i] = signature;
+		
+		// Clear tile
+		glScissor(static_cast<GLint>(viewport[0]), static_cast<GLint>(viewport[1]), static_cast<GLsizei>(viewport[2]), static_cast<GLsizei>(viewport[3]));
+		rasterizer->clear_framebuffer(false, true, false);
+		
+		// Draw casters
+		draw_casters(cropped_view_projection);
+	}
+	
+	glDisable(GL_SCISSOR_TEST);
+	glDisable(GL_DEPTH_CLAMP);
+}
+
+void shadow_map_pass::gather_casters(const render_context* context) const
+{
+	casters.clear();
+	offscreen_casters.clear();
+	
+	// Gather casters from the render operations of visible objects
+	for (const render_operation& operation: context->operations)
+	{
+		if (is_shadow_caster(operation.material))
+		{
+			casters.push_back(&operation);
+		}
+	}
+	
+	// Gather casters from model instances which were culled by the camera or by occluders, as they may still cast shadows into the view frustum
+	for (const scene::object_base* object: *context->collection->get_objects(scene::model_instance::object_type_id))
+	{
+		gather_offscreen_casters(context, static_cast<const scene::model_instance*>(object));
+	}
+	
+	// Gather culled casters from the selected level of each LOD group, as the renderer does
+	for (const scene::object_base* object: *context->collection->get_objects(scene::lod_group::object_type_id))
+	{
+		if (!object->is_active())
+			continue;
+		
+		const scene::lod_group* lod_group = static_cast<const scene::lod_group*>(object);
+		std::size_t level = lod_group->select_lod(*context->camera, context->viewport_height);
+		for (const scene::object_base* child: lod_group->get_objects(level))
+		{
+			if (child->get_object_type_id() == scene::model_instance::object_type_id)
+				gather_offscreen_casters(context, static_cast<const scene::model_instance*>(child));
+		}
+	}
+	
+	for (const render_operation& operation: offscreen_casters)
+	{
+		casters.push_back(&operation);
+	}
+	
+	// Sort casters by shader program, then by geometry
+	std::sort(casters.begin(), casters.end(), operation_compare);
+	
+	// Sort the culling volumes of casters into arrays of AABBs and spheres, to be culled against each cascade
+	caster_aabbs.clear();
+	caster_aabb_indices.clear();
+	caster_spheres.clear();
+	caster_sphere_indices.clear();
+	caster_bounded.assign(casters.size(), 0);
+	for (std::size_t i = 0; i < casters.size(); ++i)
+	{
+		const geom::bounding_volume<float>* culling_volume = casters[i]->culling_volume;
+		if (!culling_volume)
+			continue;
+		
+		switch (culling_volume->get_bounding_volume_type())
+		{
+			case geom::bounding_volume_type::aabb:
+				caster_aabbs.push_back(static_cast<const geom::aabb<float>&>(*culling_volume));
+				caster_aabb_indices.push_back(i);
+				caster_bounded[i] = 1;
+				break;
+			
+			case geom::bounding_volume_type::sphere:
+				caster_spheres.push_back(static_cast<const geom::sphere<float>&>(*culling_volume));
+				caster_sphere_indices.push_back(i);
+				caster_bounded[i] = 1;
+				break;
 			
+			default:
+				break;
+		}
+	}
+}
+
+void shadow_map_pass::gather_offscreen_casters(const render_context* context, const scene::model_instance* model_instance) const
+{
+	if (!model_instance->is_active())
+		return;
+	
+	const model* model = model_instance->get_model();
+	if (!model)
+		return;
+	
+	// Skip model instances which are visible, as their operations have already been gathered
+	const geom::bounding_volume<float>* object_culling_volume = model_instance->get_culling_mask();
+	if (!object_culling_volume)
+		object_culling_volume = &model_instance->get_bounds();
+	const bool occluded = context->occlusion_culler && !context->occlusion_culler->is_visible(*object_culling_volume);
+	if (!occluded && context->camera_culling_volume->intersects(*object_culling_volume))
+		return;
+	
+	const std::vector<material*>* instance_materials = model_instance->get_materials();
+	const float4x4 transform = context->transform_matrices[model_instance->get_transform_index()] * model->get_dequantization_transform();
+	
+	for (model_group* group: *model->get_groups())
+	{
+		render_operation operation;
+		operation.material = group->get_material();
+		if ((*instance_materials)[group->get_index()])
+		{
+			operation.material = (*instance_materials)[group->get_index()];
+		}
+		
+		if (!is_shadow_caster(operation.material))
+			continue;
+		
+		// Skip groups of occluded model instances which were gathered because they are visible through occluders
+		if (occluded && operation.material && (operation.material->get_flags() & MATERIAL_FLAG_X_RAY))
+			continue;
+		
+		operation.pose = model_instance->get_pose();
+		operation.vertex_array = model->get_vertex_array();
+		operation.drawing_mode = group->get_drawing_mode();
+		operation.start_index = group->get_start_index();
+		operation.index_count = group->get_index_count();
+		operation.transform = transform;
+		operation.depth = 0.0f;
+		operation.instance_count = model_instance->get_instance_count();
+		operation.indexed = model->is_indexed();
+		operation.index_type = model->get_index_type();
+		operation.culling_volume = object_culling_volume;
+		
+		offscreen_casters.push_back(operation);
+	}
+}
+
+void shadow_map_pass::cull_casters(const geom::convex_hull<float>& light_volume) const
+{
+	// Casters without AABB or sphere culling volumes are always visible
+	caster_visibility.resize(casters.size());
+	for (std::size_t i = 0; i < casters.size(); ++i)
+	{
+		caster_visibility[i] = !caster_bounded[i];
+	}
+	
+	geom::cull(light_volume, caster_aabbs, caster_mask);
+	for (std::size_t i = 0; i < caster_aabb_indices.size(); ++i)
+	{
+		caster_visibility[caster_aabb_indices[i]] = (caster_mask[i / 64] >> (i % 64)) & 1;
+	}
+	
+	geom::cull(light_volume, caster_spheres, caster_mask);
+	for (std::size_t i = 0; i < caster_sphere_indices.size(); ++i)
+	{
+		caster_visibility[caster_sphere_indices[i]] = (caster_mask[i / 64] >> (i % 64)) & 1;
+	}
+}
+
+void shadow_map_pass::draw_casters(const float4x4& view_projection) const
+{
+	gl::shader_program* active_shader_program = nullptr;
+	float4x4 model_view_projection;
+	
+	const std::size_t caster_count = cascade_casters.size();
+	for (std::size_t i = 0; i < caster_count;)
+	{
+		const render_operation& operation = *cascade_casters[i];
+		
+		// Find run of static casters which share geometry
+		std::size_t run_length = 1;
+		if (!operation.pose && !operation.instance_count)
+		{
+			while (i + run_length < caster_count && shares_geometry(operation, *cascade_casters[i + run_length]))
+			{
+				++run_length;
+			}
+		}
+		
+		if (run_length > 1)
+		{
+			if (active_shader_program != instanced_shader_program)
+			{
+				active_shader_program = instanced_shader_program;
+				rasterizer->use_program(*active_shader_program);
+			}
+			
+			// Calculate model-view-projection matrices of the run
+			instance_matrices.resize(run_length);
+			for (std::size_t j = 0; j < run_length; ++j)
+			{
+				instance_matrices[j] = view_projection * cascade_casters[i + j]->transform;
+			}
+			
+			// Draw run in batches which fit in the shader's matrix array
+			const std::size_t batch_size = std::max<std::size_t>(1, instanced_model_view_projections_input->get_element_count());
+			for (std::size_t j = 0; j < run_length; j += batch_size)
+			{
+				const std::size_t instance_count = std::min(batch_size, run_length - j);
+				instanced_model_view_projections_input->upload(0, &instance_matrices[j], instance_count);
+				draw(operation, instance_count);
+			}
+		}
+		else
+		{
 			// Switch shader programs if necessary
 			gl::shader_program* shader_program = (operation.pose != nullptr) ? skinned_shader_program : unskinned_shader_program;
 			if (active_shader_program != shader_program)
@@ -232,7 +533,7 @@ void shadow_map_pass::render(render_context* context) const
 			}
 			
 			// Calculate model-view-projection matrix
-			model_view_projection = cropped_view_projection * operation.transform;
+			model_view_projection = view_projection * operation.transform;
 			
 			// Upload operation-dependent parameters to shader program
 			if (active_shader_program == unskinned_shader_program)
@@ -243,10 +544,12 @@ void shadow_map_pass::render(render_context* context) const
 			{
 				skinned_model_view_projection_input->upload(model_view_projection);
 			}
-
+			
 			// Draw geometry
-			rasterizer->draw_arrays(*operation.vertex_array, operation.drawing_mode, operation.start_index, operation.index_count);
+			draw(operation);
 		}
+		
+		i += run_length;
 	}
 }
 
@@ -260,36 +563,65 @@ void shadow_map_pass::set_light(const scene::directional_light* light)
 	this->light = light;
 }
 
-bool operation_compare(const render_operation& a, const render_operation& b)
+void shadow_map_pass::set_first_cached_cascade(int index)
 {
-	// Determine transparency
-	bool skinned_a = (a.pose != nullptr);
-	bool skinned_b = (b.pose != nullptr);
+	first_cached_cascade = index;
 	
-	if (skinned_a)
+	// Invalidate cached cascades
+	for (int i = 0; i < 4; ++i)
 	{
-		if (skinned_b)
-		{
-			// A and B are both skinned, sort by VAO
-			return (a.vertex_array < b.vertex_array);
-		}
-		else
-		{
-			// A is skinned, B is unskinned. Render B first
-			return false;
-		}
+		cascade_cached[i] = false;
 	}
-	else
+}
+
+bool operation_compare(const render_operation* a, const render_operation* b)
+{
+	// Render unskinned operations before skinned operations
+	const bool skinned_a = (a->pose != nullptr);
+	const bool skinned_b = (b->pose != nullptr);
+	if (skinned_a != skinned_b)
 	{
-		if (skinned_b)
-		{
-			// A is unskinned, B is skinned. Render A first
-			return true;
-		}
-		else
-		{
-			// A and B are both unskinned, sort by VAO
-			return (a.vertex_array < b.vertex_array);
-		}
+		return skinned_b;
+	}
+	
+	// Group operations which share geometry
+	if (a->vertex_array != b->vertex_array)
+	{
+		return (a->vertex_array < b->vertex_array);
+	}
+	if (a->drawing_mode != b->drawing_mode)
+	{
+		return (a->drawing_mode < b->drawing_mode);
+	}
+	if (a->start_index != b->start_index)
+	{
+		return (a->start_index < b->start_index);
+	}
+	return (a->index_count < b->index_count);
+}
+
+bool is_shadow_caster(const ::material* material)
+{
+	return !material || !(material->get_flags() & MATERIAL_FLAG_NOT_SHADOW_CASTER);
+}
+
+bool shares_geometry(const render_operation& a, const render_operation& b)
+{
+	return !b.pose && !b.instance_count &&
+		a.vertex_array == b.vertex_array &&
+		a.indexed == b.indexed &&
+		a.drawing_mode == b.drawing_mode &&
+		a.start_index == b.start_index &&
+		a.index_count == b.index_count;
+}
+
+std::uint64_t hash_bytes(std::uint64_t hash, const void* data, std::size_t size)
+{
+	const unsigned char* bytes = static_cast<const unsigned char*>(data);
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= 0x100000001b3;
 	}
+	return hash;
 }
@@ -25,11 +25,22 @@
 #include "scene/directional-light.hpp"
 #include "gl/shader-program.hpp"
 #include "gl/shader-input.hpp"
+#include "renderer/render-operation.hpp"
+#include "geom/culling.hpp"
+#include <cstdint>
+#include <vector>
 
 class resource_manager;
 
+namespace scene
+{
+	class model_instance;
+}
+
 /**
+ * Renders cascaded shadow maps for a directional light.
  *
+ * Shadow casters are gathered from the render context and from the scene objects which were culled by the camera, then culled against the cropped light frustum of each cascade. Static casters which share geometry are drawn with instancing. Cascades which are cached are only re-rendered when their light-space crop, their casters, or the contents of their casters' buffers change. Depth is clamped while rendering, so casters between the light and a cascade are kept.
  */
 class shadow_map_pass: public render_pass
 {
@@ -47,6 +58,13 @@ public:
 	
 	void set_light(const scene::directional_light* light);
 	
+	/**
+	 * Sets the index of the first cascade which may be cached across frames.
+	 *
+	 * @param index Index of the first cached cascade. A value of `4` disables caching.
+	 */
+	void set_first_cached_cascade(int index);
+	
 	const float4x4* get_shadow_matrices() const;
 	const float* get_split_distances() const;
 
@@ -62,17 +80,64 @@ private:
 	 */
 	static void distribute_frustum_splits(float* split_distances, std::size_t split_count, float split_scheme, float near, float far);
 	
+	/**
+	 * Gathers shadow casters from the render context and from the model instances, including those of the selected level of each LOD group, culled by the camera.
+	 *
+	 * @param context Render context.
+	 */
+	void gather_casters(const render_context* context) const;
+	
+	/**
+	 * Gathers the shadow casters of a model instance which was culled by the camera or by occluders.
+	 *
+	 * @param context Render context.
+	 * @param model_instance Model instance from which to gather casters.
+	 */
+	void gather_offscreen_casters(const render_context* context, const scene::model_instance* model_instance) const;
+	
+	/**
+	 * Culls the gathered shadow casters against the light volume of a cascade, updating the caster visibility flags.
+	 *
+	 * @param light_volume Light volume of the cascade.
+	 */
+	void cull_casters(const geom::convex_hull<float>& light_volume) const;
+	
+	/**
+	 * Draws the shadow casters of a cascade.
+	 *
+	 * @param view_projection Cropped light view-projection matrix of the cascade.
+	 */
+	void draw_casters(const float4x4& view_projection) const;
+	
 	gl::shader_program* unskinned_shader_program;
 	const gl::shader_input* unskinned_model_view_projection_input;
 	
 	gl::shader_program* skinned_shader_program;
 	const gl::shader_input* skinned_model_view_projection_input;
 	
+	gl::shader_program* instanced_shader_program;
+	const gl::shader_input* instanced_model_view_projections_input;
+	
 	mutable float split_distances[5];
 	mutable float4x4 shadow_matrices[4];
 	float4x4 bias_tile_matrices[4];
 	float split_scheme_weight;
 	const scene::directional_light* light;
+	
+	mutable std::vector<render_operation> offscreen_casters;
+	mutable std::vector<const render_operation*> casters;
+	mutable std::vector<const render_operation*> cascade_casters;
+	mutable geom::aabb_array<float> caster_aabbs;
+	mutable geom::sphere_array<float> caster_spheres;
+	mutable std::vector<std::size_t> caster_aabb_indices;
+	mutable std::vector<std::size_t> caster_sphere_indices;
+	mutable std::vector<unsigned char> caster_bounded;
+	mutable std::vector<unsigned char> caster_visibility;
+	mutable std::vector<std::uint64_t> caster_mask;
+	mutable std::vector<float4x4> instance_matrices;
+	mutable std::uint64_t cascade_signatures[4];
+	mutable bool cascade_cached[4];
+	int first_cached_cascade;
 };
 
 inline const float4x4* shadow_map_pass::get_shadow_matrices() const
@@ -31,6 +31,8 @@
 #include "gl/texture-2d.hpp"
 #include "gl/texture-wrapping.hpp"
 #include "gl/texture-filter.hpp"
+#include "gl/pixel-type.hpp"
+#include "gl/pixel-format.hpp"
 #include "renderer/vertex-attributes.hpp"
 #include "renderer/render-context.hpp"
 #include "renderer/model.hpp"
@@ -54,14 +56,12 @@ sky_pass::sky_pass(gl::rasterizer* rasterizer, const gl::framebuffer* framebuffe
 	mouse_position({0.0f, 0.0f}),
 	sky_model(nullptr),
 	sky_material(nullptr),
-	sky_model_vao(nullptr),
 	sky_shader_program(nullptr),
+	transmittance_lut_input(nullptr),
 	moon_model(nullptr),
-	moon_model_vao(nullptr),
 	moon_material(nullptr),
 	moon_shader_program(nullptr),
 	stars_model(nullptr),
-	stars_model_vao(nullptr),
 	star_material(nullptr),
 	star_shader_program(nullptr),
 	time_tween(nullptr),
@@ -69,11 +69,14 @@ sky_pass::sky_pass(gl::rasterizer* rasterizer, const gl::framebuffer* framebuffe
 	sun_position_tween(float3{1.0f, 0.0f, 0.0f}, math::lerp<float3, float>),
 	sun_color_tween(float3{1.0f, 1.0f, 1.0f}, math::lerp<float3, float>),
 	topocentric_frame_translation({0, 0, 0}, math::lerp<float3, float>),
-	topocentric_frame_rotation(math::quaternion<float>::identity(), math::nlerp<float>)
+	topocentric_frame_rotation(math::quaternion<float>::identity(), math::nlerp<float>),
+	transmittance_lut_texture(nullptr)
 {}
 
 sky_pass::~sky_pass()
-{}
+{
+	delete transmittance_lut_texture;
+}
 
 void sky_pass::render(render_context* context) const
 {
@@ -154,10 +157,12 @@ void sky_pass::render(render_context* context) const
 			mie_anisotropy_input->upload(mie_anisotropy);
 		if (atmosphere_radii_input)
 			atmosphere_radii_input->upload(atmosphere_radii);
+		if (transmittance_lut_input && transmittance_lut_texture)
+			transmittance_lut_input->upload(transmittance_lut_texture);
 		
 		sky_material->upload(context->alpha);
 
-		rasterizer->draw_arrays(*sky_model_vao, sky_model_drawing_mode, sky_model_start_index, sky_model_index_count);
+		draw(sky_model_operation);
 	}
 	
 	glEnable(GL_BLEND);
@@ -186,7 +191,7 @@ void sky_pass::render(render_context* context) const
 		
 		star_material->upload(context->alpha);
 		
-		rasterizer->draw_arrays(*stars_model_vao, stars_model_drawing_mode, stars_model_start_index, stars_model_index_count);
+		draw(stars_model_operation);
 	}
 	
 	// Draw moon model
@@ -219,7 +224,7 @@ void sky_pass::render(render_context* context) const
 		if (moon_sun_position_input)
 			moon_sun_position_input->upload(sun_position);
 		moon_material->upload(context->alpha);
-		rasterizer->draw_arrays(*moon_model_vao, moon_model_drawing_mode, moon_model_start_index, moon_model_index_count);
+		draw(moon_model_operation);
 	}
 	*/
 	
@@ -232,15 +237,17 @@ void sky_pass::set_sky_model(const model* model)
 	
 	if (sky_model)
 	{
-		sky_model_vao = model->get_vertex_array();
+		sky_model_operation.vertex_array = model->get_vertex_array();
+		sky_model_operation.indexed = model->is_indexed();
+		sky_model_operation.index_type = model->get_index_type();
 
 		const std::vector<model_group*>& groups = *model->get_groups();
 		for (model_group* group: groups)
 		{
 			sky_material = group->get_material();
-			sky_model_drawing_mode = group->get_drawing_mode();
-			sky_model_start_index = group->get_start_index();
-			sky_model_index_count = group->get_index_count();
+			sky_model_operation.drawing_mode = group->get_drawing_mode();
+			sky_model_operation.start_index = group->get_start_index();
+			sky_model_operation.index_count = group->get_index_count();
 		}
 		
 		if (sky_material)
@@ -264,12 +271,13 @@ void sky_pass::set_sky_model(const model* model)
 				mie_scattering_input = sky_shader_program->get_input("mie_scattering");
 				mie_anisotropy_input = sky_shader_program->get_input("mie_anisotropy");
 				atmosphere_radii_input = sky_shader_program->get_input("atmosphere_radii");
+				transmittance_lut_input = sky_shader_program->get_input("transmittance_lut");
 			}
 		}
 	}
 	else
 	{
-		sky_model_vao = nullptr;
+		sky_model_operation.vertex_array = nullptr;
 	}
 }
 
@@ -279,15 +287,17 @@ void sky_pass::set_moon_model(const model* model)
 	
 	if (moon_model)
 	{
-		moon_model_vao = model->get_vertex_array();
+		moon_model_operation.vertex_array = model->get_vertex_array();
+		moon_model_operation.indexed = model->is_indexed();
+		moon_model_operation.index_type = model->get_index_type();
 
 		const std::vector<model_group*>& groups = *model->get_groups();
 		for (model_group* group: groups)
 		{
 			moon_material = group->get_material();
-			moon_model_drawing_mode = group->get_drawing_mode();
-			moon_model_start_index = group->get_start_index();
-			moon_model_index_count = group->get_index_count();
+			moon_model_operation.drawing_mode = group->get_drawing_mode();
+			moon_model_operation.start_index = group->get_start_index();
+			moon_model_operation.index_count = group->get_index_count();
 		}
 		
 		if (moon_material)
@@ -315,15 +325,17 @@ void sky_pass::set_stars_model(const model* model)
 	
 	if (stars_model)
 	{
-		stars_model_vao = model->get_vertex_array();
+		stars_model_operation.vertex_array = model->get_vertex_array();
+		stars_model_operation.indexed = model->is_indexed();
+		stars_model_operation.index_type = model->get_index_type();
 
 		const std::vector<model_group*>& groups = *model->get_groups();
 		for (model_group* group: groups)
 		{
 			star_material = group->get_material();
-			stars_model_drawing_mode = group->get_drawing_mode();
-			stars_model_start_index = group->get_start_index();
-			stars_model_index_count = group->get_index_count();
+			stars_model_operation.drawing_mode = group->get_drawing_mode();
+			stars_model_operation.start_index = group->get_start_index();
+			stars_model_operation.index_count = group->get_index_count();
 		}
 		
 		if (star_material)
@@ -408,6 +420,36 @@ void sky_pass::set_atmosphere_radii(float inner, float outer)
 	atmosphere_radii.z = outer * outer;
 }
 
+void sky_pass::set_transmittance_lut(std::shared_ptr<const physics::atmosphere::transmittance_lut<float>> lut)
+{
+	if (lut == transmittance_lut)
+		return;
+	
+	transmittance_lut = lut;
+	
+	if (!transmittance_lut)
+	{
+		delete transmittance_lut_texture;
+		transmittance_lut_texture = nullptr;
+		return;
+	}
+	
+	const int width = static_cast<int>(transmittance_lut->get_width());
+	const int height = static_cast<int>(transmittance_lut->get_height());
+	const void* data = transmittance_lut->get_data().data();
+	
+	if (!transmittance_lut_texture)
+	{
+		transmittance_lut_texture = new gl::texture_2d(width, height, gl::pixel_type::float_32, gl::pixel_format::rgb, gl::color_space::linear, data);
+		transmittance_lut_texture->set_wrapping(gl::texture_wrapping::extend, gl::texture_wrapping::extend);
+		transmittance_lut_texture->set_filters(gl::texture_min_filter::linear, gl::texture_mag_filter::linear);
+	}
+	else
+	{
+		transmittance_lut_texture->resize(width, height, gl::pixel_type::float_32, gl::pixel_format::rgb, gl::color_space::linear, data);
+	}
+}
+
 void sky_pass::handle_event(const mouse_moved_event& event)
 {
 	mouse_position = {static_cast<float>(event.x), static_cast<float>(event.y)};
@@ -32,8 +32,11 @@
 #include "gl/vertex-array.hpp"
 #include "gl/texture-2d.hpp"
 #include "gl/drawing-mode.hpp"
+#include "renderer/render-operation.hpp"
 #include "physics/frame.hpp"
+#include "physics/atmosphere.hpp"
 #include "scene/object.hpp"
+#include <memory>
 
 class resource_manager;
 class model;
@@ -67,6 +70,13 @@ public:
 	void set_scattering_coefficients(const float3& r, const float3& m);
 	void set_mie_anisotropy(float g);
 	void set_atmosphere_radii(float inner, float outer);
+	
+	/**
+	 * Sets the atmospheric transmittance lookup table. The table is uploaded to a texture only when it differs from the previously set table.
+	 *
+	 * @param lut Transmittance lookup table, or `nullptr` to disable.
+	 */
+	void set_transmittance_lut(std::shared_ptr<const physics::atmosphere::transmittance_lut<float>> lut);
 
 private:
 	virtual void handle_event(const mouse_moved_event& event);
@@ -86,6 +96,7 @@ private:
 	const gl::shader_input* mie_scattering_input;
 	const gl::shader_input* mie_anisotropy_input;
 	const gl::shader_input* atmosphere_radii_input;
+	const gl::shader_input* transmittance_lut_input;
 	
 	gl::shader_program* moon_shader_program;
 	const gl::shader_input* moon_model_view_projection_input;
@@ -95,24 +106,15 @@ private:
 	
 	const model* sky_model;
 	const material* sky_material;
-	const gl::vertex_array* sky_model_vao;
-	gl::drawing_mode sky_model_drawing_mode;
-	std::size_t sky_model_start_index;
-	std::size_t sky_model_index_count;
+	render_operation sky_model_operation;
 	
 	const model* moon_model;
 	const material* moon_material;
-	const gl::vertex_array* moon_model_vao;
-	gl::drawing_mode moon_model_drawing_mode;
-	std::size_t moon_model_start_index;
-	std::size_t moon_model_index_count;
+	render_operation moon_model_operation;
 	
 	const model* stars_model;
 	const material* star_material;
-	const gl::vertex_array* stars_model_vao;
-	gl::drawing_mode stars_model_drawing_mode;
-	std::size_t stars_model_start_index;
-	std::size_t stars_model_index_count;
+	render_operation stars_model_operation;
 	gl::shader_program* star_shader_program;
 	const gl::shader_input* star_model_view_input;
 	const gl::shader_input* star_projection_input;
@@ -137,6 +139,9 @@ private:
 	float3 mie_scattering;
 	float2 mie_anisotropy;
 	float3 atmosphere_radii;
+	
+	std::shared_ptr<const physics::atmosphere::transmittance_lut<float>> transmittance_lut;
+	gl::texture_2d* transmittance_lut_texture;
 };
 
 #endif // ANTKEEPER_SKY_PASS_HPP
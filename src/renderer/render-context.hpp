@@ -28,6 +28,8 @@
 #include "scene/collection.hpp"
 #include <list>
 
+class occlusion_culler;
+
 struct render_context
 {
 	const scene::camera* camera;
@@ -35,9 +37,17 @@ struct render_context
 	float3 camera_forward;
 	float3 camera_up;
 	const geom::bounding_volume<float>* camera_culling_volume;
+	const occlusion_culler* occlusion_culler;
 	geom::plane<float> clip_near;
 	
+	/// Height of the viewport, in pixels, used to select the levels of LOD groups.
+	float viewport_height;
+	
 	const scene::collection* collection;
+	
+	/// Interpolated transformation matrices of all scene objects, indexed by scene::object_base::get_transform_index().
+	const float4x4* transform_matrices;
+	
 	std::list<render_operation> operations;
 	float alpha;
 };
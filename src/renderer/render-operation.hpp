@@ -23,6 +23,8 @@
 #include "utility/fundamental-types.hpp"
 #include "gl/vertex-array.hpp"
 #include "gl/drawing-mode.hpp"
+#include "gl/element-array-type.hpp"
+#include "geom/bounding-volume.hpp"
 #include <cstdlib>
 
 class pose;
@@ -42,6 +44,15 @@ struct render_operation
 	float4x4 transform;
 	float depth;
 	std::size_t instance_count;
+	
+	/// `true` if `start_index` and `index_count` refer to the element buffer of the vertex array, `false` if they refer to its vertices.
+	bool indexed;
+	
+	/// Type of the indices in the element buffer of the vertex array.
+	gl::element_array_type index_type;
+	
+	/// World-space culling volume of the object which generated the operation, or `nullptr` if the operation should never be culled.
+	const geom::bounding_volume<float>* culling_volume;
 };
 
 #endif // ANTKEEPER_RENDER_OPERATION_HPP
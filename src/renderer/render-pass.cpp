@@ -18,6 +18,15 @@
  */
 
 #include "renderer/render-pass.hpp"
+#include "renderer/render-operation.hpp"
+#include <cstdint>
+
+static constexpr std::size_t element_size_lut[] =
+{
+	sizeof(std::uint8_t),
+	sizeof(std::uint16_t),
+	sizeof(std::uint32_t)
+};
 
 render_pass::render_pass(gl::rasterizer* rasterizer, const gl::framebuffer* framebuffer):
 	rasterizer(rasterizer),
@@ -33,3 +42,22 @@ void render_pass::set_enabled(bool enabled)
 	this->enabled = enabled;
 }
 
+void render_pass::draw(const render_operation& operation, std::size_t instance_count) const
+{
+	if (operation.indexed)
+	{
+		const std::size_t offset = operation.start_index * element_size_lut[static_cast<std::size_t>(operation.index_type)];
+		
+		if (instance_count)
+			rasterizer->draw_elements_instanced(*operation.vertex_array, operation.drawing_mode, offset, operation.index_count, operation.index_type, instance_count);
+		else
+			rasterizer->draw_elements(*operation.vertex_array, operation.drawing_mode, offset, operation.index_count, operation.index_type);
+	}
+	else
+	{
+		if (instance_count)
+			rasterizer->draw_arrays_instanced(*operation.vertex_array, operation.drawing_mode, operation.start_index, operation.index_count, instance_count);
+		else
+			rasterizer->draw_arrays(*operation.vertex_array, operation.drawing_mode, operation.start_index, operation.index_count);
+	}
+}
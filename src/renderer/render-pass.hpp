@@ -24,6 +24,7 @@
 #include "gl/framebuffer.hpp"
 
 struct render_context;
+struct render_operation;
 
 /**
  *
@@ -40,6 +41,14 @@ public:
 	bool is_enabled() const;
 
 protected:
+	/**
+	 * Draws the geometry of a render operation, as indexed elements if the operation is indexed.
+	 *
+	 * @param operation Render operation to draw.
+	 * @param instance_count Number of instances to draw, or `0` if the geometry should not be instanced.
+	 */
+	void draw(const render_operation& operation, std::size_t instance_count = 0) const;
+	
 	gl::rasterizer* rasterizer;
 	const gl::framebuffer* framebuffer;
 
@@ -26,14 +26,27 @@
 #include "scene/billboard.hpp"
 #include "scene/lod-group.hpp"
 #include "renderer/model.hpp"
+#include "renderer/material.hpp"
+#include "renderer/material-flags.hpp"
+#include "renderer/occlusion-culler.hpp"
 #include "gl/drawing-mode.hpp"
 #include "math/math.hpp"
 #include "geom/projection.hpp"
+#include "geom/convex-hull.hpp"
 #include "configuration.hpp"
+#include <algorithm>
 #include <functional>
 #include <set>
 
-renderer::renderer()
+static const geom::bounding_volume<float>* get_culling_volume(const scene::object_base* object);
+
+renderer::renderer():
+	transform_revision(0),
+	transform_alpha(-1.0f),
+	occlusion_culler(nullptr),
+	occlusion_buffer_width(256),
+	occlusion_buffer_height(128),
+	viewport_height(1080.0f)
 {
 	// Setup billboard render operation
 	billboard_op.pose = nullptr;
@@ -42,10 +55,21 @@ renderer::renderer()
 	billboard_op.start_index = 0;
 	billboard_op.index_count = 6;
 	billboard_op.instance_count = 0;
+	billboard_op.indexed = false;
+	billboard_op.index_type = gl::element_array_type::uint_32;
+	billboard_op.culling_volume = nullptr;
+}
+
+renderer::~renderer()
+{
+	delete occlusion_culler;
 }
 
 void renderer::render(float alpha, const scene::collection& collection) const
 {
+	// Interpolate the transforms of all scene objects, unless they were already interpolated for this frame
+	interpolate_transforms(alpha);
+	
 	// Get list of all objects in the collection
 	const std::list<scene::object_base*>* objects = collection.get_objects();
 	
@@ -85,11 +109,13 @@ void renderer::render(float alpha, const scene::collection& collection) const
 		// Setup render context
 		render_context context;
 		context.camera = camera;
-		context.camera_transform = camera->get_transform_tween().interpolate(alpha); 
+		context.camera_transform = camera->interpolate_published_transform(alpha);
 		context.camera_forward = context.camera_transform.rotation * global_forward;
 		context.camera_up = context.camera_transform.rotation * global_up;
 		context.clip_near = camera->get_view_frustum().get_near(); ///< TODO: tween this
+		context.viewport_height = viewport_height;
 		context.collection = &collection;
+		context.transform_matrices = transform_matrices.data();
 		context.alpha = alpha;
 		
 		// Get camera culling volume
@@ -97,15 +123,29 @@ void renderer::render(float alpha, const scene::collection& collection) const
 		if (!context.camera_culling_volume)
 			context.camera_culling_volume = &camera->get_bounds();
 		
+		// Rasterize occluders, skipping occlusion tests if the camera sees none
+		context.occlusion_culler = nullptr;
+		if (occlusion_culler && rasterize_occluders(context))
+		{
+			context.occlusion_culler = occlusion_culler;
+		}
+		
 		// Generate render operations for each visible scene object
-		for (const scene::object_base* object: *objects)
+		if (context.camera_culling_volume->get_bounding_volume_type() == geom::bounding_volume_type::convex_hull)
 		{
-			// Skip inactive objects
-			if (!object->is_active())
-				continue;
-			
-			// Process object
-			process_object(context, object);
+			cull_objects(context, *objects);
+		}
+		else
+		{
+			for (const scene::object_base* object: *objects)
+			{
+				// Skip inactive objects
+				if (!object->is_active())
+					continue;
+				
+				// Process object
+				process_object(context, object);
+			}
 		}
 		
 		// Pass render context to the camera's compositor
@@ -118,16 +158,195 @@ void renderer::set_billboard_vao(gl::vertex_array* vao)
 	billboard_op.vertex_array = vao;
 }
 
+void renderer::set_occlusion_culling_enabled(bool enabled)
+{
+	if (enabled && !occlusion_culler)
+	{
+		occlusion_culler = new ::occlusion_culler(occlusion_buffer_width, occlusion_buffer_height);
+	}
+	else if (!enabled && occlusion_culler)
+	{
+		delete occlusion_culler;
+		occlusion_culler = nullptr;
+	}
+}
+
+void renderer::set_occlusion_buffer_resolution(int width, int height)
+{
+	occlusion_buffer_width = width;
+	occlusion_buffer_height = height;
+	
+	if (occlusion_culler)
+	{
+		occlusion_culler->resize(width, height);
+	}
+}
+
+void renderer::set_viewport_height(float height)
+{
+	viewport_height = height;
+}
+
+void renderer::interpolate_transforms(float alpha) const
+{
+	// Render from the transform tweens published by the last snapshot, so that rendering never reads the live transform store
+	const scene::object_base::transform_store_type& transforms = scene::object_base::get_published_transform_store();
+	const scene::object_base::transform_store_type& current_transforms = scene::object_base::get_transform_store();
+	const std::size_t count = std::max(transforms.size(), current_transforms.size());
+	if (alpha == transform_alpha && transforms.get_revision() == transform_revision && transform_matrices.size() == count)
+		return;
+	
+	// Interpolate all published transforms, then convert them to matrices in a single batch
+	interpolated_transforms.resize(count);
+	transform_matrices.resize(count);
+	transforms.interpolate
+	(
+		alpha,
+		interpolated_transforms.data(),
+		[](const math::transform<float>& transform) -> math::transform<float>
+		{
+			return transform;
+		}
+	);
+	
+	// Interpolate the transforms of objects created since the tweens were published
+	for (std::size_t i = transforms.size(); i < count; ++i)
+		interpolated_transforms[i] = current_transforms.interpolate(i, alpha);
+	
+	math::matrix_cast(interpolated_transforms.data(), transform_matrices.data(), interpolated_transforms.size());
+	
+	transform_alpha = alpha;
+	transform_revision = transforms.get_revision();
+}
+
+bool renderer::rasterize_occluders(render_context& context) const
+{
+	bool cleared = false;
+	
+	const std::list<scene::object_base*>* model_instances = context.collection->get_objects(scene::model_instance::object_type_id);
+	for (const scene::object_base* object: *model_instances)
+	{
+		if (!object->is_active())
+			continue;
+		
+		// Skip models without occluder triangles
+		const scene::model_instance* model_instance = static_cast<const scene::model_instance*>(object);
+		const model* model = model_instance->get_model();
+		if (!model || !model->is_occluder() || model_instance->get_instance_count())
+			continue;
+		
+		// Skip occluders outside of the view frustum
+		const geom::bounding_volume<float>* object_culling_volume = model_instance->get_culling_mask();
+		if (!object_culling_volume)
+			object_culling_volume = &model_instance->get_bounds();
+		if (!context.camera_culling_volume->intersects(*object_culling_volume))
+			continue;
+		
+		// Clear the depth buffer once the first occluder is found
+		if (!cleared)
+		{
+			occlusion_culler->clear(context.camera->get_view_projection_tween().interpolate(context.alpha));
+			cleared = true;
+		}
+		
+		const std::vector<float3>& positions = model->get_occluder_positions();
+		const std::vector<std::uint32_t>& indices = model->get_occluder_indices();
+		const float4x4& transform = context.transform_matrices[model_instance->get_transform_index()];
+		occlusion_culler->rasterize(positions.data(), indices.data(), indices.size(), transform);
+	}
+	
+	if (cleared)
+	{
+		occlusion_culler->update_hierarchy();
+	}
+	
+	return cleared;
+}
+
+void renderer::cull_objects(render_context& context, const std::list<scene::object_base*>& objects) const
+{
+	const geom::convex_hull<float>& camera_hull = static_cast<const geom::convex_hull<float>&>(*context.camera_culling_volume);
+	
+	culling_aabbs.clear();
+	culling_aabb_objects.clear();
+	culling_spheres.clear();
+	culling_sphere_objects.clear();
+	
+	// Sort the culling volumes of models and billboards into arrays of AABBs and spheres
+	for (const scene::object_base* object: objects)
+	{
+		// Skip inactive objects
+		if (!object->is_active())
+			continue;
+		
+		// Process other objects, and objects with other types of culling volumes, individually
+		const std::size_t type = object->get_object_type_id();
+		if (type != scene::model_instance::object_type_id && type != scene::billboard::object_type_id)
+		{
+			process_object(context, object);
+			continue;
+		}
+		
+		const geom::bounding_volume<float>* object_culling_volume = get_culling_volume(object);
+		switch (object_culling_volume->get_bounding_volume_type())
+		{
+			case geom::bounding_volume_type::aabb:
+				culling_aabbs.push_back(static_cast<const geom::aabb<float>&>(*object_culling_volume));
+				culling_aabb_objects.push_back(object);
+				break;
+			
+			case geom::bounding_volume_type::sphere:
+				culling_spheres.push_back(static_cast<const geom::sphere<float>&>(*object_culling_volume));
+				culling_sphere_objects.push_back(object);
+				break;
+			
+			default:
+				process_object(context, object);
+				break;
+		}
+	}
+	
+	// Cull AABBs against the view frustum and process the visible objects
+	geom::cull(camera_hull, culling_aabbs, culling_mask);
+	for (std::size_t i = 0; i < culling_aabb_objects.size(); ++i)
+	{
+		if ((culling_mask[i / 64] >> (i % 64)) & 1)
+			process_visible_object(context, culling_aabb_objects[i]);
+	}
+	
+	// Cull spheres against the view frustum and process the visible objects
+	geom::cull(camera_hull, culling_spheres, culling_mask);
+	for (std::size_t i = 0; i < culling_sphere_objects.size(); ++i)
+	{
+		if ((culling_mask[i / 64] >> (i % 64)) & 1)
+			process_visible_object(context, culling_sphere_objects[i]);
+	}
+}
+
 void renderer::process_object(render_context& context, const scene::object_base* object) const
 {
 	std::size_t type = object->get_object_type_id();
 	
+	if (type == scene::lod_group::object_type_id)
+	{
+		process_lod_group(context, static_cast<const scene::lod_group*>(object));
+	}
+	else if (type == scene::model_instance::object_type_id || type == scene::billboard::object_type_id)
+	{
+		// Perform view-frustum culling
+		if (context.camera_culling_volume->intersects(*get_culling_volume(object)))
+			process_visible_object(context, object);
+	}
+}
+
+void renderer::process_visible_object(render_context& context, const scene::object_base* object) const
+{
+	std::size_t type = object->get_object_type_id();
+	
 	if (type == scene::model_instance::object_type_id)
 		process_model_instance(context, static_cast<const scene::model_instance*>(object));
-	else if (type == scene::billboard::object_type_id)		
+	else if (type == scene::billboard::object_type_id)
 		process_billboard(context, static_cast<const scene::billboard*>(object));
-	else if (type == scene::lod_group::object_type_id)
-		process_lod_group(context, static_cast<const scene::lod_group*>(object));
 }
 
 void renderer::process_model_instance(render_context& context, const scene::model_instance* model_instance) const
@@ -136,17 +355,14 @@ void renderer::process_model_instance(render_context& context, const scene::mode
 	if (!model)
 		return;
 	
-	// Get object culling volume
-	const geom::bounding_volume<float>* object_culling_volume = model_instance->get_culling_mask();
-	if (!object_culling_volume)
-		object_culling_volume = &model_instance->get_bounds();
+	const geom::bounding_volume<float>* object_culling_volume = get_culling_volume(model_instance);
 	
-	// Perform view-frustum culling
-	if (!context.camera_culling_volume->intersects(*object_culling_volume))
-		return;
+	// Perform occlusion culling
+	const bool occluded = context.occlusion_culler && !context.occlusion_culler->is_visible(*object_culling_volume);
 	
 	const std::vector<material*>* instance_materials = model_instance->get_materials();
 	const std::vector<model_group*>* groups = model->get_groups();
+	const float4x4 transform = context.transform_matrices[model_instance->get_transform_index()] * model->get_dequantization_transform();
 
 	for (model_group* group: *groups)
 	{
@@ -159,15 +375,22 @@ void renderer::process_model_instance(render_context& context, const scene::mode
 			// Override model group material with the instance's material 
 			operation.material = (*instance_materials)[group->get_index()];
 		}
+		
+		// Skip occluded groups, unless their material is visible through occluders
+		if (occluded && !(operation.material && (operation.material->get_flags() & MATERIAL_FLAG_X_RAY)))
+			continue;
 
 		operation.pose = model_instance->get_pose();
 		operation.vertex_array = model->get_vertex_array();
 		operation.drawing_mode = group->get_drawing_mode();
 		operation.start_index = group->get_start_index();
 		operation.index_count = group->get_index_count();
-		operation.transform = math::matrix_cast(model_instance->get_transform_tween().interpolate(context.alpha));
+		operation.transform = transform;
 		operation.depth = context.clip_near.signed_distance(math::resize<3>(operation.transform[3]));
 		operation.instance_count = model_instance->get_instance_count();
+		operation.indexed = model->is_indexed();
+		operation.index_type = model->get_index_type();
+		operation.culling_volume = object_culling_volume;
 
 		context.operations.push_back(operation);
 	}
@@ -175,17 +398,19 @@ void renderer::process_model_instance(render_context& context, const scene::mode
 
 void renderer::process_billboard(render_context& context, const scene::billboard* billboard) const
 {
-	// Get object culling volume
-	const geom::bounding_volume<float>* object_culling_volume = billboard->get_culling_mask();
-	if (!object_culling_volume)
-		object_culling_volume = &billboard->get_bounds();
+	const geom::bounding_volume<float>* object_culling_volume = get_culling_volume(billboard);
 	
-	// Perform view-frustum culling
-	if (!context.camera_culling_volume->intersects(*object_culling_volume))
-		return;
+	// Perform occlusion culling, unless the billboard's material is visible through occluders
+	const ::material* billboard_material = billboard->get_material();
+	if (context.occlusion_culler && !(billboard_material && (billboard_material->get_flags() & MATERIAL_FLAG_X_RAY)))
+	{
+		if (!context.occlusion_culler->is_visible(*object_culling_volume))
+			return;
+	}
 	
-	math::transform<float> billboard_transform = billboard->get_transform_tween().interpolate(context.alpha);
+	math::transform<float> billboard_transform = billboard->interpolate_published_transform(context.alpha);
 	billboard_op.material = billboard->get_material();
+	billboard_op.culling_volume = object_culling_volume;
 	billboard_op.depth = context.clip_near.signed_distance(math::resize<3>(billboard_transform.translation));
 	
 	// Align billboard
@@ -211,7 +436,7 @@ void renderer::process_billboard(render_context& context, const scene::billboard
 void renderer::process_lod_group(render_context& context, const scene::lod_group* lod_group) const
 {
 	// Select level of detail
-	std::size_t level = lod_group->select_lod(*context.camera);
+	std::size_t level = lod_group->select_lod(*context.camera, viewport_height);
 	
 	// Process all objects in the group with the selected level of detail
 	const std::list<scene::object_base*>& objects = lod_group->get_objects(level);
@@ -220,3 +445,11 @@ void renderer::process_lod_group(render_context& context, const scene::lod_group
 		process_object(context, object);
 	}
 }
+
+const geom::bounding_volume<float>* get_culling_volume(const scene::object_base* object)
+{
+	const geom::bounding_volume<float>* culling_volume = object->get_culling_mask();
+	if (!culling_volume)
+		culling_volume = &object->get_bounds();
+	return culling_volume;
+}
@@ -22,8 +22,15 @@
 
 #include "render-operation.hpp"
 #include "gl/vertex-array.hpp"
+#include "geom/culling.hpp"
+#include "math/transform-type.hpp"
+#include "utility/fundamental-types.hpp"
+#include <cstdint>
+#include <list>
+#include <vector>
 
 struct render_context;
+class occlusion_culler;
 
 namespace scene
 {
@@ -38,11 +45,12 @@ namespace scene
 # Pipeline
 
 1. A scene containing meshes, lights, and cameras is passed to renderer::render().
-2. Each camera is processed in order of priority.
-3. Scene objects are tested for visibility against camera's view frustum.
-4. List of visible scene objects are passed to the camera's compositor.
-5. Compositor passes the visible scene objects to each render pass
-6. Render pass sorts scene objects according to its own rules, then rasterizes to its render target.
+2. The transforms of all scene objects are interpolated into an array of matrices, which is reused by every camera and render pass of the frame.
+3. Each camera is processed in order of priority.
+4. Scene objects are tested for visibility against camera's view frustum, in bulk over arrays of their bounding volumes, then against the occluders rasterized for the camera.
+5. List of visible scene objects are passed to the camera's compositor.
+6. Compositor passes the visible scene objects to each render pass
+7. Render pass sorts scene objects according to its own rules, then rasterizes to its render target.
 */
 
 /**
@@ -52,6 +60,7 @@ class renderer
 {
 public:
 	renderer();
+	~renderer();
 	
 	/**
 	 * Renders a collection of scene objects.
@@ -66,13 +75,52 @@ public:
 	 */
 	void set_billboard_vao(gl::vertex_array* vao);
 	
+	/**
+	 * Enables or disables software occlusion culling. When enabled, the occluder triangles of visible models are rasterized into a low-resolution depth buffer for each camera, and objects hidden behind them are not rendered. Cameras which see no occluders skip the occlusion test.
+	 *
+	 * @param enabled `true` if occlusion culling should be enabled, `false` otherwise.
+	 */
+	void set_occlusion_culling_enabled(bool enabled);
+	
+	/**
+	 * Sets the resolution of the occlusion culling depth buffer.
+	 *
+	 * @param width Width of the depth buffer, in pixels.
+	 * @param height Height of the depth buffer, in pixels.
+	 */
+	void set_occlusion_buffer_resolution(int width, int height);
+	
+	/**
+	 * Sets the height of the viewport, which is used to measure the screen-space error of LOD groups.
+	 *
+	 * @param height Viewport height, in pixels.
+	 */
+	void set_viewport_height(float height);
+	
 private:
+	void interpolate_transforms(float alpha) const;
+	bool rasterize_occluders(render_context& context) const;
+	void cull_objects(render_context& context, const std::list<scene::object_base*>& objects) const;
 	void process_object(render_context& context, const scene::object_base* object) const;
+	void process_visible_object(render_context& context, const scene::object_base* object) const;
 	void process_model_instance(render_context& context, const scene::model_instance* model_instance) const;
 	void process_billboard(render_context& context, const scene::billboard* billboard) const;
 	void process_lod_group(render_context& context, const scene::lod_group* lod_group) const;
 
 	mutable render_operation billboard_op;
+	mutable geom::aabb_array<float> culling_aabbs;
+	mutable geom::sphere_array<float> culling_spheres;
+	mutable std::vector<const scene::object_base*> culling_aabb_objects;
+	mutable std::vector<const scene::object_base*> culling_sphere_objects;
+	mutable std::vector<std::uint64_t> culling_mask;
+	mutable std::vector<math::transform<float>> interpolated_transforms;
+	mutable std::vector<float4x4> transform_matrices;
+	mutable std::size_t transform_revision;
+	mutable float transform_alpha;
+	occlusion_culler* occlusion_culler;
+	int occlusion_buffer_width;
+	int occlusion_buffer_height;
+	float viewport_height;
 };
 
 #endif // ANTKEEPER_RENDERER_HPP
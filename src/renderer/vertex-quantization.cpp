@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "renderer/vertex-quantization.hpp"
+#include "math/constants.hpp"
+#include "math/vector-operators.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static float quantization_scale(const geom::aabb<float>& bounds);
+
+std::uint16_t encode_float_16(float x)
+{
+	std::uint32_t bits;
+	std::memcpy(&bits, &x, sizeof(bits));
+	
+	const std::uint16_t sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000);
+	const std::uint32_t magnitude = bits & 0x7fffffff;
+	
+	// NaN
+	if (magnitude > 0x7f800000)
+		return sign | 0x7e00;
+	
+	const int exponent = static_cast<int>(magnitude >> 23) - 127 + 15;
+	std::uint32_t mantissa = magnitude & 0x7fffff;
+	
+	// Overflow to infinity
+	if (exponent >= 31)
+		return sign | 0x7c00;
+	
+	// Subnormal or underflow to zero
+	if (exponent <= 0)
+	{
+		if (exponent < -10)
+			return sign;
+		
+		mantissa |= 0x800000;
+		const int shift = 14 - exponent;
+		std::uint32_t half = mantissa >> shift;
+		if ((mantissa >> (shift - 1)) & 1)
+			++half;
+		
+		return sign | static_cast<std::uint16_t>(half);
+	}
+	
+	// Normal, rounding may carry into the exponent
+	std::uint32_t half = (static_cast<std::uint32_t>(exponent) << 10) | (mantissa >> 13);
+	if (mantissa & 0x1000)
+		++half;
+	
+	return sign | static_cast<std::uint16_t>(half);
+}
+
+std::int8_t encode_snorm_8(float x)
+{
+	return static_cast<std::int8_t>(std::lround(std::clamp(x, -1.0f, 1.0f) * 127.0f));
+}
+
+std::uint8_t encode_unorm_8(float x)
+{
+	return static_cast<std::uint8_t>(std::lround(std::clamp(x, 0.0f, 1.0f) * 255.0f));
+}
+
+std::int16_t encode_snorm_16(float x)
+{
+	return static_cast<std::int16_t>(std::lround(std::clamp(x, -1.0f, 1.0f) * 32767.0f));
+}
+
+void encode_position(std::int16_t* destination, const float3& position, const geom::aabb<float>& bounds)
+{
+	const float3 center = (bounds.min_point + bounds.max_point) * 0.5f;
+	const float inverse_scale = 1.0f / quantization_scale(bounds);
+	
+	destination[0] = encode_snorm_16((position.x - center.x) * inverse_scale);
+	destination[1] = encode_snorm_16((position.y - center.y) * inverse_scale);
+	destination[2] = encode_snorm_16((position.z - center.z) * inverse_scale);
+}
+
+float4x4 position_dequantization_transform(const geom::aabb<float>& bounds)
+{
+	const float3 center = (bounds.min_point + bounds.max_point) * 0.5f;
+	const float scale = quantization_scale(bounds);
+	
+	float4x4 transform = math::identity4x4<float>;
+	transform[0][0] = scale;
+	transform[1][1] = scale;
+	transform[2][2] = scale;
+	transform[3] = {center.x, center.y, center.z, 1.0f};
+	
+	return transform;
+}
+
+void encode_barycentric(std::uint8_t* destination, const float3& barycentric)
+{
+	destination[0] = encode_unorm_8(barycentric.x);
+	destination[1] = encode_unorm_8(barycentric.y);
+	destination[2] = encode_unorm_8(barycentric.z);
+	destination[3] = 0;
+}
+
+float quantization_scale(const geom::aabb<float>& bounds)
+{
+	const float3 extent = (bounds.max_point - bounds.min_point) * 0.5f;
+	const float scale = std::max(extent.x, std::max(extent.y, extent.z));
+	return (scale > 0.0f) ? scale : 1.0f;
+}
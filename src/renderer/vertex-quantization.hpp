@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2021  Christopher J. Howard
+ *
+ * This file is part of Antkeeper source code.
+ *
+ * Antkeeper source code is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Antkeeper source code is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Antkeeper source code.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANTKEEPER_VERTEX_QUANTIZATION_HPP
+#define ANTKEEPER_VERTEX_QUANTIZATION_HPP
+
+#include "geom/aabb.hpp"
+#include "utility/fundamental-types.hpp"
+#include <cstdint>
+
+/**
+ * Converts a single-precision floating-point number to a half-precision floating-point number, rounding to nearest.
+ *
+ * @param x Single-precision value.
+ * @return Bits of the half-precision value.
+ */
+std::uint16_t encode_float_16(float x);
+
+/**
+ * Encodes a value in `[-1, 1]` as a signed normalized 8-bit integer.
+ */
+std::int8_t encode_snorm_8(float x);
+
+/**
+ * Encodes a value in `[0, 1]` as an unsigned normalized 8-bit integer.
+ */
+std::uint8_t encode_unorm_8(float x);
+
+/**
+ * Encodes a value in `[-1, 1]` as a signed normalized 16-bit integer.
+ */
+std::int16_t encode_snorm_16(float x);
+
+/**
+ * Encodes a position as three signed normalized 16-bit integers, relative to the center of a bounding box and scaled uniformly by the largest half-extent of the box.
+ *
+ * @param[out] destination Array of three integers.
+ * @param position Position to encode.
+ * @param bounds Bounds of the quantized positions.
+ *
+ * @see position_dequantization_transform(const geom::aabb<float>&)
+ */
+void encode_position(std::int16_t* destination, const float3& position, const geom::aabb<float>& bounds);
+
+/**
+ * Returns the transform which maps positions encoded by encode_position() back into model space. As the scale is uniform, normal matrices derived from a model transform multiplied by this transform remain valid up to normalization.
+ *
+ * @param bounds Bounds of the quantized positions.
+ */
+float4x4 position_dequantization_transform(const geom::aabb<float>& bounds);
+
+/**
+ * Encodes barycentric coordinates as three unsigned normalized 8-bit integers, followed by a padding byte.
+ *
+ * @param[out] destination Array of four integers.
+ * @param barycentric Barycentric coordinates.
+ */
+void encode_barycentric(std::uint8_t* destination, const float3& barycentric);
+
+#endif // ANTKEEPER_VERTEX_QUANTIZATION_HPP
@@ -45,6 +45,9 @@ static bool load_component_behavior(entity::archetype& archetype, resource_manag
 	std::string filename = parameters[1];
 	entity::component::behavior component;
 	component.behavior_tree = resource_manager.load<entity::ebt::node>(filename);
+	component.idle_ticks = 0;
+	component.phase = 0;
+	component.idle_time = 0.0;
 	if (!component.behavior_tree)
 	{
 		std::string message = std::string("load_component_behavior(): Failed to load behavior tree \"") + filename + std::string("\"");
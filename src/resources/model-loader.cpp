@@ -20,10 +20,13 @@
 #include "resources/resource-loader.hpp"
 #include "resources/resource-manager.hpp"
 #include "renderer/model.hpp"
+#include "renderer/geometry-optimization.hpp"
+#include "renderer/vertex-quantization.hpp"
 #include "renderer/vertex-attributes.hpp"
 #include "gl/vertex-attribute-type.hpp"
 #include "gl/drawing-mode.hpp"
 #include "utility/fundamental-types.hpp"
+#include <cstring>
 #include <sstream>
 #include <stdexcept>
 #include <limits>
@@ -31,6 +34,28 @@
 #include <iostream>
 #include <nlohmann/json.hpp>
 
+/// Layout of a quantized vertex attribute.
+struct quantized_attribute
+{
+	/// Name of the attribute.
+	std::string name;
+	
+	/// Offset of the attribute in the source vertex, in floats.
+	std::size_t source_offset;
+	
+	/// Number of components bound to the attribute location.
+	std::size_t size;
+	
+	/// Component type of the quantized attribute.
+	gl::vertex_attribute_type type;
+	
+	/// Offset of the attribute in the quantized vertex, in bytes.
+	std::size_t offset;
+	
+	/// Size of the quantized attribute, including padding, in bytes.
+	std::size_t stride;
+};
+
 static const float3 barycentric_coords[3] =
 {
 	float3{1, 0, 0},
@@ -430,25 +455,45 @@ model* resource_loader<model>::load(resource_manager* resource_manager, PHYSFS_F
 		}
 	}
 	
+	// Load geometric error of simplified models
+	float error = 0.0f;
+	if (auto error_node = json.find("error"); error_node != json.end())
+		error = error_node.value().get<float>();
+	
 	// Allocate a model
 	model* model = new ::model();
 	
-	// Set the model bounds
+	// Set the model bounds and error
 	model->set_bounds(bounds);
+	model->set_error(error);
 	
-	// Calculate vertex size, count, and stride
+	// Calculate vertex size and count, and locate the position and barycentric attributes
 	std::size_t vertex_size = 0;
 	std::size_t vertex_count = 0;
+	std::size_t position_offset = 0;
+	std::size_t barycentric_offset = 0;
+	bool has_position = false;
+	bool has_barycentric = false;
 	for (auto it = attributes.begin(); it != attributes.end(); ++it)
 	{
+		if (it->first == "position")
+		{
+			position_offset = vertex_size;
+			has_position = true;
+		}
+		else if (it->first == "barycentric")
+		{
+			barycentric_offset = vertex_size;
+			has_barycentric = true;
+		}
+		
 		vertex_size += std::get<0>(it->second);
 		vertex_count = std::get<1>(it->second).size() / std::get<0>(it->second);
 	}
-	std::size_t vertex_stride = sizeof(float) * vertex_size;
 	
 	// Build interleaved vertex data buffer
-	float* vertex_data = new float[vertex_size * vertex_count];
-	float* v = &vertex_data[0];
+	std::vector<float> vertex_data(vertex_size * vertex_count);
+	float* v = vertex_data.data();
 	for (std::size_t i = 0; i < vertex_count; ++i)
 	{
 		for (auto it = attributes.begin(); it != attributes.end(); ++it)
@@ -461,12 +506,50 @@ model* resource_loader<model>::load(resource_manager* resource_manager, PHYSFS_F
 		}
 	}
 	
-	// Resize VBO and upload vertex data
-	gl::vertex_buffer* vbo = model->get_vertex_buffer();
-	vbo->resize(sizeof(float) * vertex_size * vertex_count, vertex_data);
+	// Clear barycentric coordinates, which are reassigned after vertices are welded
+	if (has_barycentric)
+	{
+		for (std::size_t i = 0; i < vertex_count; ++i)
+			std::fill_n(vertex_data.begin() + i * vertex_size + barycentric_offset, 3, 0.0f);
+	}
 	
-	// Free interleaved vertex data buffer
-	delete[] vertex_data;
+	// Weld duplicate vertices of the triangle list into indexed vertices
+	std::vector<std::uint32_t> indices(vertex_count);
+	std::size_t indexed_vertex_count = weld_vertices(indices.data(), vertex_data.data(), vertex_size, vertex_count);
+	std::vector<float> indexed_vertex_data(vertex_size * indexed_vertex_count);
+	remap_vertices(indexed_vertex_data.data(), vertex_data.data(), vertex_size, vertex_count, indices.data());
+	
+	// Optimize the triangle order of each material group for the vertex cache and overdraw. Triangles are only reordered within their group, so the group ranges of the model file remain valid.
+	if (auto materials_node = json.find("materials"); materials_node != json.end())
+	{
+		for (const auto& material_node: materials_node.value().items())
+		{
+			std::size_t group_offset = 0;
+			std::size_t group_size = 0;
+			if (auto offset_node = material_node.value().find("offset"); offset_node != material_node.value().end())
+				group_offset = offset_node.value().get<std::size_t>();
+			if (auto size_node = material_node.value().find("size"); size_node != material_node.value().end())
+				group_size = size_node.value().get<std::size_t>();
+			if ((group_offset + group_size) * 3 > indices.size())
+				continue;
+			
+			std::uint32_t* group_indices = indices.data() + group_offset * 3;
+			optimize_vertex_cache(group_indices, group_size * 3, indexed_vertex_count);
+			if (has_position)
+				optimize_overdraw(group_indices, group_size * 3, indexed_vertex_data.data() + position_offset, vertex_size, indexed_vertex_count);
+		}
+	}
+	
+	// Reassign barycentric coordinates along the optimized triangle order
+	if (has_barycentric)
+		indexed_vertex_count = assign_barycentric_coordinates(indexed_vertex_data, vertex_size, barycentric_offset, indices.data(), indices.size());
+	
+	// Order vertices by first use
+	std::vector<std::uint32_t> fetch_remap(indexed_vertex_count);
+	const std::size_t fetched_vertex_count = optimize_vertex_fetch(fetch_remap.data(), indices.data(), indices.size(), indexed_vertex_count);
+	vertex_data.resize(vertex_size * fetched_vertex_count);
+	remap_vertices(vertex_data.data(), indexed_vertex_data.data(), vertex_size, indexed_vertex_count, fetch_remap.data());
+	remap_indices(indices.data(), indices.size(), fetch_remap.data());
 	
 	// Map attribute names to locations
 	static const std::unordered_map<std::string, unsigned int> attribute_location_map =
@@ -481,18 +564,112 @@ model* resource_loader<model>::load(resource_manager* resource_manager, PHYSFS_F
 		{"barycentric", VERTEX_BARYCENTRIC_LOCATION}
 	};
 	
-	// Bind attributes to VAO
-	gl::vertex_array* vao = model->get_vertex_array();
-	std::size_t offset = 0;
-	for (auto attribute_it = attributes.begin(); attribute_it != attributes.end(); ++attribute_it)
+	// Choose a quantized format for each attribute. Positions are stored relative to their bounds as normalized 16-bit integers, texture coordinates as half floats, and barycentric coordinates as normalized 8-bit integers, all of which shaders fetch as floats. Other attributes, including normals and tangents, remain 32-bit floats.
+	std::vector<quantized_attribute> quantized_attributes;
+	std::size_t quantized_vertex_stride = 0;
+	std::size_t source_offset = 0;
+	for (auto it = attributes.begin(); it != attributes.end(); ++it)
 	{
-		std::string attribute_name = attribute_it->first;
-		std::size_t attribute_size = std::get<0>(attribute_it->second);
+		const std::size_t attribute_size = std::get<0>(it->second);
+		
+		quantized_attribute attribute;
+		attribute.name = it->first;
+		attribute.source_offset = source_offset;
+		attribute.size = attribute_size;
+		attribute.type = gl::vertex_attribute_type::float_32;
+		attribute.stride = sizeof(float) * attribute_size;
+		
+		if (attribute.name == "position" && attribute_size == 3)
+		{
+			attribute.type = gl::vertex_attribute_type::snorm_16;
+			attribute.stride = sizeof(std::int16_t) * 4;
+		}
+		else if (attribute.name == "texcoord" && attribute_size == 2)
+		{
+			attribute.type = gl::vertex_attribute_type::float_16;
+			attribute.stride = sizeof(std::uint16_t) * 2;
+		}
+		else if (attribute.name == "barycentric" && attribute_size == 3)
+		{
+			attribute.type = gl::vertex_attribute_type::unorm_8;
+			attribute.stride = sizeof(std::uint8_t) * 4;
+		}
+		
+		attribute.offset = quantized_vertex_stride;
+		quantized_vertex_stride += attribute.stride;
+		source_offset += attribute_size;
 		
-		if (auto location_it = attribute_location_map.find(attribute_name); location_it != attribute_location_map.end())
-			vao->bind_attribute(location_it->second, *vbo, attribute_size, gl::vertex_attribute_type::float_32, vertex_stride, offset);
+		quantized_attributes.push_back(attribute);
+	}
+	
+	// Calculate bounds of vertex positions
+	geom::aabb<float> position_bounds = {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}};
+	if (has_position && fetched_vertex_count)
+	{
+		const float* p = vertex_data.data() + position_offset;
+		position_bounds = {{p[0], p[1], p[2]}, {p[0], p[1], p[2]}};
+		for (std::size_t i = 1; i < fetched_vertex_count; ++i)
+		{
+			p += vertex_size;
+			for (std::size_t j = 0; j < 3; ++j)
+			{
+				position_bounds.min_point[j] = std::min<float>(position_bounds.min_point[j], p[j]);
+				position_bounds.max_point[j] = std::max<float>(position_bounds.max_point[j], p[j]);
+			}
+		}
+	}
+	
+	// Encode vertex data
+	std::vector<std::uint8_t> quantized_vertex_data(quantized_vertex_stride * fetched_vertex_count, 0);
+	for (std::size_t i = 0; i < fetched_vertex_count; ++i)
+	{
+		const float* source = vertex_data.data() + vertex_size * i;
+		std::uint8_t* destination = quantized_vertex_data.data() + quantized_vertex_stride * i;
 		
-		offset += attribute_size * sizeof(float);
+		for (const quantized_attribute& attribute: quantized_attributes)
+		{
+			const float* a = source + attribute.source_offset;
+			std::uint8_t* b = destination + attribute.offset;
+			
+			if (attribute.type == gl::vertex_attribute_type::float_32)
+			{
+				std::memcpy(b, a, attribute.stride);
+			}
+			else if (attribute.name == "position")
+			{
+				std::int16_t position[3];
+				encode_position(position, {a[0], a[1], a[2]}, position_bounds);
+				std::memcpy(b, position, sizeof(position));
+			}
+			else if (attribute.name == "texcoord")
+			{
+				const std::uint16_t texcoord[2] = {encode_float_16(a[0]), encode_float_16(a[1])};
+				std::memcpy(b, texcoord, sizeof(texcoord));
+			}
+			else if (attribute.name == "barycentric")
+			{
+				encode_barycentric(b, {a[0], a[1], a[2]});
+			}
+		}
+	}
+	
+	// Dequantize positions with the model transform
+	if (has_position)
+		model->set_dequantization_transform(position_dequantization_transform(position_bounds));
+	
+	// Resize VBO and upload vertex data
+	gl::vertex_buffer* vbo = model->get_vertex_buffer();
+	vbo->resize(quantized_vertex_data.size(), quantized_vertex_data.data());
+	
+	// Upload indices
+	model->set_indices(indices.data(), indices.size(), fetched_vertex_count);
+	
+	// Bind attributes to VAO
+	gl::vertex_array* vao = model->get_vertex_array();
+	for (const quantized_attribute& attribute: quantized_attributes)
+	{
+		if (auto location_it = attribute_location_map.find(attribute.name); location_it != attribute_location_map.end())
+			vao->bind_attribute(location_it->second, *vbo, attribute.size, attribute.type, quantized_vertex_stride, attribute.offset);
 	}
 	
 	// Load materials
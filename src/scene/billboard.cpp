@@ -66,9 +66,8 @@ void billboard::transformed()
 	bounds = aabb_type::transform(untransformed_bounds, get_transform());
 }
 
-void billboard::update_tweens()
+void billboard::update_object_tweens()
 {
-	object_base::update_tweens();
 	if (material)
 	{
 		material->update_tweens();
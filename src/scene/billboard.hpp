@@ -66,8 +66,10 @@ public:
 	material* get_material() const;
 	billboard_type get_billboard_type() const;
 	const float3& get_alignment_axis() const;
-	
-	virtual void update_tweens();
+
+protected:
+	/// @copydoc object_base::update_object_tweens();
+	virtual void update_object_tweens();
 
 private:
 	static const aabb_type untransformed_bounds;
@@ -27,7 +27,7 @@ namespace scene {
 
 static float4x4 interpolate_view(const camera* camera, const float4x4& x, const float4x4& y, float a)
 {
-	math::transform<float> transform = camera->get_transform_tween().interpolate(a);
+	math::transform<float> transform = camera->interpolate_published_transform(a);
 	float3 forward = transform.rotation * global_forward;
 	float3 up = transform.rotation * global_up;
 	return math::look_at(transform.translation, transform.translation + forward, up);
@@ -64,18 +64,18 @@ camera::camera():
 	compositor(nullptr),
 	composite_index(0),
 	orthographic(true),
-	clip_left(-1.0f, math::lerp<float, float>),
-	clip_right(1.0f, math::lerp<float, float>),
-	clip_bottom(-1.0f, math::lerp<float, float>),
-	clip_top(1.0f, math::lerp<float, float>),
-	clip_near(-1.0f, math::lerp<float, float>),
-	clip_far(1.0f, math::lerp<float, float>),
-	fov(math::half_pi<float>, math::lerp<float, float>),
-	aspect_ratio(1.0f, math::lerp<float, float>),
+	clip_left(-1.0f),
+	clip_right(1.0f),
+	clip_bottom(-1.0f),
+	clip_top(1.0f),
+	clip_near(-1.0f),
+	clip_far(1.0f),
+	fov(math::half_pi<float>),
+	aspect_ratio(1.0f),
 	view(math::identity4x4<float>, std::bind(&interpolate_view, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)),
 	projection(math::identity4x4<float>, std::bind(&interpolate_projection, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)),
 	view_projection(math::identity4x4<float>, std::bind(&interpolate_view_projection, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)),
-	exposure(0.0f, math::lerp<float, float>)
+	exposure(0.0f)
 {}
 
 float3 camera::project(const float3& object, const float4& viewport) const
@@ -159,9 +159,8 @@ void camera::set_composite_index(int index)
 	composite_index = index;
 }
 
-void camera::update_tweens()
+void camera::update_object_tweens()
 {
-	object_base::update_tweens();
 	clip_left.update();
 	clip_right.update();
 	clip_bottom.update();
@@ -120,21 +120,22 @@ public:
 	compositor* get_compositor();
 	int get_composite_index() const;
 
-	const tween<float>& get_clip_left_tween() const;
-	const tween<float>& get_clip_right_tween() const;
-	const tween<float>& get_clip_bottom_tween() const;
-	const tween<float>& get_clip_top_tween() const;
-	const tween<float>& get_clip_near_tween() const;
-	const tween<float>& get_clip_far_tween() const;
-	const tween<float>& get_fov_tween() const;
-	const tween<float>& get_aspect_ratio_tween() const;
+	const lerp_tween<float>& get_clip_left_tween() const;
+	const lerp_tween<float>& get_clip_right_tween() const;
+	const lerp_tween<float>& get_clip_bottom_tween() const;
+	const lerp_tween<float>& get_clip_top_tween() const;
+	const lerp_tween<float>& get_clip_near_tween() const;
+	const lerp_tween<float>& get_clip_far_tween() const;
+	const lerp_tween<float>& get_fov_tween() const;
+	const lerp_tween<float>& get_aspect_ratio_tween() const;
 	const tween<float4x4>& get_view_tween() const;
 	const tween<float4x4>& get_projection_tween() const;
 	const tween<float4x4>& get_view_projection_tween() const;
-	const tween<float>& get_exposure_tween() const;
+	const lerp_tween<float>& get_exposure_tween() const;
 
-	/// @copydoc object_base::update_tweens();
-	virtual void update_tweens();
+protected:
+	/// @copydoc object_base::update_object_tweens();
+	virtual void update_object_tweens();
 
 private:
 	virtual void transformed();
@@ -142,18 +143,18 @@ private:
 	compositor* compositor;
 	int composite_index;
 	bool orthographic;
-	tween<float> clip_left;
-	tween<float> clip_right;
-	tween<float> clip_bottom;
-	tween<float> clip_top;
-	tween<float> clip_near;
-	tween<float> clip_far;
-	tween<float> fov;
-	tween<float> aspect_ratio;
+	lerp_tween<float> clip_left;
+	lerp_tween<float> clip_right;
+	lerp_tween<float> clip_bottom;
+	lerp_tween<float> clip_top;
+	lerp_tween<float> clip_near;
+	lerp_tween<float> clip_far;
+	lerp_tween<float> fov;
+	lerp_tween<float> aspect_ratio;
 	tween<float4x4> view;
 	tween<float4x4> projection;
 	tween<float4x4> view_projection;
-	tween<float> exposure;
+	lerp_tween<float> exposure;
 	view_frustum_type view_frustum;
 };
 
@@ -248,42 +249,42 @@ inline int camera::get_composite_index() const
 	return composite_index;
 }
 
-inline const tween<float>& camera::get_clip_left_tween() const
+inline const lerp_tween<float>& camera::get_clip_left_tween() const
 {
 	return clip_left;
 }
 
-inline const tween<float>& camera::get_clip_right_tween() const
+inline const lerp_tween<float>& camera::get_clip_right_tween() const
 {
 	return clip_right;
 }
 
-inline const tween<float>& camera::get_clip_bottom_tween() const
+inline const lerp_tween<float>& camera::get_clip_bottom_tween() const
 {
 	return clip_bottom;
 }
 
-inline const tween<float>& camera::get_clip_top_tween() const
+inline const lerp_tween<float>& camera::get_clip_top_tween() const
 {
 	return clip_top;
 }
 
-inline const tween<float>& camera::get_clip_near_tween() const
+inline const lerp_tween<float>& camera::get_clip_near_tween() const
 {
 	return clip_near;
 }
 
-inline const tween<float>& camera::get_clip_far_tween() const
+inline const lerp_tween<float>& camera::get_clip_far_tween() const
 {
 	return clip_far;
 }
 
-inline const tween<float>& camera::get_fov_tween() const
+inline const lerp_tween<float>& camera::get_fov_tween() const
 {
 	return fov;
 }
 
-inline const tween<float>& camera::get_aspect_ratio_tween() const
+inline const lerp_tween<float>& camera::get_aspect_ratio_tween() const
 {
 	return aspect_ratio;
 }
@@ -303,7 +304,7 @@ inline const tween<float4x4>& camera::get_view_projection_tween() const
 	return view_projection;
 }
 
-inline const tween<float>& camera::get_exposure_tween() const
+inline const lerp_tween<float>& camera::get_exposure_tween() const
 {
 	return exposure;
 }
@@ -44,7 +44,7 @@ void collection::update_tweens()
 {
 	for (object_base* object: objects)
 	{
-		object->update_tweens();
+		object->update_object_tweens();
 	}
 }
 
@@ -50,7 +50,9 @@ public:
 	/// Removes all objects from the collection.
 	void remove_objects();
 	
-	/// Updates the tweens of all objects in the collection.
+	/**
+	 * Updates the tweens of all objects in the collection other than their transform tweens. The transform tweens of all scene objects are updated at once by object_base::update_transform_tweens().
+	 */
 	void update_tweens();
 
 	/// Returns a list of all objects in the collection.
@@ -33,8 +33,8 @@ static float3 interpolate_direction(const float3& x, const float3& y, float a)
 directional_light::directional_light():
 	direction(global_forward, interpolate_direction),
 	light_texture(nullptr),
-	light_texture_opacity(1.0f, math::lerp<float, float>),
-	light_texture_scale({1.0f, 1.0f}, math::lerp<float2, float>)
+	light_texture_opacity(1.0f),
+	light_texture_scale({1.0f, 1.0f})
 {}
 
 void directional_light::set_light_texture(const gl::texture_2d* texture)
@@ -52,9 +52,9 @@ void directional_light::set_light_texture_scale(const float2& scale)
 	light_texture_scale[1] = scale;
 }
 
-void directional_light::update_tweens()
+void directional_light::update_object_tweens()
 {
-	light::update_tweens();
+	light::update_object_tweens();
 	direction.update();
 	
 	if (light_texture)
@@ -75,21 +75,22 @@ public:
 	const tween<float3>& get_direction_tween() const;
 	
 	/// Returns the light texture opacity tween.
-	const tween<float>& get_light_texture_opacity_tween() const;
+	const lerp_tween<float>& get_light_texture_opacity_tween() const;
 	
 	/// Returns the light texture scale tween.
-	const tween<float2>& get_light_texture_scale_tween() const;
+	const lerp_tween<float2>& get_light_texture_scale_tween() const;
 
-	/// @copydoc object_base::update_tweens();
-	virtual void update_tweens();
+protected:
+	/// @copydoc object_base::update_object_tweens();
+	virtual void update_object_tweens();
 
 private:
 	virtual void transformed();
 
 	tween<float3> direction;
 	const gl::texture_2d* light_texture;
-	tween<float> light_texture_opacity;
-	tween<float2> light_texture_scale;
+	lerp_tween<float> light_texture_opacity;
+	lerp_tween<float2> light_texture_scale;
 };
 
 inline light_type directional_light::get_light_type() const
@@ -122,12 +123,12 @@ inline const tween<float3>& directional_light::get_direction_tween() const
 	return direction;
 }
 
-inline const tween<float>& directional_light::get_light_texture_opacity_tween() const
+inline const lerp_tween<float>& directional_light::get_light_texture_opacity_tween() const
 {
 	return light_texture_opacity;
 }
 
-inline const tween<float2>& directional_light::get_light_texture_scale_tween() const
+inline const lerp_tween<float2>& directional_light::get_light_texture_scale_tween() const
 {
 	return light_texture_scale;
 }
@@ -24,9 +24,9 @@ namespace scene {
 
 light::light():
 	bounds(get_translation(), 0.0f),
-	color(float3{1.0f, 1.0f, 1.0f}, math::lerp<float3, float>),
-	intensity(1.0f, math::lerp<float, float>),
-	scaled_color(float3{1.0f, 1.0f, 1.0f}, math::lerp<float3, float>)
+	color(float3{1.0f, 1.0f, 1.0f}),
+	intensity(1.0f),
+	scaled_color(float3{1.0f, 1.0f, 1.0f})
 {}
 
 void light::set_color(const float3& color)
@@ -41,9 +41,8 @@ void light::set_intensity(float intensity)
 	scaled_color[1] = color[1] * intensity;
 }
 
-void light::update_tweens()
+void light::update_object_tweens()
 {
-	object_base::update_tweens();
 	color.update();
 	intensity.update();
 	scaled_color.update();
@@ -82,19 +82,20 @@ public:
 	/// Returns the intensity-scaled light color.
 	const float3& get_scaled_color() const;
 
-	const tween<float3>& get_color_tween() const;
-	const tween<float>& get_intensity_tween() const;
-	const tween<float3>& get_scaled_color_tween() const;
+	const lerp_tween<float3>& get_color_tween() const;
+	const lerp_tween<float>& get_intensity_tween() const;
+	const lerp_tween<float3>& get_scaled_color_tween() const;
 
-	/// @copydoc object_base::update_tweens();
-	virtual void update_tweens();
+protected:
+	/// @copydoc object_base::update_object_tweens();
+	virtual void update_object_tweens();
 
 private:
 	virtual void transformed();
 	
-	tween<float3> color;
-	tween<float> intensity;
-	tween<float3> scaled_color;
+	lerp_tween<float3> color;
+	lerp_tween<float> intensity;
+	lerp_tween<float3> scaled_color;
 	sphere_type bounds;
 };
 
@@ -118,17 +119,17 @@ inline const float3& light::get_scaled_color() const
 	return scaled_color[1];
 }
 
-inline const tween<float3>& light::get_color_tween() const
+inline const lerp_tween<float3>& light::get_color_tween() const
 {
 	return color;
 }
 
-inline const tween<float>& light::get_intensity_tween() const
+inline const lerp_tween<float>& light::get_intensity_tween() const
 {
 	return intensity;
 }
 
-inline const tween<float3>& light::get_scaled_color_tween() const
+inline const lerp_tween<float3>& light::get_scaled_color_tween() const
 {
 	return scaled_color;
 }
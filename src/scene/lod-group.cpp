@@ -19,11 +19,16 @@
 
 #include "scene/lod-group.hpp"
 #include "scene/camera.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace scene {
 
 lod_group::lod_group(std::size_t level_count):
-	bounds(get_translation(), get_translation())
+	bounds(get_translation(), get_translation()),
+	max_screen_error(1.0f),
+	hysteresis(0.1f)
 {
 	resize(level_count);
 }
@@ -35,20 +40,75 @@ lod_group::lod_group():
 void lod_group::resize(std::size_t level_count)
 {
 	levels.resize(level_count);
+	level_errors.resize(level_count, std::numeric_limits<float>::infinity());
+	if (level_count)
+		level_errors[0] = 0.0f;
+	for (auto& camera_level: camera_levels)
+		camera_level.second = std::min(camera_level.second, level_count ? level_count - 1 : 0);
 }
 
-std::size_t lod_group::select_lod(const camera& camera) const
+void lod_group::set_level_error(std::size_t level, float error)
 {
-	float distance = camera.get_view_frustum().get_near().signed_distance(get_translation());
-	
-	if (distance < 300.0f)
+	level_errors[level] = error;
+}
+
+void lod_group::set_max_screen_error(float error)
+{
+	max_screen_error = error;
+}
+
+void lod_group::set_hysteresis(float hysteresis)
+{
+	this->hysteresis = hysteresis;
+}
+
+std::size_t lod_group::select_lod(const camera& camera, float viewport_height) const
+{
+	if (levels.size() < 2)
 		return 0;
-	else if (distance < 500.0f)
-		return 1;
-	else if (distance < 600.0f)
-		return 2;
 	
-	return 3;
+	// Determine the number of pixels per object space unit, at the distance of the group
+	float pixels_per_unit;
+	if (camera.is_orthographic())
+	{
+		pixels_per_unit = viewport_height / (camera.get_clip_top() - camera.get_clip_bottom());
+	}
+	else
+	{
+		const float distance = std::max(camera.get_view_frustum().get_near().signed_distance(get_translation()), camera.get_clip_near());
+		pixels_per_unit = viewport_height / (2.0f * std::tan(camera.get_fov() * 0.5f) * distance);
+	}
+	const float3& scale = get_scale();
+	pixels_per_unit *= std::max(std::max(scale.x, scale.y), scale.z);
+	
+	// Find the level last selected for this camera
+	auto camera_level = std::find_if
+	(
+		camera_levels.begin(),
+		camera_levels.end(),
+		[&camera](const std::pair<const scene::camera*, std::size_t>& pair) -> bool
+		{
+			return pair.first == &camera;
+		}
+	);
+	if (camera_level == camera_levels.end())
+		camera_level = camera_levels.insert(camera_levels.end(), {&camera, 0});
+	const std::size_t current_level = camera_level->second;
+	
+	// Select the coarsest level with an acceptable screen-space error
+	std::size_t level = 0;
+	for (std::size_t i = levels.size() - 1; i > 0; --i)
+	{
+		const float threshold = (i > current_level) ? max_screen_error * (1.0f - hysteresis) : max_screen_error;
+		if (level_errors[i] * pixels_per_unit <= threshold)
+		{
+			level = i;
+			break;
+		}
+	}
+	
+	camera_level->second = level;
+	return level;
 }
 
 void lod_group::add_object(std::size_t level, object_base* object)
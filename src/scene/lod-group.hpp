@@ -23,12 +23,20 @@
 #include "scene/object.hpp"
 #include "geom/aabb.hpp"
 #include <list>
+#include <utility>
 #include <vector>
 
 namespace scene {
 
 class camera;
 
+/**
+ * Group of scene objects with multiple levels of detail.
+ *
+ * Each level of detail has a geometric error, which is the maximum distance between its objects and the full-detail surface they approximate. The coarsest level whose error projects to no more than the maximum screen-space error is selected. A level is only coarsened once its error falls below the maximum by the hysteresis fraction, so groups near a threshold don't alternate between levels. The level last selected is remembered separately for each camera, so cameras with different views don't disturb each other's hysteresis.
+ *
+ * Levels other than `0` have infinite error until set_level_error() is called, so a group whose level errors are never set always selects level `0`.
+ */
 class lod_group: public object<lod_group>
 {
 public:
@@ -52,12 +60,37 @@ public:
 	void resize(std::size_t level_count);
 	
 	/**
-	 * Selects the appropriate level of detail for a camera.
+	 * Sets the geometric error of a level of detail. By default, level `0` has an error of `0`, and all other levels have infinite error, and are never selected until their error is set.
+	 *
+	 * @param level Level of detail.
+	 * @param error Maximum distance between the objects of the level and the full-detail surface, in object space units.
+	 *
+	 * @see model::get_error()
+	 */
+	void set_level_error(std::size_t level, float error);
+	
+	/**
+	 * Sets the maximum screen-space error of the selected level of detail.
+	 *
+	 * @param error Maximum projected geometric error, in pixels.
+	 */
+	void set_max_screen_error(float error);
+	
+	/**
+	 * Sets the fraction by which the projected error of a coarser level of detail must fall below the maximum screen-space error before it is selected.
+	 *
+	 * @param hysteresis Hysteresis fraction, on `[0, 1)`.
+	 */
+	void set_hysteresis(float hysteresis);
+	
+	/**
+	 * Selects the appropriate level of detail for a camera, and remembers it as the camera's current level for hysteresis.
 	 *
 	 * @param camera Camera for which the LOD should be selected.
+	 * @param viewport_height Height of the camera's viewport, in pixels.
 	 * @return Selected level of detail.
 	 */
-	std::size_t select_lod(const camera& camera) const;
+	std::size_t select_lod(const camera& camera, float viewport_height) const;
 	
 	/**
 	 * Adds an object to the LOD group.
@@ -87,6 +120,15 @@ public:
 	/// Returns the number of detail levels in the group.
 	std::size_t get_level_count() const;
 	
+	/// Returns the geometric error of a level of detail.
+	float get_level_error(std::size_t level) const;
+	
+	/// Returns the maximum screen-space error, in pixels.
+	float get_max_screen_error() const;
+	
+	/// Returns the hysteresis fraction.
+	float get_hysteresis() const;
+	
 	/**
 	 * Returns a list containing all objects in the LOD group with the specified detail level.
 	 *
@@ -101,6 +143,10 @@ private:
 	
 	aabb_type bounds;
 	std::vector<std::list<object_base*>> levels;
+	std::vector<float> level_errors;
+	float max_screen_error;
+	float hysteresis;
+	mutable std::vector<std::pair<const camera*, std::size_t>> camera_levels;
 };
 
 inline const typename object_base::bounding_volume_type& lod_group::get_bounds() const
@@ -113,6 +159,21 @@ inline std::size_t lod_group::get_level_count() const
 	return levels.size();
 }
 
+inline float lod_group::get_level_error(std::size_t level) const
+{
+	return level_errors[level];
+}
+
+inline float lod_group::get_max_screen_error() const
+{
+	return max_screen_error;
+}
+
+inline float lod_group::get_hysteresis() const
+{
+	return hysteresis;
+}
+
 inline const std::list<object_base*>& lod_group::get_objects(std::size_t level) const
 {
 	return levels[level];
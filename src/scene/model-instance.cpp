@@ -102,10 +102,8 @@ void model_instance::transformed()
 	update_bounds();
 }
 
-void model_instance::update_tweens()
+void model_instance::update_object_tweens()
 {
-	object_base::update_tweens();
-	
 	// Update model material tweens
 	if (model)
 	{
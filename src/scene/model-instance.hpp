@@ -78,10 +78,12 @@ public:
 	bool is_instanced() const;
 	std::size_t get_instance_count() const;
 	
-	virtual void update_tweens();
-	
 	void update_bounds();
 
+protected:
+	/// @copydoc object_base::update_object_tweens();
+	virtual void update_object_tweens();
+
 private:
 	virtual void transformed();
 	
@@ -22,22 +22,34 @@
 
 namespace scene {
 
-typename object_base::transform_type object_base::interpolate_transforms(const transform_type& x, const transform_type& y, float a)
-{
-	return
-		{
-			math::lerp(x.translation, y.translation, a),
-			math::nlerp(x.rotation, y.rotation, a),
-			math::lerp(x.scale, y.scale, a),
-		};
-}
-
 object_base::object_base():
 	active(true),
-	transform(math::identity_transform<float>, interpolate_transforms),
+	transform_index(transform_store().insert(math::identity_transform<float>)),
 	culling_mask(nullptr)
 {}
 
+object_base::object_base(const object_base& other):
+	active(other.active),
+	transform_index(transform_store().insert(other.get_transform())),
+	culling_mask(other.culling_mask)
+{
+	transform_store().set(transform_index, 0, get_transform_store().get(other.transform_index, 0));
+}
+
+object_base::~object_base()
+{
+	transform_store().erase(transform_index);
+}
+
+object_base& object_base::operator=(const object_base& other)
+{
+	active = other.active;
+	transform_store().set(transform_index, 0, get_transform_store().get(other.transform_index, 0));
+	transform_store().set(transform_index, 1, get_transform_store().get(other.transform_index, 1));
+	culling_mask = other.culling_mask;
+	return *this;
+}
+
 void object_base::set_culling_mask(const bounding_volume_type* culling_mask)
 {
 	this->culling_mask = culling_mask;
@@ -51,13 +63,37 @@ std::size_t object_base::next_object_type_id()
 
 void object_base::update_tweens()
 {
-	transform.update();
+	transform_store().update(transform_index);
+	update_object_tweens();
 }
 
+void object_base::update_transform_tweens()
+{
+	transform_store().update();
+}
+
+void object_base::publish_transform_tweens()
+{
+	published_transform_store() = transform_store();
+}
+
+object_base::transform_type object_base::interpolate_published_transform(float a) const
+{
+	const transform_store_type& published = get_published_transform_store();
+	if (transform_index < published.size())
+		return published.interpolate(transform_index, a);
+	return get_transform_store().interpolate(transform_index, a);
+}
+
+void object_base::update_object_tweens()
+{}
+
 void object_base::look_at(const vector_type& position, const vector_type& target, const vector_type& up)
 {
-	transform[1].translation = position;
-	transform[1].rotation = math::look_rotation(math::normalize(math::sub(target, position)), up);
+	transform_type transform = get_transform();
+	transform.translation = position;
+	transform.rotation = math::look_rotation(math::normalize(math::sub(target, position)), up);
+	transform_store().set(transform_index, 1, transform);
 	transformed();
 }
 
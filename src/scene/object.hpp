@@ -20,11 +20,14 @@
 #ifndef ANTKEEPER_SCENE_OBJECT_HPP
 #define ANTKEEPER_SCENE_OBJECT_HPP
 
+#include "animation/static-tween.hpp"
 #include "animation/tween.hpp"
+#include "animation/tween-store.hpp"
 #include "geom/bounding-volume.hpp"
 #include "math/vector-type.hpp"
 #include "math/quaternion-type.hpp"
 #include "math/transform-type.hpp"
+#include "math/transform-functions.hpp"
 #include <atomic>
 #include <cstdlib>
 
@@ -40,6 +43,7 @@ public:
 	typedef math::quaternion<float> quaternion_type;
 	typedef math::transform<float> transform_type;
 	typedef geom::bounding_volume<float> bounding_volume_type;
+	typedef tween_store<transform_type, float, math::lerp<float>> transform_store_type;
 	
 	/// Returns the type ID for this scene object type.
 	virtual const std::size_t get_object_type_id() const = 0;
@@ -48,16 +52,36 @@ public:
 	 * Creates a scene object base.
 	 */
 	object_base();
+	
+	/**
+	 * Creates a scene object base with a copy of another object's transform tween.
+	 */
+	object_base(const object_base& other);
 
 	/**
 	 * Destroys a scene object base.
 	 */
-	virtual ~object_base() = default;
+	virtual ~object_base();
+	
+	/**
+	 * Copies the active state, transform tween, and culling mask of another scene object.
+	 */
+	object_base& operator=(const object_base& other);
 
 	/**
 	 * Updates all tweens in the scene object.
 	 */
-	virtual void update_tweens();
+	void update_tweens();
+	
+	/**
+	 * Updates the transform tweens of all scene objects with a single copy. Should be called once per update, before updating the tweens of any collection.
+	 */
+	static void update_transform_tweens();
+	
+	/**
+	 * Copies the transform tweens of all scene objects into the published store, from which they are rendered. Should be called once per frame, after all scene changes of the frame have been made and before rendering.
+	 */
+	static void publish_transform_tweens();
 	
 	/**
 	 * Activates or deactivates the scene object.
@@ -100,28 +124,50 @@ public:
 	/**
 	 * Returns the transform.
 	 */
-	const transform_type& get_transform() const;
+	transform_type get_transform() const;
 
 	/**
 	 * Returns the transform's translation vector.
 	 */
-	const vector_type& get_translation() const;
+	vector_type get_translation() const;
 
 	/**
 	 * Returns the transform's rotation quaternion.
 	 */
-	const quaternion_type& get_rotation() const;
+	quaternion_type get_rotation() const;
 
 	/**
 	 * Returns the transform's scale vector.
 	 */
-	const vector_type& get_scale() const;
+	vector_type get_scale() const;
 
 	/**
-	 * Returns the transform tween.
+	 * Returns a handle to the transform tween.
 	 */
-	const tween<transform_type>& get_transform_tween() const;
-	tween<transform_type>& get_transform_tween();
+	transform_store_type::const_reference get_transform_tween() const;
+	transform_store_type::reference get_transform_tween();
+	
+	/**
+	 * Returns the index of the scene object's transform tween in the transform store.
+	 */
+	std::size_t get_transform_index() const;
+	
+	/**
+	 * Returns the store which holds the transform tweens of all scene objects.
+	 */
+	static const transform_store_type& get_transform_store();
+	
+	/**
+	 * Returns the copy of the transform store which was made by the last call to publish_transform_tweens().
+	 */
+	static const transform_store_type& get_published_transform_store();
+	
+	/**
+	 * Returns the transform interpolated from the published transform tween. Objects created since the transform tweens were last published are interpolated from their current transform tween.
+	 *
+	 * @param a Interpolation factor.
+	 */
+	transform_type interpolate_published_transform(float a) const;
 
 	/**
 	 * Returns the bounds of the object.
@@ -135,10 +181,20 @@ public:
 
 protected:
 	static std::size_t next_object_type_id();
+	
+	/**
+	 * Updates all tweens in the scene object other than its transform tween. Called by update_tweens().
+	 */
+	virtual void update_object_tweens();
 
 private:
-	/// Interpolates between two transforms.
-	static transform_type interpolate_transforms(const transform_type& x, const transform_type& y, float a);
+	friend class collection;
+	
+	/// Returns the transform store for modification.
+	static transform_store_type& transform_store();
+	
+	/// Returns the published transform store for modification.
+	static transform_store_type& published_transform_store();
 	
 	/**
 	 * Called every time the scene object's tranform is changed.
@@ -146,7 +202,7 @@ private:
 	virtual void transformed();
 
 	bool active;
-	tween<transform_type> transform;
+	std::size_t transform_index;
 	const bounding_volume_type* culling_mask;
 };
 
@@ -157,25 +213,31 @@ inline void object_base::set_active(bool active)
 
 inline void object_base::set_transform(const transform_type& transform)
 {
-	this->transform[1] = transform;
+	transform_store().set(transform_index, 1, transform);
 	transformed();
 }
 
 inline void object_base::set_translation(const vector_type& translation)
 {
-	transform[1].translation = translation;
+	transform_type transform = get_transform();
+	transform.translation = translation;
+	transform_store().set(transform_index, 1, transform);
 	transformed();
 }
 
 inline void object_base::set_rotation(const quaternion_type& rotation)
 {
-	transform[1].rotation = rotation;
+	transform_type transform = get_transform();
+	transform.rotation = rotation;
+	transform_store().set(transform_index, 1, transform);
 	transformed();
 }
 
 inline void object_base::set_scale(const vector_type& scale)
 {
-	transform[1].scale = scale;
+	transform_type transform = get_transform();
+	transform.scale = scale;
+	transform_store().set(transform_index, 1, transform);
 	transformed();
 }
 
@@ -184,34 +246,61 @@ inline bool object_base::is_active() const
 	return active;
 }
 
-inline const typename object_base::transform_type& object_base::get_transform() const
+inline typename object_base::transform_type object_base::get_transform() const
 {
-	return transform[1];
+	return get_transform_store().get(transform_index, 1);
 }
 
-inline const typename object_base::vector_type& object_base::get_translation() const
+inline typename object_base::vector_type object_base::get_translation() const
 {
 	return get_transform().translation;
 }
 
-inline const typename object_base::quaternion_type& object_base::get_rotation() const
+inline typename object_base::quaternion_type object_base::get_rotation() const
 {
 	return get_transform().rotation;
 }
 
-inline const typename object_base::vector_type& object_base::get_scale() const
+inline typename object_base::vector_type object_base::get_scale() const
 {
 	return get_transform().scale;
 }
 
-inline const tween<typename object_base::transform_type>& object_base::get_transform_tween() const
+inline typename object_base::transform_store_type::const_reference object_base::get_transform_tween() const
+{
+	return get_transform_store()[transform_index];
+}
+
+inline typename object_base::transform_store_type::reference object_base::get_transform_tween()
+{
+	return transform_store()[transform_index];
+}
+
+inline std::size_t object_base::get_transform_index() const
+{
+	return transform_index;
+}
+
+inline const typename object_base::transform_store_type& object_base::get_transform_store()
+{
+	return transform_store();
+}
+
+inline typename object_base::transform_store_type& object_base::transform_store()
+{
+	static transform_store_type store;
+	return store;
+}
+
+inline const typename object_base::transform_store_type& object_base::get_published_transform_store()
 {
-	return transform;
+	return published_transform_store();
 }
 
-inline tween<typename object_base::transform_type>& object_base::get_transform_tween()
+inline typename object_base::transform_store_type& object_base::published_transform_store()
 {
-	return transform;
+	static transform_store_type store;
+	return store;
 }
 
 inline const typename object_base::bounding_volume_type* object_base::get_culling_mask() const
@@ -23,7 +23,7 @@
 namespace scene {
 
 point_light::point_light():
-	attenuation(float3{1, 0, 0}, math::lerp<float3, float>)
+	attenuation(float3{1, 0, 0})
 {}
 
 void point_light::set_attenuation(const float3& attenuation)
@@ -31,9 +31,9 @@ void point_light::set_attenuation(const float3& attenuation)
 	this->attenuation[1] = attenuation;
 }
 
-void point_light::update_tweens()
+void point_light::update_object_tweens()
 {
-	light::update_tweens();
+	light::update_object_tweens();
 	attenuation.update();
 }
 
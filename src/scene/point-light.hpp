@@ -47,13 +47,14 @@ public:
 	const float3& get_attenuation() const;
 
 	/// Returns the attenuation tween.
-	const tween<float3>& get_attenuation_tween() const;
+	const lerp_tween<float3>& get_attenuation_tween() const;
 
-	/// @copydoc object_base::update_tweens();
-	virtual void update_tweens();
+protected:
+	/// @copydoc object_base::update_object_tweens();
+	virtual void update_object_tweens();
 
 private:
-	tween<float3> attenuation;
+	lerp_tween<float3> attenuation;
 };
 
 inline light_type point_light::get_light_type() const
@@ -66,7 +67,7 @@ inline const float3& point_light::get_attenuation() const
 	return attenuation[1];
 }
 
-inline const tween<float3>& point_light::get_attenuation_tween() const
+inline const lerp_tween<float3>& point_light::get_attenuation_tween() const
 {
 	return attenuation;
 }
@@ -33,9 +33,9 @@ static float3 interpolate_direction(const float3& x, const float3& y, float a)
 
 spot_light::spot_light():
 	direction(global_forward, interpolate_direction),
-	attenuation(float3{1, 0, 0}, math::lerp<float3, float>),
-	cutoff(float2{math::pi<float>, math::pi<float>}, math::lerp<float2, float>),
-	cosine_cutoff(float2{std::cos(math::pi<float>), std::cos(math::pi<float>)}, math::lerp<float2, float>)
+	attenuation(float3{1, 0, 0}),
+	cutoff(float2{math::pi<float>, math::pi<float>}),
+	cosine_cutoff(float2{std::cos(math::pi<float>), std::cos(math::pi<float>)})
 {}
 
 void spot_light::set_attenuation(const float3& attenuation)
@@ -49,9 +49,9 @@ void spot_light::set_cutoff(const float2& cutoff)
 	this->cosine_cutoff[1] = {std::cos(cutoff.x), std::cos(cutoff.y)};
 }
 
-void spot_light::update_tweens()
+void spot_light::update_object_tweens()
 {
-	light::update_tweens();
+	light::update_object_tweens();
 	direction.update();
 	attenuation.update();
 	cutoff.update();
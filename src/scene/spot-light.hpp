@@ -67,24 +67,25 @@ public:
 	const tween<float3>& get_direction_tween() const;
 	
 	/// Returns the attenuation tween.
-	const tween<float3>& get_attenuation_tween() const;
+	const lerp_tween<float3>& get_attenuation_tween() const;
 	
 	/// Returns the cutoff tween.
-	const tween<float2>& get_cutoff_tween() const;
+	const lerp_tween<float2>& get_cutoff_tween() const;
 	
 	/// Returns the cosine cutoff tween.
-	const tween<float2>& get_cosine_cutoff_tween() const;
+	const lerp_tween<float2>& get_cosine_cutoff_tween() const;
 
-	/// @copydoc object_base::update_tweens();
-	virtual void update_tweens();
+protected:
+	/// @copydoc object_base::update_object_tweens();
+	virtual void update_object_tweens();
 
 private:
 	virtual void transformed();
 
 	tween<float3> direction;
-	tween<float3> attenuation;
-	tween<float2> cutoff;
-	tween<float2> cosine_cutoff;
+	lerp_tween<float3> attenuation;
+	lerp_tween<float2> cutoff;
+	lerp_tween<float2> cosine_cutoff;
 };
 
 inline light_type spot_light::get_light_type() const
@@ -117,17 +118,17 @@ inline const tween<float3>& spot_light::get_direction_tween() const
 	return direction;
 }
 
-inline const tween<float3>& spot_light::get_attenuation_tween() const
+inline const lerp_tween<float3>& spot_light::get_attenuation_tween() const
 {
 	return attenuation;
 }
 
-inline const tween<float2>& spot_light::get_cutoff_tween() const
+inline const lerp_tween<float2>& spot_light::get_cutoff_tween() const
 {
 	return cutoff;
 }
 
-inline const tween<float2>& spot_light::get_cosine_cutoff_tween() const
+inline const lerp_tween<float2>& spot_light::get_cosine_cutoff_tween() const
 {
 	return cosine_cutoff;
 }